@@ -279,35 +279,34 @@ std::vector<types::Ticker> BinanceAdapter::get_all_tickers() {
             return tickers;
         }
         
-        auto json = nlohmann::json::parse(response.body);
-        if (!json.is_array()) {
+        const int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        
+        // Each element is parsed in place; unmapped fields and unsupported
+        // symbols cost only a skip over their bytes
+        size_t parsed = rest_ticker_parser_.parse_each(response.body, [&](const utils::FeedFields& fields) {
+            std::string standard_symbol = from_binance_symbol(std::string(fields.text(utils::FeedField::SYMBOL)));
+            if (standard_symbol.empty()) return; // Skip unsupported symbols
+            
+            types::Ticker ticker;
+            ticker.symbol = standard_symbol;
+            ticker.exchange = get_exchange_id();
+            ticker.bid = fields.number(utils::FeedField::BID_PRICE);
+            ticker.ask = fields.number(utils::FeedField::ASK_PRICE);
+            ticker.last = fields.number(utils::FeedField::LAST_PRICE);
+            ticker.price = ticker.last;
+            ticker.volume_24h = fields.number(utils::FeedField::VOLUME);
+            ticker.volume = ticker.volume_24h;
+            ticker.timestamp = now_ms;
+            
+            tickers.push_back(ticker);
+        });
+        
+        if (parsed == 0) {
             handle_error("Invalid response format for all tickers");
             return tickers;
         }
         
-        for (const auto& ticker_json : json) {
-            try {
-                std::string binance_symbol = binance_utils::safe_get_string(ticker_json, "symbol");
-                std::string standard_symbol = from_binance_symbol(binance_symbol);
-                
-                if (standard_symbol.empty()) continue; // Skip unsupported symbols
-                
-                types::Ticker ticker;
-                ticker.symbol = standard_symbol;
-                ticker.exchange = get_exchange_id();
-                ticker.bid = std::stod(binance_utils::safe_get_string(ticker_json, "bidPrice", "0"));
-                ticker.ask = std::stod(binance_utils::safe_get_string(ticker_json, "askPrice", "0"));
-                ticker.last = std::stod(binance_utils::safe_get_string(ticker_json, "lastPrice", "0"));
-                ticker.volume_24h = std::stod(binance_utils::safe_get_string(ticker_json, "volume", "0"));
-                ticker.timestamp = std::chrono::system_clock::now();
-                
-                tickers.push_back(ticker);
-                
-            } catch (const std::exception& e) {
-                utils::Logger::warn("Failed to parse ticker data: {}", e.what());
-            }
-        }
-        
         utils::Logger::debug("Retrieved {} tickers from Binance", tickers.size());
         
     } catch (const std::exception& e) {
@@ -335,15 +334,22 @@ types::Ticker BinanceAdapter::get_ticker(const std::string& symbol) {
             return ticker;
         }
         
-        auto json = nlohmann::json::parse(response.body);
+        utils::FeedFields fields;
+        if (!rest_ticker_parser_.parse(response.body, fields)) {
+            handle_error("Invalid response format for ticker " + symbol);
+            return ticker;
+        }
         
         ticker.symbol = symbol;
         ticker.exchange = get_exchange_id();
-        ticker.bid = std::stod(binance_utils::safe_get_string(json, "bidPrice", "0"));
-        ticker.ask = std::stod(binance_utils::safe_get_string(json, "askPrice", "0"));
-        ticker.last = std::stod(binance_utils::safe_get_string(json, "lastPrice", "0"));
-        ticker.volume_24h = std::stod(binance_utils::safe_get_string(json, "volume", "0"));
-        ticker.timestamp = std::chrono::system_clock::now();
+        ticker.bid = fields.number(utils::FeedField::BID_PRICE);
+        ticker.ask = fields.number(utils::FeedField::ASK_PRICE);
+        ticker.last = fields.number(utils::FeedField::LAST_PRICE);
+        ticker.price = ticker.last;
+        ticker.volume_24h = fields.number(utils::FeedField::VOLUME);
+        ticker.volume = ticker.volume_24h;
+        ticker.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
         
         utils::Logger::debug("Retrieved ticker for {}: last={}, bid={}, ask={}", 
                            symbol, ticker.last, ticker.bid, ticker.ask);
@@ -446,7 +452,97 @@ void BinanceAdapter::handle_error(const std::string& error_message) {
     utils::Logger::error("Binance adapter error: {}", error_message);
 }
 
+// WebSocket message handling
+void BinanceAdapter::on_websocket_message(const WebSocketMessage& message) {
+    messages_received_++;
+    last_message_time_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+        message.timestamp.time_since_epoch());
+    
+    if (!stream_parser_.parse(message.data, stream_fields_)) {
+        utils::Logger::warn("Malformed Binance stream message ({} bytes)", message.data.size());
+        return;
+    }
+    
+    using utils::FeedField;
+    std::string_view event = stream_fields_.text(FeedField::EVENT_TYPE);
+    if (event == "trade") {
+        parse_trade_message(stream_fields_);
+    } else if (event == "depthUpdate" ||
+               (event.empty() && stream_fields_.has(FeedField::BIDS) && !stream_fields_.has(FeedField::BID_QUANTITY))) {
+        parse_orderbook_message(stream_fields_);
+    } else if (event == "24hrTicker" || (event.empty() && stream_fields_.has(FeedField::BID_QUANTITY))) {
+        parse_ticker_message(stream_fields_);
+    }
+    // Anything else (subscription acks, unknown events) carries no market data
+}
+
+void BinanceAdapter::parse_ticker_message(const utils::FeedFields& fields) {
+    using utils::FeedField;
+    std::string symbol = symbol_from_fields(fields);
+    if (symbol.empty()) return;
+    
+    types::Ticker ticker;
+    ticker.symbol = symbol;
+    ticker.exchange = get_exchange_id();
+    ticker.bid = fields.number(FeedField::BID_PRICE);
+    ticker.ask = fields.number(FeedField::ASK_PRICE);
+    ticker.last = fields.number(FeedField::LAST_PRICE);
+    ticker.price = ticker.last;
+    ticker.volume_24h = fields.number(FeedField::VOLUME);
+    ticker.volume = ticker.volume_24h;
+    ticker.timestamp = fields.integer(FeedField::EVENT_TIME, last_message_time_.load().count());
+    
+    notify_ticker_update(ticker);
+}
+
+void BinanceAdapter::parse_orderbook_message(const utils::FeedFields& fields) {
+    if (!orderbook_callback_) return;
+    
+    std::string symbol = symbol_from_fields(fields);
+    if (symbol.empty()) return;
+    
+    auto read_side = [this, &fields](utils::FeedField field, std::vector<std::pair<double, double>>& out) {
+        // 1000 is the deepest book Binance serves
+        if (level_buffer_.empty()) level_buffer_.resize(1000);
+        size_t count = fields.read_levels(field, level_buffer_.data(), level_buffer_.size());
+        out.clear();
+        for (size_t i = 0; i < count; ++i) {
+            out.emplace_back(level_buffer_[i].price, level_buffer_[i].quantity);
+        }
+    };
+    
+    read_side(utils::FeedField::BIDS, bid_levels_);
+    read_side(utils::FeedField::ASKS, ask_levels_);
+    orderbook_callback_(symbol, get_exchange_id(), bid_levels_, ask_levels_);
+}
+
+void BinanceAdapter::parse_trade_message(const utils::FeedFields& fields) {
+    if (!trade_callback_) return;
+    
+    std::string symbol = symbol_from_fields(fields);
+    if (symbol.empty()) return;
+    
+    int64_t trade_time = fields.integer(utils::FeedField::TRADE_TIME, last_message_time_.load().count());
+    trade_callback_(symbol, get_exchange_id(),
+                    fields.number(utils::FeedField::TRADE_PRICE),
+                    fields.number(utils::FeedField::TRADE_QUANTITY),
+                    types::Timestamp(std::chrono::milliseconds(trade_time)));
+}
+
 // Private helper methods
+// Partial depth snapshots carry no symbol field; on combined streams it is
+// taken from the stream name instead
+std::string BinanceAdapter::symbol_from_fields(const utils::FeedFields& fields) const {
+    std::string_view binance_symbol = fields.text(utils::FeedField::SYMBOL);
+    std::string from_stream;
+    if (binance_symbol.empty()) {
+        std::string_view stream = fields.text(utils::FeedField::STREAM);
+        from_stream = binance_utils::normalize_symbol(std::string(stream.substr(0, stream.find('@'))));
+        binance_symbol = from_stream;
+    }
+    return from_binance_symbol(std::string(binance_symbol));
+}
+
 std::string BinanceAdapter::to_binance_symbol(const std::string& symbol) const {
     auto it = SYMBOL_MAPPING.find(symbol);
     return it != SYMBOL_MAPPING.end() ? it->second : "";
@@ -3,6 +3,7 @@
 #include "exchange_interface.hpp"
 #include "http_client.hpp"
 #include "websocket_client.hpp"
+#include "utils/fast_feed_parser.hpp"
 #include <nlohmann/json.hpp>
 #include <memory>
 #include <unordered_map>
@@ -87,18 +88,27 @@ private:
     std::atomic<size_t> messages_received_{0};
     std::atomic<std::chrono::milliseconds> last_message_time_{std::chrono::milliseconds(0)};
     
+    // Feed parsing; the buffers are reused by the WebSocket thread
+    utils::FastFeedParser stream_parser_{utils::feed_schemas::binance_stream()};
+    utils::FastFeedParser rest_ticker_parser_{utils::feed_schemas::binance_rest_ticker()};
+    utils::FeedFields stream_fields_;
+    std::vector<utils::PriceLevel> level_buffer_;
+    std::vector<std::pair<double, double>> bid_levels_;
+    std::vector<std::pair<double, double>> ask_levels_;
+    
     // Message processing
     void on_websocket_message(const WebSocketMessage& message);
     void on_websocket_connection(WebSocketStatus status, const std::string& reason);
     void on_websocket_error(const std::string& error);
     
     // Message parsing
-    void parse_ticker_message(const nlohmann::json& json);
-    void parse_orderbook_message(const nlohmann::json& json);
-    void parse_trade_message(const nlohmann::json& json);
+    void parse_ticker_message(const utils::FeedFields& fields);
+    void parse_orderbook_message(const utils::FeedFields& fields);
+    void parse_trade_message(const utils::FeedFields& fields);
     void parse_error_message(const nlohmann::json& json);
     
     // Symbol conversion
+    std::string symbol_from_fields(const utils::FeedFields& fields) const;
     std::string to_binance_symbol(const std::string& symbol) const;
     std::string from_binance_symbol(const std::string& binance_symbol) const;
     
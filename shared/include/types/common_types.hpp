@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include "symbol_registry.hpp"
 
 namespace ats {
 namespace types {
@@ -120,6 +121,35 @@ struct Ticker {
         : symbol(sym), exchange(ex), bid(b), ask(a), price(l), last(l), volume(v), volume_24h(v), timestamp(ts) {}
 };
 
+// Interned, allocation-free ticker for hot paths
+struct CompactTicker {
+    SymbolCode symbol = INVALID_CODE;
+    ExchangeCode exchange = INVALID_CODE;
+    Price bid = 0.0;
+    Price ask = 0.0;
+    Price last = 0.0;
+    Volume volume = 0.0;
+    int64_t timestamp = 0;  // Unix timestamp in milliseconds
+};
+
+// Either code is INVALID_CODE when its registry is full
+inline CompactTicker to_compact(const Ticker& ticker) {
+    CompactTicker compact;
+    compact.symbol = intern_symbol(ticker.symbol);
+    compact.exchange = intern_exchange(ticker.exchange);
+    compact.bid = ticker.bid;
+    compact.ask = ticker.ask;
+    compact.last = ticker.last;
+    compact.volume = ticker.volume;
+    compact.timestamp = ticker.timestamp;
+    return compact;
+}
+
+inline Ticker to_ticker(const CompactTicker& compact) {
+    return Ticker(symbol_name(compact.symbol), exchange_name(compact.exchange),
+                  compact.bid, compact.ask, compact.last, compact.volume, compact.timestamp);
+}
+
 // Order structure
 struct Order {
     OrderId id;
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace ats {
+namespace types {
+
+// Dense integer codes for interned names. Hot-path structures carry these
+// instead of heap strings and convert back only at the edges (adapters,
+// logging, gRPC).
+using SymbolCode = uint16_t;
+using ExchangeCode = uint16_t;
+
+constexpr uint16_t INVALID_CODE = 0xFFFF;
+constexpr size_t MAX_SYMBOLS = 4096;
+constexpr size_t MAX_EXCHANGES = 16;
+
+// Thread-safe string interner handing out dense codes in insertion order.
+// Lookups by code never lock: names live in a fixed array and a code is only
+// published after its name has been written.
+template <size_t Capacity>
+class NameRegistry {
+public:
+    NameRegistry() : names_(new std::string[Capacity]) {}
+
+    NameRegistry(const NameRegistry&) = delete;
+    NameRegistry& operator=(const NameRegistry&) = delete;
+
+    // Returns the existing code for name or assigns the next free one.
+    // Once the registry is full, new names get INVALID_CODE; callers skip
+    // them rather than unwind a hot path.
+    uint16_t intern(std::string_view name) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = codes_.find(name);
+            if (it != codes_.end()) {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = codes_.find(name);
+        if (it != codes_.end()) {
+            return it->second;
+        }
+
+        size_t code = size_.load(std::memory_order_relaxed);
+        if (code >= Capacity) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return INVALID_CODE;
+        }
+
+        names_[code] = std::string(name);
+        codes_.emplace(names_[code], static_cast<uint16_t>(code));
+        size_.store(code + 1, std::memory_order_release);
+        return static_cast<uint16_t>(code);
+    }
+
+    // Returns INVALID_CODE if name has not been interned
+    uint16_t find(std::string_view name) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = codes_.find(name);
+        return it != codes_.end() ? it->second : INVALID_CODE;
+    }
+
+    const std::string& name(uint16_t code) const {
+        static const std::string unknown;
+        return code < size_.load(std::memory_order_acquire) ? names_[code] : unknown;
+    }
+
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Intern calls turned away because the registry was full
+    size_t rejected() const { return rejected_.load(std::memory_order_relaxed); }
+
+private:
+    std::unique_ptr<std::string[]> names_;
+    std::unordered_map<std::string_view, uint16_t> codes_; // views into names_
+    std::atomic<size_t> size_{0};
+    std::atomic<size_t> rejected_{0};
+    mutable std::shared_mutex mutex_;
+};
+
+class SymbolRegistry : public NameRegistry<MAX_SYMBOLS> {
+public:
+    static SymbolRegistry& instance() {
+        static SymbolRegistry registry;
+        return registry;
+    }
+};
+
+class ExchangeRegistry : public NameRegistry<MAX_EXCHANGES> {
+public:
+    static ExchangeRegistry& instance() {
+        static ExchangeRegistry registry;
+        return registry;
+    }
+};
+
+inline SymbolCode intern_symbol(std::string_view symbol) {
+    return SymbolRegistry::instance().intern(symbol);
+}
+
+inline ExchangeCode intern_exchange(std::string_view exchange) {
+    return ExchangeRegistry::instance().intern(exchange);
+}
+
+inline const std::string& symbol_name(SymbolCode code) {
+    return SymbolRegistry::instance().name(code);
+}
+
+inline const std::string& exchange_name(ExchangeCode code) {
+    return ExchangeRegistry::instance().name(code);
+}
+
+} // namespace types
+} // namespace ats
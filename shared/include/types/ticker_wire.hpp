@@ -0,0 +1,152 @@
+#pragma once
+
+#include "types/common_types.hpp"
+#include "types/symbol_registry.hpp"
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace ats {
+namespace types {
+
+// Binary ticker encoding for Redis price channels.
+//
+// A message is a sequence of frames. Every frame starts with a 4-byte header
+// {magic, version, kind, size}. The magic byte is never valid as the first
+// byte of JSON, so subscribers tell the formats apart per message and JSON
+// stays usable on any channel for debugging.
+//
+// Symbol and exchange codes are interned per process, so they are not stable
+// across publisher and subscriber. A publisher announces each code with a
+// dictionary frame ahead of the first ticker that uses it, and repeats the
+// announcement periodically for subscribers that join late.
+//
+// Ticker frame (56 bytes, little-endian, doubles 8-byte aligned):
+//   0  header         4   exchange code u16   6  symbol code u16
+//   8  sequence u64   16  timestamp ms i64    24 bid f64
+//   32 ask f64        40  last f64            48 volume f64
+//
+// Dictionary frame (8 + name bytes):
+//   0  header         4   code u16            6  domain u8   7 reserved
+//   8  name
+enum class WireFormat {
+    JSON,
+    BINARY
+};
+
+namespace wire {
+
+constexpr uint8_t MAGIC = 0xA7;
+constexpr uint8_t VERSION = 1;
+constexpr uint8_t KIND_TICKER = 1;
+constexpr uint8_t KIND_DICTIONARY = 2;
+constexpr uint8_t DOMAIN_EXCHANGE = 0;
+constexpr uint8_t DOMAIN_SYMBOL = 1;
+
+constexpr size_t HEADER_SIZE = 4;
+constexpr size_t TICKER_FRAME_SIZE = 56;
+constexpr size_t DICTIONARY_HEADER_SIZE = 8;
+constexpr size_t MAX_NAME_SIZE = 255 - DICTIONARY_HEADER_SIZE;
+
+template <typename T>
+inline T load(const unsigned char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(&value);
+    for (size_t i = 0; i < sizeof(T) / 2; ++i) {
+        std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+    }
+#endif
+    return value;
+}
+
+} // namespace wire
+
+inline bool is_binary_frame(std::string_view payload) {
+    return !payload.empty() && static_cast<unsigned char>(payload.front()) == wire::MAGIC;
+}
+
+// Frames in a binary message, counted from the headers alone. Counting
+// stops at the first malformed header.
+struct WireFrameCounts {
+    size_t tickers = 0;
+    size_t dictionaries = 0;
+};
+
+WireFrameCounts count_frames(std::string_view payload);
+
+// Read-only view over a ticker frame inside a received buffer. Fields are
+// read in place; the buffer must outlive the view.
+class TickerFrameView {
+public:
+    explicit TickerFrameView(const unsigned char* frame) : frame_(frame) {}
+
+    uint16_t exchange() const { return wire::load<uint16_t>(frame_ + 4); }
+    uint16_t symbol() const { return wire::load<uint16_t>(frame_ + 6); }
+    uint64_t sequence() const { return wire::load<uint64_t>(frame_ + 8); }
+    int64_t timestamp() const { return wire::load<int64_t>(frame_ + 16); }
+    double bid() const { return wire::load<double>(frame_ + 24); }
+    double ask() const { return wire::load<double>(frame_ + 32); }
+    double last() const { return wire::load<double>(frame_ + 40); }
+    double volume() const { return wire::load<double>(frame_ + 48); }
+
+private:
+    const unsigned char* frame_;
+};
+
+// Per-channel encoder. Keeps the channel's sequence number and which codes
+// the channel has announced.
+class TickerWireEncoder {
+public:
+    // Codes are announced again after this many messages
+    explicit TickerWireEncoder(uint64_t dictionary_interval = 4096);
+
+    // Replaces out with one message: any pending dictionary frames followed
+    // by the ticker frame
+    void encode(const CompactTicker& ticker, std::string& out);
+
+    uint64_t sequence() const { return sequence_; }
+
+private:
+    void announce(uint8_t domain, uint16_t code, const std::string& name, std::string& out);
+
+    uint64_t dictionary_interval_;
+    uint64_t sequence_ = 0;
+    std::bitset<MAX_EXCHANGES> exchanges_announced_;
+    std::bitset<MAX_SYMBOLS> symbols_announced_;
+};
+
+// Per-channel decoder. Translates the publisher's codes to local interned
+// codes and tracks the sequence number to detect lost messages.
+class TickerWireDecoder {
+public:
+    enum class Status {
+        TICKER,        // ticker decoded
+        DICTIONARY,    // only dictionary frames; nothing to deliver
+        UNKNOWN_CODE,  // ticker references a code not announced yet
+        MALFORMED
+    };
+
+    TickerWireDecoder();
+
+    // Decodes every frame in the message. On TICKER, ticker holds the last
+    // ticker frame of the message.
+    Status decode(std::string_view payload, CompactTicker& ticker);
+
+    uint64_t last_sequence() const { return last_sequence_; }
+    uint64_t sequence_gaps() const { return sequence_gaps_; }
+
+private:
+    std::array<uint16_t, MAX_EXCHANGES> exchanges_;
+    std::array<uint16_t, MAX_SYMBOLS> symbols_;
+    uint64_t last_sequence_ = 0;
+    uint64_t sequence_gaps_ = 0;
+};
+
+} // namespace types
+} // namespace ats
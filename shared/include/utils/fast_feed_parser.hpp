@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ats {
+namespace utils {
+
+// Fields the exchange feeds are mined for. Each schema maps a subset of them
+// to JSON paths of one exchange's messages.
+enum class FeedField : uint8_t {
+    EVENT_TYPE,
+    SYMBOL,
+    STREAM,  // combined-stream name, e.g. "btcusdt@depth20"
+    EVENT_TIME,
+    UPDATE_ID,
+    FIRST_UPDATE_ID,
+    BID_PRICE,
+    BID_QUANTITY,
+    ASK_PRICE,
+    ASK_QUANTITY,
+    LAST_PRICE,
+    VOLUME,
+    TRADE_ID,
+    TRADE_PRICE,
+    TRADE_QUANTITY,
+    TRADE_TIME,
+    BUYER_MAKER,
+    BIDS,   // array of [price, quantity] levels
+    ASKS,   // array of [price, quantity] levels
+    COUNT
+};
+
+constexpr size_t FEED_FIELD_COUNT = static_cast<size_t>(FeedField::COUNT);
+
+struct PriceLevel {
+    double price = 0.0;
+    double quantity = 0.0;
+};
+
+// Maps fields to paths inside a message. Paths are dot separated; numeric
+// segments index arrays, so "1.b.0" is the first element of key "b" in the
+// second element of a top-level array. A field may be mapped to several
+// paths, e.g. with and without a combined-stream wrapper, and a path may
+// carry several fields when message types reuse a key with different shapes
+// (Binance "b" is a price in bookTicker and a level array in depthUpdate).
+class FeedSchema {
+public:
+    FeedSchema();
+
+    FeedSchema& map(FeedField field, std::string_view path);
+
+    size_t field_count() const { return field_count_; }
+
+private:
+    friend class FastFeedParser;
+
+    struct Node {
+        std::string key;      // object key; empty for array elements
+        int index = -1;       // array index, or -1 for object keys
+        uint32_t fields = 0;  // FeedFields captured here (bit per field)
+        std::vector<uint16_t> children;
+    };
+
+    uint16_t child(uint16_t parent, std::string_view segment, bool create);
+
+    std::vector<Node> nodes_; // nodes_[0] is the document root
+    uint32_t mapped_ = 0;
+    size_t field_count_ = 0;
+};
+
+// Fields captured from one message. Values are views into the parsed buffer,
+// which must outlive this object; nothing is copied or allocated.
+class FeedFields {
+public:
+    bool has(FeedField field) const { return (present_ >> static_cast<size_t>(field)) & 1u; }
+    size_t size() const { return found_; }
+
+    // Numbers are accepted bare or quoted, as Binance sends prices as strings
+    double number(FeedField field, double default_value = 0.0) const;
+    int64_t integer(FeedField field, int64_t default_value = 0) const;
+    bool boolean(FeedField field, bool default_value = false) const;
+
+    // String contents without the quotes; escape sequences are not decoded
+    std::string_view text(FeedField field) const;
+
+    // Reads up to capacity [price, quantity] pairs from an array field
+    size_t read_levels(FeedField field, PriceLevel* out, size_t capacity) const;
+
+    void clear() {
+        present_ = 0;
+        found_ = 0;
+    }
+
+private:
+    friend class FastFeedParser;
+
+    struct Slot {
+        const char* data = nullptr;
+        uint32_t size = 0;
+        bool quoted = false;
+    };
+
+    void set(uint32_t fields, const char* data, size_t size, bool quoted);
+
+    std::array<Slot, FEED_FIELD_COUNT> slots_;
+    uint32_t present_ = 0;
+    size_t found_ = 0;
+};
+
+// Streaming, on-demand JSON extraction. Walks the message once, descends only
+// into keys the schema asks for, skips everything else with SIMD scans for
+// quotes and brackets, and stops as soon as every mapped field is captured.
+// No DOM is built and nothing is allocated. The parser trusts exchange
+// payloads to be well-formed JSON and only guards against reading past the
+// buffer; parse() returns false on a truncated or malformed message.
+class FastFeedParser {
+public:
+    explicit FastFeedParser(FeedSchema schema) : schema_(std::move(schema)) {}
+
+    bool parse(std::string_view message, FeedFields& fields) const;
+
+    // Parses each element of a top-level array (e.g. a REST ticker list) and
+    // passes the fields to on_element; returns the number of elements parsed
+    template <typename F>
+    size_t parse_each(std::string_view array, F&& on_element) const;
+
+    const FeedSchema& schema() const { return schema_; }
+
+private:
+    // Iterates the elements of a JSON array without parsing them
+    class ArrayElements {
+    public:
+        explicit ArrayElements(std::string_view array);
+        bool next(std::string_view& element);
+
+    private:
+        const char* cursor_;
+        const char* end_;
+        bool done_ = false;
+    };
+
+    const char* walk(uint16_t node, const char* cursor, const char* end, FeedFields& fields, bool& done) const;
+
+    FeedSchema schema_;
+};
+
+template <typename F>
+size_t FastFeedParser::parse_each(std::string_view array, F&& on_element) const {
+    ArrayElements elements(array);
+    std::string_view element;
+    FeedFields fields;
+    size_t count = 0;
+    while (elements.next(element)) {
+        fields.clear();
+        if (parse(element, fields)) {
+            on_element(static_cast<const FeedFields&>(fields));
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Field maps for the feeds we consume
+namespace feed_schemas {
+
+// bookTicker, 24hrTicker, depthUpdate, partial depth and trade events, bare
+// or wrapped in a combined-stream {"stream", "data"} envelope
+FeedSchema binance_stream();
+// /api/v3/ticker/24hr REST objects
+FeedSchema binance_rest_ticker();
+// ticker and orderbook messages (best level only)
+FeedSchema upbit_stream();
+// ticker channel messages
+FeedSchema coinbase_stream();
+// v1 ticker arrays: [channel_id, {a, b, c, v, ...}, "ticker", pair]
+FeedSchema kraken_ticker();
+// v2 ticker arrays: [channel_id, [BID, BID_SIZE, ASK, ASK_SIZE, ..., LAST_PRICE, VOLUME, ...]]
+FeedSchema bitfinex_ticker();
+
+} // namespace feed_schemas
+
+} // namespace utils
+} // namespace ats
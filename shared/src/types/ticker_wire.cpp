@@ -0,0 +1,169 @@
+#include "types/ticker_wire.hpp"
+#include <stdexcept>
+
+namespace ats {
+namespace types {
+
+namespace {
+
+template <typename T>
+void store(std::string& out, size_t offset, T value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(&value);
+    for (size_t i = 0; i < sizeof(T) / 2; ++i) {
+        std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+    }
+#endif
+    std::memcpy(&out[offset], &value, sizeof(T));
+}
+
+void append_header(std::string& out, uint8_t kind, size_t size) {
+    out += static_cast<char>(wire::MAGIC);
+    out += static_cast<char>(wire::VERSION);
+    out += static_cast<char>(kind);
+    out += static_cast<char>(size);
+}
+
+} // namespace
+
+WireFrameCounts count_frames(std::string_view payload) {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(payload.data());
+    WireFrameCounts counts;
+    size_t offset = 0;
+    while (payload.size() - offset >= wire::HEADER_SIZE) {
+        const unsigned char* frame = data + offset;
+        const size_t frame_size = frame[3];
+        if (frame[0] != wire::MAGIC || frame_size < wire::HEADER_SIZE || frame_size > payload.size() - offset) {
+            break;
+        }
+        counts.tickers += frame[2] == wire::KIND_TICKER;
+        counts.dictionaries += frame[2] == wire::KIND_DICTIONARY;
+        offset += frame_size;
+    }
+    return counts;
+}
+
+TickerWireEncoder::TickerWireEncoder(uint64_t dictionary_interval)
+    : dictionary_interval_(dictionary_interval > 0 ? dictionary_interval : 1) {}
+
+void TickerWireEncoder::announce(uint8_t domain, uint16_t code, const std::string& name, std::string& out) {
+    if (name.size() > wire::MAX_NAME_SIZE) {
+        throw std::length_error("Name too long for ticker dictionary frame: " + name);
+    }
+
+    size_t offset = out.size();
+    size_t size = wire::DICTIONARY_HEADER_SIZE + name.size();
+    append_header(out, wire::KIND_DICTIONARY, size);
+    out.resize(offset + wire::DICTIONARY_HEADER_SIZE);
+    store<uint16_t>(out, offset + 4, code);
+    out[offset + 6] = static_cast<char>(domain);
+    out[offset + 7] = 0;
+    out += name;
+}
+
+void TickerWireEncoder::encode(const CompactTicker& ticker, std::string& out) {
+    if (ticker.exchange >= MAX_EXCHANGES || ticker.symbol >= MAX_SYMBOLS) {
+        throw std::invalid_argument("Ticker carries an invalid interned code");
+    }
+
+    out.clear();
+    if (sequence_ % dictionary_interval_ == 0) {
+        exchanges_announced_.reset();
+        symbols_announced_.reset();
+    }
+    if (!exchanges_announced_.test(ticker.exchange)) {
+        announce(wire::DOMAIN_EXCHANGE, ticker.exchange, exchange_name(ticker.exchange), out);
+        exchanges_announced_.set(ticker.exchange);
+    }
+    if (!symbols_announced_.test(ticker.symbol)) {
+        announce(wire::DOMAIN_SYMBOL, ticker.symbol, symbol_name(ticker.symbol), out);
+        symbols_announced_.set(ticker.symbol);
+    }
+
+    size_t offset = out.size();
+    append_header(out, wire::KIND_TICKER, wire::TICKER_FRAME_SIZE);
+    out.resize(offset + wire::TICKER_FRAME_SIZE);
+    store<uint16_t>(out, offset + 4, ticker.exchange);
+    store<uint16_t>(out, offset + 6, ticker.symbol);
+    store<uint64_t>(out, offset + 8, ++sequence_);
+    store<int64_t>(out, offset + 16, ticker.timestamp);
+    store<double>(out, offset + 24, ticker.bid);
+    store<double>(out, offset + 32, ticker.ask);
+    store<double>(out, offset + 40, ticker.last);
+    store<double>(out, offset + 48, ticker.volume);
+}
+
+TickerWireDecoder::TickerWireDecoder() {
+    exchanges_.fill(INVALID_CODE);
+    symbols_.fill(INVALID_CODE);
+}
+
+TickerWireDecoder::Status TickerWireDecoder::decode(std::string_view payload, CompactTicker& ticker) {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(payload.data());
+    const size_t size = payload.size();
+    Status status = Status::DICTIONARY;
+    size_t offset = 0;
+
+    while (offset < size) {
+        if (size - offset < wire::HEADER_SIZE) {
+            return Status::MALFORMED;
+        }
+        const unsigned char* frame = data + offset;
+        const size_t frame_size = frame[3];
+        if (frame[0] != wire::MAGIC || frame[1] != wire::VERSION ||
+            frame_size < wire::HEADER_SIZE || frame_size > size - offset) {
+            return Status::MALFORMED;
+        }
+
+        if (frame[2] == wire::KIND_DICTIONARY) {
+            if (frame_size < wire::DICTIONARY_HEADER_SIZE) {
+                return Status::MALFORMED;
+            }
+            uint16_t remote = wire::load<uint16_t>(frame + 4);
+            std::string_view name(reinterpret_cast<const char*>(frame + wire::DICTIONARY_HEADER_SIZE),
+                                  frame_size - wire::DICTIONARY_HEADER_SIZE);
+            if (frame[6] == wire::DOMAIN_EXCHANGE && remote < MAX_EXCHANGES) {
+                exchanges_[remote] = intern_exchange(name);
+            } else if (frame[6] == wire::DOMAIN_SYMBOL && remote < MAX_SYMBOLS) {
+                symbols_[remote] = intern_symbol(name);
+            } else {
+                return Status::MALFORMED;
+            }
+        } else if (frame[2] == wire::KIND_TICKER) {
+            if (frame_size != wire::TICKER_FRAME_SIZE) {
+                return Status::MALFORMED;
+            }
+            TickerFrameView view(frame);
+
+            // A jump past the next number means messages were lost on the channel
+            uint64_t sequence = view.sequence();
+            if (last_sequence_ != 0 && sequence > last_sequence_ + 1) {
+                sequence_gaps_ += sequence - last_sequence_ - 1;
+            }
+            last_sequence_ = sequence;
+
+            uint16_t exchange = view.exchange() < MAX_EXCHANGES ? exchanges_[view.exchange()] : INVALID_CODE;
+            uint16_t symbol = view.symbol() < MAX_SYMBOLS ? symbols_[view.symbol()] : INVALID_CODE;
+            if (exchange == INVALID_CODE || symbol == INVALID_CODE) {
+                status = Status::UNKNOWN_CODE;
+            } else {
+                ticker.exchange = exchange;
+                ticker.symbol = symbol;
+                ticker.timestamp = view.timestamp();
+                ticker.bid = view.bid();
+                ticker.ask = view.ask();
+                ticker.last = view.last();
+                ticker.volume = view.volume();
+                status = Status::TICKER;
+            }
+        }
+        // Unknown frame kinds are skipped so newer publishers can add them
+
+        offset += frame_size;
+    }
+
+    return status;
+}
+
+} // namespace types
+} // namespace ats
@@ -0,0 +1,552 @@
+#include "utils/fast_feed_parser.hpp"
+#include <charconv>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ats {
+namespace utils {
+
+namespace {
+
+inline bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline const char* skip_space(const char* p, const char* end) {
+    while (p < end && is_space(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// First '"' or '\\' at or after p, or nullptr
+const char* find_quote_or_escape(const char* p, const char* end) {
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i escape = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, escape)));
+        if (mask != 0) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        p += 16;
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == '"' || *p == '\\') {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+// First of '"', '{', '}', '[' or ']' at or after p, or nullptr
+const char* find_structural(const char* p, const char* end) {
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i open_brace = _mm_set1_epi8('{');
+    const __m128i close_brace = _mm_set1_epi8('}');
+    const __m128i open_bracket = _mm_set1_epi8('[');
+    const __m128i close_bracket = _mm_set1_epi8(']');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, open_brace)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, close_brace), _mm_cmpeq_epi8(chunk, open_bracket)),
+                         _mm_cmpeq_epi8(chunk, close_bracket)));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask != 0) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        p += 16;
+    }
+#endif
+    for (; p < end; ++p) {
+        char c = *p;
+        if (c == '"' || c == '{' || c == '}' || c == '[' || c == ']') {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+// p points just past an opening quote; returns the closing quote or nullptr
+const char* string_end(const char* p, const char* end) {
+    while (true) {
+        p = find_quote_or_escape(p, end);
+        if (p == nullptr || *p == '"') {
+            return p;
+        }
+        p += 2; // escaped character
+        if (p > end) {
+            return nullptr;
+        }
+    }
+}
+
+// p points at '{' or '['; returns one past the matching close or nullptr
+const char* skip_container(const char* p, const char* end) {
+    int depth = 0;
+    while (p < end) {
+        p = find_structural(p, end);
+        if (p == nullptr) {
+            return nullptr;
+        }
+        switch (*p) {
+            case '"':
+                p = string_end(p + 1, end);
+                if (p == nullptr) {
+                    return nullptr;
+                }
+                ++p;
+                break;
+            case '{':
+            case '[':
+                ++depth;
+                ++p;
+                break;
+            default:
+                ++p;
+                if (--depth == 0) {
+                    return p;
+                }
+                break;
+        }
+    }
+    return nullptr;
+}
+
+// p points at the first character of a value; returns one past it or nullptr
+const char* skip_value(const char* p, const char* end) {
+    if (p >= end) {
+        return nullptr;
+    }
+    if (*p == '"') {
+        const char* close = string_end(p + 1, end);
+        return close != nullptr ? close + 1 : nullptr;
+    }
+    if (*p == '{' || *p == '[') {
+        return skip_container(p, end);
+    }
+    const char* start = p;
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && !is_space(*p)) {
+        ++p;
+    }
+    return p != start ? p : nullptr;
+}
+
+// Unquoted view of the value at p, which ends at value_end
+std::string_view value_text(const char* p, const char* value_end) {
+    if (*p == '"') {
+        return std::string_view(p + 1, static_cast<size_t>(value_end - p - 2));
+    }
+    return std::string_view(p, static_cast<size_t>(value_end - p));
+}
+
+bool to_double(std::string_view text, double& value) {
+    if (text.empty()) {
+        return false;
+    }
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+} // namespace
+
+// FeedSchema implementation
+FeedSchema::FeedSchema() {
+    nodes_.emplace_back();
+}
+
+uint16_t FeedSchema::child(uint16_t parent, std::string_view segment, bool create) {
+    int index = -1;
+    if (!segment.empty() && segment.find_first_not_of("0123456789") == std::string_view::npos) {
+        std::from_chars(segment.data(), segment.data() + segment.size(), index);
+    }
+
+    for (uint16_t id : nodes_[parent].children) {
+        const Node& node = nodes_[id];
+        if (index >= 0 ? node.index == index : node.index < 0 && node.key == segment) {
+            return id;
+        }
+    }
+    if (!create) {
+        return 0;
+    }
+    if (nodes_.size() >= UINT16_MAX) {
+        throw std::length_error("Feed schema has too many paths");
+    }
+
+    Node node;
+    node.index = index;
+    if (index < 0) {
+        node.key = std::string(segment);
+    }
+    uint16_t id = static_cast<uint16_t>(nodes_.size());
+    nodes_.push_back(std::move(node));
+    nodes_[parent].children.push_back(id);
+    return id;
+}
+
+FeedSchema& FeedSchema::map(FeedField field, std::string_view path) {
+    if (field >= FeedField::COUNT || path.empty()) {
+        throw std::invalid_argument("Invalid feed schema mapping");
+    }
+
+    uint16_t node = 0;
+    while (true) {
+        size_t dot = path.find('.');
+        node = child(node, path.substr(0, dot), true);
+        if (dot == std::string_view::npos) {
+            break;
+        }
+        path.remove_prefix(dot + 1);
+    }
+
+    uint32_t bit = 1u << static_cast<size_t>(field);
+    nodes_[node].fields |= bit;
+    if ((mapped_ & bit) == 0) {
+        mapped_ |= bit;
+        ++field_count_;
+    }
+    return *this;
+}
+
+// FeedFields implementation
+void FeedFields::set(uint32_t fields, const char* data, size_t size, bool quoted) {
+    for (size_t i = 0; i < FEED_FIELD_COUNT; ++i) {
+        uint32_t bit = 1u << i;
+        if ((fields & bit) == 0) {
+            continue;
+        }
+        slots_[i] = Slot{data, static_cast<uint32_t>(size), quoted};
+        if ((present_ & bit) == 0) {
+            present_ |= bit;
+            ++found_;
+        }
+    }
+}
+
+std::string_view FeedFields::text(FeedField field) const {
+    if (!has(field)) {
+        return {};
+    }
+    const Slot& slot = slots_[static_cast<size_t>(field)];
+    return std::string_view(slot.data, slot.size);
+}
+
+double FeedFields::number(FeedField field, double default_value) const {
+    double value = 0.0;
+    return to_double(text(field), value) ? value : default_value;
+}
+
+int64_t FeedFields::integer(FeedField field, int64_t default_value) const {
+    std::string_view value_text = text(field);
+    if (value_text.empty()) {
+        return default_value;
+    }
+    int64_t value = 0;
+    auto result = std::from_chars(value_text.data(), value_text.data() + value_text.size(), value);
+    if (result.ec == std::errc() && result.ptr == value_text.data() + value_text.size()) {
+        return value;
+    }
+    // Fractional or exponent forms such as Upbit's 1.7e12 timestamps
+    double real = 0.0;
+    return to_double(value_text, real) ? static_cast<int64_t>(real) : default_value;
+}
+
+bool FeedFields::boolean(FeedField field, bool default_value) const {
+    std::string_view value = text(field);
+    if (value == "true") {
+        return true;
+    }
+    if (value == "false") {
+        return false;
+    }
+    return default_value;
+}
+
+size_t FeedFields::read_levels(FeedField field, PriceLevel* out, size_t capacity) const {
+    if (!has(field) || slots_[static_cast<size_t>(field)].quoted) {
+        return 0;
+    }
+    const Slot& slot = slots_[static_cast<size_t>(field)];
+    const char* p = slot.data;
+    const char* end = slot.data + slot.size;
+    if (p >= end || *p != '[') {
+        return 0;
+    }
+
+    size_t count = 0;
+    p = skip_space(p + 1, end);
+    while (p < end && *p == '[' && count < capacity) {
+        // Take the first two numeric elements; a leading side marker such as
+        // "buy" is passed over
+        double values[2] = {0.0, 0.0};
+        size_t parsed = 0;
+        p = skip_space(p + 1, end);
+        while (p < end && *p != ']') {
+            const char* value_end = skip_value(p, end);
+            if (value_end == nullptr) {
+                return count;
+            }
+            if (parsed < 2 && to_double(value_text(p, value_end), values[parsed])) {
+                ++parsed;
+            }
+            p = skip_space(value_end, end);
+            if (p < end && *p == ',') {
+                p = skip_space(p + 1, end);
+            }
+        }
+        if (p >= end) {
+            return count;
+        }
+        if (parsed == 2) {
+            out[count].price = values[0];
+            out[count].quantity = values[1];
+            ++count;
+        }
+        p = skip_space(p + 1, end);
+        if (p < end && *p == ',') {
+            p = skip_space(p + 1, end);
+        }
+    }
+    return count;
+}
+
+// FastFeedParser implementation
+const char* FastFeedParser::walk(uint16_t node_id, const char* p, const char* end, FeedFields& fields,
+                                 bool& done) const {
+    const FeedSchema::Node& node = schema_.nodes_[node_id];
+
+    if (node.fields != 0) {
+        const char* value_end = skip_value(p, end);
+        if (value_end == nullptr) {
+            return nullptr;
+        }
+        std::string_view value = value_text(p, value_end);
+        fields.set(node.fields, value.data(), value.size(), *p == '"');
+        done = fields.found_ == schema_.field_count_;
+        return value_end;
+    }
+
+    if (node.children.empty() || (*p != '{' && *p != '[')) {
+        return skip_value(p, end);
+    }
+
+    const bool object = *p == '{';
+    const char close = object ? '}' : ']';
+    int index = 0;
+
+    p = skip_space(p + 1, end);
+    if (p < end && *p == close) {
+        return p + 1;
+    }
+
+    while (p < end) {
+        uint16_t child = 0;
+        if (object) {
+            if (*p != '"') {
+                return nullptr;
+            }
+            const char* key_end = string_end(p + 1, end);
+            if (key_end == nullptr) {
+                return nullptr;
+            }
+            std::string_view key(p + 1, static_cast<size_t>(key_end - p - 1));
+            for (uint16_t id : node.children) {
+                if (schema_.nodes_[id].index < 0 && schema_.nodes_[id].key == key) {
+                    child = id;
+                    break;
+                }
+            }
+            p = skip_space(key_end + 1, end);
+            if (p >= end || *p != ':') {
+                return nullptr;
+            }
+            p = skip_space(p + 1, end);
+            if (p >= end) {
+                return nullptr;
+            }
+        } else {
+            for (uint16_t id : node.children) {
+                if (schema_.nodes_[id].index == index) {
+                    child = id;
+                    break;
+                }
+            }
+        }
+
+        p = child != 0 ? walk(child, p, end, fields, done) : skip_value(p, end);
+        if (p == nullptr || done) {
+            return p;
+        }
+
+        p = skip_space(p, end);
+        if (p >= end) {
+            return nullptr;
+        }
+        if (*p == close) {
+            return p + 1;
+        }
+        if (*p != ',') {
+            return nullptr;
+        }
+        p = skip_space(p + 1, end);
+        ++index;
+    }
+    return nullptr;
+}
+
+bool FastFeedParser::parse(std::string_view message, FeedFields& fields) const {
+    fields.clear();
+    const char* end = message.data() + message.size();
+    const char* p = skip_space(message.data(), end);
+    if (p >= end) {
+        return false;
+    }
+    bool done = false;
+    return walk(0, p, end, fields, done) != nullptr;
+}
+
+FastFeedParser::ArrayElements::ArrayElements(std::string_view array)
+    : cursor_(array.data()), end_(array.data() + array.size()) {
+    cursor_ = skip_space(cursor_, end_);
+    if (cursor_ >= end_ || *cursor_ != '[') {
+        done_ = true;
+        return;
+    }
+    cursor_ = skip_space(cursor_ + 1, end_);
+    if (cursor_ < end_ && *cursor_ == ']') {
+        done_ = true;
+    }
+}
+
+bool FastFeedParser::ArrayElements::next(std::string_view& element) {
+    if (done_) {
+        return false;
+    }
+    const char* value_end = skip_value(cursor_, end_);
+    if (value_end == nullptr) {
+        done_ = true;
+        return false;
+    }
+    element = std::string_view(cursor_, static_cast<size_t>(value_end - cursor_));
+
+    cursor_ = skip_space(value_end, end_);
+    if (cursor_ < end_ && *cursor_ == ',') {
+        cursor_ = skip_space(cursor_ + 1, end_);
+    } else {
+        done_ = true;
+    }
+    return true;
+}
+
+namespace feed_schemas {
+
+FeedSchema binance_stream() {
+    FeedSchema schema;
+    schema.map(FeedField::STREAM, "stream");
+    for (std::string prefix : {"", "data."}) {
+        schema.map(FeedField::EVENT_TYPE, prefix + "e")
+            .map(FeedField::SYMBOL, prefix + "s")
+            .map(FeedField::EVENT_TIME, prefix + "E")
+            .map(FeedField::UPDATE_ID, prefix + "u")
+            .map(FeedField::UPDATE_ID, prefix + "lastUpdateId")
+            .map(FeedField::FIRST_UPDATE_ID, prefix + "U")
+            // bookTicker and 24hrTicker carry best prices in b/a; depthUpdate
+            // carries level arrays under the same keys
+            .map(FeedField::BID_PRICE, prefix + "b")
+            .map(FeedField::BIDS, prefix + "b")
+            .map(FeedField::BID_QUANTITY, prefix + "B")
+            .map(FeedField::ASK_PRICE, prefix + "a")
+            .map(FeedField::ASKS, prefix + "a")
+            .map(FeedField::ASK_QUANTITY, prefix + "A")
+            .map(FeedField::BIDS, prefix + "bids")
+            .map(FeedField::ASKS, prefix + "asks")
+            .map(FeedField::LAST_PRICE, prefix + "c")
+            .map(FeedField::VOLUME, prefix + "v")
+            .map(FeedField::TRADE_ID, prefix + "t")
+            .map(FeedField::TRADE_PRICE, prefix + "p")
+            .map(FeedField::TRADE_QUANTITY, prefix + "q")
+            .map(FeedField::TRADE_TIME, prefix + "T")
+            .map(FeedField::BUYER_MAKER, prefix + "m");
+    }
+    return schema;
+}
+
+FeedSchema binance_rest_ticker() {
+    FeedSchema schema;
+    schema.map(FeedField::SYMBOL, "symbol")
+        .map(FeedField::BID_PRICE, "bidPrice")
+        .map(FeedField::BID_QUANTITY, "bidQty")
+        .map(FeedField::ASK_PRICE, "askPrice")
+        .map(FeedField::ASK_QUANTITY, "askQty")
+        .map(FeedField::LAST_PRICE, "lastPrice")
+        .map(FeedField::VOLUME, "volume")
+        .map(FeedField::EVENT_TIME, "closeTime");
+    return schema;
+}
+
+FeedSchema upbit_stream() {
+    FeedSchema schema;
+    schema.map(FeedField::EVENT_TYPE, "type")
+        .map(FeedField::SYMBOL, "code")
+        .map(FeedField::EVENT_TIME, "timestamp")
+        .map(FeedField::LAST_PRICE, "trade_price")
+        .map(FeedField::VOLUME, "acc_trade_volume_24h")
+        .map(FeedField::BID_PRICE, "orderbook_units.0.bid_price")
+        .map(FeedField::BID_QUANTITY, "orderbook_units.0.bid_size")
+        .map(FeedField::ASK_PRICE, "orderbook_units.0.ask_price")
+        .map(FeedField::ASK_QUANTITY, "orderbook_units.0.ask_size");
+    return schema;
+}
+
+FeedSchema coinbase_stream() {
+    FeedSchema schema;
+    schema.map(FeedField::EVENT_TYPE, "type")
+        .map(FeedField::SYMBOL, "product_id")
+        .map(FeedField::UPDATE_ID, "sequence")
+        .map(FeedField::LAST_PRICE, "price")
+        .map(FeedField::BID_PRICE, "best_bid")
+        .map(FeedField::BID_QUANTITY, "best_bid_size")
+        .map(FeedField::ASK_PRICE, "best_ask")
+        .map(FeedField::ASK_QUANTITY, "best_ask_size")
+        .map(FeedField::VOLUME, "volume_24h")
+        .map(FeedField::TRADE_ID, "trade_id")
+        .map(FeedField::TRADE_QUANTITY, "last_size");
+    return schema;
+}
+
+FeedSchema kraken_ticker() {
+    FeedSchema schema;
+    schema.map(FeedField::BID_PRICE, "1.b.0")
+        .map(FeedField::BID_QUANTITY, "1.b.2")
+        .map(FeedField::ASK_PRICE, "1.a.0")
+        .map(FeedField::ASK_QUANTITY, "1.a.2")
+        .map(FeedField::LAST_PRICE, "1.c.0")
+        .map(FeedField::VOLUME, "1.v.1")
+        .map(FeedField::EVENT_TYPE, "2")
+        .map(FeedField::SYMBOL, "3");
+    return schema;
+}
+
+FeedSchema bitfinex_ticker() {
+    FeedSchema schema;
+    schema.map(FeedField::BID_PRICE, "1.0")
+        .map(FeedField::BID_QUANTITY, "1.1")
+        .map(FeedField::ASK_PRICE, "1.2")
+        .map(FeedField::ASK_QUANTITY, "1.3")
+        .map(FeedField::LAST_PRICE, "1.6")
+        .map(FeedField::VOLUME, "1.7");
+    return schema;
+}
+
+} // namespace feed_schemas
+
+} // namespace utils
+} // namespace ats
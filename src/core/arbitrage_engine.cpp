@@ -15,9 +15,20 @@ void ArbitrageEngine::stop() {
 }
 
 void ArbitrageEngine::evaluate_opportunity(const ArbitrageOpportunity& opportunity) {
-    if (risk_manager_->IsTradeAllowed(opportunity)) {
-        trade_executor_->execute_trade(opportunity);
+    // The risk check and the reservation are one atomic step, so shards can
+    // place orders concurrently without two of them passing the same limits
+    double trade_size = risk_manager_->ReserveCapacity(opportunity);
+    if (trade_size <= 0) {
+        return;
     }
+
+    try {
+        trade_executor_->execute_trade(opportunity, trade_size);
+    } catch (...) {
+        risk_manager_->ReleaseCapacity(trade_size);
+        throw;
+    }
+    risk_manager_->ReleaseCapacity(trade_size);
 }
 
 }
\ No newline at end of file
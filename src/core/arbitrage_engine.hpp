@@ -13,6 +13,7 @@ public:
     void start();
     void stop();
 
+    // Called concurrently by every event loop shard
     void evaluate_opportunity(const ArbitrageOpportunity& opportunity);
 
 private:
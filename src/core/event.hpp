@@ -7,7 +7,7 @@
 namespace ats {
 
 struct PriceUpdateEvent {
-    PriceComparison comparison;
+    CompactPriceComparison comparison;
 };
 
 struct ArbitrageOpportunityEvent {
@@ -18,6 +18,12 @@ struct TradeExecutionEvent {
     Trade trade;
 };
 
-using Event = std::variant<PriceUpdateEvent, ArbitrageOpportunityEvent, TradeExecutionEvent>;
+// Marker for a conflated price update; the comparison itself waits in the
+// event loop's per-symbol slot and is read when the marker is processed
+struct ConflatedPriceUpdateEvent {
+    types::SymbolCode symbol;
+};
+
+using Event = std::variant<PriceUpdateEvent, ArbitrageOpportunityEvent, TradeExecutionEvent, ConflatedPriceUpdateEvent>;
 
 }
\ No newline at end of file
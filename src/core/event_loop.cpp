@@ -1,27 +1,158 @@
 #include "event_loop.hpp"
+#include <algorithm>
 
 namespace ats {
 
-EventLoop::EventLoop(OpportunityDetector* opportunity_detector, ArbitrageEngine* arbitrage_engine)
-    : opportunity_detector_(opportunity_detector),
+thread_local EventLoop* EventLoop::current_loop_ = nullptr;
+
+EventLoop::EventLoop(OpportunityDetector* opportunity_detector, ArbitrageEngine* arbitrage_engine,
+                     const EventLoopConfig& config)
+    : config_(config),
+      event_queue_(config.queue_capacity, config.wait_strategy),
+      opportunity_detector_(opportunity_detector),
       arbitrage_engine_(arbitrage_engine),
-      running_(false) {}
+      running_(false) {
+    // A zero batch would never drain the ring or the overflow queues
+    config_.max_batch_size = std::max<size_t>(config_.max_batch_size, 1);
+}
 
 void EventLoop::run() {
+    current_loop_ = this;
     running_ = true;
+    std::vector<Event> batch;
+    batch.reserve(config_.max_batch_size);
     while (running_) {
-        Event event;
-        event_queue_.wait_and_pop(event);
-        process_event(event);
+        if (overflow_.empty() && cross_shard_depth_.load(std::memory_order_acquire) == 0 &&
+            !event_queue_.wait_for_data(running_)) {
+            continue;
+        }
+        batch.clear();
+        event_queue_.drain(batch, config_.max_batch_size);
+        for (const auto& event : batch) {
+            process_event(event);
+        }
+        process_cross_shard_overflow();
+        process_overflow();
     }
+    current_loop_ = nullptr;
 }
 
 void EventLoop::stop() {
     running_ = false;
+    event_queue_.notify();
 }
 
 void EventLoop::push_event(Event event) {
-    event_queue_.push(std::move(event));
+    if (config_.conflate_price_updates) {
+        if (auto* price_update = std::get_if<PriceUpdateEvent>(&event)) {
+            if (price_conflator_.offer(price_update->comparison)) {
+                enqueue(ConflatedPriceUpdateEvent{price_update->comparison.symbol});
+            }
+            return;
+        }
+    }
+    enqueue(std::move(event));
+}
+
+void EventLoop::enqueue(Event event) {
+    if (current_loop_ == nullptr) {
+        // External producers get backpressure
+        event_queue_.push(std::move(event));
+        return;
+    }
+
+    if (current_loop_ == this) {
+        // Keep own-thread events in order once any have overflowed
+        if (overflow_.empty() && event_queue_.try_push(std::move(event))) {
+            return;
+        }
+        overflow_.push_back(std::move(event));
+        overflow_depth_.store(overflow_.size(), std::memory_order_relaxed);
+        overflowed_events_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Another loop's thread must not wait on this loop, which may be waiting
+    // on it. Once anything has overflowed, later events queue behind it so
+    // each producer's events stay in order.
+    if (cross_shard_depth_.load(std::memory_order_acquire) == 0 && event_queue_.try_push(std::move(event))) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(cross_shard_mutex_);
+        // A dropped conflation marker would leave its symbol's slot dirty,
+        // and offer() only asks for a marker on a clean slot, so the symbol
+        // would never be processed again. Markers are bounded by the symbol
+        // count, so they are admitted like opportunities.
+        if (cross_shard_overflow_.size() >= config_.cross_shard_overflow_capacity &&
+            !std::holds_alternative<ArbitrageOpportunityEvent>(event) &&
+            !std::holds_alternative<ConflatedPriceUpdateEvent>(event)) {
+            dropped_events_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        cross_shard_overflow_.push_back(std::move(event));
+        cross_shard_depth_.store(cross_shard_overflow_.size(), std::memory_order_release);
+    }
+    overflowed_events_.fetch_add(1, std::memory_order_relaxed);
+    // The ring may already be drained, so the consumer could be parked; a
+    // wake-up lost in its park window is covered by the park timeout
+    event_queue_.notify();
+}
+
+void EventLoop::process_cross_shard_overflow() {
+    if (cross_shard_depth_.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    // Bounded per pass like the local overflow; handlers run without the lock
+    std::vector<Event> events;
+    {
+        std::lock_guard<std::mutex> lock(cross_shard_mutex_);
+        size_t count = std::min(cross_shard_overflow_.size(), config_.max_batch_size);
+        events.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            events.push_back(std::move(cross_shard_overflow_.front()));
+            cross_shard_overflow_.pop_front();
+        }
+        cross_shard_depth_.store(cross_shard_overflow_.size(), std::memory_order_release);
+    }
+    for (const auto& event : events) {
+        process_event(event);
+    }
+}
+
+void EventLoop::process_overflow() {
+    // Bounded per pass so overflow cannot starve the ring; handlers may append
+    for (size_t i = 0; i < config_.max_batch_size && !overflow_.empty(); ++i) {
+        Event event = std::move(overflow_.front());
+        overflow_.pop_front();
+        process_event(event);
+    }
+    overflow_depth_.store(overflow_.size(), std::memory_order_relaxed);
+}
+
+size_t EventLoop::queue_depth() const {
+    return event_queue_.size() + overflow_depth_.load(std::memory_order_relaxed) +
+           cross_shard_depth_.load(std::memory_order_relaxed);
+}
+
+size_t EventLoop::queue_high_water_mark() const {
+    return event_queue_.high_water_mark();
+}
+
+size_t EventLoop::conflated_price_updates() const {
+    return price_conflator_.conflated_count();
+}
+
+size_t EventLoop::rejected_price_updates() const {
+    return price_conflator_.rejected_count();
+}
+
+size_t EventLoop::overflowed_events() const {
+    return overflowed_events_.load(std::memory_order_relaxed);
+}
+
+size_t EventLoop::dropped_events() const {
+    return dropped_events_.load(std::memory_order_relaxed);
 }
 
 void EventLoop::process_event(const Event& event) {
@@ -31,8 +162,13 @@ void EventLoop::process_event(const Event& event) {
             opportunity_detector_->update_prices(arg.comparison);
         } else if constexpr (std::is_same_v<T, ArbitrageOpportunityEvent>) {
             arbitrage_engine_->evaluate_opportunity(arg.opportunity);
+        } else if constexpr (std::is_same_v<T, ConflatedPriceUpdateEvent>) {
+            CompactPriceComparison comparison;
+            if (price_conflator_.take(arg.symbol, comparison)) {
+                opportunity_detector_->update_prices(comparison);
+            }
         }
     }, event);
 }
 
-}
\ No newline at end of file
+}
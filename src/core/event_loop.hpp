@@ -1,29 +1,72 @@
 #pragma once
 
-#include "../utils/thread_safe_queue.hpp"
+#include <deque>
+#include <mutex>
+#include "../utils/mpsc_ring_buffer.hpp"
 #include "event.hpp"
 #include "event_pusher.hpp"
+#include "price_conflator.hpp"
 #include "opportunity_detector.hpp"
 #include "arbitrage_engine.hpp"
 
 namespace ats {
 
+struct EventLoopConfig {
+    size_t queue_capacity = 8192;    // Rounded up to a power of two
+    size_t max_batch_size = 256;     // Events drained per wake-up; at least 1
+    size_t cross_shard_overflow_capacity = 8192; // Events from other loops held while the ring is full
+    bool conflate_price_updates = false; // Drop queued price updates superseded by newer ones
+    WaitStrategy wait_strategy;
+};
+
 class EventLoop : public EventPusher {
 public:
-    EventLoop(OpportunityDetector* opportunity_detector, ArbitrageEngine* arbitrage_engine);
+    EventLoop(OpportunityDetector* opportunity_detector, ArbitrageEngine* arbitrage_engine,
+              const EventLoopConfig& config = EventLoopConfig());
 
     void run();
     void stop();
+    bool is_running() const { return running_; }
 
     void push_event(Event event) override;
 
+    // Queue metrics
+    size_t queue_depth() const;             // ring plus local overflow
+    size_t queue_high_water_mark() const;
+    size_t conflated_price_updates() const;
+    size_t rejected_price_updates() const;  // updates without a symbol code the conflator turned away
+    size_t overflowed_events() const;       // loop-thread pushes that found the ring full
+    size_t dropped_events() const;          // pushes from another loop's thread that found its overflow full too
+
 private:
+    void enqueue(Event event);
     void process_event(const Event& event);
+    void process_overflow();
+    void process_cross_shard_overflow();
+
+    // The loop whose run() owns the calling thread, if any
+    static thread_local EventLoop* current_loop_;
 
-    ThreadSafeQueue<Event> event_queue_;
+    EventLoopConfig config_;
+    MpscRingBuffer<Event> event_queue_;
+    // Events this loop's own thread pushed while the ring was full. Handlers
+    // run on the consumer thread, and only that thread drains the ring, so
+    // blocking there would deadlock. Consumer thread only.
+    std::deque<Event> overflow_;
+    std::atomic<size_t> overflow_depth_{0};
+    // Events other loops' threads pushed while the ring was full. They must
+    // not wait on this loop, which may be waiting on them, so they park here
+    // up to cross_shard_overflow_capacity; opportunities and conflation
+    // markers are always admitted.
+    std::mutex cross_shard_mutex_;
+    std::deque<Event> cross_shard_overflow_;
+    std::atomic<size_t> cross_shard_depth_{0};
+    std::atomic<size_t> overflowed_events_{0};
+    std::atomic<size_t> dropped_events_{0};
+    PriceConflator price_conflator_;
     OpportunityDetector* opportunity_detector_;
     ArbitrageEngine* arbitrage_engine_;
     std::atomic<bool> running_;
 };
 
-}
\ No newline at end of file
+}
@@ -5,7 +5,17 @@
 namespace ats {
 
 OpportunityDetector::OpportunityDetector(ConfigManager* config_manager, const std::vector<std::string>& symbols)
-    : config_manager_(config_manager), symbols_(config_manager->get_trading_config().pairs), event_pusher_(nullptr) {}
+    : config_manager_(config_manager), symbols_(config_manager->get_trading_config().pairs), event_pusher_(nullptr) {
+    for (const auto& [name, exchange_config] : config_manager_->get_exchange_configs()) {
+        types::ExchangeCode code = types::intern_exchange(name);
+        if (code < taker_fees_.size()) {
+            taker_fees_[code] = exchange_config.taker_fee;
+            has_taker_fee_.set(code);
+        } else {
+            LOG_WARNING("Exchange registry full, ignoring taker fee of %s", name.c_str());
+        }
+    }
+}
 
 void OpportunityDetector::start() {
     // Start the opportunity detector
@@ -19,14 +29,18 @@ void OpportunityDetector::set_event_pusher(EventPusher* event_pusher) {
     event_pusher_ = event_pusher;
 }
 
-void OpportunityDetector::update_prices(const PriceComparison& comparison) {
+void OpportunityDetector::update_prices(const CompactPriceComparison& comparison) {
     // Find the best buy and sell prices
     double best_bid = 0;
     double best_ask = 1e9;
-    std::string best_bid_exchange;
-    std::string best_ask_exchange;
+    types::ExchangeCode best_bid_exchange = types::INVALID_CODE;
+    types::ExchangeCode best_ask_exchange = types::INVALID_CODE;
 
-    for (const auto& [exchange, price] : comparison.exchange_prices) {
+    for (types::ExchangeCode exchange = 0; exchange < types::MAX_EXCHANGES; ++exchange) {
+        if (!comparison.has(exchange)) {
+            continue;
+        }
+        const auto& price = comparison.prices[exchange];
         if (price.bid > best_bid) {
             best_bid = price.bid;
             best_bid_exchange = exchange;
@@ -39,20 +53,42 @@ void OpportunityDetector::update_prices(const PriceComparison& comparison) {
 
     // Check for an arbitrage opportunity
     if (best_bid > best_ask) {
-        LOG_INFO("Potential opportunity found for {}: buy at {} on {}, sell at {} on {}", comparison.symbol, best_ask, best_ask_exchange, best_bid, best_bid_exchange);
-        double buy_taker_fee = config_manager_->get_exchange_configs().at(best_ask_exchange).taker_fee;
-        double sell_taker_fee = config_manager_->get_exchange_configs().at(best_bid_exchange).taker_fee;
+        // Names are only resolved once there is something to report
+        const std::string& symbol = types::symbol_name(comparison.symbol);
+        const std::string& buy_exchange = types::exchange_name(best_ask_exchange);
+        const std::string& sell_exchange = types::exchange_name(best_bid_exchange);
+
+        LOG_INFO("Potential opportunity found for %s: buy at %f on %s, sell at %f on %s", symbol.c_str(), best_ask, buy_exchange.c_str(), best_bid, sell_exchange.c_str());
+
+        // Pricing a venue as fee-free would overstate the profit
+        bool fees_known = true;
+        for (types::ExchangeCode exchange : {best_ask_exchange, best_bid_exchange}) {
+            if (has_taker_fee_.test(exchange)) {
+                continue;
+            }
+            fees_known = false;
+            uint32_t bit = 1u << exchange;
+            if (!(warned_missing_fee_.fetch_or(bit, std::memory_order_relaxed) & bit)) {
+                LOG_WARNING("No taker fee configured for %s, skipping its opportunities", types::exchange_name(exchange).c_str());
+            }
+        }
+        if (!fees_known) {
+            return;
+        }
+
+        double buy_taker_fee = taker_fees_[best_ask_exchange];
+        double sell_taker_fee = taker_fees_[best_bid_exchange];
 
         double buy_price_with_fee = best_ask * (1 + buy_taker_fee);
         double sell_price_with_fee = best_bid * (1 - sell_taker_fee);
         double profit = sell_price_with_fee - buy_price_with_fee;
-        LOG_INFO("Profit after fees: {}", profit);
+        LOG_INFO("Profit after fees: %f", profit);
 
         if (profit > 0) {
             ArbitrageOpportunity opportunity;
-            opportunity.symbol = comparison.symbol;
-            opportunity.buy_exchange = best_ask_exchange;
-            opportunity.sell_exchange = best_bid_exchange;
+            opportunity.symbol = symbol;
+            opportunity.buy_exchange = buy_exchange;
+            opportunity.sell_exchange = sell_exchange;
             opportunity.buy_price = best_ask;
             opportunity.sell_price = best_bid;
             opportunity.profit = profit;
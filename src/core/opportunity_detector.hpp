@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
@@ -17,12 +21,19 @@ public:
     void stop();
 
     void set_event_pusher(EventPusher* event_pusher);
-    void update_prices(const PriceComparison& comparison);
+
+    // Safe to call from several event loop shards at once: it only reads the
+    // fee table, which is fixed at construction. Exchanges without a
+    // configured fee never form an opportunity.
+    void update_prices(const CompactPriceComparison& comparison);
 
 private:
     ConfigManager* config_manager_;
     std::vector<std::string> symbols_;
     EventPusher* event_pusher_;
+    std::array<double, types::MAX_EXCHANGES> taker_fees_{}; // indexed by exchange code
+    std::bitset<types::MAX_EXCHANGES> has_taker_fee_;
+    std::atomic<uint32_t> warned_missing_fee_{0}; // one bit per exchange code, logged once
 };
 
-} 
\ No newline at end of file
+} 
@@ -0,0 +1,65 @@
+#include "price_conflator.hpp"
+
+namespace ats {
+
+bool PriceConflator::offer(const CompactPriceComparison& comparison) {
+    // Slots are indexed by code; the sentinel would grow the table to its
+    // full 64K range for a symbol that has no slot of its own
+    if (comparison.symbol == types::INVALID_CODE) {
+        rejected_count_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Slot& slot = slot_for(comparison.symbol);
+
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    bool was_dirty = slot.dirty;
+    slot.latest = comparison;
+    slot.dirty = true;
+
+    if (was_dirty) {
+        conflated_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return !was_dirty;
+}
+
+bool PriceConflator::take(types::SymbolCode symbol, CompactPriceComparison& comparison) {
+    Slot* slot;
+    {
+        std::shared_lock<std::shared_mutex> lock(slots_mutex_);
+        if (symbol >= slots_.size()) {
+            return false;
+        }
+        slot = &slots_[symbol];
+    }
+
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    if (!slot->dirty) {
+        return false;
+    }
+    comparison = slot->latest;
+    slot->dirty = false;
+    return true;
+}
+
+size_t PriceConflator::symbol_count() const {
+    std::shared_lock<std::shared_mutex> lock(slots_mutex_);
+    return slots_.size();
+}
+
+PriceConflator::Slot& PriceConflator::slot_for(types::SymbolCode symbol) {
+    {
+        std::shared_lock<std::shared_mutex> lock(slots_mutex_);
+        if (symbol < slots_.size()) {
+            return slots_[symbol];
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(slots_mutex_);
+    while (slots_.size() <= symbol) {
+        slots_.emplace_back();
+    }
+    return slots_[symbol];
+}
+
+}
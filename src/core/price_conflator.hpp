@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include "types.hpp"
+
+namespace ats {
+
+// Keeps the latest price comparison per symbol. A newer comparison replaces a
+// pending one in place, so the consumer only ever sees the freshest prices
+// and the intermediate ticks are counted as conflated.
+class PriceConflator {
+public:
+    // Stores the comparison. Returns true when the symbol's slot was clean,
+    // i.e. the caller must enqueue a marker for it; false when it replaced a
+    // pending update that already has a marker queued, or when the symbol
+    // is INVALID_CODE and the comparison was rejected.
+    bool offer(const CompactPriceComparison& comparison);
+
+    // Copies the pending comparison for symbol out of its slot and marks it
+    // clean. Returns false if nothing is pending.
+    bool take(types::SymbolCode symbol, CompactPriceComparison& comparison);
+
+    size_t conflated_count() const { return conflated_count_.load(std::memory_order_relaxed); }
+    size_t rejected_count() const { return rejected_count_.load(std::memory_order_relaxed); }
+    size_t symbol_count() const;
+
+private:
+    struct Slot {
+        std::mutex mutex;
+        CompactPriceComparison latest;
+        bool dirty = false;
+    };
+
+    Slot& slot_for(types::SymbolCode symbol);
+
+    // Slots are indexed by symbol code; deque keeps addresses stable on growth
+    mutable std::shared_mutex slots_mutex_;
+    std::deque<Slot> slots_;
+    std::atomic<size_t> conflated_count_{0};
+    std::atomic<size_t> rejected_count_{0};
+};
+
+}
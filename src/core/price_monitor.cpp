@@ -1,6 +1,7 @@
 #include "price_monitor.hpp"
 #include <iostream>
 #include <chrono>
+#include <future>
 #include "../utils/logger.hpp"
 #include "../exchange/exchange_exception.hpp"
 
@@ -9,6 +10,20 @@ namespace ats {
 PriceMonitor::PriceMonitor(ConfigManager* config_manager, const std::vector<std::shared_ptr<ExchangeInterface>>& exchanges)
     : config_manager_(config_manager), exchanges_(exchanges), event_pusher_(nullptr), running_(false) {
     symbols_ = config_manager_->get_trading_config().pairs;
+    settings_ = config_manager_->get_price_monitor_settings();
+
+    for (const auto& symbol : symbols_) {
+        if (types::intern_symbol(symbol) == types::INVALID_CODE) {
+            LOG_WARNING("Symbol registry full, not monitoring %s", symbol.c_str());
+        }
+    }
+    for (const auto& exchange : exchanges_) {
+        types::ExchangeCode code = types::intern_exchange(exchange->get_name());
+        if (code == types::INVALID_CODE) {
+            LOG_WARNING("Exchange registry full, ignoring prices from %s", exchange->get_name().c_str());
+        }
+        exchange_codes_.push_back(code);
+    }
 }
 
 PriceMonitor::~PriceMonitor() {
@@ -17,14 +32,52 @@ PriceMonitor::~PriceMonitor() {
 
 void PriceMonitor::start() {
     running_ = true;
-    thread_ = std::thread(&PriceMonitor::run, this);
+
+    if (!settings_.push_driven) {
+        thread_ = std::thread(&PriceMonitor::run, this);
+        return;
+    }
+
+    streaming_exchanges_.clear();
+    rest_exchanges_.clear();
+    for (size_t i = 0; i < exchanges_.size(); ++i) {
+        const auto& exchange = exchanges_[i];
+        std::string name = exchange->get_name();
+        types::ExchangeCode code = exchange_codes_[i];
+        bool streaming = exchange->supports_price_stream() &&
+            exchange->subscribe_prices(symbols_, [this, code](const Price& price) {
+                on_price(code, price);
+            });
+
+        if (streaming) {
+            Logger::info("PriceMonitor streaming tickers from " + name);
+            streaming_exchanges_.push_back(exchange);
+        } else {
+            Logger::info("PriceMonitor polling " + name + " over REST");
+            rest_exchanges_.push_back(i);
+        }
+    }
+
+    if (!rest_exchanges_.empty()) {
+        size_t threads = settings_.rest_fanout_threads > 0 ? settings_.rest_fanout_threads : rest_exchanges_.size();
+        fanout_pool_ = std::make_unique<ThreadPool>(threads);
+        thread_ = std::thread(&PriceMonitor::run_rest_fanout, this);
+    }
 }
 
 void PriceMonitor::stop() {
     running_ = false;
+    for (const auto& exchange : streaming_exchanges_) {
+        exchange->unsubscribe_prices();
+    }
+    streaming_exchanges_.clear();
     if (thread_.joinable()) {
         thread_.join();
     }
+    if (fanout_pool_) {
+        fanout_pool_->shutdown();
+        fanout_pool_.reset();
+    }
 }
 
 void PriceMonitor::set_event_pusher(EventPusher* event_pusher) {
@@ -38,19 +91,98 @@ void PriceMonitor::run() {
     }
 }
 
+void PriceMonitor::run_rest_fanout() {
+    const auto interval = std::chrono::milliseconds(settings_.rest_poll_interval_ms);
+
+    while (running_) {
+        auto round_start = std::chrono::steady_clock::now();
+
+        // One request per exchange in parallel, so a round costs the slowest
+        // venue's latency rather than the sum of all of them
+        std::vector<std::future<void>> pending;
+        pending.reserve(rest_exchanges_.size());
+        for (size_t index : rest_exchanges_) {
+            pending.push_back(fanout_pool_->submit([this, index] { poll_exchange(index); }));
+        }
+        for (auto& result : pending) {
+            result.wait();
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - round_start;
+        if (elapsed < interval) {
+            std::this_thread::sleep_for(interval - elapsed);
+        }
+    }
+}
+
+void PriceMonitor::poll_exchange(size_t index) {
+    const auto& exchange = exchanges_[index];
+    types::ExchangeCode code = exchange_codes_[index];
+    try {
+        for (const auto& price : exchange->get_prices(symbols_)) {
+            on_price(code, price);
+        }
+    } catch (const ExchangeException& e) {
+        Logger::error("Error getting prices from " + exchange->get_name() + ": " + e.what());
+    }
+}
+
+void PriceMonitor::on_price(types::ExchangeCode exchange, const Price& price) {
+    if (!running_ || !event_pusher_ || price.symbol.empty() || exchange == types::INVALID_CODE) {
+        return;
+    }
+
+    // Streams can report symbols beyond the configured pairs; once the
+    // registry is full those have no code and are dropped
+    types::SymbolCode symbol = types::intern_symbol(price.symbol);
+    if (symbol == types::INVALID_CODE) {
+        return;
+    }
+    CompactPriceComparison snapshot;
+    {
+        std::lock_guard<std::mutex> lock(latest_mutex_);
+        if (symbol >= latest_.size()) {
+            latest_.resize(symbol + 1);
+        }
+        auto& comparison = latest_[symbol];
+
+        if (comparison.has(exchange) &&
+            comparison.prices[exchange].bid == price.bid && comparison.prices[exchange].ask == price.ask) {
+            return;
+        }
+
+        comparison.symbol = symbol;
+        comparison.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        comparison.set(exchange, to_compact(price));
+
+        // A single venue cannot form an arbitrage pair yet
+        if (comparison.exchange_count() < 2) {
+            return;
+        }
+        snapshot = comparison;
+    }
+
+    ++price_changes_;
+    event_pusher_->push_event(PriceUpdateEvent{snapshot});
+}
+
 void PriceMonitor::check_prices() {
     if (exchanges_.size() < 2 || !event_pusher_) {
         return;
     }
 
     for (const auto& symbol : symbols_) {
-        PriceComparison comparison;
-        comparison.symbol = symbol;
+        CompactPriceComparison comparison;
+        comparison.symbol = types::intern_symbol(symbol);
+        if (comparison.symbol == types::INVALID_CODE) {
+            continue;
+        }
         comparison.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 
-        for (const auto& exchange : exchanges_) {
+        for (size_t i = 0; i < exchanges_.size(); ++i) {
+            const auto& exchange = exchanges_[i];
             try {
-                comparison.exchange_prices[exchange->get_name()] = exchange->get_price(symbol);
+                comparison.set(exchange_codes_[i], to_compact(exchange->get_price(symbol)));
             } catch (const ExchangeException& e) {
                 Logger::error("Error getting price from " + exchange->get_name() + ": " + e.what());
             }
@@ -60,4 +192,4 @@ void PriceMonitor::check_prices() {
     }
 }
 
-}
\ No newline at end of file
+}
@@ -4,10 +4,12 @@
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <mutex>
 #include "types.hpp"
 #include "event_pusher.hpp"
 #include "../exchange/exchange_interface.hpp"
 #include "../utils/config_manager.hpp"
+#include "../utils/thread_pool.hpp"
 
 namespace ats {
 
@@ -16,13 +18,20 @@ public:
     PriceMonitor(ConfigManager* config_manager, const std::vector<std::shared_ptr<ExchangeInterface>>& exchanges);
     ~PriceMonitor();
 
+    // Starts the push-driven pipeline when price_monitor.push_driven is set,
+    // otherwise the legacy serial polling loop
     void start();
     void stop();
 
     void set_event_pusher(EventPusher* event_pusher);
 
+    size_t get_price_changes() const { return price_changes_.load(); }
+
 private:
     void run();
+    void run_rest_fanout();
+    void poll_exchange(size_t index);
+    void on_price(types::ExchangeCode exchange, const Price& price);
 
 public:
     void check_prices();
@@ -33,6 +42,19 @@ public:
     EventPusher* event_pusher_;
     std::thread thread_;
     std::atomic<bool> running_;
+
+private:
+    PriceMonitorSettings settings_;
+    std::vector<std::shared_ptr<ExchangeInterface>> streaming_exchanges_;
+    std::vector<size_t> rest_exchanges_; // indexes into exchanges_
+    std::unique_ptr<ThreadPool> fanout_pool_;
+
+    std::vector<types::ExchangeCode> exchange_codes_; // parallel to exchanges_
+
+    // Latest price per symbol and exchange, indexed by symbol code
+    std::mutex latest_mutex_;
+    std::vector<CompactPriceComparison> latest_;
+    std::atomic<size_t> price_changes_{0};
 };
 
-} 
\ No newline at end of file
+} 
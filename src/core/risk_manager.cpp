@@ -144,8 +144,8 @@ double RiskManager::CalculateMaxPositionSize(const ArbitrageOpportunity& opportu
     // Check position size limits
     double max_size = limits_.max_position_size_usd;
     
-    // Check total exposure limit
-    double current_exposure = this->GetTotalExposure();
+    // Check total exposure limit, counting capacity reserved by trades in flight
+    double current_exposure = this->GetTotalExposure() + GetReservedExposure();
     double remaining_exposure = limits_.max_total_exposure_usd - current_exposure;
     max_size = std::min(max_size, remaining_exposure);
     
@@ -156,6 +156,28 @@ double RiskManager::CalculateMaxPositionSize(const ArbitrageOpportunity& opportu
     return std::max(0.0, max_size);
 }
 
+double RiskManager::ReserveCapacity(const ArbitrageOpportunity& opportunity) {
+    std::lock_guard<std::mutex> lock(reservation_mutex_);
+    if (!IsTradeAllowed(opportunity)) {
+        return 0.0;
+    }
+
+    double size = CalculateMaxPositionSize(opportunity);
+    if (size <= 0) {
+        return 0.0;
+    }
+
+    std::lock_guard<std::mutex> positions_lock(positions_mutex_);
+    reserved_exposure_ += size;
+    return size;
+}
+
+void RiskManager::ReleaseCapacity(double size) {
+    // Releasing only loosens the limit, so it does not need reservation_mutex_
+    std::lock_guard<std::mutex> lock(positions_mutex_);
+    reserved_exposure_ = std::max(0.0, reserved_exposure_ - size);
+}
+
 void RiskManager::RecordTradeStart(const std::string& trade_id, 
                                   const ArbitrageOpportunity& opportunity, 
                                   double volume) {
@@ -241,6 +263,11 @@ double RiskManager::GetTotalExposure() const {
     return total;
 }
 
+double RiskManager::GetReservedExposure() const {
+    std::lock_guard<std::mutex> lock(positions_mutex_);
+    return reserved_exposure_;
+}
+
 double RiskManager::GetExchangeExposure(const std::string& exchange) const {
     std::lock_guard<std::mutex> lock(positions_mutex_);
     auto it = exchange_exposures_.find(exchange);
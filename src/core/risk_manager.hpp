@@ -101,6 +101,13 @@ public:
     RiskAssessment AssessOpportunity(const ArbitrageOpportunity& opportunity);
     virtual bool IsTradeAllowed(const ArbitrageOpportunity& opportunity);
     double CalculateMaxPositionSize(const ArbitrageOpportunity& opportunity) const;
+
+    // Approves the opportunity and holds its position size against the
+    // exposure limit in one step, so concurrent callers cannot both pass the
+    // same limits. Returns the reserved size, or 0 if the trade is rejected.
+    // Every non-zero reservation must be handed back with ReleaseCapacity.
+    double ReserveCapacity(const ArbitrageOpportunity& opportunity);
+    void ReleaseCapacity(double size);
     
     // Position management
     void RecordTradeStart(const std::string& trade_id, const ArbitrageOpportunity& opportunity, double volume);
@@ -109,6 +116,7 @@ public:
     void UpdatePosition(const std::string& symbol, double size_change);
     double GetCurrentPosition(const std::string& symbol) const;
     double GetTotalExposure() const;
+    double GetReservedExposure() const;
     double GetExchangeExposure(const std::string& exchange) const;
     
     // P&L tracking
@@ -216,7 +224,11 @@ private:
     // Current positions and exposure
     std::unordered_map<std::string, double> current_positions_;    // symbol -> position size
     std::unordered_map<std::string, double> exchange_exposures_;   // exchange -> total exposure
+    double reserved_exposure_ = 0.0;                                // held by trades in flight
     mutable std::mutex positions_mutex_;
+
+    // Serializes check-and-reserve; never held across exchange calls
+    std::mutex reservation_mutex_;
     
     // P&L tracking
     std::atomic<double> daily_pnl_;
@@ -0,0 +1,142 @@
+#include "sharded_event_loop.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ats {
+
+ShardedEventLoop::ShardedEventLoop(OpportunityDetector* opportunity_detector, ArbitrageEngine* arbitrage_engine,
+                                   const ShardedEventLoopConfig& config)
+    : config_(config),
+      stop_requested_(false) {
+    size_t shard_count = config_.shard_count == 0 ? 1 : config_.shard_count;
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<EventLoop>(opportunity_detector, arbitrage_engine, config_.loop_config));
+    }
+}
+
+ShardedEventLoop::~ShardedEventLoop() {
+    stop();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void ShardedEventLoop::run() {
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        if (stop_requested_) {
+            return;
+        }
+    }
+
+    threads_.reserve(shards_.size());
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        threads_.emplace_back(&EventLoop::run, shards_[i].get());
+        if (config_.pin_to_cores && !pin_thread_to_core(threads_.back(), config_.first_core + i)) {
+            LOG_WARNING("Failed to pin event loop shard %zu to core %zu", i, config_.first_core + i);
+        }
+    }
+
+    // A shard only observes stop() once its run() has set the running flag
+    for (const auto& shard : shards_) {
+        while (!shard->is_running()) {
+            std::this_thread::yield();
+        }
+    }
+
+    LOG_INFO("Event loop running with %zu shard(s)", shards_.size());
+
+    {
+        std::unique_lock<std::mutex> lock(run_mutex_);
+        if (config_.metrics_interval.count() > 0) {
+            while (!stop_condition_.wait_for(lock, config_.metrics_interval, [this] { return stop_requested_; })) {
+                EventQueueMetrics metrics = queue_metrics();
+                LOG_INFO("Event queue depth %zu, high-water mark %zu, overflowed %zu, dropped %zu",
+                         metrics.queue_depth, metrics.queue_high_water_mark,
+                         metrics.overflowed_events, metrics.dropped_events);
+            }
+        } else {
+            stop_condition_.wait(lock, [this] { return stop_requested_; });
+        }
+    }
+
+    for (auto& shard : shards_) {
+        shard->stop();
+    }
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+void ShardedEventLoop::stop() {
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        stop_requested_ = true;
+    }
+    stop_condition_.notify_all();
+}
+
+void ShardedEventLoop::push_event(Event event) {
+    size_t index = shards_.size() == 1 ? 0 : shard_for(routing_key(event));
+    shards_[index]->push_event(std::move(event));
+}
+
+EventQueueMetrics ShardedEventLoop::queue_metrics() const {
+    EventQueueMetrics metrics;
+    for (const auto& shard : shards_) {
+        metrics.queue_depth += shard->queue_depth();
+        metrics.queue_high_water_mark = std::max(metrics.queue_high_water_mark, shard->queue_high_water_mark());
+        metrics.overflowed_events += shard->overflowed_events();
+        metrics.dropped_events += shard->dropped_events();
+        metrics.conflated_price_updates += shard->conflated_price_updates();
+        metrics.rejected_price_updates += shard->rejected_price_updates();
+    }
+    return metrics;
+}
+
+size_t ShardedEventLoop::shard_for(types::SymbolCode symbol) const {
+    return symbol % shards_.size();
+}
+
+// A symbol the full registry turned away routes as INVALID_CODE, which still
+// lands on one fixed shard, so its events stay ordered
+types::SymbolCode ShardedEventLoop::routing_key(const Event& event) {
+    return std::visit([](auto&& arg) -> types::SymbolCode {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, PriceUpdateEvent>) {
+            return arg.comparison.symbol;
+        } else if constexpr (std::is_same_v<T, ArbitrageOpportunityEvent>) {
+            return types::intern_symbol(arg.opportunity.symbol);
+        } else if constexpr (std::is_same_v<T, TradeExecutionEvent>) {
+            return types::intern_symbol(arg.trade.symbol);
+        } else {
+            return arg.symbol;
+        }
+    }, event);
+}
+
+bool ShardedEventLoop::pin_thread_to_core(std::thread& thread, size_t core) {
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+    (void)thread;
+    (void)core;
+    return false;
+#endif
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include "event_loop.hpp"
+
+namespace ats {
+
+struct ShardedEventLoopConfig {
+    size_t shard_count = 1;
+    bool pin_to_cores = false;
+    size_t first_core = 0;           // Shard i is pinned to core first_core + i
+    std::chrono::milliseconds metrics_interval{10000}; // Queue metrics log period; 0 disables
+    EventLoopConfig loop_config;
+};
+
+// Queue metrics summed over the shards; the high-water mark is the largest
+// of any single shard
+struct EventQueueMetrics {
+    size_t queue_depth = 0;
+    size_t queue_high_water_mark = 0;
+    size_t overflowed_events = 0;
+    size_t dropped_events = 0;
+    size_t conflated_price_updates = 0;
+    size_t rejected_price_updates = 0;
+};
+
+// Partitions events by their interned symbol onto N independent EventLoops,
+// each running on its own thread. All events for one symbol land on the same
+// shard, so per-symbol ordering is preserved.
+class ShardedEventLoop : public EventPusher {
+public:
+    ShardedEventLoop(OpportunityDetector* opportunity_detector, ArbitrageEngine* arbitrage_engine,
+                     const ShardedEventLoopConfig& config = ShardedEventLoopConfig());
+    ~ShardedEventLoop();
+
+    // Starts every shard and blocks until stop() is called
+    void run();
+    void stop();
+
+    void push_event(Event event) override;
+
+    size_t shard_count() const { return shards_.size(); }
+    size_t shard_for(types::SymbolCode symbol) const;
+    const EventLoop& shard(size_t index) const { return *shards_.at(index); }
+
+    EventQueueMetrics queue_metrics() const;
+
+private:
+    static types::SymbolCode routing_key(const Event& event);
+    static bool pin_thread_to_core(std::thread& thread, size_t core);
+
+    ShardedEventLoopConfig config_;
+    std::vector<std::unique_ptr<EventLoop>> shards_;
+    std::vector<std::thread> threads_;
+
+    std::mutex run_mutex_;
+    std::condition_variable stop_condition_;
+    bool stop_requested_;
+};
+
+}
@@ -41,8 +41,7 @@ std::shared_ptr<ExchangeInterface> TradeExecutor::get_exchange(const std::string
     return nullptr;
 }
 
-void TradeExecutor::execute_trade(const ArbitrageOpportunity& opportunity) {
-    double trade_size = risk_manager_->CalculateMaxPositionSize(opportunity);
+void TradeExecutor::execute_trade(const ArbitrageOpportunity& opportunity, double trade_size) {
     if (trade_size <= 0) {
         return;
     }
@@ -72,6 +71,7 @@ void TradeExecutor::execute_trade(const ArbitrageOpportunity& opportunity) {
         OrderResult buy_result = buy_exchange->place_order(buy_order);
         OrderResult sell_result = sell_exchange->place_order(sell_order);
 
+        std::lock_guard<std::mutex> lock(completion_mutex_);
         portfolio_manager_->update_position(buy_result);
         portfolio_manager_->update_position(sell_result);
 
@@ -4,6 +4,7 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include "types.hpp"
 #include "portfolio_manager.hpp"
 #include "risk_manager.hpp"
@@ -26,7 +27,11 @@ public:
     void AddExchange(std::shared_ptr<ExchangeInterface> exchange);
     void SetExecutionCallback(ExecutionCallback callback);
 
-    virtual void execute_trade(const ArbitrageOpportunity& opportunity);
+    // Places both legs for trade_size, which the caller has already reserved
+    // with RiskManager::ReserveCapacity. Safe to call from several shards at
+    // once: the exchange calls run unlocked, and only the position updates
+    // and the execution callback are serialized.
+    virtual void execute_trade(const ArbitrageOpportunity& opportunity, double trade_size);
 
 private:
     std::shared_ptr<ExchangeInterface> get_exchange(const std::string& name);
@@ -36,6 +41,7 @@ private:
     RiskManager* risk_manager_;
     std::vector<std::shared_ptr<ExchangeInterface>> exchanges_;
     ExecutionCallback execution_callback_;
+    std::mutex completion_mutex_;
 };
 
 }
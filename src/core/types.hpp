@@ -1,9 +1,12 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <nlohmann/json.hpp>
+#include "types/symbol_registry.hpp"
 
 namespace ats {
 
@@ -150,6 +153,75 @@ struct PriceComparison {
     std::unordered_map<std::string, Price> exchange_prices;
 };
 
+// Interned variant of PriceComparison used on the event path. Exchanges are
+// addressed by their registry code, so building and copying a comparison
+// never allocates.
+struct CompactPrice {
+    double bid = 0.0;
+    double ask = 0.0;
+    double last = 0.0;
+    double volume = 0.0;
+    long long timestamp = 0;
+};
+
+struct CompactPriceComparison {
+    types::SymbolCode symbol = types::INVALID_CODE;
+    long long timestamp = 0;
+    uint32_t exchange_mask = 0; // bit i set when prices[i] holds a quote
+    std::array<CompactPrice, types::MAX_EXCHANGES> prices{};
+
+    bool has(types::ExchangeCode exchange) const {
+        return exchange < types::MAX_EXCHANGES && (exchange_mask & (1u << exchange)) != 0;
+    }
+
+    void set(types::ExchangeCode exchange, const CompactPrice& price) {
+        if (exchange < types::MAX_EXCHANGES) {
+            prices[exchange] = price;
+            exchange_mask |= (1u << exchange);
+        }
+    }
+
+    size_t exchange_count() const {
+        size_t count = 0;
+        for (uint32_t mask = exchange_mask; mask != 0; mask &= mask - 1) {
+            ++count;
+        }
+        return count;
+    }
+};
+
+inline CompactPrice to_compact(const Price& price) {
+    return CompactPrice{price.bid, price.ask, price.last, price.volume, price.timestamp};
+}
+
+// Exchanges without a code are left out; the symbol is INVALID_CODE when
+// the registry is full
+inline CompactPriceComparison to_compact(const PriceComparison& comparison) {
+    CompactPriceComparison compact;
+    compact.symbol = types::intern_symbol(comparison.symbol);
+    compact.timestamp = comparison.timestamp;
+    for (const auto& [exchange, price] : comparison.exchange_prices) {
+        compact.set(types::intern_exchange(exchange), to_compact(price));
+    }
+    return compact;
+}
+
+inline PriceComparison to_price_comparison(const CompactPriceComparison& compact) {
+    PriceComparison comparison;
+    comparison.symbol = types::symbol_name(compact.symbol);
+    comparison.timestamp = compact.timestamp;
+    comparison.max_spread_percent = 0.0;
+    for (types::ExchangeCode exchange = 0; exchange < types::MAX_EXCHANGES; ++exchange) {
+        if (!compact.has(exchange)) {
+            continue;
+        }
+        const auto& price = compact.prices[exchange];
+        comparison.exchange_prices[types::exchange_name(exchange)] =
+            Price{comparison.symbol, price.bid, price.ask, price.last, price.volume, price.timestamp};
+    }
+    return comparison;
+}
+
 struct ArbitrageOpportunity {
     std::string symbol;
     std::string buy_exchange;
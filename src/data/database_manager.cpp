@@ -2,11 +2,49 @@
 #include "../utils/logger.hpp"
 #include "sqlite3.h"
 #include <chrono>
+#include <algorithm>
 
 namespace ats {
 
-DatabaseManager::DatabaseManager(const std::string& db_path)
-    : db_path_(db_path), db_(nullptr) {}
+namespace {
+
+constexpr int64_t SECONDS_PER_DAY = 86400;
+
+const char* const TRADE_COLUMNS =
+    "id,symbol,buy_exchange,sell_exchange,volume,buy_price,sell_price,pnl,timestamp";
+
+int64_t ToEpochSeconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+TradeRecord ReadTradeRow(sqlite3_stmt* stmt) {
+    TradeRecord trade;
+    trade.trade_id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    trade.symbol = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+    trade.buy_exchange = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+    trade.sell_exchange = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+    trade.volume = sqlite3_column_double(stmt, 4);
+    trade.buy_price = sqlite3_column_double(stmt, 5);
+    trade.sell_price = sqlite3_column_double(stmt, 6);
+    trade.realized_pnl = sqlite3_column_double(stmt, 7);
+    trade.end_time = std::chrono::system_clock::from_time_t(sqlite3_column_int64(stmt, 8));
+    return trade;
+}
+
+} // namespace
+
+DatabaseManager::DatabaseManager(const std::string& db_path, const TradeStoreSettings& settings)
+    : db_path_(db_path), db_(nullptr), settings_(settings), insert_stmt_(nullptr), reader_db_(nullptr),
+      writer_running_(false), enqueued_seq_(0), committed_seq_(0), failed_seq_(0), flushed_seq_(0),
+      flush_requested_(false),
+      queue_high_water_mark_(0), trades_written_(0), batches_committed_(0), failed_writes_(0),
+      last_batch_ms_(0.0) {
+    // A zero batch size would spin the writer and a zero capacity would block
+    // every producer forever
+    settings_.max_batch_size = std::max<size_t>(settings_.max_batch_size, 1);
+    settings_.queue_capacity = std::max<size_t>(settings_.queue_capacity, 1);
+    settings_.flush_interval_ms = std::max(settings_.flush_interval_ms, 0);
+}
 
 DatabaseManager::~DatabaseManager() {
     Close();
@@ -20,6 +58,34 @@ bool DatabaseManager::Open() {
         LOG_INFO("Opened database successfully");
     }
 
+    if (!CreateSchema()) {
+        return false;
+    }
+
+    char* zErrMsg = 0;
+    if (settings_.async_writes) {
+        // WAL lets readers run alongside the writer, and NORMAL syncs only
+        // at checkpoints instead of on every commit
+        if (sqlite3_exec(db_, "PRAGMA journal_mode=WAL;", 0, 0, &zErrMsg) != SQLITE_OK ||
+            sqlite3_exec(db_, "PRAGMA synchronous=NORMAL;", 0, 0, &zErrMsg) != SQLITE_OK) {
+            LOG_ERROR("SQL error: {}", zErrMsg);
+            sqlite3_free(zErrMsg);
+            return false;
+        }
+
+        if (sqlite3_open_v2(db_path_.c_str(), &reader_db_, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+            LOG_ERROR("Can't open read connection: {}", sqlite3_errmsg(reader_db_));
+            sqlite3_close(reader_db_);
+            reader_db_ = nullptr;
+        }
+
+        writer_running_ = true;
+        writer_thread_ = std::thread(&DatabaseManager::WriterLoop, this);
+    }
+    return true;
+}
+
+bool DatabaseManager::CreateSchema() {
     const char* sql = "CREATE TABLE IF NOT EXISTS trades("
                       "id TEXT PRIMARY KEY NOT NULL,"
                       "symbol TEXT NOT NULL,"
@@ -29,17 +95,75 @@ bool DatabaseManager::Open() {
                       "buy_price REAL NOT NULL,"
                       "sell_price REAL NOT NULL,"
                       "pnl REAL NOT NULL,"
-                      "timestamp INTEGER NOT NULL);";
+                      "timestamp INTEGER NOT NULL);"
+                      "CREATE INDEX IF NOT EXISTS idx_trades_time ON trades(timestamp, id);"
+                      "CREATE INDEX IF NOT EXISTS idx_trades_symbol_time ON trades(symbol, timestamp, id);"
+                      "CREATE INDEX IF NOT EXISTS idx_trades_buy_exchange_time ON trades(buy_exchange, timestamp);"
+                      "CREATE INDEX IF NOT EXISTS idx_trades_sell_exchange_time ON trades(sell_exchange, timestamp);"
+                      "CREATE TABLE IF NOT EXISTS daily_pnl("
+                      "day INTEGER NOT NULL,"
+                      "symbol TEXT NOT NULL,"
+                      "trade_count INTEGER NOT NULL,"
+                      "volume REAL NOT NULL,"
+                      "pnl REAL NOT NULL,"
+                      "PRIMARY KEY (day, symbol)) WITHOUT ROWID;";
+
+    // The rollup is kept by a trigger so it commits atomically with the
+    // trade. Databases created before the trigger existed are backfilled once.
+    const char* rollup_sql =
+        "INSERT OR REPLACE INTO daily_pnl (day,symbol,trade_count,volume,pnl) "
+        "SELECT timestamp - timestamp % 86400, symbol, COUNT(*), SUM(volume), SUM(pnl) "
+        "FROM trades GROUP BY 1, 2;"
+        "CREATE TRIGGER trades_daily_pnl AFTER INSERT ON trades BEGIN "
+        "INSERT INTO daily_pnl (day,symbol,trade_count,volume,pnl) "
+        "VALUES (NEW.timestamp - NEW.timestamp % 86400, NEW.symbol, 1, NEW.volume, NEW.pnl) "
+        "ON CONFLICT (day, symbol) DO UPDATE SET "
+        "trade_count = trade_count + 1, volume = volume + excluded.volume, pnl = pnl + excluded.pnl; "
+        "END;";
+
     char* zErrMsg = 0;
-    if (sqlite3_exec(db_, sql, 0, 0, &zErrMsg) != SQLITE_OK) {
+    if (sqlite3_exec(db_, "BEGIN;", 0, 0, &zErrMsg) != SQLITE_OK ||
+        sqlite3_exec(db_, sql, 0, 0, &zErrMsg) != SQLITE_OK) {
         LOG_ERROR("SQL error: {}", zErrMsg);
         sqlite3_free(zErrMsg);
+        sqlite3_exec(db_, "ROLLBACK;", 0, 0, 0);
+        return false;
+    }
+
+    bool has_trigger = false;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db_, "SELECT 1 FROM sqlite_master WHERE type = 'trigger' AND name = 'trades_daily_pnl';",
+                           -1, &stmt, 0) == SQLITE_OK) {
+        has_trigger = sqlite3_step(stmt) == SQLITE_ROW;
+        sqlite3_finalize(stmt);
+    }
+
+    if ((!has_trigger && sqlite3_exec(db_, rollup_sql, 0, 0, &zErrMsg) != SQLITE_OK) ||
+        sqlite3_exec(db_, "COMMIT;", 0, 0, &zErrMsg) != SQLITE_OK) {
+        LOG_ERROR("SQL error: {}", zErrMsg);
+        sqlite3_free(zErrMsg);
+        sqlite3_exec(db_, "ROLLBACK;", 0, 0, 0);
         return false;
     }
     return true;
 }
 
 void DatabaseManager::Close() {
+    StopWriter();
+
+    {
+        std::lock_guard<std::mutex> lock(reader_mutex_);
+        if (reader_db_) {
+            sqlite3_close(reader_db_);
+            reader_db_ = nullptr;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(db_mutex_);
+    if (insert_stmt_) {
+        sqlite3_finalize(insert_stmt_);
+        insert_stmt_ = nullptr;
+    }
     if (db_) {
         sqlite3_close(db_);
         db_ = nullptr;
@@ -49,15 +173,46 @@ void DatabaseManager::Close() {
 bool DatabaseManager::SaveTrade(const TradeRecord& trade) {
     if (!db_) return false;
 
-    std::string sql = "INSERT INTO trades (id,symbol,buy_exchange,sell_exchange,volume,buy_price,sell_price,pnl,timestamp) "
-                      "VALUES (?,?,?,?,?,?,?,?,?);";
-    
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, 0) != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
-        return false;
+    if (!writer_running_) {
+        std::lock_guard<std::mutex> lock(db_mutex_);
+        return db_ && InsertTrade(trade);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        space_cv_.wait(lock, [this] {
+            return pending_.size() < settings_.queue_capacity || !writer_running_;
+        });
+        if (!writer_running_) {
+            return false;
+        }
+
+        pending_.push_back(trade);
+        ++enqueued_seq_;
+        queue_high_water_mark_ = std::max(queue_high_water_mark_, pending_.size());
+        // Wake the writer for the first trade so it starts its linger, and again
+        // once a full batch is waiting; anything in between rides the linger
+        if (pending_.size() != 1 && pending_.size() < settings_.max_batch_size) {
+            return true;
+        }
+    }
+    queue_cv_.notify_one();
+    return true;
+}
+
+bool DatabaseManager::InsertTrade(const TradeRecord& trade) {
+    // Caller holds db_mutex_
+    if (!insert_stmt_) {
+        const char* sql = "INSERT INTO trades (id,symbol,buy_exchange,sell_exchange,volume,buy_price,sell_price,pnl,timestamp) "
+                          "VALUES (?,?,?,?,?,?,?,?,?);";
+        if (sqlite3_prepare_v2(db_, sql, -1, &insert_stmt_, 0) != SQLITE_OK) {
+            LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
+            insert_stmt_ = nullptr;
+            return false;
+        }
     }
 
+    sqlite3_stmt* stmt = insert_stmt_;
     sqlite3_bind_text(stmt, 1, trade.trade_id.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 2, trade.symbol.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 3, trade.buy_exchange.c_str(), -1, SQLITE_STATIC);
@@ -66,47 +221,289 @@ bool DatabaseManager::SaveTrade(const TradeRecord& trade) {
     sqlite3_bind_double(stmt, 6, trade.buy_price);
     sqlite3_bind_double(stmt, 7, trade.sell_price);
     sqlite3_bind_double(stmt, 8, trade.realized_pnl);
-    sqlite3_bind_int64(stmt, 9, std::chrono::duration_cast<std::chrono::seconds>(trade.end_time.time_since_epoch()).count());
+    sqlite3_bind_int64(stmt, 9, ToEpochSeconds(trade.end_time));
 
-    if (sqlite3_step(stmt) != SQLITE_DONE) {
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    if (!ok) {
         LOG_ERROR("Failed to execute statement: {}", sqlite3_errmsg(db_));
-        sqlite3_finalize(stmt);
+    }
+
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return ok;
+}
+
+void DatabaseManager::WriterLoop() {
+    const auto linger = std::chrono::milliseconds(settings_.flush_interval_ms);
+    std::vector<TradeRecord> batch;
+    batch.reserve(settings_.max_batch_size);
+
+    while (true) {
+        uint64_t batch_end_seq;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !pending_.empty() || !writer_running_; });
+
+            // Linger so that trades arriving close together share a commit
+            queue_cv_.wait_for(lock, linger, [this] {
+                return pending_.size() >= settings_.max_batch_size || flush_requested_ || !writer_running_;
+            });
+
+            if (pending_.empty()) {
+                if (!writer_running_) {
+                    break;
+                }
+                continue;
+            }
+
+            size_t count = std::min(pending_.size(), settings_.max_batch_size);
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(std::move(pending_.front()));
+                pending_.pop_front();
+            }
+            batch_end_seq = committed_seq_ + count;
+            if (pending_.empty()) {
+                flush_requested_ = false;
+            }
+        }
+        space_cv_.notify_all();
+
+        bool committed = CommitBatch(batch);
+        batch.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            committed_seq_ = batch_end_seq;
+            if (!committed) {
+                failed_seq_ = batch_end_seq;
+            }
+        }
+        committed_cv_.notify_all();
+    }
+}
+
+bool DatabaseManager::CommitBatch(std::vector<TradeRecord>& batch) {
+    auto start = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(db_mutex_);
+
+    char* zErrMsg = 0;
+    if (sqlite3_exec(db_, "BEGIN IMMEDIATE;", 0, 0, &zErrMsg) != SQLITE_OK) {
+        LOG_ERROR("Failed to begin trade batch: {}", zErrMsg);
+        sqlite3_free(zErrMsg);
+        failed_writes_ += batch.size();
         return false;
     }
 
-    sqlite3_finalize(stmt);
+    // A failed row is logged and counted but does not abort its batch
+    size_t written = 0;
+    for (const auto& trade : batch) {
+        if (InsertTrade(trade)) {
+            ++written;
+        }
+    }
+
+    if (sqlite3_exec(db_, "COMMIT;", 0, 0, &zErrMsg) != SQLITE_OK) {
+        LOG_ERROR("Failed to commit trade batch: {}", zErrMsg);
+        sqlite3_free(zErrMsg);
+        sqlite3_exec(db_, "ROLLBACK;", 0, 0, 0);
+        failed_writes_ += batch.size();
+        return false;
+    }
+
+    trades_written_ += written;
+    failed_writes_ += batch.size() - written;
+    ++batches_committed_;
+    last_batch_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
     return true;
 }
 
+void DatabaseManager::StopWriter() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!writer_running_) {
+            return;
+        }
+        writer_running_ = false; // the writer drains what is queued before exiting
+    }
+    queue_cv_.notify_all();
+    space_cv_.notify_all();
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+    committed_cv_.notify_all();
+}
+
+bool DatabaseManager::Flush(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    if (!writer_running_) {
+        return pending_.empty();
+    }
+
+    uint64_t target = enqueued_seq_;
+    uint64_t reported = flushed_seq_;
+    flush_requested_ = true;
+    queue_cv_.notify_one();
+    if (!committed_cv_.wait_for(lock, timeout, [this, target] { return committed_seq_ >= target; })) {
+        return false;
+    }
+
+    // A batch that failed since the previous Flush may hold some of these
+    // trades. Each call keeps its own baseline so concurrent calls all see it.
+    bool lost = failed_seq_ > reported;
+    flushed_seq_ = std::max(flushed_seq_, target);
+    return !lost;
+}
+
+DatabaseManager::WriterMetrics DatabaseManager::GetWriterMetrics() const {
+    WriterMetrics metrics;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        metrics.queue_depth = pending_.size();
+        metrics.queue_high_water_mark = queue_high_water_mark_;
+    }
+    metrics.trades_written = trades_written_.load();
+    metrics.batches_committed = batches_committed_.load();
+    metrics.failed_writes = failed_writes_.load();
+    metrics.last_batch_ms = last_batch_ms_.load();
+    return metrics;
+}
+
 std::vector<TradeRecord> DatabaseManager::GetTradeHistory(int limit) {
     std::vector<TradeRecord> trades;
-    if (!db_) return trades;
+    TradeQuery query;
+    query.limit = limit > 0 ? static_cast<size_t>(limit) : 0;
+    ForEachTrade(query, [&trades](const TradeRecord& trade) {
+        trades.push_back(trade);
+        return true;
+    });
+    return trades;
+}
+
+sqlite3* DatabaseManager::AcquireReader(std::unique_lock<std::mutex>& lock) {
+    {
+        std::unique_lock<std::mutex> reader_lock(reader_mutex_);
+        if (reader_db_) {
+            lock = std::move(reader_lock);
+            return reader_db_;
+        }
+    }
+    lock = std::unique_lock<std::mutex>(db_mutex_);
+    return db_;
+}
+
+size_t DatabaseManager::ForEachTrade(const TradeQuery& query,
+                                     const std::function<bool(const TradeRecord&)>& visitor) {
+    std::unique_lock<std::mutex> lock;
+    sqlite3* db = AcquireReader(lock);
+    if (!db) return 0;
+
+    const char* order = query.newest_first ? "DESC" : "ASC";
+    std::string sql = std::string("SELECT ") + TRADE_COLUMNS + " FROM trades WHERE 1 = 1";
+    if (query.from) sql += " AND timestamp >= ?";
+    if (query.to) sql += " AND timestamp < ?";
+    if (!query.symbol.empty()) sql += " AND symbol = ?";
+    if (!query.exchange.empty()) sql += " AND (buy_exchange = ? OR sell_exchange = ?)";
+    if (query.after) sql += query.newest_first ? " AND (timestamp, id) < (?, ?)" : " AND (timestamp, id) > (?, ?)";
+    sql += std::string(" ORDER BY timestamp ") + order + ", id " + order;
+    if (query.limit > 0) sql += " LIMIT ?";
+    sql += ";";
 
-    std::string sql = "SELECT * FROM trades ORDER BY timestamp DESC LIMIT ?;";
     sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, 0) != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db_));
-        return trades;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, 0) != SQLITE_OK) {
+        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db));
+        return 0;
     }
 
-    sqlite3_bind_int(stmt, 1, limit);
+    int index = 1;
+    if (query.from) sqlite3_bind_int64(stmt, index++, ToEpochSeconds(*query.from));
+    if (query.to) sqlite3_bind_int64(stmt, index++, ToEpochSeconds(*query.to));
+    if (!query.symbol.empty()) sqlite3_bind_text(stmt, index++, query.symbol.c_str(), -1, SQLITE_STATIC);
+    if (!query.exchange.empty()) {
+        sqlite3_bind_text(stmt, index++, query.exchange.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, index++, query.exchange.c_str(), -1, SQLITE_STATIC);
+    }
+    if (query.after) {
+        sqlite3_bind_int64(stmt, index++, query.after->timestamp);
+        sqlite3_bind_text(stmt, index++, query.after->trade_id.c_str(), -1, SQLITE_STATIC);
+    }
+    if (query.limit > 0) sqlite3_bind_int64(stmt, index++, static_cast<sqlite3_int64>(query.limit));
 
+    size_t visited = 0;
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        TradeRecord trade;
-        trade.trade_id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        trade.symbol = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        trade.buy_exchange = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        trade.sell_exchange = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        trade.volume = sqlite3_column_double(stmt, 4);
-        trade.buy_price = sqlite3_column_double(stmt, 5);
-        trade.sell_price = sqlite3_column_double(stmt, 6);
-        trade.realized_pnl = sqlite3_column_double(stmt, 7);
-        trade.end_time = std::chrono::system_clock::from_time_t(sqlite3_column_int64(stmt, 8));
-        trades.push_back(trade);
+        ++visited;
+        if (!visitor(ReadTradeRow(stmt))) {
+            break;
+        }
     }
 
     sqlite3_finalize(stmt);
-    return trades;
+    return visited;
+}
+
+TradePage DatabaseManager::QueryTrades(TradeQuery query, size_t page_size) {
+    TradePage page;
+    if (page_size == 0) return page;
+
+    // One extra row tells whether another page follows
+    query.limit = page_size + 1;
+    page.trades.reserve(page_size);
+    bool has_more = false;
+    ForEachTrade(query, [&](const TradeRecord& trade) {
+        if (page.trades.size() == page_size) {
+            has_more = true;
+            return false;
+        }
+        page.trades.push_back(trade);
+        return true;
+    });
+
+    if (has_more) {
+        const TradeRecord& last = page.trades.back();
+        page.next = TradeCursor{ToEpochSeconds(last.end_time), last.trade_id};
+    }
+    return page;
+}
+
+std::vector<DailyPnl> DatabaseManager::GetDailyPnl(std::chrono::system_clock::time_point from,
+                                                   std::chrono::system_clock::time_point to,
+                                                   const std::string& symbol) {
+    std::vector<DailyPnl> rows;
+    std::unique_lock<std::mutex> lock;
+    sqlite3* db = AcquireReader(lock);
+    if (!db) return rows;
+
+    const char* sql = symbol.empty()
+        ? "SELECT day, '', SUM(trade_count), SUM(volume), SUM(pnl) FROM daily_pnl "
+          "WHERE day >= ? AND day < ? GROUP BY day ORDER BY day;"
+        : "SELECT day, symbol, trade_count, volume, pnl FROM daily_pnl "
+          "WHERE symbol = ? AND day >= ? AND day < ? ORDER BY day;";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, 0) != SQLITE_OK) {
+        LOG_ERROR("Failed to prepare statement: {}", sqlite3_errmsg(db));
+        return rows;
+    }
+
+    // Select every day that overlaps [from, to)
+    int64_t from_day = ToEpochSeconds(from);
+    from_day -= ((from_day % SECONDS_PER_DAY) + SECONDS_PER_DAY) % SECONDS_PER_DAY;
+    int index = 1;
+    if (!symbol.empty()) sqlite3_bind_text(stmt, index++, symbol.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, index++, from_day);
+    sqlite3_bind_int64(stmt, index++, ToEpochSeconds(to));
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        DailyPnl row;
+        row.day = std::chrono::system_clock::from_time_t(sqlite3_column_int64(stmt, 0));
+        row.symbol = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        row.trade_count = sqlite3_column_int64(stmt, 2);
+        row.volume = sqlite3_column_double(stmt, 3);
+        row.pnl = sqlite3_column_double(stmt, 4);
+        rows.push_back(row);
+    }
+
+    sqlite3_finalize(stmt);
+    return rows;
 }
 
 } // namespace ats
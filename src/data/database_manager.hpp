@@ -3,27 +3,143 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include "../core/types.hpp"
 #include "../core/risk_manager.hpp"
+#include "../utils/config_types.hpp"
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace ats {
 
+// Position in a trade scan, used to resume a paginated query after the
+// last row of the previous page
+struct TradeCursor {
+    int64_t timestamp = 0;
+    std::string trade_id;
+};
+
+// Filters for trade queries. Empty fields do not filter. The exchange
+// filter matches either leg of the trade.
+struct TradeQuery {
+    std::optional<std::chrono::system_clock::time_point> from; // inclusive
+    std::optional<std::chrono::system_clock::time_point> to;   // exclusive
+    std::string symbol;
+    std::string exchange;
+    bool newest_first = true;
+    std::optional<TradeCursor> after;
+    size_t limit = 0; // 0 = no limit
+};
+
+struct TradePage {
+    std::vector<TradeRecord> trades;
+    std::optional<TradeCursor> next; // unset on the last page
+};
+
+// One row of the daily PnL rollup. Days are UTC.
+struct DailyPnl {
+    std::chrono::system_clock::time_point day;
+    std::string symbol; // empty when aggregated across symbols
+    int64_t trade_count = 0;
+    double volume = 0.0;
+    double pnl = 0.0;
+};
+
 class DatabaseManager {
 public:
-    DatabaseManager(const std::string& db_path);
+    struct WriterMetrics {
+        size_t queue_depth = 0;
+        size_t queue_high_water_mark = 0;
+        uint64_t trades_written = 0;
+        uint64_t batches_committed = 0;
+        uint64_t failed_writes = 0;
+        double last_batch_ms = 0.0;
+    };
+
+    DatabaseManager(const std::string& db_path, const TradeStoreSettings& settings = TradeStoreSettings());
     ~DatabaseManager();
 
     bool Open();
     void Close();
 
+    // In async mode the trade is queued for the writer thread and this only
+    // fails if the database is closed
     bool SaveTrade(const TradeRecord& trade);
     std::vector<TradeRecord> GetTradeHistory(int limit = 100);
 
+    // Streams matching trades to the visitor without materializing them.
+    // Returning false from the visitor stops the scan. The visitor must not
+    // call back into the DatabaseManager. Returns the number of rows visited.
+    size_t ForEachTrade(const TradeQuery& query, const std::function<bool(const TradeRecord&)>& visitor);
+
+    // Keyset pagination: pass page.next as query.after to fetch the next page
+    TradePage QueryTrades(TradeQuery query, size_t page_size);
+
+    // Reads the rollup table maintained on insert. With an empty symbol the
+    // rows are summed across symbols, one per day.
+    std::vector<DailyPnl> GetDailyPnl(std::chrono::system_clock::time_point from,
+                                      std::chrono::system_clock::time_point to,
+                                      const std::string& symbol = "");
+
+    // Durability barrier: blocks until every trade queued before the call
+    // has been written or timeout expires. Returns false on timeout, or when
+    // a batch queued since the previous Flush failed to commit and its
+    // trades were lost. Returns immediately when writes are synchronous.
+    bool Flush(std::chrono::milliseconds timeout = std::chrono::milliseconds(5000));
+
+    WriterMetrics GetWriterMetrics() const;
+
 private:
+    bool CreateSchema();
+    bool InsertTrade(const TradeRecord& trade);
+    // Locks and returns the connection queries should run on
+    sqlite3* AcquireReader(std::unique_lock<std::mutex>& lock);
+    void WriterLoop();
+    bool CommitBatch(std::vector<TradeRecord>& batch);
+    void StopWriter();
+
     std::string db_path_;
     sqlite3* db_;
+    TradeStoreSettings settings_;
+
+    // Guards db_ and the cached statements, which are shared between the
+    // writer thread and synchronous callers
+    std::mutex db_mutex_;
+    sqlite3_stmt* insert_stmt_;
+
+    // Separate read connection in WAL mode so long scans do not stall the
+    // writer thread
+    std::mutex reader_mutex_;
+    sqlite3* reader_db_;
+
+    // Async writer state
+    std::thread writer_thread_;
+    std::atomic<bool> writer_running_;
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;       // writer waits for work
+    std::condition_variable space_cv_;       // producers wait for room
+    std::condition_variable committed_cv_;   // Flush waits for commits
+    std::deque<TradeRecord> pending_;
+    uint64_t enqueued_seq_;
+    uint64_t committed_seq_;  // last trade the writer finished with, committed or not
+    uint64_t failed_seq_;     // last trade of the latest batch that failed to commit
+    uint64_t flushed_seq_;    // failures at or below this were already reported by Flush
+    bool flush_requested_;
+    size_t queue_high_water_mark_;
+
+    std::atomic<uint64_t> trades_written_;
+    std::atomic<uint64_t> batches_committed_;
+    std::atomic<uint64_t> failed_writes_;
+    std::atomic<double> last_batch_ms_;
 };
 
 } // namespace ats
@@ -1,84 +1,207 @@
 #include "market_data.hpp"
 #include "../utils/logger.hpp"
 #include <shared_mutex>
+#include <algorithm>
+#include <cmath>
+#include <functional>
 
 namespace ats {
 
+namespace {
+
+long long NowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// RollingTradeWindow Implementation
+void MarketDataFeed::RollingTradeWindow::Subtract(Totals& totals, const Totals& expired) {
+    totals.volume = std::max(0.0, totals.volume - expired.volume);
+    totals.notional = std::max(0.0, totals.notional - expired.notional);
+    totals.return_sum -= expired.return_sum;
+    totals.return_sq_sum = std::max(0.0, totals.return_sq_sum - expired.return_sq_sum);
+    totals.return_count -= std::min(totals.return_count, expired.return_count);
+}
+
+void MarketDataFeed::RollingTradeWindow::Advance(long long minute) {
+    if (head_minute_ < 0) {
+        head_minute_ = minute;
+        return;
+    }
+    if (minute <= head_minute_) {
+        return;
+    }
+
+    // Minute slots passed over held the minutes that drop out of the hour
+    if (minute - head_minute_ >= static_cast<long long>(HOUR_BUCKETS)) {
+        minutes_.fill(0.0);
+        hour_volume_ = 0.0;
+    } else {
+        for (long long m = head_minute_ + 1; m <= minute; ++m) {
+            hour_volume_ -= MinuteAt(m);
+            MinuteAt(m) = 0.0;
+        }
+        hour_volume_ = std::max(0.0, hour_volume_);
+    }
+
+    // Likewise for the day buckets, which held the buckets from 24h back
+    long long head_bucket = DayBucketOf(head_minute_);
+    long long bucket = DayBucketOf(minute);
+    if (bucket - head_bucket >= static_cast<long long>(DAY_BUCKETS)) {
+        days_.fill(Totals());
+        day_ = Totals();
+    } else {
+        for (long long d = head_bucket + 1; d <= bucket; ++d) {
+            Subtract(day_, DayAt(d));
+            DayAt(d) = Totals();
+        }
+    }
+
+    head_minute_ = minute;
+}
+
+void MarketDataFeed::RollingTradeWindow::Add(long long timestamp_ms, double price, double quantity) {
+    long long minute = timestamp_ms / MINUTE_MS;
+    Advance(minute);
+
+    // Late trades still land in their own bucket while it is in range
+    long long bucket = DayBucketOf(minute);
+    if (bucket <= DayBucketOf(head_minute_) - static_cast<long long>(DAY_BUCKETS)) {
+        return; // older than the window
+    }
+
+    Totals& totals = DayAt(bucket);
+    totals.volume += quantity;
+    totals.notional += price * quantity;
+    day_.volume += quantity;
+    day_.notional += price * quantity;
+    if (minute > head_minute_ - static_cast<long long>(HOUR_BUCKETS)) {
+        MinuteAt(minute) += quantity;
+        hour_volume_ += quantity;
+    }
+
+    if (last_price_ > 0.0) {
+        double return_rate = (price - last_price_) / last_price_;
+        totals.return_sum += return_rate;
+        totals.return_sq_sum += return_rate * return_rate;
+        ++totals.return_count;
+        day_.return_sum += return_rate;
+        day_.return_sq_sum += return_rate * return_rate;
+        ++day_.return_count;
+    }
+    last_price_ = price;
+}
+
+MarketDataFeed::RollingTradeWindow::Snapshot MarketDataFeed::RollingTradeWindow::At(long long now_ms) const {
+    Snapshot snapshot;
+    snapshot.day = day_;
+    snapshot.hour_volume = hour_volume_;
+
+    long long minute = now_ms / MINUTE_MS;
+    if (head_minute_ < 0 || minute <= head_minute_) {
+        return snapshot;
+    }
+
+    // Same walk as Advance, subtracting instead of clearing: the slots past
+    // the head still hold exactly what has expired since the last trade
+    if (minute - head_minute_ >= static_cast<long long>(HOUR_BUCKETS)) {
+        snapshot.hour_volume = 0.0;
+    } else {
+        for (long long m = head_minute_ + 1; m <= minute; ++m) {
+            snapshot.hour_volume -= MinuteAt(m);
+        }
+        snapshot.hour_volume = std::max(0.0, snapshot.hour_volume);
+    }
+
+    long long head_bucket = DayBucketOf(head_minute_);
+    long long bucket = DayBucketOf(minute);
+    if (bucket - head_bucket >= static_cast<long long>(DAY_BUCKETS)) {
+        snapshot.day = Totals();
+    } else {
+        for (long long d = head_bucket + 1; d <= bucket; ++d) {
+            Subtract(snapshot.day, DayAt(d));
+        }
+    }
+    return snapshot;
+}
+
 // MarketDataFeed Implementation
 MarketDataFeed::MarketDataFeed() 
     : max_trade_history_(1000), stats_update_interval_(std::chrono::minutes(5)) {
 }
 
 void MarketDataFeed::UpdatePrice(const std::string& exchange, const Price& price) {
-    unique_lock_type lock(data_mutex_);
     std::string key = MakeKey(exchange, price.symbol);
-    latest_prices_[key] = price;
+    auto& shard = price_shards_[ShardIndex(key)];
+    bool inserted;
+    {
+        unique_lock_type lock(shard.mutex);
+        auto result = shard.entries.insert_or_assign(key, price);
+        inserted = result.second;
+    }
+    if (inserted) {
+        IndexKey(exchange, price.symbol);
+    }
 }
 
 void MarketDataFeed::UpdateOrderBook(const std::string& exchange, const OrderBook& orderbook) {
-    unique_lock_type lock(data_mutex_);
     std::string key = MakeKey(exchange, orderbook.symbol);
-    latest_orderbooks_[key] = orderbook;
+    auto& shard = orderbook_shards_[ShardIndex(key)];
+    bool inserted;
+    {
+        unique_lock_type lock(shard.mutex);
+        auto result = shard.entries.insert_or_assign(key, orderbook);
+        inserted = result.second;
+    }
+    if (inserted) {
+        IndexKey(exchange, orderbook.symbol);
+    }
 }
 
 void MarketDataFeed::UpdateTicker(const std::string& exchange, const Ticker& ticker) {
-    unique_lock_type lock(data_mutex_);
     std::string key = MakeKey(exchange, ticker.symbol);
-    latest_tickers_[key] = ticker;
+    auto& shard = ticker_shards_[ShardIndex(key)];
+    unique_lock_type lock(shard.mutex);
+    shard.entries[key] = ticker;
 }
 
 void MarketDataFeed::UpdateTrade(const std::string& exchange, const Trade& trade) {
+    std::string key = MakeKey(exchange, trade.symbol);
+    auto& shard = trade_shards_[ShardIndex(key)];
+    size_t max_history = max_trade_history_.load();
+    bool inserted;
     {
-        unique_lock_type lock(data_mutex_);
-        std::string key = MakeKey(exchange, trade.symbol);
-        
-        // Store trade in history
-        auto& trade_history = trade_histories_[key];
-        trade_history.push_back(trade);
-        
-        // Keep only recent trades (last 1000)
-        if (trade_history.size() > max_trade_history_) {
-            trade_history.erase(trade_history.begin());
-        }
-        
-        // Update trade statistics
-        UpdateTradeStatistics(key, trade);
-    }
-    
-    LOG_DEBUG("Trade update for {}: {} {} @ {}", exchange, trade.symbol, trade.quantity, trade.price);
-}
+        unique_lock_type lock(shard.mutex);
+        auto result = shard.entries.try_emplace(key, max_history);
+        inserted = result.second;
+        TradeState& state = result.first->second;
 
-void MarketDataFeed::UpdateTradeStatistics(const std::string& key, const Trade& trade) {
-    auto& stats = trade_stats_[key];
-    
-    auto now = std::chrono::system_clock::now();
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-    
-    // Update volume statistics
-    stats.volume_1h += trade.quantity;
-    stats.volume_24h += trade.quantity;
-    stats.last_trade_time = timestamp;
-    stats.last_price = trade.price;
-    
-    // Calculate VWAP (Volume Weighted Average Price)
-    stats.vwap_total_value += trade.price * trade.quantity;
-    stats.vwap_total_volume += trade.quantity;
-    if (stats.vwap_total_volume > 0) {
-        stats.vwap = stats.vwap_total_value / stats.vwap_total_volume;
+        // Store trade in history, overwriting the oldest once full
+        state.history.set_capacity(max_history);
+        state.history.push(trade);
+
+        // Bucket by when the trade happened; fall back to arrival time for
+        // feeds that do not stamp their trades
+        long long timestamp = trade.timestamp > 0 ? trade.timestamp : NowMillis();
+        state.window.Add(timestamp, trade.price, trade.quantity);
+        state.last_price = trade.price;
+        state.last_trade_time = std::max(state.last_trade_time, timestamp);
     }
-    
-    // Update price statistics for volatility calculation
-    stats.price_history.push_back({trade.price, timestamp});
-    if (stats.price_history.size() > 200) { // Keep last 200 price points
-        stats.price_history.erase(stats.price_history.begin());
+    if (inserted) {
+        IndexKey(exchange, trade.symbol);
     }
+    
+    LOG_DEBUG("Trade update for {}: {} {} @ {}", exchange, trade.symbol, trade.quantity, trade.price);
 }
 
 bool MarketDataFeed::GetLatestPrice(const std::string& exchange, const std::string& symbol, Price& price) const {
-    shared_lock_type lock(data_mutex_);
     std::string key = MakeKey(exchange, symbol);
-    auto it = latest_prices_.find(key);
-    if (it != latest_prices_.end()) {
+    const auto& shard = price_shards_[ShardIndex(key)];
+    shared_lock_type lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end()) {
         price = it->second;
         return true;
     }
@@ -86,10 +209,11 @@ bool MarketDataFeed::GetLatestPrice(const std::string& exchange, const std::stri
 }
 
 bool MarketDataFeed::GetLatestOrderBook(const std::string& exchange, const std::string& symbol, OrderBook& orderbook) const {
-    shared_lock_type lock(data_mutex_);
     std::string key = MakeKey(exchange, symbol);
-    auto it = latest_orderbooks_.find(key);
-    if (it != latest_orderbooks_.end()) {
+    const auto& shard = orderbook_shards_[ShardIndex(key)];
+    shared_lock_type lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end()) {
         orderbook = it->second;
         return true;
     }
@@ -97,10 +221,11 @@ bool MarketDataFeed::GetLatestOrderBook(const std::string& exchange, const std::
 }
 
 bool MarketDataFeed::GetLatestTicker(const std::string& exchange, const std::string& symbol, Ticker& ticker) const {
-    shared_lock_type lock(data_mutex_);
     std::string key = MakeKey(exchange, symbol);
-    auto it = latest_tickers_.find(key);
-    if (it != latest_tickers_.end()) {
+    const auto& shard = ticker_shards_[ShardIndex(key)];
+    shared_lock_type lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end()) {
         ticker = it->second;
         return true;
     }
@@ -110,20 +235,15 @@ bool MarketDataFeed::GetLatestTicker(const std::string& exchange, const std::str
 void MarketDataFeed::ComparePrices(const std::string& symbol, 
                                              const std::vector<std::string>& exchanges,
                                              PriceComparison& comparison) const {
-    shared_lock_type lock(data_mutex_);
-    
     comparison.symbol = symbol;
-    comparison.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    comparison.timestamp = NowMillis();
     
     double highest_bid = 0.0;
     double lowest_ask = std::numeric_limits<double>::max();
     
     for (const auto& exchange : exchanges) {
-        std::string key = MakeKey(exchange, symbol);
-        auto it = latest_prices_.find(key);
-        if (it != latest_prices_.end()) {
-            const Price& price = it->second;
+        Price price;
+        if (GetLatestPrice(exchange, symbol, price)) {
             comparison.exchange_prices[exchange] = price;
             
             if (price.bid > highest_bid) {
@@ -146,12 +266,13 @@ void MarketDataFeed::ComparePrices(const std::string& symbol,
 std::vector<MarketDepth> MarketDataFeed::GetMarketDepth(const std::string& symbol,
                                                        const std::vector<std::string>& exchanges) const {
     std::vector<MarketDepth> depths;
-    shared_lock_type lock(data_mutex_);
     
     for (const auto& exchange : exchanges) {
         std::string key = MakeKey(exchange, symbol);
-        auto it = latest_orderbooks_.find(key);
-        if (it != latest_orderbooks_.end()) {
+        const auto& shard = orderbook_shards_[ShardIndex(key)];
+        shared_lock_type lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end()) {
             const OrderBook& orderbook = it->second;
             
             MarketDepth depth;
@@ -188,77 +309,85 @@ std::vector<MarketDepth> MarketDataFeed::GetMarketDepth(const std::string& symbo
 }
 
 MarketStats MarketDataFeed::GetMarketStats(const std::string& symbol) const {
-    shared_lock_type lock(data_mutex_);
+    shared_lock_type lock(stats_mutex_);
     auto it = market_stats_.find(symbol);
     return (it != market_stats_.end()) ? it->second : MarketStats();
 }
 
+double MarketDataFeed::GetVwap(const std::string& exchange, const std::string& symbol) const {
+    std::string key = MakeKey(exchange, symbol);
+    const auto& shard = trade_shards_[ShardIndex(key)];
+    shared_lock_type lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    return it != shard.entries.end() ? it->second.window.At(NowMillis()).Vwap() : 0.0;
+}
+
 void MarketDataFeed::UpdateMarketStats(const std::string& symbol) {
-    unique_lock_type lock(data_mutex_);
-    
     MarketStats stats;
     stats.symbol = symbol;
-    stats.last_update = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    stats.last_update = NowMillis();
     
-    // Implement statistical calculations
-    CalculateVolatility(symbol, stats);
+    // Each calculation reads the maintained aggregates of this symbol's
+    // exchanges only, as of now; no trade history is rescanned
+    CalculateTradeFlow(symbol, stats.last_update, stats);
+    CalculateVolatility(symbol, stats.last_update, stats);
     CalculateSpread(symbol, stats);
-    CalculateLiquidity(symbol, stats);
+    CalculateLiquidity(symbol, stats.last_update, stats);
     
+    unique_lock_type lock(stats_mutex_);
     market_stats_[symbol] = stats;
 }
 
-void MarketDataFeed::CalculateVolatility(const std::string& symbol, MarketStats& stats) const {
-    // Calculate volatility based on price history from all exchanges
-    std::vector<double> all_prices;
-    auto now = std::chrono::system_clock::now();
-    auto cutoff_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-        (now - std::chrono::hours(24)).time_since_epoch()).count();
+void MarketDataFeed::CalculateTradeFlow(const std::string& symbol, long long now_ms, MarketStats& stats) const {
+    // Pool every exchange's volume and notional, so the VWAP weighs each
+    // venue by what actually traded there
+    double notional = 0.0;
     
-    // Collect prices from all exchanges for this symbol
-    for (const auto& pair : trade_stats_) {
-        if (pair.first.find(":" + symbol) != std::string::npos) {
-            const auto& trade_stat = pair.second;
-            for (const auto& price_point : trade_stat.price_history) {
-                if (price_point.second >= cutoff_time) {
-                    all_prices.push_back(price_point.first);
-                }
-            }
+    for (const auto& exchange : ExchangesFor(symbol)) {
+        std::string key = MakeKey(exchange, symbol);
+        const auto& shard = trade_shards_[ShardIndex(key)];
+        shared_lock_type lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end()) {
+            const TradeState& state = it->second;
+            auto window = state.window.At(now_ms);
+            stats.volume_1h += window.hour_volume;
+            stats.volume_24h += window.day.volume;
+            notional += window.day.notional;
+            stats.last_trade_time = std::max(stats.last_trade_time, state.last_trade_time);
         }
     }
     
-    if (all_prices.size() < 2) {
-        stats.volatility = 0.0;
-        return;
-    }
+    stats.vwap = stats.volume_24h > 0.0 ? notional / stats.volume_24h : 0.0;
+}
+
+void MarketDataFeed::CalculateVolatility(const std::string& symbol, long long now_ms, MarketStats& stats) const {
+    // Pool the 24h return moments of every exchange trading this symbol
+    double return_sum = 0.0;
+    double return_sq_sum = 0.0;
+    size_t return_count = 0;
     
-    // Calculate returns
-    std::vector<double> returns;
-    for (size_t i = 1; i < all_prices.size(); ++i) {
-        if (all_prices[i-1] > 0) {
-            double return_rate = (all_prices[i] - all_prices[i-1]) / all_prices[i-1];
-            returns.push_back(return_rate);
+    for (const auto& exchange : ExchangesFor(symbol)) {
+        std::string key = MakeKey(exchange, symbol);
+        const auto& shard = trade_shards_[ShardIndex(key)];
+        shared_lock_type lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end()) {
+            auto day = it->second.window.At(now_ms).day;
+            return_sum += day.return_sum;
+            return_sq_sum += day.return_sq_sum;
+            return_count += day.return_count;
         }
     }
     
-    if (returns.empty()) {
+    if (return_count == 0) {
         stats.volatility = 0.0;
         return;
     }
     
-    // Calculate standard deviation of returns
-    double mean_return = 0.0;
-    for (double ret : returns) {
-        mean_return += ret;
-    }
-    mean_return /= returns.size();
-    
-    double variance = 0.0;
-    for (double ret : returns) {
-        variance += (ret - mean_return) * (ret - mean_return);
-    }
-    variance /= returns.size();
+    // Standard deviation of returns from the running moments
+    double mean_return = return_sum / return_count;
+    double variance = std::max(0.0, return_sq_sum / return_count - mean_return * mean_return);
     
     // Convert to annualized volatility percentage
     double daily_volatility = std::sqrt(variance);
@@ -270,56 +399,62 @@ void MarketDataFeed::CalculateSpread(const std::string& symbol, MarketStats& sta
     double total_spread = 0.0;
     int spread_count = 0;
     
-    for (const auto& pair : latest_prices_) {
-        if (pair.first.find(":" + symbol) != std::string::npos) {
-            const Price& price = pair.second;
-            if (price.ask > 0 && price.bid > 0) {
-                double spread_percent = (price.ask - price.bid) / price.bid * 100.0;
-                total_spread += spread_percent;
-                spread_count++;
-            }
+    for (const auto& exchange : ExchangesFor(symbol)) {
+        Price price;
+        if (GetLatestPrice(exchange, symbol, price) && price.ask > 0 && price.bid > 0) {
+            double spread_percent = (price.ask - price.bid) / price.bid * 100.0;
+            total_spread += spread_percent;
+            spread_count++;
         }
     }
     
     stats.average_spread = spread_count > 0 ? total_spread / spread_count : 0.0;
 }
 
-void MarketDataFeed::CalculateLiquidity(const std::string& symbol, MarketStats& stats) const {
+void MarketDataFeed::CalculateLiquidity(const std::string& symbol, long long now_ms, MarketStats& stats) const {
     // Calculate liquidity score based on multiple factors
     double volume_score = 0.0;
     double depth_score = 0.0;
     double spread_score = 0.0;
     int exchange_count = 0;
     
-    // Collect data from all exchanges
-    for (const auto& pair : trade_stats_) {
-        if (pair.first.find(":" + symbol) != std::string::npos) {
-            const auto& trade_stat = pair.second;
-            exchange_count++;
-            
-            // Volume component (normalized)
-            volume_score += std::min(100.0, std::log10(trade_stat.volume_24h + 1) * 20.0);
-        }
-    }
-    
-    // Order book depth component
-    for (const auto& pair : latest_orderbooks_) {
-        if (pair.first.find(":" + symbol) != std::string::npos) {
-            const OrderBook& orderbook = pair.second;
-            
-            double bid_depth = 0.0;
-            double ask_depth = 0.0;
-            
-            // Sum top 5 levels
-            for (size_t i = 0; i < std::min(size_t(5), orderbook.bids.size()); ++i) {
-                bid_depth += orderbook.bids[i].second;
+    for (const auto& exchange : ExchangesFor(symbol)) {
+        std::string key = MakeKey(exchange, symbol);
+        
+        {
+            const auto& shard = trade_shards_[ShardIndex(key)];
+            shared_lock_type lock(shard.mutex);
+            auto it = shard.entries.find(key);
+            if (it != shard.entries.end()) {
+                exchange_count++;
+                
+                // Volume component (normalized)
+                volume_score += std::min(100.0, std::log10(it->second.window.At(now_ms).day.volume + 1) * 20.0);
             }
-            for (size_t i = 0; i < std::min(size_t(5), orderbook.asks.size()); ++i) {
-                ask_depth += orderbook.asks[i].second;
+        }
+        
+        // Order book depth component
+        {
+            const auto& shard = orderbook_shards_[ShardIndex(key)];
+            shared_lock_type lock(shard.mutex);
+            auto it = shard.entries.find(key);
+            if (it != shard.entries.end()) {
+                const OrderBook& orderbook = it->second;
+                
+                double bid_depth = 0.0;
+                double ask_depth = 0.0;
+                
+                // Sum top 5 levels
+                for (size_t i = 0; i < std::min(size_t(5), orderbook.bids.size()); ++i) {
+                    bid_depth += orderbook.bids[i].second;
+                }
+                for (size_t i = 0; i < std::min(size_t(5), orderbook.asks.size()); ++i) {
+                    ask_depth += orderbook.asks[i].second;
+                }
+                
+                double total_depth = bid_depth + ask_depth;
+                depth_score += std::min(100.0, std::log10(total_depth + 1) * 25.0);
             }
-            
-            double total_depth = bid_depth + ask_depth;
-            depth_score += std::min(100.0, std::log10(total_depth + 1) * 25.0);
         }
     }
     
@@ -343,13 +478,15 @@ void MarketDataFeed::CalculateLiquidity(const std::string& symbol, MarketStats&
 }
 
 std::vector<std::string> MarketDataFeed::GetAvailableSymbols() const {
-    shared_lock_type lock(data_mutex_);
     std::unordered_set<std::string> symbols;
     
-    for (const auto& pair : latest_prices_) {
-        size_t pos = pair.first.find(':');
-        if (pos != std::string::npos) {
-            symbols.insert(pair.first.substr(pos + 1));
+    for (const auto& shard : price_shards_) {
+        shared_lock_type lock(shard.mutex);
+        for (const auto& pair : shard.entries) {
+            size_t pos = pair.first.find(':');
+            if (pos != std::string::npos) {
+                symbols.insert(pair.first.substr(pos + 1));
+            }
         }
     }
     
@@ -357,13 +494,15 @@ std::vector<std::string> MarketDataFeed::GetAvailableSymbols() const {
 }
 
 std::vector<std::string> MarketDataFeed::GetActiveExchanges() const {
-    shared_lock_type lock(data_mutex_);
     std::unordered_set<std::string> exchanges;
     
-    for (const auto& pair : latest_prices_) {
-        size_t pos = pair.first.find(':');
-        if (pos != std::string::npos) {
-            exchanges.insert(pair.first.substr(0, pos));
+    for (const auto& shard : price_shards_) {
+        shared_lock_type lock(shard.mutex);
+        for (const auto& pair : shard.entries) {
+            size_t pos = pair.first.find(':');
+            if (pos != std::string::npos) {
+                exchanges.insert(pair.first.substr(0, pos));
+            }
         }
     }
     
@@ -372,54 +511,68 @@ std::vector<std::string> MarketDataFeed::GetActiveExchanges() const {
 
 bool MarketDataFeed::IsDataStale(const std::string& exchange, const std::string& symbol, 
                                 std::chrono::seconds max_age) const {
-    shared_lock_type lock(data_mutex_);
-    std::string key = MakeKey(exchange, symbol);
-    auto it = latest_prices_.find(key);
-    
-    if (it == latest_prices_.end()) {
+    Price price;
+    if (!GetLatestPrice(exchange, symbol, price)) {
         return true; // No data is considered stale
     }
     
-    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
-    auto age = std::chrono::milliseconds(now - it->second.timestamp);
+    auto age = std::chrono::milliseconds(NowMillis() - price.timestamp);
     
     return age > max_age;
 }
 
 void MarketDataFeed::CleanupOldData(std::chrono::minutes max_age) {
-    unique_lock_type lock(data_mutex_);
-    
-    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
-    auto cutoff = now - std::chrono::duration_cast<std::chrono::milliseconds>(max_age).count();
-    
-    // Clean old prices
-    for (auto it = latest_prices_.begin(); it != latest_prices_.end();) {
-        if (it->second.timestamp < cutoff) {
-            it = latest_prices_.erase(it);
-        } else {
-            ++it;
+    auto cutoff = NowMillis() - std::chrono::duration_cast<std::chrono::milliseconds>(max_age).count();
+    
+    // One shard at a time, so readers of other shards are never held up.
+    // Trade histories are bounded ring buffers and need no trimming.
+    for (auto& shard : price_shards_) {
+        unique_lock_type lock(shard.mutex);
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            if (it->second.timestamp < cutoff) {
+                it = shard.entries.erase(it);
+            } else {
+                ++it;
+            }
         }
     }
     
-    // Clean old orderbooks
-    for (auto it = latest_orderbooks_.begin(); it != latest_orderbooks_.end();) {
-        if (it->second.timestamp < cutoff) {
-            it = latest_orderbooks_.erase(it);
-        } else {
-            ++it;
+    for (auto& shard : orderbook_shards_) {
+        unique_lock_type lock(shard.mutex);
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            if (it->second.timestamp < cutoff) {
+                it = shard.entries.erase(it);
+            } else {
+                ++it;
+            }
         }
     }
 }
 
 size_t MarketDataFeed::GetMemoryUsage() const {
-    shared_lock_type lock(data_mutex_);
-    
     size_t usage = 0;
-    usage += latest_prices_.size() * (sizeof(Price) + 50); // Approximate key size
-    usage += latest_orderbooks_.size() * (sizeof(OrderBook) + 50);
-    usage += latest_tickers_.size() * (sizeof(Ticker) + 50);
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        {
+            shared_lock_type lock(price_shards_[i].mutex);
+            usage += price_shards_[i].entries.size() * (sizeof(Price) + 50); // Approximate key size
+        }
+        {
+            shared_lock_type lock(orderbook_shards_[i].mutex);
+            usage += orderbook_shards_[i].entries.size() * (sizeof(OrderBook) + 50);
+        }
+        {
+            shared_lock_type lock(ticker_shards_[i].mutex);
+            usage += ticker_shards_[i].entries.size() * (sizeof(Ticker) + 50);
+        }
+        {
+            shared_lock_type lock(trade_shards_[i].mutex);
+            for (const auto& pair : trade_shards_[i].entries) {
+                usage += sizeof(TradeState) + 50 + pair.second.history.capacity() * sizeof(Trade);
+            }
+        }
+    }
+    
+    shared_lock_type lock(stats_mutex_);
     usage += market_stats_.size() * (sizeof(MarketStats) + 50);
     
     return usage;
@@ -429,4 +582,22 @@ std::string MarketDataFeed::MakeKey(const std::string& exchange, const std::stri
     return exchange + ":" + symbol;
 }
 
+size_t MarketDataFeed::ShardIndex(const std::string& key) {
+    return std::hash<std::string>{}(key) % SHARD_COUNT;
+}
+
+void MarketDataFeed::IndexKey(const std::string& exchange, const std::string& symbol) {
+    unique_lock_type lock(index_mutex_);
+    symbol_exchanges_[symbol].insert(exchange);
+}
+
+std::vector<std::string> MarketDataFeed::ExchangesFor(const std::string& symbol) const {
+    shared_lock_type lock(index_mutex_);
+    auto it = symbol_exchanges_.find(symbol);
+    if (it == symbol_exchanges_.end()) {
+        return {};
+    }
+    return std::vector<std::string>(it->second.begin(), it->second.end());
+}
+
 } // namespace ats 
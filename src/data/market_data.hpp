@@ -8,8 +8,11 @@
 #include <shared_mutex>
 #include <unordered_set>
 #include <limits>
+#include <array>
+#include <atomic>
 
 #include "../core/types.hpp"
+#include "../utils/ring_buffer.hpp"
 
 namespace ats {
 
@@ -51,10 +54,15 @@ struct MarketStats {
     double average_spread;      // Average bid-ask spread
     double liquidity_score;     // Liquidity indicator
     double correlation;         // Price correlation with other markets
+    double volume_1h;           // Traded quantity over the last hour, all exchanges
+    double volume_24h;          // Traded quantity over the last 24h, all exchanges
+    double vwap;                // 24h volume-weighted average price, 0 without trades
+    long long last_trade_time;  // Latest trade on any exchange
     long long last_update;
     
     MarketStats() : volatility(0.0), average_spread(0.0), liquidity_score(0.0),
-                   correlation(0.0), last_update(0) {}
+                   correlation(0.0), volume_1h(0.0), volume_24h(0.0), vwap(0.0),
+                   last_trade_time(0), last_update(0) {}
 };
 
 // Note: PriceComparison moved to types.hpp to avoid duplication
@@ -82,40 +90,100 @@ struct MarketDepth {
     }
 };
 
-// Real-time market data feed
+// Real-time market data feed.
+//
+// State is split by kind (prices, order books, tickers, trades) and each kind
+// is sharded by exchange:symbol key, so a burst of trades on one symbol only
+// contends with writers of the same trade shard and never with price readers.
 class MarketDataFeed {
 private:
-    // Current market data
-    std::unordered_map<std::string, Price> latest_prices_;
-    std::unordered_map<std::string, OrderBook> latest_orderbooks_;
-    std::unordered_map<std::string, Ticker> latest_tickers_;
-    std::unordered_map<std::string, MarketStats> market_stats_;
-    
-    // Trade history and statistics
-    std::unordered_map<std::string, std::vector<Trade>> trade_histories_;
-    
-    struct TradeStatistics {
-        double volume_1h = 0.0;
-        double volume_24h = 0.0;
-        double vwap = 0.0;
-        double vwap_total_value = 0.0;
-        double vwap_total_volume = 0.0;
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    template<typename T>
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, T> entries;
+    };
+
+    // Sliding trade window: per-minute volume for the last hour and
+    // 15-minute buckets of volume, notional and return moments for the last
+    // day (so the 24h edge moves in 15-minute steps). Buckets are keyed by
+    // trade time. Running totals are adjusted as buckets leave the ranges,
+    // so each trade costs O(1) amortized. Readers take a snapshot at the
+    // current time, which drops whatever expired since the last trade
+    // without mutating the window, so an idle key decays under a shared lock.
+    class RollingTradeWindow {
+    public:
+        static constexpr long long MINUTE_MS = 60 * 1000;
+        static constexpr size_t HOUR_BUCKETS = 60;              // one per minute
+        static constexpr long long DAY_BUCKET_MINUTES = 15;
+        static constexpr size_t DAY_BUCKETS = 24 * 60 / DAY_BUCKET_MINUTES;
+
+        struct Totals {
+            double volume = 0.0;
+            double notional = 0.0;
+            double return_sum = 0.0;
+            double return_sq_sum = 0.0;
+            size_t return_count = 0;
+        };
+
+        struct Snapshot {
+            Totals day;
+            double hour_volume = 0.0;
+
+            double Vwap() const { return day.volume > 0.0 ? day.notional / day.volume : 0.0; }
+        };
+
+        void Add(long long timestamp_ms, double price, double quantity);
+        Snapshot At(long long now_ms) const;
+
+    private:
+        void Advance(long long minute);
+        static void Subtract(Totals& totals, const Totals& expired);
+
+        static long long DayBucketOf(long long minute) { return minute / DAY_BUCKET_MINUTES; }
+        double& MinuteAt(long long minute) { return minutes_[static_cast<size_t>(minute) % HOUR_BUCKETS]; }
+        double MinuteAt(long long minute) const { return minutes_[static_cast<size_t>(minute) % HOUR_BUCKETS]; }
+        Totals& DayAt(long long bucket) { return days_[static_cast<size_t>(bucket) % DAY_BUCKETS]; }
+        const Totals& DayAt(long long bucket) const { return days_[static_cast<size_t>(bucket) % DAY_BUCKETS]; }
+
+        std::array<double, HOUR_BUCKETS> minutes_{};
+        std::array<Totals, DAY_BUCKETS> days_{};
+        long long head_minute_ = -1;
+        Totals day_;
+        double hour_volume_ = 0.0;
+        double last_price_ = 0.0;
+    };
+
+    struct TradeState {
+        RingBuffer<Trade> history;
+        RollingTradeWindow window;
         double last_price = 0.0;
         long long last_trade_time = 0;
-        std::vector<std::pair<double, long long>> price_history; // price, timestamp
-        
-        TradeStatistics() = default;
+
+        explicit TradeState(size_t max_history) : history(max_history) {}
     };
-    std::unordered_map<std::string, TradeStatistics> trade_stats_;
-    
-    mutable std::shared_mutex data_mutex_;
+
+    std::array<Shard<Price>, SHARD_COUNT> price_shards_;
+    std::array<Shard<OrderBook>, SHARD_COUNT> orderbook_shards_;
+    std::array<Shard<Ticker>, SHARD_COUNT> ticker_shards_;
+    std::array<Shard<TradeState>, SHARD_COUNT> trade_shards_;
+
+    // Exchanges seen per symbol, so per-symbol statistics visit only the
+    // relevant keys instead of scanning every map
+    mutable std::shared_mutex index_mutex_;
+    std::unordered_map<std::string, std::unordered_set<std::string>> symbol_exchanges_;
+
+    mutable std::shared_mutex stats_mutex_;
+    std::unordered_map<std::string, MarketStats> market_stats_;
     
     // Lock type aliases for convenience
     using unique_lock_type = std::unique_lock<std::shared_mutex>;
     using shared_lock_type = std::shared_lock<std::shared_mutex>;
     
     // Configuration
-    size_t max_trade_history_;
+    std::atomic<size_t> max_trade_history_;
     std::chrono::minutes stats_update_interval_;
     
 public:
@@ -123,7 +191,7 @@ public:
     ~MarketDataFeed() = default;
     
     // Configuration
-    void SetMaxTradeHistory(size_t max_history) { max_trade_history_ = max_history; }
+    void SetMaxTradeHistory(size_t max_history) { max_trade_history_.store(max_history); }
     void SetStatsUpdateInterval(std::chrono::minutes interval) { stats_update_interval_ = interval; }
     
     // Data updates (thread-safe)
@@ -147,6 +215,7 @@ public:
     
     // Statistics
     MarketStats GetMarketStats(const std::string& symbol) const;
+    double GetVwap(const std::string& exchange, const std::string& symbol) const; // 24h, 0 without trades
     void UpdateMarketStats(const std::string& symbol);
     
     // Utility functions
@@ -161,10 +230,13 @@ public:
     
 private:
     std::string MakeKey(const std::string& exchange, const std::string& symbol) const;
-    void UpdateTradeStatistics(const std::string& key, const Trade& trade);
-    void CalculateVolatility(const std::string& symbol, MarketStats& stats) const;
+    static size_t ShardIndex(const std::string& key);
+    void IndexKey(const std::string& exchange, const std::string& symbol);
+    std::vector<std::string> ExchangesFor(const std::string& symbol) const;
+    void CalculateTradeFlow(const std::string& symbol, long long now_ms, MarketStats& stats) const;
+    void CalculateVolatility(const std::string& symbol, long long now_ms, MarketStats& stats) const;
     void CalculateSpread(const std::string& symbol, MarketStats& stats) const;
-    void CalculateLiquidity(const std::string& symbol, MarketStats& stats) const;
+    void CalculateLiquidity(const std::string& symbol, long long now_ms, MarketStats& stats) const;
 };
 
 } // namespace ats 
\ No newline at end of file
@@ -6,10 +6,15 @@
 namespace ats {
 
 // PriceCache Implementation
-PriceCache::PriceCache(size_t max_prices, size_t max_orderbooks)
-    : price_cache_(max_prices), orderbook_cache_(max_orderbooks),
+PriceCache::PriceCache(size_t max_prices, size_t max_orderbooks, PriceCacheMode mode)
+    : mode_(mode), price_cache_(max_prices), orderbook_cache_(max_orderbooks),
       price_ttl_(std::chrono::seconds(30)), orderbook_ttl_(std::chrono::seconds(10)),
       running_(true) {
+    if (mode_ == PriceCacheMode::SEQLOCK) {
+        price_table_ = std::make_unique<SeqlockPriceTable>(max_prices);
+    }
+    AttachIndex(price_cache_, price_index_);
+    AttachIndex(orderbook_cache_, orderbook_index_);
     
     // Start cleanup thread
     cleanup_thread_ = std::thread(&PriceCache::CleanupLoop, this);
@@ -25,20 +30,61 @@ PriceCache::~PriceCache() {
 }
 
 bool PriceCache::GetPrice(const std::string& exchange, const std::string& symbol, Price& price) {
+    if (price_table_) {
+        types::ExchangeCode exchange_code = types::ExchangeRegistry::instance().find(exchange);
+        types::SymbolCode symbol_code = types::SymbolRegistry::instance().find(symbol);
+        // Names the registries had no room for live in the string-keyed cache
+        if (exchange_code != types::INVALID_CODE && symbol_code != types::INVALID_CODE) {
+            CompactPrice compact;
+            if (!price_table_->Get(exchange_code, symbol_code, compact)) {
+                return false;
+            }
+            price = Price{symbol, compact.bid, compact.ask, compact.last, compact.volume, compact.timestamp};
+            return true;
+        }
+    }
+
     std::string key = MakeKey(exchange, symbol);
     return price_cache_.Get(key, price);
 }
 
+bool PriceCache::GetPrice(types::ExchangeCode exchange, types::SymbolCode symbol, CompactPrice& price) const {
+    return price_table_ && price_table_->Get(exchange, symbol, price);
+}
+
 void PriceCache::SetPrice(const std::string& exchange, const std::string& symbol, const Price& price) {
+    if (price_table_) {
+        types::ExchangeCode exchange_code = types::intern_exchange(exchange);
+        types::SymbolCode symbol_code = types::intern_symbol(symbol);
+        // A full registry hands out no code; such prices fall back to the
+        // string-keyed cache rather than aliasing the table's sentinel keys
+        if (exchange_code != types::INVALID_CODE && symbol_code != types::INVALID_CODE) {
+            price_table_->Put(exchange_code, symbol_code, to_compact(price));
+            return;
+        }
+    }
+
     std::string key = MakeKey(exchange, symbol);
     price_cache_.Put(key, price);
 }
 
 bool PriceCache::IsPriceStale(const std::string& exchange, const std::string& symbol, 
                              std::chrono::seconds max_age) const {
-    std::string key = MakeKey(exchange, symbol);
     Price price;
-    if (!price_cache_.GetConst(key, price)) {
+    types::ExchangeCode exchange_code = types::INVALID_CODE;
+    types::SymbolCode symbol_code = types::INVALID_CODE;
+    if (price_table_) {
+        exchange_code = types::ExchangeRegistry::instance().find(exchange);
+        symbol_code = types::SymbolRegistry::instance().find(symbol);
+    }
+    if (exchange_code != types::INVALID_CODE && symbol_code != types::INVALID_CODE) {
+        CompactPrice compact;
+        if (!price_table_->Peek(exchange_code, symbol_code, compact)) {
+            return true; // No price data is considered stale
+        }
+        price.timestamp = compact.timestamp;
+    } else if (!price_cache_.Inspect(MakeKey(exchange, symbol),
+                                     [&price](const Price& cached) { price.timestamp = cached.timestamp; })) {
         return true; // No price data is considered stale
     }
     
@@ -62,28 +108,39 @@ void PriceCache::SetOrderBook(const std::string& exchange, const std::string& sy
 bool PriceCache::IsOrderBookStale(const std::string& exchange, const std::string& symbol,
                                  std::chrono::seconds max_age) const {
     std::string key = MakeKey(exchange, symbol);
-    OrderBook orderbook;
-    if (!orderbook_cache_.GetConst(key, orderbook)) {
+    long long timestamp = 0;
+    // Only the timestamp is needed, so avoid copying the book's levels
+    if (!orderbook_cache_.Inspect(key, [&timestamp](const OrderBook& cached) { timestamp = cached.timestamp; })) {
         return true; // No orderbook data is considered stale
     }
     
     auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
-    auto age = std::chrono::milliseconds(now - orderbook.timestamp);
+    auto age = std::chrono::milliseconds(now - timestamp);
     
     return age > max_age;
 }
 
 std::vector<Price> PriceCache::GetAllPrices(const std::string& symbol) {
     std::vector<Price> prices;
+
+    if (price_table_) {
+        // At most MAX_EXCHANGES lock-free probes, one per known exchange
+        types::SymbolCode symbol_code = types::SymbolRegistry::instance().find(symbol);
+        size_t exchange_count = types::ExchangeRegistry::instance().size();
+        for (types::ExchangeCode exchange = 0; symbol_code != types::INVALID_CODE && exchange < exchange_count; ++exchange) {
+            CompactPrice compact;
+            if (price_table_->Peek(exchange, symbol_code, compact)) {
+                prices.push_back(Price{symbol, compact.bid, compact.ask, compact.last, compact.volume, compact.timestamp});
+            }
+        }
+        // Prices without codes fell back to the string-keyed cache below
+    }
     
-    // Get all exchanges that have this symbol cached
-    std::vector<std::string> exchanges = GetCachedExchanges();
-    
-    for (const auto& exchange : exchanges) {
-        std::string key = MakeKey(exchange, symbol);
+    // Only the exchanges that quote this symbol are looked up
+    for (const auto& exchange : IndexedExchanges(price_index_, symbol)) {
         Price price;
-        if (price_cache_.GetConst(key, price)) {
+        if (price_cache_.GetConst(MakeKey(exchange, symbol), price)) {
             prices.push_back(price);
         }
     }
@@ -93,83 +150,79 @@ std::vector<Price> PriceCache::GetAllPrices(const std::string& symbol) {
 
 std::vector<std::string> PriceCache::GetCachedSymbols() const {
     std::set<std::string> unique_symbols;
-    
-    // Extract symbols from all cache keys
-    auto keys = price_cache_.GetAllKeys();
-    for (const auto& key : keys) {
-        size_t colon_pos = key.find(':');
-        if (colon_pos != std::string::npos && colon_pos + 1 < key.length()) {
-            std::string symbol = key.substr(colon_pos + 1);
-            unique_symbols.insert(symbol);
+
+    if (price_table_) {
+        for (const auto& entry : price_table_->Snapshot()) {
+            unique_symbols.insert(types::symbol_name(entry.symbol));
         }
     }
     
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    for (const auto& [symbol, exchanges] : price_index_.exchanges_by_symbol) {
+        unique_symbols.insert(symbol);
+    }
+    
     return std::vector<std::string>(unique_symbols.begin(), unique_symbols.end());
 }
 
 std::vector<std::string> PriceCache::GetCachedExchanges() const {
     std::set<std::string> unique_exchanges;
-    
-    // Extract exchanges from all cache keys
-    auto keys = price_cache_.GetAllKeys();
-    for (const auto& key : keys) {
-        size_t colon_pos = key.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string exchange = key.substr(0, colon_pos);
-            unique_exchanges.insert(exchange);
+
+    if (price_table_) {
+        for (const auto& entry : price_table_->Snapshot()) {
+            unique_exchanges.insert(types::exchange_name(entry.exchange));
         }
     }
     
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    for (const auto& [exchange, symbols] : price_index_.symbols_by_exchange) {
+        unique_exchanges.insert(exchange);
+    }
+    
     return std::vector<std::string>(unique_exchanges.begin(), unique_exchanges.end());
 }
 
 void PriceCache::ClearAll() {
     price_cache_.Clear();
+    if (price_table_) {
+        price_table_->Clear();
+    }
     orderbook_cache_.Clear();
     LOG_INFO("Price cache cleared");
 }
 
 void PriceCache::ClearExchange(const std::string& exchange) {
-    std::string prefix = exchange + ":";
-    
-    // Get all keys and remove those starting with the exchange prefix
-    auto keys = price_cache_.GetAllKeys();
-    for (const auto& key : keys) {
-        if (key.substr(0, prefix.length()) == prefix) {
-            price_cache_.Remove(key);
+    if (price_table_) {
+        types::ExchangeCode exchange_code = types::ExchangeRegistry::instance().find(exchange);
+        if (exchange_code != types::INVALID_CODE) {
+            price_table_->RemoveExchange(exchange_code);
         }
     }
     
-    // Also clear orderbook cache for this exchange
-    auto orderbook_keys = orderbook_cache_.GetAllKeys();
-    for (const auto& key : orderbook_keys) {
-        if (key.substr(0, prefix.length()) == prefix) {
-            orderbook_cache_.Remove(key);
-        }
+    // Removal fires the key listeners, which prune the indexes
+    for (const auto& symbol : IndexedSymbols(price_index_, exchange)) {
+        price_cache_.Remove(MakeKey(exchange, symbol));
+    }
+    for (const auto& symbol : IndexedSymbols(orderbook_index_, exchange)) {
+        orderbook_cache_.Remove(MakeKey(exchange, symbol));
     }
     
     LOG_INFO("Cleared cache for exchange: {}", exchange);
 }
 
 void PriceCache::ClearSymbol(const std::string& symbol) {
-    std::string suffix = ":" + symbol;
-    
-    // Get all keys and remove those ending with the symbol suffix
-    auto keys = price_cache_.GetAllKeys();
-    for (const auto& key : keys) {
-        if (key.length() >= suffix.length() && 
-            key.substr(key.length() - suffix.length()) == suffix) {
-            price_cache_.Remove(key);
+    if (price_table_) {
+        types::SymbolCode symbol_code = types::SymbolRegistry::instance().find(symbol);
+        if (symbol_code != types::INVALID_CODE) {
+            price_table_->RemoveSymbol(symbol_code);
         }
     }
     
-    // Also clear orderbook cache for this symbol
-    auto orderbook_keys = orderbook_cache_.GetAllKeys();
-    for (const auto& key : orderbook_keys) {
-        if (key.length() >= suffix.length() && 
-            key.substr(key.length() - suffix.length()) == suffix) {
-            orderbook_cache_.Remove(key);
-        }
+    for (const auto& exchange : IndexedExchanges(price_index_, symbol)) {
+        price_cache_.Remove(MakeKey(exchange, symbol));
+    }
+    for (const auto& exchange : IndexedExchanges(orderbook_index_, symbol)) {
+        orderbook_cache_.Remove(MakeKey(exchange, symbol));
     }
     
     LOG_INFO("Cleared cache for symbol: {}", symbol);
@@ -177,6 +230,9 @@ void PriceCache::ClearSymbol(const std::string& symbol) {
 
 void PriceCache::ForceCleanup() {
     price_cache_.CleanupExpired(price_ttl_);
+    if (price_table_) {
+        price_table_->CleanupExpired(price_ttl_);
+    }
     orderbook_cache_.CleanupExpired(orderbook_ttl_);
     LOG_DEBUG("Forced cache cleanup completed");
 }
@@ -201,6 +257,77 @@ std::string PriceCache::MakeKey(const std::string& exchange, const std::string&
     return exchange + ":" + symbol;
 }
 
+bool PriceCache::SplitKey(const std::string& key, std::string& exchange, std::string& symbol) {
+    size_t colon_pos = key.find(':');
+    if (colon_pos == std::string::npos) {
+        return false;
+    }
+    exchange = key.substr(0, colon_pos);
+    symbol = key.substr(colon_pos + 1);
+    return true;
+}
+
+template<typename Value>
+void PriceCache::AttachIndex(LRUCache<std::string, Value>& cache, KeyIndex& index) {
+    // Keys are split only when they enter or leave the cache, never on lookups
+    cache.SetKeyListeners(
+        [this, &index](const std::string& key) {
+            std::string exchange, symbol;
+            if (SplitKey(key, exchange, symbol)) {
+                std::lock_guard<std::mutex> lock(index_mutex_);
+                index.Add(exchange, symbol);
+            }
+        },
+        [this, &index](const std::string& key) {
+            std::string exchange, symbol;
+            if (SplitKey(key, exchange, symbol)) {
+                std::lock_guard<std::mutex> lock(index_mutex_);
+                index.Erase(exchange, symbol);
+            }
+        });
+}
+
+std::vector<std::string> PriceCache::IndexedExchanges(const KeyIndex& index, const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    auto it = index.exchanges_by_symbol.find(symbol);
+    if (it == index.exchanges_by_symbol.end()) {
+        return {};
+    }
+    return std::vector<std::string>(it->second.begin(), it->second.end());
+}
+
+std::vector<std::string> PriceCache::IndexedSymbols(const KeyIndex& index, const std::string& exchange) const {
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    auto it = index.symbols_by_exchange.find(exchange);
+    if (it == index.symbols_by_exchange.end()) {
+        return {};
+    }
+    return std::vector<std::string>(it->second.begin(), it->second.end());
+}
+
+void PriceCache::KeyIndex::Add(const std::string& exchange, const std::string& symbol) {
+    exchanges_by_symbol[symbol].insert(exchange);
+    symbols_by_exchange[exchange].insert(symbol);
+}
+
+void PriceCache::KeyIndex::Erase(const std::string& exchange, const std::string& symbol) {
+    auto by_symbol = exchanges_by_symbol.find(symbol);
+    if (by_symbol != exchanges_by_symbol.end()) {
+        by_symbol->second.erase(exchange);
+        if (by_symbol->second.empty()) {
+            exchanges_by_symbol.erase(by_symbol);
+        }
+    }
+
+    auto by_exchange = symbols_by_exchange.find(exchange);
+    if (by_exchange != symbols_by_exchange.end()) {
+        by_exchange->second.erase(symbol);
+        if (by_exchange->second.empty()) {
+            symbols_by_exchange.erase(by_exchange);
+        }
+    }
+}
+
 void PriceCache::CleanupLoop() {
     LOG_DEBUG("Price cache cleanup thread started");
     
@@ -208,7 +335,8 @@ void PriceCache::CleanupLoop() {
         try {
             // Wait for cleanup interval or shutdown signal
             std::unique_lock<std::mutex> lock(cleanup_mutex_);
-            cleanup_cv_.wait_for(lock, std::chrono::minutes(1), [this] { 
+            // Expiry only touches buckets that came due, so frequent passes are cheap
+            cleanup_cv_.wait_for(lock, std::chrono::seconds(1), [this] { 
                 return !running_.load(); 
             });
             
@@ -218,6 +346,9 @@ void PriceCache::CleanupLoop() {
             
             // Perform cleanup
             price_cache_.CleanupExpired(price_ttl_);
+            if (price_table_) {
+                price_table_->CleanupExpired(price_ttl_);
+            }
             orderbook_cache_.CleanupExpired(orderbook_ttl_);
             
             LOG_DEBUG("Cache cleanup completed - Prices: {}, OrderBooks: {}", 
@@ -243,9 +374,9 @@ PriceCache& PriceCacheManager::Instance() {
     return *instance_;
 }
 
-void PriceCacheManager::Initialize(size_t max_prices, size_t max_orderbooks) {
+void PriceCacheManager::Initialize(size_t max_prices, size_t max_orderbooks, PriceCacheMode mode) {
     std::lock_guard<std::mutex> lock(instance_mutex_);
-    instance_ = std::make_unique<PriceCache>(max_prices, max_orderbooks);
+    instance_ = std::make_unique<PriceCache>(max_prices, max_orderbooks, mode);
     LOG_INFO("PriceCacheManager initialized");
 }
 
@@ -1,12 +1,19 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
+#include <functional>
 #include <list>
+#include <vector>
+#include <iterator>
+#include <algorithm>
 #include <mutex>
 #include <chrono>
 #include <atomic>
 #include <condition_variable>
+#include <thread>
 #include "../core/types.hpp"
+#include "seqlock_price_table.hpp"
 
 namespace ats {
 
@@ -61,25 +68,85 @@ struct CacheEntry {
     }
 };
 
-// LRU Cache implementation optimized for memory usage
+// LRU Cache implementation optimized for memory usage.
+//
+// Besides the recency list, entries are filed by write time into a bucketed
+// expiry index (a single-level timer wheel of EXPIRY_BUCKETS buckets, each
+// EXPIRY_RESOLUTION wide), so TTL expiry only visits buckets that have come
+// due instead of walking the whole list.
 template<typename Key, typename Value>
 class LRUCache {
 private:
     using CacheEntryType = CacheEntry<Value>;
     using ListIterator = typename std::list<std::pair<Key, CacheEntryType>>::iterator;
+    using ExpiryBucket = std::list<Key>;
+    using KeyListener = std::function<void(const Key&)>;
+
+    static constexpr std::chrono::milliseconds EXPIRY_RESOLUTION{100};
+    static constexpr size_t EXPIRY_BUCKETS = 1024; // ~100s span; longer TTLs wrap around
+
+    struct IndexEntry {
+        ListIterator position;
+        size_t expiry_bucket;
+        typename ExpiryBucket::iterator expiry_position;
+    };
     
     size_t max_size_;
     std::list<std::pair<Key, CacheEntryType>> cache_list_;
-    std::unordered_map<Key, ListIterator> cache_map_;
+    std::unordered_map<Key, IndexEntry> cache_map_;
+    std::vector<ExpiryBucket> expiry_buckets_;
+    long long next_expiry_tick_;
     mutable std::mutex cache_mutex_;
+
+    // Invoked under cache_mutex_ whenever a key enters or leaves the cache
+    KeyListener on_insert_;
+    KeyListener on_erase_;
     
     // Statistics
     std::atomic<long long> hits_;
     std::atomic<long long> misses_;
     std::atomic<long long> evictions_;
+
+    static long long ToTick(std::chrono::steady_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() /
+               EXPIRY_RESOLUTION.count();
+    }
+
+    static size_t BucketFor(long long tick) {
+        return static_cast<size_t>(tick) % EXPIRY_BUCKETS;
+    }
+
+    // Files a freshly written entry under its write time, moving it out of
+    // its previous bucket without reallocating the node
+    void Reschedule(IndexEntry& index, std::chrono::steady_clock::time_point written) {
+        size_t bucket = BucketFor(ToTick(written));
+        auto& target = expiry_buckets_[bucket];
+        target.splice(target.end(), expiry_buckets_[index.expiry_bucket], index.expiry_position);
+        index.expiry_bucket = bucket;
+    }
+
+    void EraseIndexed(typename std::unordered_map<Key, IndexEntry>::iterator it) {
+        if (on_erase_) {
+            on_erase_(it->first);
+        }
+        expiry_buckets_[it->second.expiry_bucket].erase(it->second.expiry_position);
+        cache_list_.erase(it->second.position);
+        cache_map_.erase(it);
+    }
     
 public:
-    explicit LRUCache(size_t max_size) : max_size_(max_size), hits_(0), misses_(0), evictions_(0) {}
+    explicit LRUCache(size_t max_size)
+        : max_size_(max_size), expiry_buckets_(EXPIRY_BUCKETS),
+          next_expiry_tick_(ToTick(std::chrono::steady_clock::now())),
+          hits_(0), misses_(0), evictions_(0) {}
+
+    // Lets an owner maintain secondary indexes that follow evictions and
+    // expiry. Listeners run under the cache lock and must not call back in.
+    void SetKeyListeners(KeyListener on_insert, KeyListener on_erase) {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        on_insert_ = std::move(on_insert);
+        on_erase_ = std::move(on_erase);
+    }
     
     // Get value from cache
     bool Get(const Key& key, Value& value) {
@@ -92,12 +159,12 @@ public:
         }
         
         // Move to front (most recently used)
-        cache_list_.splice(cache_list_.begin(), cache_list_, it->second);
+        cache_list_.splice(cache_list_.begin(), cache_list_, it->second.position);
         
         // Update access info safely
-        it->second->second.IncrementAccess();
+        it->second.position->second.IncrementAccess();
         
-        value = it->second->second.data;
+        value = it->second.position->second.data;
         hits_.fetch_add(1);
         return true;
     }
@@ -111,7 +178,22 @@ public:
             return false;
         }
         
-        value = it->second->second.data;
+        value = it->second.position->second.data;
+        return true;
+    }
+
+    // Runs inspector on the cached value under the lock without copying it;
+    // returns false if the key is absent
+    template<typename Inspector>
+    bool Inspect(const Key& key, Inspector&& inspector) const {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+
+        auto it = cache_map_.find(key);
+        if (it == cache_map_.end()) {
+            return false;
+        }
+
+        inspector(static_cast<const Value&>(it->second.position->second.data));
         return true;
     }
     
@@ -122,25 +204,32 @@ public:
         auto it = cache_map_.find(key);
         if (it != cache_map_.end()) {
             // Update existing entry
-            it->second->second.data = value;
-            it->second->second.timestamp = std::chrono::steady_clock::now();
-            it->second->second.IncrementAccess();
+            auto& entry = it->second.position->second;
+            entry.data = value;
+            entry.timestamp = std::chrono::steady_clock::now();
+            entry.IncrementAccess();
+            Reschedule(it->second, entry.timestamp);
             
             // Move to front
-            cache_list_.splice(cache_list_.begin(), cache_list_, it->second);
+            cache_list_.splice(cache_list_.begin(), cache_list_, it->second.position);
             return;
         }
         
         // Add new entry
         cache_list_.emplace_front(key, CacheEntryType(value));
-        cache_map_[key] = cache_list_.begin();
+        size_t bucket = BucketFor(ToTick(cache_list_.front().second.timestamp));
+        auto& target = expiry_buckets_[bucket];
+        target.push_back(key);
+        cache_map_[key] = IndexEntry{cache_list_.begin(), bucket, std::prev(target.end())};
+        if (on_insert_) {
+            on_insert_(key);
+        }
         
         // Evict if necessary
         if (cache_list_.size() > max_size_) {
             auto last = cache_list_.end();
             --last;
-            cache_map_.erase(last->first);
-            cache_list_.pop_back();
+            EraseIndexed(cache_map_.find(last->first));
             evictions_.fetch_add(1);
         }
     }
@@ -154,8 +243,7 @@ public:
             return false;
         }
         
-        cache_list_.erase(it->second);
-        cache_map_.erase(it);
+        EraseIndexed(it);
         return true;
     }
     
@@ -168,25 +256,44 @@ public:
     // Clear all entries
     void Clear() {
         std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (on_erase_) {
+            for (const auto& pair : cache_list_) {
+                on_erase_(pair.first);
+            }
+        }
         cache_list_.clear();
         cache_map_.clear();
+        for (auto& bucket : expiry_buckets_) {
+            bucket.clear();
+        }
     }
     
-    // Cleanup expired entries
+    // Expire entries written more than max_age ago. Only buckets that have
+    // come due since the previous call are visited.
     void CleanupExpired(std::chrono::seconds max_age) {
         std::lock_guard<std::mutex> lock(cache_mutex_);
         
-        auto now = std::chrono::steady_clock::now();
-        auto it = cache_list_.begin();
-        
-        while (it != cache_list_.end()) {
-            if (now - it->second.timestamp > max_age) {
-                cache_map_.erase(it->first);
-                it = cache_list_.erase(it);
-            } else {
-                ++it;
+        auto cutoff = std::chrono::steady_clock::now() - max_age;
+        long long cutoff_tick = ToTick(cutoff);
+
+        // After a long gap every bucket may hold due entries, but each is
+        // still visited only once
+        long long first_tick = std::max(next_expiry_tick_, cutoff_tick - static_cast<long long>(EXPIRY_BUCKETS) + 1);
+        for (long long tick = first_tick; tick <= cutoff_tick; ++tick) {
+            auto& bucket = expiry_buckets_[BucketFor(tick)];
+            auto key_it = bucket.begin();
+            while (key_it != bucket.end()) {
+                auto it = cache_map_.find(*key_it);
+                ++key_it;
+                // Entries from a later lap of the wheel stay put
+                if (it->second.position->second.timestamp <= cutoff) {
+                    EraseIndexed(it);
+                }
             }
         }
+
+        // The cutoff bucket is only partly due, so it is revisited next time
+        next_expiry_tick_ = std::max(next_expiry_tick_, cutoff_tick);
     }
     
     // Statistics
@@ -223,10 +330,21 @@ public:
     }
 };
 
+// LRU keeps exact recency behind a mutex; SEQLOCK serves prices from a
+// fixed-capacity table whose reads never block (see SeqlockPriceTable).
+// In SEQLOCK mode, names the symbol or exchange registry had no room for
+// are kept in the LRU cache instead.
+enum class PriceCacheMode {
+    LRU,
+    SEQLOCK
+};
+
 // Specialized price cache for arbitrage system
 class PriceCache {
 private:
+    PriceCacheMode mode_;
     LRUCache<std::string, Price> price_cache_;
+    std::unique_ptr<SeqlockPriceTable> price_table_; // SEQLOCK mode only
     LRUCache<std::string, OrderBook> orderbook_cache_;
     
     // Configuration
@@ -238,10 +356,26 @@ private:
     std::atomic<bool> running_;
     std::condition_variable cleanup_cv_;
     std::mutex cleanup_mutex_;
+
+    // Secondary indexes over the LRU caches' composite keys, kept in step
+    // through the caches' key listeners
+    struct KeyIndex {
+        std::unordered_map<std::string, std::unordered_set<std::string>> exchanges_by_symbol;
+        std::unordered_map<std::string, std::unordered_set<std::string>> symbols_by_exchange;
+
+        void Add(const std::string& exchange, const std::string& symbol);
+        void Erase(const std::string& exchange, const std::string& symbol);
+    };
+    mutable std::mutex index_mutex_; // taken after a cache's own lock
+    KeyIndex price_index_;
+    KeyIndex orderbook_index_;
     
 public:
-    PriceCache(size_t max_prices = 1000, size_t max_orderbooks = 100);
+    PriceCache(size_t max_prices = 1000, size_t max_orderbooks = 100,
+               PriceCacheMode mode = PriceCacheMode::LRU);
     ~PriceCache();
+
+    PriceCacheMode GetMode() const { return mode_; }
     
     // Configuration
     void SetPriceTTL(std::chrono::seconds ttl) { price_ttl_ = ttl; }
@@ -249,6 +383,8 @@ public:
     
     // Price operations
     bool GetPrice(const std::string& exchange, const std::string& symbol, Price& price);
+    // Lock-free lookup by interned codes; SEQLOCK mode only
+    bool GetPrice(types::ExchangeCode exchange, types::SymbolCode symbol, CompactPrice& price) const;
     void SetPrice(const std::string& exchange, const std::string& symbol, const Price& price);
     bool IsPriceStale(const std::string& exchange, const std::string& symbol, 
                      std::chrono::seconds max_age) const;
@@ -271,9 +407,9 @@ public:
     void ForceCleanup();
     
     // Statistics and monitoring
-    size_t GetPriceCacheSize() const { return price_cache_.Size(); }
+    size_t GetPriceCacheSize() const { return price_table_ ? price_table_->Size() : price_cache_.Size(); }
     size_t GetOrderBookCacheSize() const { return orderbook_cache_.Size(); }
-    double GetPriceHitRate() const { return price_cache_.GetHitRate(); }
+    double GetPriceHitRate() const { return price_table_ ? price_table_->GetHitRate() : price_cache_.GetHitRate(); }
     double GetOrderBookHitRate() const { return orderbook_cache_.GetHitRate(); }
     
     // Memory usage estimation
@@ -282,6 +418,11 @@ public:
     
 private:
     std::string MakeKey(const std::string& exchange, const std::string& symbol) const;
+    static bool SplitKey(const std::string& key, std::string& exchange, std::string& symbol);
+    template<typename Value>
+    void AttachIndex(LRUCache<std::string, Value>& cache, KeyIndex& index);
+    std::vector<std::string> IndexedExchanges(const KeyIndex& index, const std::string& symbol) const;
+    std::vector<std::string> IndexedSymbols(const KeyIndex& index, const std::string& exchange) const;
     void CleanupLoop();
 };
 
@@ -293,7 +434,8 @@ private:
     
 public:
     static PriceCache& Instance();
-    static void Initialize(size_t max_prices = 1000, size_t max_orderbooks = 100);
+    static void Initialize(size_t max_prices = 1000, size_t max_orderbooks = 100,
+                           PriceCacheMode mode = PriceCacheMode::LRU);
     static void Cleanup();
 };
 
@@ -0,0 +1,441 @@
+#include "seqlock_price_table.hpp"
+#include <cstring>
+#include <thread>
+
+namespace ats {
+
+namespace {
+
+size_t RoundUpPow2(size_t n) {
+    size_t result = 2;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+uint64_t ToWord(double value) {
+    uint64_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    return word;
+}
+
+double FromWord(uint64_t word) {
+    double value;
+    std::memcpy(&value, &word, sizeof(value));
+    return value;
+}
+
+int64_t SteadyNowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Small dense per-thread index used to pick a statistics shard
+size_t ThreadIndex() {
+    static std::atomic<size_t> next_index{0};
+    thread_local size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} // namespace
+
+SeqlockPriceTable::SeqlockPriceTable(size_t max_entries)
+    : max_entries_(max_entries > 0 ? max_entries : 1),
+      mask_(RoundUpPow2(max_entries_ * 2) - 1), // keep load factor at or below 0.5
+      slots_(new Slot[mask_ + 1]),
+      stats_(new ThreadStats[STATS_SHARDS]) {}
+
+size_t SeqlockPriceTable::HashKey(uint32_t key) const {
+    // Fibonacci hashing spreads the packed (exchange, symbol) codes
+    return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+}
+
+SeqlockPriceTable::Slot* SeqlockPriceTable::FindSlot(uint32_t key) const {
+    size_t index = HashKey(key);
+    for (size_t probe = 0; probe <= mask_; ++probe) {
+        Slot& slot = slots_[(index + probe) & mask_];
+        uint32_t slot_key = slot.key.load(std::memory_order_acquire);
+        if (slot_key == key) {
+            return &slot;
+        }
+        if (slot_key == EMPTY_KEY) {
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+SeqlockPriceTable::Slot* SeqlockPriceTable::Lookup(uint32_t key, CompactPrice& price) const {
+    for (;;) {
+        uint32_t epoch = shift_epoch_.load(std::memory_order_acquire);
+        Slot* slot = FindSlot(key);
+        if (slot && ReadSlot(*slot, key, price, nullptr)) {
+            return slot;
+        }
+        // The entry may have been moved behind the probe; only trust a miss
+        // that no shift overlapped
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!(epoch & 1) && shift_epoch_.load(std::memory_order_relaxed) == epoch) {
+            return nullptr;
+        }
+        std::this_thread::yield();
+    }
+}
+
+bool SeqlockPriceTable::ReadSlot(const Slot& slot, uint32_t key, CompactPrice& price, int64_t* write_time) const {
+    std::array<uint64_t, PAYLOAD_WORDS> words;
+    for (;;) {
+        uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint32_t slot_key = slot.key.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < PAYLOAD_WORDS; ++i) {
+            words[i] = slot.payload[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+        if (slot_key != key) {
+            return false;
+        }
+        break;
+    }
+
+    price.bid = FromWord(words[0]);
+    price.ask = FromWord(words[1]);
+    price.last = FromWord(words[2]);
+    price.volume = FromWord(words[3]);
+    price.timestamp = static_cast<long long>(words[4]);
+    if (write_time) {
+        *write_time = static_cast<int64_t>(words[5]);
+    }
+    return true;
+}
+
+bool SeqlockPriceTable::TryLockSlot(Slot& slot) const {
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    if (sequence & 1) {
+        return false;
+    }
+    if (!slot.sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire)) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+}
+
+void SeqlockPriceTable::WriteSlot(Slot& slot, uint32_t key, const CompactPrice& price) const {
+    slot.key.store(key, std::memory_order_relaxed);
+    slot.payload[0].store(ToWord(price.bid), std::memory_order_relaxed);
+    slot.payload[1].store(ToWord(price.ask), std::memory_order_relaxed);
+    slot.payload[2].store(ToWord(price.last), std::memory_order_relaxed);
+    slot.payload[3].store(ToWord(price.volume), std::memory_order_relaxed);
+    slot.payload[4].store(static_cast<uint64_t>(price.timestamp), std::memory_order_relaxed);
+    slot.payload[5].store(static_cast<uint64_t>(SteadyNowNanos()), std::memory_order_relaxed);
+}
+
+void SeqlockPriceTable::UnlockSlot(Slot& slot) const {
+    slot.sequence.fetch_add(1, std::memory_order_release);
+}
+
+bool SeqlockPriceTable::Get(types::ExchangeCode exchange, types::SymbolCode symbol, CompactPrice& price) const {
+    uint32_t key = MakeKey(exchange, symbol);
+    if (Slot* slot = Lookup(key, price)) {
+        if (slot->referenced.load(std::memory_order_relaxed) == 0) {
+            slot->referenced.store(1, std::memory_order_relaxed);
+        }
+        LocalStats().hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    LocalStats().misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool SeqlockPriceTable::Peek(types::ExchangeCode exchange, types::SymbolCode symbol, CompactPrice& price) const {
+    return Lookup(MakeKey(exchange, symbol), price) != nullptr;
+}
+
+void SeqlockPriceTable::Put(types::ExchangeCode exchange, types::SymbolCode symbol, const CompactPrice& price) {
+    uint32_t key = MakeKey(exchange, symbol);
+
+    // Fast path: overwrite an existing entry without the structural lock
+    if (Slot* slot = FindSlot(key)) {
+        while (!TryLockSlot(*slot)) {
+            std::this_thread::yield();
+        }
+        if (slot->key.load(std::memory_order_relaxed) == key) {
+            WriteSlot(*slot, key, price);
+            slot->referenced.store(1, std::memory_order_relaxed);
+            UnlockSlot(*slot);
+            return;
+        }
+        UnlockSlot(*slot); // evicted while we were looking
+    }
+
+    std::lock_guard<std::mutex> lock(structural_mutex_);
+
+    // Re-probe under the lock: another writer may have inserted the key.
+    // Shifts only run under this lock, so the probe sees the whole chain.
+    Slot* target = FindSlot(key);
+    bool inserting = target == nullptr;
+    if (inserting) {
+        // Evict before choosing a slot: the shift that follows an eviction
+        // can open an empty slot earlier in this key's probe chain
+        if (size_.load(std::memory_order_relaxed) >= max_entries_) {
+            EvictOne();
+        }
+        size_t index = HashKey(key);
+        for (size_t probe = 0; probe <= mask_; ++probe) {
+            Slot& slot = slots_[(index + probe) & mask_];
+            if (slot.key.load(std::memory_order_relaxed) == EMPTY_KEY) {
+                target = &slot;
+                break;
+            }
+        }
+        if (!target) {
+            return; // unreachable while the load factor stays below one
+        }
+    }
+
+    while (!TryLockSlot(*target)) {
+        std::this_thread::yield();
+    }
+    WriteSlot(*target, key, price);
+    target->referenced.store(1, std::memory_order_relaxed);
+    UnlockSlot(*target);
+
+    if (inserting) {
+        size_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool SeqlockPriceTable::Remove(types::ExchangeCode exchange, types::SymbolCode symbol) {
+    uint32_t key = MakeKey(exchange, symbol);
+    std::lock_guard<std::mutex> lock(structural_mutex_);
+    Slot* slot = FindSlot(key);
+    if (!slot) {
+        return false;
+    }
+    EvictSlot(*slot);
+    return true;
+}
+
+size_t SeqlockPriceTable::RemoveExchange(types::ExchangeCode exchange) {
+    return RemoveMatching([exchange](uint32_t key) { return (key >> 16) == exchange; });
+}
+
+size_t SeqlockPriceTable::RemoveSymbol(types::SymbolCode symbol) {
+    return RemoveMatching([symbol](uint32_t key) { return (key & 0xFFFFu) == symbol; });
+}
+
+template <typename Predicate>
+size_t SeqlockPriceTable::RemoveMatching(Predicate matches) {
+    std::lock_guard<std::mutex> lock(structural_mutex_);
+    size_t removed = 0;
+    for (size_t i = 0; i <= mask_; ++i) {
+        Slot& slot = slots_[i];
+        uint32_t key = slot.key.load(std::memory_order_acquire);
+        if (key == EMPTY_KEY || key == TOMBSTONE_KEY || !matches(key)) {
+            continue;
+        }
+        EvictSlot(slot);
+        ++removed;
+        --i; // the shift may have moved another entry into this slot
+    }
+    return removed;
+}
+
+void SeqlockPriceTable::Clear() {
+    std::lock_guard<std::mutex> lock(structural_mutex_);
+    for (size_t i = 0; i <= mask_; ++i) {
+        Slot& slot = slots_[i];
+        if (slot.key.load(std::memory_order_relaxed) == EMPTY_KEY) {
+            continue;
+        }
+        while (!TryLockSlot(slot)) {
+            std::this_thread::yield();
+        }
+        slot.key.store(EMPTY_KEY, std::memory_order_relaxed);
+        slot.referenced.store(0, std::memory_order_relaxed);
+        UnlockSlot(slot);
+    }
+    size_.store(0, std::memory_order_relaxed);
+    clock_hand_ = 0;
+}
+
+void SeqlockPriceTable::CleanupExpired(std::chrono::seconds max_age) {
+    std::lock_guard<std::mutex> lock(structural_mutex_);
+    int64_t cutoff = SteadyNowNanos() - std::chrono::duration_cast<std::chrono::nanoseconds>(max_age).count();
+
+    for (size_t i = 0; i <= mask_; ++i) {
+        Slot& slot = slots_[i];
+        uint32_t key = slot.key.load(std::memory_order_acquire);
+        if (key == EMPTY_KEY || key == TOMBSTONE_KEY) {
+            continue;
+        }
+        CompactPrice price;
+        int64_t write_time = 0;
+        if (ReadSlot(slot, key, price, &write_time) && write_time < cutoff) {
+            EvictSlot(slot);
+            --i; // the shift may have moved another entry into this slot
+        }
+    }
+}
+
+std::vector<SeqlockPriceTable::Entry> SeqlockPriceTable::Snapshot() const {
+    std::vector<Entry> entries;
+    entries.reserve(Size());
+
+    // A shift during the scan could show an entry twice or not at all
+    uint32_t epoch;
+    do {
+        epoch = shift_epoch_.load(std::memory_order_acquire);
+        entries.clear();
+        CollectEntries(entries);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((epoch & 1) || shift_epoch_.load(std::memory_order_relaxed) != epoch);
+    return entries;
+}
+
+void SeqlockPriceTable::CollectEntries(std::vector<Entry>& entries) const {
+    for (size_t i = 0; i <= mask_; ++i) {
+        const Slot& slot = slots_[i];
+        uint32_t key = slot.key.load(std::memory_order_acquire);
+        if (key == EMPTY_KEY || key == TOMBSTONE_KEY) {
+            continue;
+        }
+        Entry entry;
+        if (ReadSlot(slot, key, entry.price, nullptr)) {
+            entry.exchange = static_cast<types::ExchangeCode>(key >> 16);
+            entry.symbol = static_cast<types::SymbolCode>(key & 0xFFFF);
+            entries.push_back(entry);
+        }
+    }
+}
+
+void SeqlockPriceTable::EvictSlot(Slot& slot) {
+    shift_epoch_.store(shift_epoch_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // The hole is a tombstone while the shift runs, so probes that pass it
+    // keep going and find the entries not yet moved
+    while (!TryLockSlot(slot)) {
+        std::this_thread::yield();
+    }
+    slot.key.store(TOMBSTONE_KEY, std::memory_order_relaxed);
+    slot.referenced.store(0, std::memory_order_relaxed);
+    UnlockSlot(slot);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+
+    // Pull back each later entry of the chain whose home does not lie
+    // between the hole and its own slot, then end the chain at the last hole
+    size_t hole = static_cast<size_t>(&slot - slots_.get());
+    for (size_t index = (hole + 1) & mask_; index != hole; index = (index + 1) & mask_) {
+        Slot& candidate = slots_[index];
+        uint32_t key = candidate.key.load(std::memory_order_relaxed);
+        if (key == EMPTY_KEY) {
+            break;
+        }
+        size_t home = HashKey(key);
+        if (((index - home) & mask_) >= ((index - hole) & mask_)) {
+            MoveSlot(candidate, slots_[hole]);
+            hole = index;
+        }
+    }
+
+    Slot& last = slots_[hole];
+    while (!TryLockSlot(last)) {
+        std::this_thread::yield();
+    }
+    last.key.store(EMPTY_KEY, std::memory_order_relaxed);
+    UnlockSlot(last);
+
+    shift_epoch_.store(shift_epoch_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void SeqlockPriceTable::MoveSlot(Slot& from, Slot& to) {
+    // Holding the source's lock throughout keeps a lock-free update of the
+    // entry from landing after the copy. For a moment both slots hold the key;
+    // lookups and updates find the destination first.
+    while (!TryLockSlot(from)) {
+        std::this_thread::yield();
+    }
+    while (!TryLockSlot(to)) {
+        std::this_thread::yield();
+    }
+    to.key.store(from.key.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    for (size_t i = 0; i < PAYLOAD_WORDS; ++i) {
+        to.payload[i].store(from.payload[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    to.referenced.store(from.referenced.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    UnlockSlot(to);
+
+    from.key.store(TOMBSTONE_KEY, std::memory_order_relaxed);
+    from.referenced.store(0, std::memory_order_relaxed);
+    UnlockSlot(from);
+}
+
+void SeqlockPriceTable::EvictOne() {
+    // CLOCK sweep: clear reference bits until an unreferenced entry turns up.
+    // Two passes always suffice since the first clears every bit it visits.
+    for (size_t step = 0; step <= 2 * (mask_ + 1); ++step) {
+        Slot& slot = slots_[clock_hand_];
+        clock_hand_ = (clock_hand_ + 1) & mask_;
+
+        uint32_t key = slot.key.load(std::memory_order_relaxed);
+        if (key == EMPTY_KEY || key == TOMBSTONE_KEY) {
+            continue;
+        }
+        if (slot.referenced.load(std::memory_order_relaxed) != 0) {
+            slot.referenced.store(0, std::memory_order_relaxed);
+            continue;
+        }
+
+        EvictSlot(slot);
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+}
+
+SeqlockPriceTable::ThreadStats& SeqlockPriceTable::LocalStats() const {
+    return stats_[ThreadIndex() % STATS_SHARDS];
+}
+
+long long SeqlockPriceTable::GetHits() const {
+    long long total = 0;
+    for (size_t i = 0; i < STATS_SHARDS; ++i) {
+        total += stats_[i].hits.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+long long SeqlockPriceTable::GetMisses() const {
+    long long total = 0;
+    for (size_t i = 0; i < STATS_SHARDS; ++i) {
+        total += stats_[i].misses.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+double SeqlockPriceTable::GetHitRate() const {
+    long long hits = GetHits();
+    long long total = hits + GetMisses();
+    return total > 0 ? static_cast<double>(hits) / total * 100.0 : 0.0;
+}
+
+void SeqlockPriceTable::ResetStatistics() {
+    for (size_t i = 0; i < STATS_SHARDS; ++i) {
+        stats_[i].hits.store(0, std::memory_order_relaxed);
+        stats_[i].misses.store(0, std::memory_order_relaxed);
+    }
+    evictions_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace ats
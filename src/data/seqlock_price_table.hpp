@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "../core/types.hpp"
+
+namespace ats {
+
+// Read-optimized price table keyed by (exchange, symbol) codes.
+//
+// Fixed-capacity open addressing with linear probing; every slot is guarded by
+// a seqlock so readers never block and never take a lock. Updates to an
+// existing key are lock-free as well; only inserting a new key or evicting one
+// takes the structural mutex. Recency is tracked with a CLOCK reference bit
+// that readers set only when it is clear, so hot keys do not keep dirtying
+// their slot's cache line.
+//
+// Removal uses backward-shift deletion, so no tombstones accumulate and probe
+// chains stay as short as the load factor allows. A lookup that misses while
+// a shift is moving entries retries once the shift is done.
+class SeqlockPriceTable {
+public:
+    struct Entry {
+        types::ExchangeCode exchange;
+        types::SymbolCode symbol;
+        CompactPrice price;
+    };
+
+    explicit SeqlockPriceTable(size_t max_entries);
+
+    SeqlockPriceTable(const SeqlockPriceTable&) = delete;
+    SeqlockPriceTable& operator=(const SeqlockPriceTable&) = delete;
+
+    bool Get(types::ExchangeCode exchange, types::SymbolCode symbol, CompactPrice& price) const;
+    // Like Get but leaves statistics and recency untouched
+    bool Peek(types::ExchangeCode exchange, types::SymbolCode symbol, CompactPrice& price) const;
+    void Put(types::ExchangeCode exchange, types::SymbolCode symbol, const CompactPrice& price);
+    bool Remove(types::ExchangeCode exchange, types::SymbolCode symbol);
+    // Remove every entry of one exchange or one symbol in a single pass over
+    // the occupied slots; return the number removed
+    size_t RemoveExchange(types::ExchangeCode exchange);
+    size_t RemoveSymbol(types::SymbolCode symbol);
+    void Clear();
+
+    // Evicts entries written longer than max_age ago
+    void CleanupExpired(std::chrono::seconds max_age);
+
+    // Consistent per-entry copy of the table contents
+    std::vector<Entry> Snapshot() const;
+
+    size_t Size() const { return size_.load(std::memory_order_relaxed); }
+    size_t Capacity() const { return max_entries_; }
+
+    // Statistics, aggregated across the per-thread counters on read
+    double GetHitRate() const;
+    long long GetHits() const;
+    long long GetMisses() const;
+    long long GetEvictions() const { return evictions_.load(std::memory_order_relaxed); }
+    void ResetStatistics();
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t STATS_SHARDS = 64;
+    static constexpr uint32_t EMPTY_KEY = 0xFFFFFFFFu;
+    static constexpr uint32_t TOMBSTONE_KEY = 0xFFFFFFFEu;
+
+    // Payload words: bid, ask, last, volume, timestamp, write time (steady ns)
+    static constexpr size_t PAYLOAD_WORDS = 6;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint32_t> sequence{0}; // odd while a writer owns the slot
+        std::atomic<uint32_t> key{EMPTY_KEY};
+        std::atomic<uint8_t> referenced{0};
+        std::array<std::atomic<uint64_t>, PAYLOAD_WORDS> payload{};
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ThreadStats {
+        std::atomic<long long> hits{0};
+        std::atomic<long long> misses{0};
+    };
+
+    static uint32_t MakeKey(types::ExchangeCode exchange, types::SymbolCode symbol) {
+        return (static_cast<uint32_t>(exchange) << 16) | symbol;
+    }
+
+    size_t HashKey(uint32_t key) const;
+    Slot* FindSlot(uint32_t key) const;
+    // FindSlot plus ReadSlot, retried when a backward shift overlaps a miss
+    Slot* Lookup(uint32_t key, CompactPrice& price) const;
+
+    // Seqlock primitives; ReadSlot returns false if the slot no longer holds key
+    bool ReadSlot(const Slot& slot, uint32_t key, CompactPrice& price, int64_t* write_time) const;
+    bool TryLockSlot(Slot& slot) const;
+    void WriteSlot(Slot& slot, uint32_t key, const CompactPrice& price) const;
+    void UnlockSlot(Slot& slot) const;
+
+    void CollectEntries(std::vector<Entry>& entries) const;
+
+    template <typename Predicate>
+    size_t RemoveMatching(Predicate matches);
+
+    // Callers hold structural_mutex_. EvictSlot fills the hole by shifting
+    // later entries of the probe chain back; tombstones exist only while it runs.
+    void EvictSlot(Slot& slot);
+    void EvictOne();
+    void MoveSlot(Slot& from, Slot& to);
+
+    ThreadStats& LocalStats() const;
+
+    size_t max_entries_;
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> size_{0};
+
+    std::mutex structural_mutex_;
+    size_t clock_hand_ = 0;
+    std::atomic<uint32_t> shift_epoch_{0}; // odd while EvictSlot moves entries
+
+    std::unique_ptr<ThreadStats[]> stats_;
+    std::atomic<long long> evictions_{0};
+};
+
+} // namespace ats
@@ -1,9 +1,25 @@
 #include "exchange_interface.hpp"
+#include "../utils/logger.hpp"
+#include <exception>
 
 namespace ats {
 
-ExchangeInterface::ExchangeInterface(const ExchangeConfig& config, AppState* app_state) {
+ExchangeInterface::ExchangeInterface(const ExchangeConfig& /*config*/, AppState* /*app_state*/) {
     // Constructor implementation
 }
 
+std::vector<Price> ExchangeInterface::get_prices(const std::vector<std::string>& symbols) {
+    std::vector<Price> prices;
+    prices.reserve(symbols.size());
+    for (const auto& symbol : symbols) {
+        // One failing symbol must not discard the prices already fetched
+        try {
+            prices.push_back(get_price(symbol));
+        } catch (const std::exception& e) {
+            Logger::error("Error getting price for " + symbol + " from " + get_name() + ": " + e.what());
+        }
+    }
+    return prices;
+}
+
 }
\ No newline at end of file
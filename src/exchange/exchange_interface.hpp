@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
 #include "../core/types.hpp"
 #include "../utils/config_types.hpp"
 
@@ -20,6 +21,18 @@ public:
     virtual void disconnect() = 0;
     virtual Price get_price(const std::string& symbol) = 0;
     virtual OrderResult place_order(const Order& order) = 0;
+
+    // Optional streaming tickers. Exchanges that support them override both
+    // methods; the callback is invoked from the exchange's feed thread.
+    using PriceCallback = std::function<void(const Price& price)>;
+    virtual bool supports_price_stream() const { return false; }
+    virtual bool subscribe_prices(const std::vector<std::string>& /*symbols*/, PriceCallback /*callback*/) { return false; }
+    virtual void unsubscribe_prices() {}
+
+    // Prices for several symbols in one call. Exchanges with an "all tickers"
+    // REST endpoint override this; the default falls back to get_price and
+    // returns the symbols that succeeded, logging the others.
+    virtual std::vector<Price> get_prices(const std::vector<std::string>& symbols);
 };
 
 }
@@ -18,20 +18,19 @@
 #include "exchange/exchange_factory.hpp"
 #include "monitoring/health_check.hpp"
 #include "monitoring/system_monitor.hpp"
-#include "core/event_loop.hpp"
+#include "core/sharded_event_loop.hpp"
 
 // Global application state
 ats::AppState app_state;
-std::unique_ptr<ats::EventLoop> event_loop_ptr = nullptr;
+std::unique_ptr<ats::ShardedEventLoop> event_loop_ptr = nullptr;
 
-// Signal handler for graceful shutdown
+volatile std::sig_atomic_t shutdown_requested = 0;
+
+// Signal handler for graceful shutdown. Only async-signal-safe work is
+// allowed here; the shutdown watcher in main() does the rest.
 void signal_handler(int signal) {
     if (signal == SIGINT || signal == SIGTERM) {
-        ats::Logger::info("Shutdown signal received. Initiating graceful shutdown...");
-        app_state.shutdown();
-        if (event_loop_ptr) {
-            event_loop_ptr->stop();
-        }
+        shutdown_requested = 1;
     }
 }
 
@@ -63,7 +62,8 @@ int main(int argc, char* argv[]) {
     ats::Logger::info("Starting ATS-V3...");
 
     // Initialize application components
-    auto db_manager = std::make_unique<ats::DatabaseManager>(config_manager.get_database_config().path);
+    auto db_manager = std::make_unique<ats::DatabaseManager>(config_manager.get_database_config().path,
+                                                           config_manager.get_trade_store_settings());
     if (!db_manager->Open()) {
         ats::Logger::error("Failed to open database. Exiting.");
         return 1;
@@ -94,7 +94,21 @@ int main(int argc, char* argv[]) {
     auto system_monitor = std::make_unique<ats::SystemMonitor>();
 
     // Initialize event loop
-    event_loop_ptr = std::make_unique<ats::EventLoop>(opportunity_detector.get(), arbitrage_engine.get());
+    const auto& event_loop_settings = config_manager.get_event_loop_settings();
+    ats::ShardedEventLoopConfig event_loop_config;
+    event_loop_config.shard_count = event_loop_settings.shard_count;
+    event_loop_config.pin_to_cores = event_loop_settings.pin_to_cores;
+    event_loop_config.first_core = event_loop_settings.first_core;
+    event_loop_config.loop_config.queue_capacity = event_loop_settings.queue_capacity;
+    event_loop_config.loop_config.max_batch_size = event_loop_settings.max_batch_size;
+    event_loop_config.loop_config.cross_shard_overflow_capacity = event_loop_settings.cross_shard_overflow_capacity;
+    event_loop_config.loop_config.conflate_price_updates = event_loop_settings.conflate_price_updates;
+    event_loop_config.loop_config.wait_strategy.spin_iterations = event_loop_settings.spin_iterations;
+    event_loop_config.loop_config.wait_strategy.yield_iterations = event_loop_settings.yield_iterations;
+    event_loop_config.loop_config.wait_strategy.park_timeout =
+        std::chrono::microseconds(event_loop_settings.park_timeout_us);
+    event_loop_config.metrics_interval = std::chrono::milliseconds(event_loop_settings.metrics_interval_ms);
+    event_loop_ptr = std::make_unique<ats::ShardedEventLoop>(opportunity_detector.get(), arbitrage_engine.get(), event_loop_config);
 
     // Set up dependencies
     price_monitor->set_event_pusher(event_loop_ptr.get());
@@ -102,22 +116,41 @@ int main(int argc, char* argv[]) {
 
     // Start all components in separate threads
     std::vector<std::thread> threads;
-    threads.emplace_back([&]() {
-        while (app_state.is_running()) {
-            price_monitor->check_prices();
-            std::this_thread::sleep_for(std::chrono::milliseconds(config_manager.get_arbitrage_config().price_update_interval_ms));
-        }
-    });
+    if (config_manager.get_price_monitor_settings().push_driven) {
+        price_monitor->start();
+    } else {
+        threads.emplace_back([&]() {
+            while (app_state.is_running()) {
+                price_monitor->check_prices();
+                std::this_thread::sleep_for(std::chrono::milliseconds(config_manager.get_arbitrage_config().price_update_interval_ms));
+            }
+        });
+    }
     threads.emplace_back([&]() { health_check->Start(); });
     threads.emplace_back([&]() { system_monitor->Start(); });
 
+    // Turns a shutdown signal, or a shutdown from anywhere else, into a stop
+    // of the event loop on an ordinary thread
+    std::thread shutdown_watcher([&]() {
+        while (!shutdown_requested && app_state.is_running()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        if (shutdown_requested) {
+            ats::Logger::info("Shutdown signal received. Initiating graceful shutdown...");
+        }
+        app_state.shutdown();
+        event_loop_ptr->stop();
+    });
+
     ats::Logger::info("ATS-V3 is running.");
 
     // Start the event loop
     event_loop_ptr->run();
+    shutdown_watcher.join();
 
     // Stop all components
     ats::Logger::info("Stopping all components...");
+    price_monitor->stop();
     health_check->Stop();
     system_monitor->Stop();
 
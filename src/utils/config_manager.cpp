@@ -45,6 +45,15 @@ bool ConfigManager::load(const std::string& file_path) {
         if (config_data_.contains("logging")) {
             config_data_["logging"].get_to(logging_config_);
         }
+        if (config_data_.contains("event_loop")) {
+            config_data_["event_loop"].get_to(event_loop_settings_);
+        }
+        if (config_data_.contains("price_monitor")) {
+            config_data_["price_monitor"].get_to(price_monitor_settings_);
+        }
+        if (config_data_.contains("trade_store")) {
+            config_data_["trade_store"].get_to(trade_store_settings_);
+        }
 
     } catch (const nlohmann::json::exception& e) {
         Logger::error("Error parsing config file: " + std::string(e.what()));
@@ -89,4 +98,16 @@ LoggingConfig& ConfigManager::get_logging_config() {
     return logging_config_;
 }
 
+EventLoopSettings& ConfigManager::get_event_loop_settings() {
+    return event_loop_settings_;
+}
+
+PriceMonitorSettings& ConfigManager::get_price_monitor_settings() {
+    return price_monitor_settings_;
+}
+
+TradeStoreSettings& ConfigManager::get_trade_store_settings() {
+    return trade_store_settings_;
+}
+
 } 
@@ -21,6 +21,9 @@ public:
     AlertsConfig& get_alerts_config();
     DatabaseConfig& get_database_config();
     LoggingConfig& get_logging_config();
+    EventLoopSettings& get_event_loop_settings();
+    PriceMonitorSettings& get_price_monitor_settings();
+    TradeStoreSettings& get_trade_store_settings();
 
 private:
     nlohmann::json config_data_; // Keep for initial parsing
@@ -33,6 +36,9 @@ private:
     AlertsConfig alerts_config_;
     DatabaseConfig database_config_;
     LoggingConfig logging_config_;
+    EventLoopSettings event_loop_settings_;
+    PriceMonitorSettings price_monitor_settings_;
+    TradeStoreSettings trade_store_settings_;
 };
 
 } 
\ No newline at end of file
@@ -106,4 +106,34 @@ struct LoggingConfig {
 };
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(LoggingConfig, file_path, max_file_size_mb, max_backup_files, console_output, file_output)
 
+struct EventLoopSettings {
+    size_t queue_capacity = 8192;
+    size_t max_batch_size = 256;
+    size_t cross_shard_overflow_capacity = 8192; // Events from other shards held while a ring is full
+    bool conflate_price_updates = false;
+    size_t shard_count = 1;
+    bool pin_to_cores = false;
+    size_t first_core = 0;
+    size_t spin_iterations = 2000;     // Busy-wait polls before yielding
+    size_t yield_iterations = 100;     // Yielding polls before parking
+    int park_timeout_us = 1000;        // Longest a parked consumer sleeps between checks
+    int metrics_interval_ms = 10000;   // Queue metrics log period; 0 disables
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(EventLoopSettings, queue_capacity, max_batch_size, cross_shard_overflow_capacity, conflate_price_updates, shard_count, pin_to_cores, first_core, spin_iterations, yield_iterations, park_timeout_us, metrics_interval_ms)
+
+struct PriceMonitorSettings {
+    bool push_driven = false;          // Stream where supported, concurrent REST otherwise
+    int rest_poll_interval_ms = 100;
+    size_t rest_fanout_threads = 0;    // 0 = one per REST-polled exchange
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(PriceMonitorSettings, push_driven, rest_poll_interval_ms, rest_fanout_threads)
+
+struct TradeStoreSettings {
+    bool async_writes = false;         // Queue trades for a background group-commit writer
+    size_t max_batch_size = 256;       // Trades per transaction
+    int flush_interval_ms = 20;        // Longest a queued trade waits for its batch
+    size_t queue_capacity = 65536;     // Producers block once this many trades are pending
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(TradeStoreSettings, async_writes, max_batch_size, flush_interval_ms, queue_capacity)
+
 } // namespace ats
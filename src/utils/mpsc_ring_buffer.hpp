@@ -0,0 +1,233 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ats {
+
+// How a consumer waits for data: busy-spin first, then yield, then park on
+// a condition variable until a producer signals
+struct WaitStrategy {
+    size_t spin_iterations = 2000;
+    size_t yield_iterations = 100;
+    std::chrono::microseconds park_timeout{1000};
+};
+
+// Bounded lock-free multi-producer/single-consumer ring buffer.
+// Producers claim slots with a CAS on the tail; each slot carries a sequence
+// number so the consumer can tell when a claimed slot has been published.
+template <typename T>
+class MpscRingBuffer {
+public:
+    explicit MpscRingBuffer(size_t capacity = 8192, WaitStrategy wait_strategy = {})
+        : capacity_(round_up_pow2(capacity)),
+          mask_(capacity_ - 1),
+          slots_(new Slot[capacity_]),
+          wait_strategy_(wait_strategy) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    // Returns false if the ring is full; value is only moved from on success
+    bool try_push(T&& value) {
+        return try_push_moved(value);
+    }
+
+    // Applies backpressure to the producer while the ring is full: spins, then
+    // yields between attempts. Must not be called from the consumer thread,
+    // which is the only thread that can make room.
+    void push(T value) {
+        size_t attempts = 0;
+        while (!try_push_moved(value)) {
+            if (++attempts < wait_strategy_.spin_iterations) {
+                continue;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Consumer side only
+    bool try_pop(T& value) {
+        size_t pos = head_.value.load(std::memory_order_relaxed);
+        Slot& slot = slots_[pos & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+
+        value = std::move(slot.value);
+        slot.sequence.store(pos + capacity_, std::memory_order_release);
+        head_.value.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer side only. Appends up to max_batch published items to out and
+    // returns the number drained; head is advanced once for the whole batch.
+    size_t drain(std::vector<T>& out, size_t max_batch) {
+        size_t pos = head_.value.load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (count < max_batch) {
+            Slot& slot = slots_[(pos + count) & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + count + 1) {
+                break;
+            }
+            out.push_back(std::move(slot.value));
+            slot.sequence.store(pos + count + capacity_, std::memory_order_release);
+            ++count;
+        }
+        if (count > 0) {
+            head_.value.store(pos + count, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    // Consumer side only. Blocks according to the wait strategy until data is
+    // available or keep_waiting becomes false; returns true if data is ready.
+    bool wait_for_data(const std::atomic<bool>& keep_waiting) {
+        for (size_t i = 0; i < wait_strategy_.spin_iterations; ++i) {
+            if (has_data() || !keep_waiting.load(std::memory_order_relaxed)) {
+                return has_data();
+            }
+        }
+        for (size_t i = 0; i < wait_strategy_.yield_iterations; ++i) {
+            if (has_data() || !keep_waiting.load(std::memory_order_relaxed)) {
+                return has_data();
+            }
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        while (!has_data() && keep_waiting.load(std::memory_order_relaxed)) {
+            consumer_parked_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (has_data()) {
+                break;
+            }
+            park_condition_.wait_for(lock, wait_strategy_.park_timeout);
+        }
+        consumer_parked_.store(false, std::memory_order_relaxed);
+        return has_data();
+    }
+
+    // Wakes a parked consumer, e.g. on shutdown
+    void notify() {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        park_condition_.notify_one();
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    // Approximate when producers are active
+    size_t size() const {
+        size_t tail = tail_.value.load(std::memory_order_acquire);
+        size_t head = head_.value.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    size_t high_water_mark() const {
+        return high_water_mark_.value.load(std::memory_order_relaxed);
+    }
+
+    void reset_high_water_mark() {
+        high_water_mark_.value.store(size(), std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    struct alignas(CACHE_LINE_SIZE) PaddedIndex {
+        std::atomic<size_t> value{0};
+    };
+
+    static size_t round_up_pow2(size_t n) {
+        size_t result = 2;
+        while (result < n) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // Moves from value only once a slot has been claimed
+    bool try_push_moved(T& value) {
+        size_t pos = tail_.value.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.value.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::move(value);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        update_high_water_mark(pos + 1);
+        notify_if_parked();
+        return true;
+    }
+
+    bool has_data() const {
+        size_t pos = head_.value.load(std::memory_order_relaxed);
+        return slots_[pos & mask_].sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    void update_high_water_mark(size_t published_tail) {
+        size_t head = head_.value.load(std::memory_order_relaxed);
+        if (published_tail <= head) {
+            return;
+        }
+        size_t depth = published_tail - head;
+        size_t current = high_water_mark_.value.load(std::memory_order_relaxed);
+        while (depth > current &&
+               !high_water_mark_.value.compare_exchange_weak(current, depth, std::memory_order_relaxed)) {
+        }
+    }
+
+    void notify_if_parked() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer_parked_.load(std::memory_order_relaxed)) {
+            notify();
+        }
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    WaitStrategy wait_strategy_;
+
+    PaddedIndex head_;            // Consumer-owned
+    PaddedIndex tail_;            // Shared by producers
+    PaddedIndex high_water_mark_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> consumer_parked_{false};
+    std::mutex park_mutex_;
+    std::condition_variable park_condition_;
+};
+
+}
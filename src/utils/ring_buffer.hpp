@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ats {
+
+// Fixed-capacity circular buffer that overwrites its oldest element when
+// full. Not thread-safe; callers provide their own synchronization.
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 0) : buffer_(capacity) {}
+
+    void push(const T& value) {
+        emplace(value);
+    }
+
+    void push(T&& value) {
+        emplace(std::move(value));
+    }
+
+    // Index 0 is the oldest element
+    const T& operator[](size_t index) const {
+        return buffer_[(head_ + index) % buffer_.size()];
+    }
+
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return buffer_.size(); }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == buffer_.size(); }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // Keeps the newest elements that still fit
+    void set_capacity(size_t capacity) {
+        if (capacity == buffer_.size()) {
+            return;
+        }
+        size_t keep = size_ < capacity ? size_ : capacity;
+        std::vector<T> resized(capacity);
+        for (size_t i = 0; i < keep; ++i) {
+            resized[i] = std::move(buffer_[(head_ + size_ - keep + i) % buffer_.size()]);
+        }
+        buffer_ = std::move(resized);
+        head_ = 0;
+        size_ = keep;
+    }
+
+private:
+    template <typename U>
+    void emplace(U&& value) {
+        if (buffer_.empty()) {
+            return;
+        }
+        if (size_ < buffer_.size()) {
+            buffer_[(head_ + size_) % buffer_.size()] = std::forward<U>(value);
+            ++size_;
+        } else {
+            buffer_[head_] = std::forward<U>(value);
+            head_ = (head_ + 1) % buffer_.size();
+        }
+    }
+
+    std::vector<T> buffer_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+}
@@ -2,6 +2,56 @@
 
 namespace ats {
 
+namespace {
+
+// Identifies the pool and worker the calling thread belongs to, so tasks
+// submitted from inside a task land on the submitting worker's own deque
+thread_local const void* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+
+} // namespace
+
+void ThreadPool::WorkDeque::push(Task&& task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count_ == buffer_.size()) {
+        grow();
+    }
+    buffer_[(head_ + count_) & (buffer_.size() - 1)] = std::move(task);
+    ++count_;
+}
+
+bool ThreadPool::WorkDeque::pop_back(Task& task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count_ == 0) {
+        return false;
+    }
+    --count_;
+    task = std::move(buffer_[(head_ + count_) & (buffer_.size() - 1)]);
+    return true;
+}
+
+bool ThreadPool::WorkDeque::pop_front(Task& task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count_ == 0) {
+        return false;
+    }
+    task = std::move(buffer_[head_]);
+    head_ = (head_ + 1) & (buffer_.size() - 1);
+    --count_;
+    return true;
+}
+
+void ThreadPool::WorkDeque::grow() {
+    // Capacity stays a power of two; growth is amortized so steady-state
+    // pushes do not allocate
+    std::vector<Task> grown(buffer_.empty() ? 64 : buffer_.size() * 2);
+    for (size_t i = 0; i < count_; ++i) {
+        grown[i] = std::move(buffer_[(head_ + i) & (buffer_.size() - 1)]);
+    }
+    buffer_ = std::move(grown);
+    head_ = 0;
+}
+
 ThreadPool::ThreadPool(size_t num_threads) {
     if (num_threads == 0) {
         num_threads = std::thread::hardware_concurrency();
@@ -10,9 +60,14 @@ ThreadPool::ThreadPool(size_t num_threads) {
         }
     }
 
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+
     threads_.reserve(num_threads);
     for (size_t i = 0; i < num_threads; ++i) {
-        threads_.emplace_back(&ThreadPool::worker_thread, this);
+        threads_.emplace_back(&ThreadPool::worker_thread, this, i);
     }
 }
 
@@ -20,60 +75,115 @@ ThreadPool::~ThreadPool() {
     shutdown();
 }
 
-void ThreadPool::worker_thread() {
-    while (!stop_) {
-        Task task;
-        
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
-            
-            if (stop_ && tasks_.empty()) {
-                return;
+void ThreadPool::enqueue(Task&& task, Lane lane) {
+    size_t target = current_pool == this
+        ? current_worker
+        : next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+
+    // Count the task before it becomes visible: a worker already scanning
+    // this lane may pop it immediately, and its decrements must never run
+    // ahead of these increments or pending_ wraps and wait_for_all misses
+    // the final notification
+    lane_pending_[lane].fetch_add(1, std::memory_order_seq_cst);
+    pending_.fetch_add(1, std::memory_order_seq_cst);
+    workers_[target]->lanes[lane].push(std::move(task));
+
+    // Pairs with the sleepers_ increment in worker_thread: either the worker
+    // sees the new pending count or we see it parked and wake it
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+        { std::lock_guard<std::mutex> lock(idle_mutex_); }
+        condition_.notify_one();
+    }
+}
+
+bool ThreadPool::try_take(size_t worker_index, Task& task) {
+    const size_t worker_count = workers_.size();
+
+    for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+        if (lane_pending_[lane].load(std::memory_order_acquire) == 0) {
+            continue;
+        }
+
+        if (workers_[worker_index]->lanes[lane].pop_back(task)) {
+            lane_pending_[lane].fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        for (size_t offset = 1; offset < worker_count; ++offset) {
+            size_t victim = (worker_index + offset) % worker_count;
+            if (workers_[victim]->lanes[lane].pop_front(task)) {
+                lane_pending_[lane].fetch_sub(1, std::memory_order_relaxed);
+                stolen_tasks_.fetch_add(1, std::memory_order_relaxed);
+                return true;
             }
-            
-            if (!tasks_.empty()) {
-                task = std::move(const_cast<Task&>(tasks_.top()));
-                tasks_.pop();
-                ++active_tasks_;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::worker_thread(size_t worker_index) {
+    current_pool = this;
+    current_worker = worker_index;
+
+    Task task;
+    for (;;) {
+        if (try_take(worker_index, task)) {
+            // Count as active before dropping pending so wait_for_all never
+            // observes both at zero while a task is in flight
+            active_tasks_.fetch_add(1, std::memory_order_seq_cst);
+            pending_.fetch_sub(1, std::memory_order_seq_cst);
+
+            task();
+            task.reset();
+
+            if (active_tasks_.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+                pending_.load(std::memory_order_seq_cst) == 0) {
+                std::lock_guard<std::mutex> lock(finished_mutex_);
+                finished_condition_.notify_all();
             }
+            continue;
         }
-        
-        if (task.function) {
-            task.function();
-            --active_tasks_;
-            finished_condition_.notify_all();
+
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        condition_.wait(lock, [this] {
+            return stop_ || pending_.load(std::memory_order_seq_cst) > 0;
+        });
+        sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+
+        if (stop_ && pending_.load(std::memory_order_seq_cst) == 0) {
+            return;
         }
     }
 }
 
 void ThreadPool::wait_for_all() {
-    std::unique_lock<std::mutex> lock(queue_mutex_);
-    finished_condition_.wait(lock, [this] { 
-        return tasks_.empty() && active_tasks_ == 0; 
+    std::unique_lock<std::mutex> lock(finished_mutex_);
+    finished_condition_.wait(lock, [this] {
+        return pending_.load(std::memory_order_seq_cst) == 0 &&
+               active_tasks_.load(std::memory_order_seq_cst) == 0;
     });
 }
 
 size_t ThreadPool::pending_tasks() const {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    return tasks_.size();
+    return pending_.load(std::memory_order_relaxed);
 }
 
 void ThreadPool::shutdown() {
     {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
+        std::unique_lock<std::mutex> lock(idle_mutex_);
         stop_ = true;
     }
-    
+
     condition_.notify_all();
-    
+
     for (auto& thread : threads_) {
         if (thread.joinable()) {
             thread.join();
         }
     }
-    
+
     threads_.clear();
 }
 
-} // namespace ats
\ No newline at end of file
+} // namespace ats
@@ -1,18 +1,126 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <vector>
-#include <queue>
+#include <memory>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <future>
 #include <functional>
 #include <atomic>
+#include <tuple>
+#include <new>
+#include <type_traits>
+#include <stdexcept>
 
 namespace ats {
 
+// Move-only type-erased callable. Callables up to INLINE_SIZE bytes are stored
+// in place so submitting a task does not touch the heap.
+class Task {
+public:
+    static constexpr size_t INLINE_SIZE = 64;
+
+    Task() = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F&& f) {
+        using Fn = std::decay_t<F>;
+        if constexpr (fits_inline<Fn>()) {
+            new (&storage_) Fn(std::forward<F>(f));
+            vtable_ = &inline_vtable<Fn>;
+        } else {
+            new (&storage_) Fn*(new Fn(std::forward<F>(f)));
+            vtable_ = &heap_vtable<Fn>;
+        }
+    }
+
+    Task(Task&& other) noexcept {
+        move_from(other);
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    explicit operator bool() const { return vtable_ != nullptr; }
+
+    void operator()() { vtable_->invoke(&storage_); }
+
+    void reset() {
+        if (vtable_) {
+            vtable_->destroy(&storage_);
+            vtable_ = nullptr;
+        }
+    }
+
+private:
+    struct VTable {
+        void (*invoke)(void*);
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void*);
+    };
+
+    template<typename Fn>
+    static constexpr bool fits_inline() {
+        return sizeof(Fn) <= INLINE_SIZE &&
+               alignof(Fn) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+    template<typename Fn>
+    static constexpr VTable inline_vtable = {
+        [](void* p) { (*static_cast<Fn*>(p))(); },
+        [](void* dst, void* src) {
+            new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        },
+        [](void* p) { static_cast<Fn*>(p)->~Fn(); }
+    };
+
+    template<typename Fn>
+    static constexpr VTable heap_vtable = {
+        [](void* p) { (**static_cast<Fn**>(p))(); },
+        [](void* dst, void* src) { new (dst) Fn*(*static_cast<Fn**>(src)); },
+        [](void* p) { delete *static_cast<Fn**>(p); }
+    };
+
+    void move_from(Task& other) noexcept {
+        vtable_ = other.vtable_;
+        if (vtable_) {
+            vtable_->move(&storage_, &other.storage_);
+            other.vtable_ = nullptr;
+        }
+    }
+
+    std::aligned_storage_t<INLINE_SIZE, alignof(std::max_align_t)> storage_;
+    const VTable* vtable_ = nullptr;
+};
+
+// Work-stealing thread pool. Each worker owns one deque per priority lane;
+// workers pop their own deques LIFO and steal FIFO from the others when idle,
+// so the common path only touches an uncontended per-worker lock.
 class ThreadPool {
 public:
+    // Priority lanes, served strictly in this order
+    enum Lane : size_t {
+        HIGH = 0,
+        NORMAL = 1,
+        LOW = 2,
+        LANE_COUNT = 3
+    };
+
     explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency());
     ~ThreadPool();
 
@@ -26,10 +134,15 @@ public:
     template<typename F, typename... Args>
     auto submit(F&& f, Args&&... args) -> std::future<typename std::invoke_result_t<F, Args...>>;
 
-    // Submit a task with priority (higher number = higher priority)
+    // Submit a task with priority: positive values go to the high lane,
+    // zero to the normal lane and negative values to the low lane
     template<typename F, typename... Args>
     auto submit_priority(int priority, F&& f, Args&&... args) -> std::future<typename std::invoke_result_t<F, Args...>>;
 
+    // Fire-and-forget submission without a future
+    template<typename F>
+    void post(F&& f, int priority = 0);
+
     // Wait for all tasks to complete
     void wait_for_all();
 
@@ -39,6 +152,9 @@ public:
     // Get number of pending tasks
     size_t pending_tasks() const;
 
+    // Number of tasks taken from another worker's deque
+    size_t stolen_tasks() const { return stolen_tasks_.load(std::memory_order_relaxed); }
+
     // Check if the pool is running
     bool is_running() const { return !stop_; }
 
@@ -46,24 +162,53 @@ public:
     void shutdown();
 
 private:
-    struct Task {
-        std::function<void()> function;
-        int priority;
-        
-        bool operator<(const Task& other) const {
-            return priority < other.priority; // Higher priority first
-        }
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // Growable ring of tasks; the owner works at the back, thieves at the front
+    class WorkDeque {
+    public:
+        void push(Task&& task);
+        bool pop_back(Task& task);
+        bool pop_front(Task& task);
+
+    private:
+        void grow();
+
+        std::mutex mutex_;
+        std::vector<Task> buffer_;
+        size_t head_ = 0;
+        size_t count_ = 0;
     };
 
+    struct alignas(CACHE_LINE_SIZE) Worker {
+        std::array<WorkDeque, LANE_COUNT> lanes;
+    };
+
+    static Lane lane_for(int priority) {
+        return priority > 0 ? HIGH : (priority < 0 ? LOW : NORMAL);
+    }
+
+    void enqueue(Task&& task, Lane lane);
+    bool try_take(size_t worker_index, Task& task);
+    void worker_thread(size_t worker_index);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
     std::vector<std::thread> threads_;
-    std::priority_queue<Task> tasks_;
-    std::mutex queue_mutex_;
-    std::condition_variable condition_;
-    std::atomic<bool> stop_{false};
+
+    std::array<std::atomic<size_t>, LANE_COUNT> lane_pending_{};
+    std::atomic<size_t> pending_{0};
     std::atomic<size_t> active_tasks_{0};
-    std::condition_variable finished_condition_;
+    std::atomic<size_t> next_worker_{0};
+    std::atomic<size_t> stolen_tasks_{0};
+    std::atomic<bool> stop_{false};
 
-    void worker_thread();
+    // Idle workers park here until work is enqueued
+    std::mutex idle_mutex_;
+    std::condition_variable condition_;
+    std::atomic<size_t> sleepers_{0};
+
+    std::mutex finished_mutex_;
+    std::condition_variable finished_condition_;
 };
 
 template<typename F, typename... Args>
@@ -75,24 +220,33 @@ template<typename F, typename... Args>
 auto ThreadPool::submit_priority(int priority, F&& f, Args&&... args) -> std::future<typename std::invoke_result_t<F, Args...>> {
     using return_type = typename std::invoke_result_t<F, Args...>;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-    );
-
-    std::future<return_type> result = task->get_future();
-
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        
-        if (stop_) {
-            throw std::runtime_error("Cannot submit task to stopped ThreadPool");
+    std::promise<return_type> promise;
+    std::future<return_type> result = promise.get_future();
+
+    post([promise = std::move(promise),
+          f = std::forward<F>(f),
+          args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+        try {
+            if constexpr (std::is_void_v<return_type>) {
+                std::apply(std::move(f), std::move(args));
+                promise.set_value();
+            } else {
+                promise.set_value(std::apply(std::move(f), std::move(args)));
+            }
+        } catch (...) {
+            promise.set_exception(std::current_exception());
         }
+    }, priority);
 
-        tasks_.emplace(Task{[task]() { (*task)(); }, priority});
-    }
-
-    condition_.notify_one();
     return result;
 }
 
-} // namespace ats
\ No newline at end of file
+template<typename F>
+void ThreadPool::post(F&& f, int priority) {
+    if (stop_) {
+        throw std::runtime_error("Cannot submit task to stopped ThreadPool");
+    }
+    enqueue(Task(std::forward<F>(f)), lane_for(priority));
+}
+
+} // namespace ats
@@ -0,0 +1,745 @@
+#include <gtest/gtest.h>
+#include "core/event_loop.hpp"
+#include "core/price_conflator.hpp"
+#include "data/database_manager.hpp"
+#include "data/market_data.hpp"
+#include "data/price_cache.hpp"
+#include "data/sqlite3.h"
+#include "data/seqlock_price_table.hpp"
+#include "utils/mpsc_ring_buffer.hpp"
+#include "utils/thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ats;
+
+namespace {
+
+TradeRecord make_trade(const std::string& id) {
+    TradeRecord trade{};
+    trade.trade_id = id;
+    trade.symbol = "BTC/USDT";
+    trade.buy_exchange = "binance";
+    trade.sell_exchange = "upbit";
+    trade.volume = 0.1;
+    trade.buy_price = 50000.0;
+    trade.sell_price = 50020.0;
+    trade.realized_pnl = 2.0;
+    trade.end_time = std::chrono::system_clock::now();
+    return trade;
+}
+
+// A UTC midnight, so day buckets in the rollup are easy to predict
+constexpr int64_t kDayStart = 1700006400;
+
+TradeRecord make_trade_at(const std::string& id, int64_t epoch_seconds) {
+    TradeRecord trade = make_trade(id);
+    trade.end_time = std::chrono::system_clock::from_time_t(epoch_seconds);
+    return trade;
+}
+
+std::vector<std::string> trade_ids(DatabaseManager& db, const TradeQuery& query) {
+    std::vector<std::string> ids;
+    db.ForEachTrade(query, [&ids](const TradeRecord& trade) {
+        ids.push_back(trade.trade_id);
+        return true;
+    });
+    return ids;
+}
+
+long long millis_ago(std::chrono::minutes age) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        (std::chrono::system_clock::now() - age).time_since_epoch()).count();
+}
+
+Trade make_market_trade(double price, double quantity, long long timestamp) {
+    Trade trade{};
+    trade.symbol = "BTC/USDT";
+    trade.price = price;
+    trade.quantity = quantity;
+    trade.timestamp = timestamp;
+    return trade;
+}
+
+// Runs wait_for_all on a helper thread so a lost wakeup fails the test
+// instead of hanging it
+bool wait_for_all_within(ThreadPool& pool, std::chrono::seconds timeout) {
+    auto waiter = std::async(std::launch::async, [&pool] { pool.wait_for_all(); });
+    return waiter.wait_for(timeout) == std::future_status::ready;
+}
+
+} // namespace
+
+// Database Manager Tests
+class DatabaseManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_path = (std::filesystem::temp_directory_path() / "ats_test_trades.db").string();
+        std::filesystem::remove(db_path);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(db_path);
+    }
+
+    std::string db_path;
+};
+
+TEST_F(DatabaseManagerTest, SingleQueuedTradeCommitsWithinFlushInterval) {
+    TradeStoreSettings settings;
+    settings.async_writes = true;
+    settings.max_batch_size = 256;
+    settings.flush_interval_ms = 20;
+
+    DatabaseManager db(db_path, settings);
+    ASSERT_TRUE(db.Open());
+    // Let the writer park on an empty queue first
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_TRUE(db.SaveTrade(make_trade("t-1")));
+
+    // No Flush: the writer has to wake up on its own for a lone trade
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (db.GetWriterMetrics().trades_written == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(settings.flush_interval_ms));
+    }
+
+    auto metrics = db.GetWriterMetrics();
+    EXPECT_EQ(metrics.trades_written, 1u);
+    EXPECT_EQ(metrics.queue_depth, 0u);
+    EXPECT_EQ(db.GetTradeHistory(10).size(), 1u);
+    db.Close();
+}
+
+TEST_F(DatabaseManagerTest, FlushReportsABatchThatFailedToCommit) {
+    TradeStoreSettings settings;
+    settings.async_writes = true;
+    settings.flush_interval_ms = 1;
+
+    DatabaseManager db(db_path, settings);
+    ASSERT_TRUE(db.Open());
+
+    // A second connection holding the write lock makes BEGIN IMMEDIATE fail
+    sqlite3* blocker = nullptr;
+    ASSERT_EQ(sqlite3_open(db_path.c_str(), &blocker), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(blocker, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr), SQLITE_OK);
+
+    ASSERT_TRUE(db.SaveTrade(make_trade("lost-1")));
+    EXPECT_FALSE(db.Flush(std::chrono::seconds(5)));
+    EXPECT_EQ(db.GetWriterMetrics().failed_writes, 1u);
+
+    sqlite3_exec(blocker, "ROLLBACK;", nullptr, nullptr, nullptr);
+    sqlite3_close(blocker);
+
+    // The loss was reported once; later trades commit and flush cleanly
+    ASSERT_TRUE(db.SaveTrade(make_trade("kept-1")));
+    EXPECT_TRUE(db.Flush(std::chrono::seconds(5)));
+    auto history = db.GetTradeHistory(10);
+    ASSERT_EQ(history.size(), 1u);
+    EXPECT_EQ(history[0].trade_id, "kept-1");
+    db.Close();
+}
+
+TEST_F(DatabaseManagerTest, QueryTradesPagesThroughEqualTimestamps) {
+    DatabaseManager db(db_path);
+    ASSERT_TRUE(db.Open());
+    // Five trades share a second, so page boundaries fall inside the tie
+    for (const char* id : {"c", "a", "e", "b", "d"}) {
+        ASSERT_TRUE(db.SaveTrade(make_trade_at(id, kDayStart + 10)));
+    }
+    ASSERT_TRUE(db.SaveTrade(make_trade_at("old", kDayStart + 5)));
+    ASSERT_TRUE(db.SaveTrade(make_trade_at("new", kDayStart + 20)));
+
+    for (bool newest_first : {true, false}) {
+        TradeQuery query;
+        query.newest_first = newest_first;
+        std::vector<std::string> ids;
+        size_t pages = 0;
+        do {
+            TradePage page = db.QueryTrades(query, 2);
+            ASSERT_LE(page.trades.size(), 2u);
+            for (const auto& trade : page.trades) ids.push_back(trade.trade_id);
+            query.after = page.next;
+            ASSERT_LT(++pages, 10u);
+        } while (query.after);
+
+        std::vector<std::string> expected = {"new", "e", "d", "c", "b", "a", "old"};
+        if (!newest_first) std::reverse(expected.begin(), expected.end());
+        EXPECT_EQ(ids, expected);
+        EXPECT_EQ(pages, 4u);
+    }
+    db.Close();
+}
+
+TEST_F(DatabaseManagerTest, ForEachTradeAppliesEachFilter) {
+    DatabaseManager db(db_path);
+    ASSERT_TRUE(db.Open());
+
+    TradeRecord eth = make_trade_at("eth", kDayStart + 200);
+    eth.symbol = "ETH/USDT";
+    TradeRecord sell_leg = make_trade_at("sell-leg", kDayStart + 300);
+    sell_leg.buy_exchange = "upbit";
+    sell_leg.sell_exchange = "kraken";
+    TradeRecord buy_leg = make_trade_at("buy-leg", kDayStart + 400);
+    buy_leg.buy_exchange = "kraken";
+    buy_leg.sell_exchange = "bithumb";
+    for (const auto& trade : {make_trade_at("early", kDayStart + 100), eth, sell_leg, buy_leg}) {
+        ASSERT_TRUE(db.SaveTrade(trade));
+    }
+
+    using Ids = std::vector<std::string>;
+    TradeQuery query;
+    query.newest_first = false;
+    EXPECT_EQ(trade_ids(db, query), (Ids{"early", "eth", "sell-leg", "buy-leg"}));
+
+    // from is inclusive and to is exclusive
+    TradeQuery window = query;
+    window.from = std::chrono::system_clock::from_time_t(kDayStart + 200);
+    window.to = std::chrono::system_clock::from_time_t(kDayStart + 400);
+    EXPECT_EQ(trade_ids(db, window), (Ids{"eth", "sell-leg"}));
+
+    TradeQuery by_symbol = query;
+    by_symbol.symbol = "ETH/USDT";
+    EXPECT_EQ(trade_ids(db, by_symbol), (Ids{"eth"}));
+
+    // The exchange filter matches either leg
+    TradeQuery by_exchange = query;
+    by_exchange.exchange = "kraken";
+    EXPECT_EQ(trade_ids(db, by_exchange), (Ids{"sell-leg", "buy-leg"}));
+
+    TradeQuery combined = by_exchange;
+    combined.symbol = "BTC/USDT";
+    combined.from = std::chrono::system_clock::from_time_t(kDayStart + 350);
+    EXPECT_EQ(trade_ids(db, combined), (Ids{"buy-leg"}));
+
+    // The visitor can stop the scan early
+    size_t visited = db.ForEachTrade(query, [](const TradeRecord&) { return false; });
+    EXPECT_EQ(visited, 1u);
+    db.Close();
+}
+
+TEST_F(DatabaseManagerTest, DailyPnlRollsUpInsertedTrades) {
+    DatabaseManager db(db_path);
+    ASSERT_TRUE(db.Open());
+
+    TradeRecord eth = make_trade_at("eth-1", kDayStart + 60);
+    eth.symbol = "ETH/USDT";
+    eth.volume = 1.5;
+    eth.realized_pnl = -1.0;
+    for (const auto& trade : {make_trade_at("btc-1", kDayStart + 10), make_trade_at("btc-2", kDayStart + 86399),
+                              make_trade_at("btc-3", kDayStart + 86400), eth}) {
+        ASSERT_TRUE(db.SaveTrade(trade));
+    }
+
+    auto day = [](int64_t n) { return std::chrono::system_clock::from_time_t(kDayStart + n * 86400); };
+
+    auto btc = db.GetDailyPnl(day(0), day(2), "BTC/USDT");
+    ASSERT_EQ(btc.size(), 2u);
+    EXPECT_EQ(btc[0].day, day(0));
+    EXPECT_EQ(btc[0].symbol, "BTC/USDT");
+    EXPECT_EQ(btc[0].trade_count, 2);
+    EXPECT_DOUBLE_EQ(btc[0].volume, 0.2);
+    EXPECT_DOUBLE_EQ(btc[0].pnl, 4.0);
+    EXPECT_EQ(btc[1].day, day(1));
+    EXPECT_EQ(btc[1].trade_count, 1);
+
+    // Without a symbol the days are summed across symbols
+    auto all = db.GetDailyPnl(day(0), day(1));
+    ASSERT_EQ(all.size(), 1u);
+    EXPECT_TRUE(all[0].symbol.empty());
+    EXPECT_EQ(all[0].trade_count, 3);
+    EXPECT_DOUBLE_EQ(all[0].volume, 1.7);
+    EXPECT_DOUBLE_EQ(all[0].pnl, 3.0);
+
+    // A range starting mid-day still includes that day
+    EXPECT_EQ(db.GetDailyPnl(day(1) - std::chrono::hours(1), day(2)).size(), 2u);
+    db.Close();
+}
+
+TEST_F(DatabaseManagerTest, DailyPnlBackfillsTradesWrittenBeforeTheTrigger) {
+    {
+        DatabaseManager db(db_path);
+        ASSERT_TRUE(db.Open());
+        ASSERT_TRUE(db.SaveTrade(make_trade_at("pre-1", kDayStart + 10)));
+        ASSERT_TRUE(db.SaveTrade(make_trade_at("pre-2", kDayStart + 20)));
+        db.Close();
+    }
+
+    // Turn it back into a database from before the rollup existed
+    sqlite3* raw = nullptr;
+    ASSERT_EQ(sqlite3_open(db_path.c_str(), &raw), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(raw, "DROP TRIGGER trades_daily_pnl; DELETE FROM daily_pnl;", nullptr, nullptr, nullptr),
+              SQLITE_OK);
+    sqlite3_close(raw);
+
+    auto from = std::chrono::system_clock::from_time_t(kDayStart);
+    auto to = std::chrono::system_clock::from_time_t(kDayStart + 86400);
+
+    DatabaseManager db(db_path);
+    ASSERT_TRUE(db.Open());
+    auto rows = db.GetDailyPnl(from, to);
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].trade_count, 2);
+    EXPECT_DOUBLE_EQ(rows[0].pnl, 4.0);
+
+    // The trigger is back and adds to the backfilled row
+    ASSERT_TRUE(db.SaveTrade(make_trade_at("post-1", kDayStart + 30)));
+    rows = db.GetDailyPnl(from, to);
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].trade_count, 3);
+    db.Close();
+
+    // The backfill runs once; reopening does not count the trades again
+    DatabaseManager reopened(db_path);
+    ASSERT_TRUE(reopened.Open());
+    rows = reopened.GetDailyPnl(from, to);
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].trade_count, 3);
+    EXPECT_DOUBLE_EQ(rows[0].pnl, 6.0);
+    reopened.Close();
+}
+
+// Market Data Feed Tests
+TEST(MarketDataFeedTest, VolumeDecaysAfterSymbolGoesIdle) {
+    MarketDataFeed feed;
+
+    // Trades are bucketed by their own timestamps: an hour and a half of
+    // silence leaves them in the 24h range but out of the last hour
+    feed.UpdateTrade("binance", make_market_trade(100.0, 1.0, millis_ago(std::chrono::minutes(120))));
+    feed.UpdateTrade("upbit", make_market_trade(200.0, 3.0, millis_ago(std::chrono::minutes(90))));
+    feed.UpdateMarketStats("BTC/USDT");
+
+    auto stats = feed.GetMarketStats("BTC/USDT");
+    EXPECT_DOUBLE_EQ(stats.volume_1h, 0.0);
+    EXPECT_DOUBLE_EQ(stats.volume_24h, 4.0);
+    EXPECT_DOUBLE_EQ(stats.vwap, 175.0);
+    EXPECT_DOUBLE_EQ(feed.GetVwap("upbit", "BTC/USDT"), 200.0);
+
+    // A fresh trade elsewhere does not revive the idle exchange's hour
+    feed.UpdateTrade("upbit", make_market_trade(300.0, 2.0, millis_ago(std::chrono::minutes(5))));
+    feed.UpdateMarketStats("BTC/USDT");
+    stats = feed.GetMarketStats("BTC/USDT");
+    EXPECT_DOUBLE_EQ(stats.volume_1h, 2.0);
+    EXPECT_DOUBLE_EQ(stats.volume_24h, 6.0);
+}
+
+TEST(MarketDataFeedTest, TradesOlderThanADayDropOut) {
+    MarketDataFeed feed;
+
+    feed.UpdateTrade("binance", make_market_trade(100.0, 5.0, millis_ago(std::chrono::hours(23))));
+    feed.UpdateTrade("binance", make_market_trade(100.0, 7.0, millis_ago(std::chrono::hours(25))));
+    feed.UpdateMarketStats("BTC/USDT");
+
+    auto stats = feed.GetMarketStats("BTC/USDT");
+    EXPECT_DOUBLE_EQ(stats.volume_1h, 0.0);
+    EXPECT_DOUBLE_EQ(stats.volume_24h, 5.0);
+    EXPECT_DOUBLE_EQ(feed.GetVwap("binance", "BTC/USDT"), 100.0);
+    EXPECT_DOUBLE_EQ(feed.GetVwap("kraken", "BTC/USDT"), 0.0);
+}
+
+// LRU Cache Tests
+TEST(LRUCacheTest, ExpiresByWriteTimeAndEvictsLeastRecentlyUsed) {
+    LRUCache<std::string, int> cache(3);
+    std::vector<std::string> erased;
+    cache.SetKeyListeners(nullptr, [&erased](const std::string& key) { erased.push_back(key); });
+
+    cache.Put("old", 1);
+    cache.Put("rewritten", 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+    // A rewrite refiles the entry under its new write time
+    cache.Put("rewritten", 3);
+    cache.Put("fresh", 4);
+
+    cache.CleanupExpired(std::chrono::seconds(1));
+    EXPECT_EQ(erased, std::vector<std::string>{"old"});
+    EXPECT_FALSE(cache.Contains("old"));
+    EXPECT_TRUE(cache.Contains("rewritten"));
+    EXPECT_TRUE(cache.Contains("fresh"));
+    EXPECT_EQ(cache.GetEvictions(), 0);
+
+    // Reading refreshes recency, so the untouched entry is evicted first
+    int value = 0;
+    cache.Put("third", 5);
+    ASSERT_TRUE(cache.Get("rewritten", value));
+    EXPECT_EQ(value, 3);
+    cache.Put("fourth", 6);
+    EXPECT_FALSE(cache.Contains("fresh"));
+    EXPECT_EQ(cache.GetEvictions(), 1);
+    EXPECT_EQ(erased.back(), "fresh");
+
+    cache.Put("fifth", 7);
+    EXPECT_FALSE(cache.Contains("third"));
+    EXPECT_EQ(cache.GetAllKeys(), (std::vector<std::string>{"fifth", "fourth", "rewritten"}));
+
+    // Evicted and removed entries left the wheel, so a later pass expires
+    // only what is still cached
+    erased.clear();
+    cache.CleanupExpired(std::chrono::seconds(0));
+    EXPECT_EQ(erased.size(), 3u);
+    EXPECT_EQ(cache.Size(), 0u);
+}
+
+// Seqlock Price Table Tests
+TEST(SeqlockPriceTableTest, RemoveExchangeAndSymbolKeepOtherEntries) {
+    SeqlockPriceTable table(128);
+    auto price_of = [](types::ExchangeCode exchange, types::SymbolCode symbol) {
+        CompactPrice price;
+        price.bid = exchange * 100.0 + symbol;
+        price.ask = price.bid + 1.0;
+        return price;
+    };
+    for (types::ExchangeCode exchange = 0; exchange < 8; ++exchange) {
+        for (types::SymbolCode symbol = 0; symbol < 8; ++symbol) {
+            table.Put(exchange, symbol, price_of(exchange, symbol));
+        }
+    }
+
+    EXPECT_EQ(table.RemoveExchange(2), 8u);
+    EXPECT_EQ(table.RemoveSymbol(3), 7u);
+    EXPECT_EQ(table.RemoveExchange(9), 0u);
+    EXPECT_EQ(table.Size(), 49u);
+
+    for (types::ExchangeCode exchange = 0; exchange < 8; ++exchange) {
+        for (types::SymbolCode symbol = 0; symbol < 8; ++symbol) {
+            CompactPrice price;
+            bool removed = exchange == 2 || symbol == 3;
+            ASSERT_EQ(table.Peek(exchange, symbol, price), !removed) << exchange << ":" << symbol;
+            if (!removed) {
+                EXPECT_DOUBLE_EQ(price.bid, price_of(exchange, symbol).bid);
+            }
+        }
+    }
+}
+
+TEST(SeqlockPriceTableTest, ReadersSeeWholeWritesWhileEntriesShift) {
+    // Every price is written with all fields derived from one value, so a
+    // torn read shows up as fields that disagree
+    auto price_for = [](long long value) {
+        CompactPrice price;
+        price.bid = static_cast<double>(value);
+        price.ask = price.bid + 1.0;
+        price.last = price.bid + 0.5;
+        price.volume = price.bid * 2.0;
+        price.timestamp = value;
+        return price;
+    };
+    constexpr types::SymbolCode stable_symbols = 16;
+    constexpr types::SymbolCode churn_symbols = 16;
+    SeqlockPriceTable table(64);
+    for (types::SymbolCode symbol = 0; symbol < stable_symbols; ++symbol) {
+        table.Put(0, symbol, price_for(0));
+    }
+
+    std::atomic<bool> running{true};
+    std::atomic<long long> torn_reads{0};
+    std::atomic<long long> missing_reads{0};
+    std::vector<std::thread> threads;
+
+    // Overwrites of the stable keys race the readers on the same slots
+    threads.emplace_back([&] {
+        for (long long value = 1; running.load(); ++value) {
+            table.Put(0, static_cast<types::SymbolCode>(value % stable_symbols), price_for(value));
+        }
+    });
+    // Inserting and removing other keys shifts entries along the probe chains
+    threads.emplace_back([&] {
+        for (long long value = 1; running.load(); ++value) {
+            auto symbol = static_cast<types::SymbolCode>(value % churn_symbols);
+            table.Put(1, symbol, price_for(value));
+            table.Remove(1, static_cast<types::SymbolCode>((value + churn_symbols / 2) % churn_symbols));
+        }
+    });
+    for (int reader = 0; reader < 2; ++reader) {
+        threads.emplace_back([&] {
+            CompactPrice price;
+            for (long long i = 0; running.load(); ++i) {
+                if (!table.Get(0, static_cast<types::SymbolCode>(i % stable_symbols), price)) {
+                    missing_reads.fetch_add(1);
+                    continue;
+                }
+                if (price.ask != price.bid + 1.0 || price.last != price.bid + 0.5 ||
+                    price.volume != price.bid * 2.0 || price.timestamp != static_cast<long long>(price.bid)) {
+                    torn_reads.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    running = false;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(torn_reads.load(), 0);
+    EXPECT_EQ(missing_reads.load(), 0);
+    EXPECT_GT(table.GetHits(), 0);
+    EXPECT_EQ(table.GetEvictions(), 0);
+}
+
+// MPSC Ring Buffer Tests
+TEST(MpscRingBufferTest, FullRingRejectsWithoutConsumingTheValue) {
+    MpscRingBuffer<std::unique_ptr<int>> ring(5);
+    ASSERT_EQ(ring.capacity(), 8u);
+
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(ring.try_push(std::make_unique<int>(i)));
+    }
+    auto extra = std::make_unique<int>(8);
+    EXPECT_FALSE(ring.try_push(std::move(extra)));
+    ASSERT_NE(extra, nullptr); // only moved from on success
+    EXPECT_EQ(ring.size(), 8u);
+    EXPECT_EQ(ring.high_water_mark(), 8u);
+
+    // Draining part of the ring frees exactly that many slots, and items
+    // come out in the order they went in
+    std::vector<std::unique_ptr<int>> out;
+    EXPECT_EQ(ring.drain(out, 3), 3u);
+    EXPECT_TRUE(ring.try_push(std::move(extra)));
+    for (int i = 9; i < 11; ++i) {
+        EXPECT_TRUE(ring.try_push(std::make_unique<int>(i)));
+    }
+    EXPECT_FALSE(ring.try_push(std::make_unique<int>(11)));
+
+    EXPECT_EQ(ring.drain(out, 100), 8u);
+    ASSERT_EQ(out.size(), 11u);
+    for (int i = 0; i < 11; ++i) {
+        EXPECT_EQ(*out[i], i);
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(MpscRingBufferTest, KeepsEachProducersOrderUnderContention) {
+    // A small ring keeps producers hitting the full path and spinning in push
+    MpscRingBuffer<std::pair<int, int>> ring(64);
+    constexpr int producers = 4;
+    constexpr int items_per_producer = 50000;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&ring, p] {
+            for (int i = 0; i < items_per_producer; ++i) {
+                ring.push({p, i});
+            }
+        });
+    }
+
+    std::atomic<bool> keep_waiting{true};
+    std::vector<int> next(producers, 0);
+    std::vector<std::pair<int, int>> batch;
+    int received = 0;
+    bool in_order = true;
+    while (received < producers * items_per_producer && ring.wait_for_data(keep_waiting)) {
+        batch.clear();
+        ring.drain(batch, 16);
+        for (const auto& [producer, sequence] : batch) {
+            in_order = in_order && sequence == next[producer];
+            next[producer] = sequence + 1;
+        }
+        received += static_cast<int>(batch.size());
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(received, producers * items_per_producer);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_LE(ring.high_water_mark(), ring.capacity());
+}
+
+// Thread Pool Tests
+TEST(ThreadPoolTest, SubmitReturnsResultsAndExceptions) {
+    ThreadPool pool(4);
+
+    auto sum = pool.submit([](int a, int b) { return a + b; }, 2, 3);
+    auto failing = pool.submit_priority(1, []() -> int { throw std::runtime_error("boom"); });
+
+    EXPECT_EQ(sum.get(), 5);
+    EXPECT_THROW(failing.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, IdleWorkersStealFromABusyOne) {
+    ThreadPool pool(4);
+    constexpr int children = 1000;
+    std::atomic<int> done{0};
+
+    // Tasks posted from inside a task land on that worker's own deque, and
+    // the parent keeps its worker busy, so only thieves can run them
+    auto parent = pool.submit([&pool, &done] {
+        for (int i = 0; i < children; ++i) {
+            pool.post([&done] { done.fetch_add(1); });
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (done.load() < children && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    });
+    parent.get();
+
+    EXPECT_EQ(done.load(), children);
+    EXPECT_GE(pool.stolen_tasks(), static_cast<size_t>(children));
+    ASSERT_TRUE(wait_for_all_within(pool, std::chrono::seconds(10)));
+}
+
+TEST(ThreadPoolTest, WaitForAllUnderConcurrentSubmitters) {
+    ThreadPool pool(4);
+    constexpr int submitters = 4;
+    constexpr int tasks_per_submitter = 20000;
+    std::atomic<int> executed{0};
+
+    for (int round = 0; round < 20; ++round) {
+        executed = 0;
+        std::vector<std::thread> threads;
+        for (int s = 0; s < submitters; ++s) {
+            threads.emplace_back([&pool, &executed, s] {
+                for (int i = 0; i < tasks_per_submitter; ++i) {
+                    if (i % 8 == 0) {
+                        // Nested work keeps the workers' own deques busy
+                        // while external submissions are being stolen
+                        pool.post([&pool, &executed] {
+                            executed.fetch_add(1);
+                            pool.post([&executed] { executed.fetch_add(1); }, -1);
+                        }, 1);
+                    } else {
+                        pool.post([&executed] { executed.fetch_add(1); }, s % 3 - 1);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        ASSERT_TRUE(wait_for_all_within(pool, std::chrono::seconds(30))) << "wait_for_all hung in round " << round;
+        EXPECT_EQ(executed.load(), submitters * (tasks_per_submitter + tasks_per_submitter / 8));
+        EXPECT_EQ(pool.pending_tasks(), 0u);
+    }
+}
+
+// Price Conflator Tests
+TEST(PriceConflatorTest, RejectsComparisonsWithoutSymbolCode) {
+    PriceConflator conflator;
+    CompactPriceComparison comparison;
+    comparison.symbol = 3;
+
+    EXPECT_TRUE(conflator.offer(comparison));
+    EXPECT_FALSE(conflator.offer(comparison));
+    EXPECT_EQ(conflator.conflated_count(), 1u);
+
+    comparison.symbol = types::INVALID_CODE;
+    EXPECT_FALSE(conflator.offer(comparison));
+    EXPECT_EQ(conflator.rejected_count(), 1u);
+    EXPECT_EQ(conflator.symbol_count(), 4u);
+
+    CompactPriceComparison taken;
+    EXPECT_FALSE(conflator.take(types::INVALID_CODE, taken));
+    EXPECT_TRUE(conflator.take(3, taken));
+    EXPECT_EQ(taken.symbol, 3);
+}
+
+// Event Loop Tests
+namespace {
+
+// Records the symbols of opportunities a detector reports
+class RecordingPusher : public EventPusher {
+public:
+    void push_event(Event event) override {
+        if (auto* found = std::get_if<ArbitrageOpportunityEvent>(&event)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            symbols_.push_back(found->opportunity.symbol);
+        }
+    }
+
+    std::vector<std::string> symbols() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return symbols_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::string> symbols_;
+};
+
+// Runs a callback on whichever loop thread the detector reports from
+class CallbackPusher : public EventPusher {
+public:
+    explicit CallbackPusher(std::function<void()> callback) : callback_(std::move(callback)) {}
+    void push_event(Event) override { callback_(); }
+
+private:
+    std::function<void()> callback_;
+};
+
+PriceUpdateEvent make_price_update(const std::string& symbol, bool crossed) {
+    CompactPriceComparison comparison;
+    comparison.symbol = types::intern_symbol(symbol);
+    comparison.set(types::intern_exchange("loop_test_a"), CompactPrice{100.0, 101.0, 100.5, 1.0, 0});
+    double bid = crossed ? 102.0 : 99.0;
+    comparison.set(types::intern_exchange("loop_test_b"), CompactPrice{bid, bid + 1.0, bid, 1.0, 0});
+    return PriceUpdateEvent{comparison};
+}
+
+} // namespace
+
+TEST(EventLoopTest, ConflatedSymbolSurvivesFullCrossShardOverflow) {
+    ConfigManager config;
+    config.get_exchange_configs()["loop_test_a"].taker_fee = 0.0;
+    config.get_exchange_configs()["loop_test_b"].taker_fee = 0.0;
+
+    // Target loop: a two-slot ring and a one-event overflow, not yet running
+    OpportunityDetector target_detector(&config, {});
+    RecordingPusher recorder;
+    target_detector.set_event_pusher(&recorder);
+    EventLoopConfig target_config;
+    target_config.queue_capacity = 2;
+    target_config.cross_shard_overflow_capacity = 1;
+    target_config.conflate_price_updates = true;
+    EventLoop target(&target_detector, nullptr, target_config);
+
+    // Source loop: its detector's report is the hook that pushes into the
+    // target from the source loop's thread, i.e. across shards
+    std::promise<void> pushed;
+    CallbackPusher cross_shard([&] {
+        target.push_event(make_price_update("LOOP/FILL1", false));
+        target.push_event(make_price_update("LOOP/FILL2", false));
+        target.push_event(make_price_update("LOOP/FILL3", false));
+        target.push_event(make_price_update("LOOP/KEEP", true));
+        pushed.set_value();
+    });
+    OpportunityDetector source_detector(&config, {});
+    source_detector.set_event_pusher(&cross_shard);
+    EventLoop source(&source_detector, nullptr);
+    std::thread source_thread([&] { source.run(); });
+    source.push_event(make_price_update("LOOP/SOURCE", true));
+    ASSERT_EQ(pushed.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    source.stop();
+    source_thread.join();
+
+    std::thread target_thread([&] { target.run(); });
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (recorder.symbols().empty() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    target.stop();
+    target_thread.join();
+
+    EXPECT_EQ(recorder.symbols(), std::vector<std::string>{"LOOP/KEEP"});
+    EXPECT_EQ(target.dropped_events(), 0u);
+    EXPECT_EQ(target.overflowed_events(), 2u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
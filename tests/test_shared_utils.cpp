@@ -2,8 +2,13 @@
 #include <gmock/gmock.h>
 #include "utils/logger.hpp"
 #include "utils/crypto_utils.hpp"
+#include "utils/fast_feed_parser.hpp"
 #include "config/config_manager.hpp"
 #include "types/common_types.hpp"
+#include "types/ticker_wire.hpp"
+#ifdef HAS_NLOHMANN_JSON
+#include <nlohmann/json.hpp>
+#endif
 #include <filesystem>
 #include <fstream>
 
@@ -210,6 +215,8 @@ TEST_F(ConfigManagerTest, DefaultConfiguration) {
     EXPECT_EQ(db_config.redis_port, 6379);
 }
 
+// File loading needs the JSON-enabled ConfigManager build
+#ifdef HAS_NLOHMANN_JSON
 TEST_F(ConfigManagerTest, ConfigurationSaveLoad) {
     // Create test configuration
     nlohmann::json test_config = {
@@ -287,8 +294,10 @@ TEST_F(ConfigManagerTest, ConfigurationValidation) {
     auto errors = config_manager->get_validation_errors();
     EXPECT_GT(errors.size(), 0);
 }
+#endif
 
 TEST_F(ConfigManagerTest, GenericValueAccess) {
+#ifdef HAS_NLOHMANN_JSON
     config_manager->set_value("test.string_value", std::string("hello"));
     config_manager->set_value("test.int_value", 42);
     config_manager->set_value("test.double_value", 3.14);
@@ -298,6 +307,7 @@ TEST_F(ConfigManagerTest, GenericValueAccess) {
     EXPECT_EQ(config_manager->get_value<int>("test.int_value"), 42);
     EXPECT_EQ(config_manager->get_value<double>("test.double_value"), 3.14);
     EXPECT_EQ(config_manager->get_value<bool>("test.bool_value"), true);
+#endif
     
     // Test default values
     EXPECT_EQ(config_manager->get_value<std::string>("nonexistent.key", "default"), "default");
@@ -306,7 +316,8 @@ TEST_F(ConfigManagerTest, GenericValueAccess) {
 
 // Common Types Tests
 TEST(CommonTypesTest, TickerCreation) {
-    auto timestamp = std::chrono::system_clock::now();
+    int64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
     Ticker ticker("BTC/USDT", "binance", 49900.0, 50000.0, 49950.0, 1000.0, timestamp);
     
     EXPECT_EQ(ticker.symbol, "BTC/USDT");
@@ -360,6 +371,190 @@ TEST(CommonTypesTest, Portfolio) {
     EXPECT_EQ(portfolio.balances["USDT"].available, 49000.0);
 }
 
+// Symbol Registry Tests
+TEST(SymbolRegistryTest, InternIsStable) {
+    SymbolCode btc = intern_symbol("BTC/USDT");
+    SymbolCode eth = intern_symbol("ETH/USDT");
+
+    EXPECT_NE(btc, eth);
+    EXPECT_EQ(intern_symbol("BTC/USDT"), btc);
+    EXPECT_EQ(symbol_name(btc), "BTC/USDT");
+    EXPECT_EQ(SymbolRegistry::instance().find("BTC/USDT"), btc);
+    EXPECT_EQ(SymbolRegistry::instance().find("UNKNOWN/PAIR"), INVALID_CODE);
+    EXPECT_TRUE(symbol_name(INVALID_CODE).empty());
+}
+
+TEST(SymbolRegistryTest, FullRegistryReturnsInvalidCode) {
+    NameRegistry<2> registry;
+    uint16_t first = registry.intern("binance");
+    uint16_t second = registry.intern("upbit");
+
+    EXPECT_EQ(registry.intern("coinbase"), INVALID_CODE);
+    EXPECT_EQ(registry.rejected(), 1);
+    EXPECT_EQ(registry.size(), 2);
+    EXPECT_EQ(registry.find("coinbase"), INVALID_CODE);
+    // Names interned before the registry filled keep their codes
+    EXPECT_EQ(registry.intern("binance"), first);
+    EXPECT_EQ(registry.intern("upbit"), second);
+}
+
+TEST(SymbolRegistryTest, CompactTickerRoundTrip) {
+    int64_t timestamp = 1700000000000;
+    Ticker ticker("BTC/USDT", "binance", 49900.0, 50000.0, 49950.0, 1000.0, timestamp);
+
+    CompactTicker compact = to_compact(ticker);
+    EXPECT_EQ(compact.symbol, intern_symbol("BTC/USDT"));
+    EXPECT_EQ(compact.exchange, intern_exchange("binance"));
+
+    Ticker restored = to_ticker(compact);
+    EXPECT_EQ(restored.symbol, ticker.symbol);
+    EXPECT_EQ(restored.exchange, ticker.exchange);
+    EXPECT_EQ(restored.bid, ticker.bid);
+    EXPECT_EQ(restored.ask, ticker.ask);
+    EXPECT_EQ(restored.timestamp, ticker.timestamp);
+}
+
+// Ticker Wire Tests
+TEST(TickerWireTest, DictionaryAndTickerRoundTrip) {
+    CompactTicker ticker = to_compact(Ticker("BTC/USDT", "binance", 49900.0, 50000.0, 49950.0, 12.5, 1700000000000));
+    TickerWireEncoder encoder;
+    std::string message;
+    encoder.encode(ticker, message);
+
+    // The first message announces both codes ahead of the ticker
+    EXPECT_TRUE(is_binary_frame(message));
+    EXPECT_GT(message.size(), wire::TICKER_FRAME_SIZE);
+
+    TickerWireDecoder decoder;
+    CompactTicker decoded;
+    ASSERT_EQ(decoder.decode(message, decoded), TickerWireDecoder::Status::TICKER);
+    EXPECT_EQ(decoded.symbol, ticker.symbol);
+    EXPECT_EQ(decoded.exchange, ticker.exchange);
+    EXPECT_EQ(decoded.bid, ticker.bid);
+    EXPECT_EQ(decoded.ask, ticker.ask);
+    EXPECT_EQ(decoded.last, ticker.last);
+    EXPECT_EQ(decoded.volume, ticker.volume);
+    EXPECT_EQ(decoded.timestamp, ticker.timestamp);
+
+    // Later messages carry the ticker frame alone
+    encoder.encode(ticker, message);
+    EXPECT_EQ(message.size(), wire::TICKER_FRAME_SIZE);
+    ASSERT_EQ(decoder.decode(message, decoded), TickerWireDecoder::Status::TICKER);
+    EXPECT_EQ(decoder.last_sequence(), encoder.sequence());
+    EXPECT_EQ(decoder.sequence_gaps(), 0u);
+}
+
+TEST(TickerWireTest, TruncatedFrameIsMalformed) {
+    CompactTicker ticker = to_compact(Ticker("ETH/USDT", "upbit", 2990.0, 3000.0, 2995.0, 4.0, 1700000000000));
+    TickerWireEncoder encoder;
+    std::string message;
+    encoder.encode(ticker, message);
+
+    TickerWireDecoder decoder;
+    CompactTicker decoded;
+    std::string truncated = message.substr(0, message.size() - 1);
+    EXPECT_EQ(decoder.decode(truncated, decoded), TickerWireDecoder::Status::MALFORMED);
+    EXPECT_EQ(decoder.decode(std::string_view(message.data(), 2), decoded), TickerWireDecoder::Status::MALFORMED);
+}
+
+TEST(TickerWireTest, TickerBeforeDictionaryIsUnknown) {
+    CompactTicker ticker = to_compact(Ticker("BTC/USDT", "binance", 49900.0, 50000.0, 49950.0, 1.0, 1700000000000));
+    TickerWireEncoder encoder;
+    std::string first;
+    std::string second;
+    encoder.encode(ticker, first);
+    encoder.encode(ticker, second);
+
+    // A subscriber that joined after the announcement cannot map the codes
+    TickerWireDecoder decoder;
+    CompactTicker decoded;
+    EXPECT_EQ(decoder.decode(second, decoded), TickerWireDecoder::Status::UNKNOWN_CODE);
+
+    // Once it sees the dictionary, the same frame decodes
+    EXPECT_EQ(decoder.decode(first, decoded), TickerWireDecoder::Status::TICKER);
+    EXPECT_EQ(decoder.decode(second, decoded), TickerWireDecoder::Status::TICKER);
+    EXPECT_EQ(decoded.symbol, ticker.symbol);
+}
+
+// Fast Feed Parser Tests
+TEST(FastFeedParserTest, StringEscapesDoNotEndTheValue) {
+    FeedSchema schema;
+    schema.map(FeedField::SYMBOL, "s").map(FeedField::LAST_PRICE, "c");
+    FastFeedParser parser(std::move(schema));
+
+    FeedFields fields;
+    ASSERT_TRUE(parser.parse(R"({"note":"a \"quoted\" \\ value","s":"BTC\"USDT","c":"50000.5"})", fields));
+    // Escapes are left encoded
+    EXPECT_EQ(fields.text(FeedField::SYMBOL), R"(BTC\"USDT)");
+    EXPECT_DOUBLE_EQ(fields.number(FeedField::LAST_PRICE), 50000.5);
+}
+
+TEST(FastFeedParserTest, SkipsNestedObjectsAndArrays) {
+    FeedSchema schema;
+    schema.map(FeedField::SYMBOL, "data.s").map(FeedField::VOLUME, "data.v");
+    FastFeedParser parser(std::move(schema));
+
+    FeedFields fields;
+    ASSERT_TRUE(parser.parse(
+        R"({"meta":{"a":[1,{"b":"]}"},[2,3]],"s":"decoy"},"list":[[],{}],"data":{"x":{"s":"nested"},"s":"ETHUSDT","v":12}})",
+        fields));
+    EXPECT_EQ(fields.text(FeedField::SYMBOL), "ETHUSDT");
+    EXPECT_DOUBLE_EQ(fields.number(FeedField::VOLUME), 12.0);
+    EXPECT_EQ(fields.size(), 2u);
+}
+
+TEST(FastFeedParserTest, ReadsDepthLevels) {
+    FeedSchema schema;
+    schema.map(FeedField::BIDS, "b").map(FeedField::ASKS, "a").map(FeedField::UPDATE_ID, "u");
+    FastFeedParser parser(std::move(schema));
+
+    FeedFields fields;
+    ASSERT_TRUE(parser.parse(
+        R"({"u":160,"b":[["100.5","2.0"],["100.4","3.5"],["100.3","1"]],"a":[[101,0.25]]})", fields));
+    EXPECT_EQ(fields.integer(FeedField::UPDATE_ID), 160);
+
+    PriceLevel levels[2];
+    ASSERT_EQ(fields.read_levels(FeedField::BIDS, levels, 2), 2u); // capped at capacity
+    EXPECT_DOUBLE_EQ(levels[0].price, 100.5);
+    EXPECT_DOUBLE_EQ(levels[0].quantity, 2.0);
+    EXPECT_DOUBLE_EQ(levels[1].price, 100.4);
+    EXPECT_DOUBLE_EQ(levels[1].quantity, 3.5);
+
+    ASSERT_EQ(fields.read_levels(FeedField::ASKS, levels, 2), 1u);
+    EXPECT_DOUBLE_EQ(levels[0].price, 101.0);
+    EXPECT_DOUBLE_EQ(levels[0].quantity, 0.25);
+}
+
+TEST(FastFeedParserTest, NumbersAcceptedAsStrings) {
+    FeedSchema schema;
+    schema.map(FeedField::BID_PRICE, "b").map(FeedField::EVENT_TIME, "E")
+          .map(FeedField::BUYER_MAKER, "m").map(FeedField::ASK_PRICE, "a");
+    FastFeedParser parser(std::move(schema));
+
+    FeedFields fields;
+    ASSERT_TRUE(parser.parse(R"({"b":"0.00012300","E":"1700000000000","m":true,"a":2.5e3})", fields));
+    EXPECT_DOUBLE_EQ(fields.number(FeedField::BID_PRICE), 0.000123);
+    EXPECT_EQ(fields.integer(FeedField::EVENT_TIME), 1700000000000);
+    EXPECT_TRUE(fields.boolean(FeedField::BUYER_MAKER));
+    EXPECT_DOUBLE_EQ(fields.number(FeedField::ASK_PRICE), 2500.0);
+    EXPECT_DOUBLE_EQ(fields.number(FeedField::LAST_PRICE, -1.0), -1.0); // not mapped
+}
+
+TEST(FastFeedParserTest, RejectsTruncatedAndMalformedInput) {
+    FeedSchema schema;
+    schema.map(FeedField::SYMBOL, "s").map(FeedField::LAST_PRICE, "x.c");
+    FastFeedParser parser(std::move(schema));
+
+    FeedFields fields;
+    EXPECT_FALSE(parser.parse("", fields));
+    fields.clear();
+    EXPECT_FALSE(parser.parse(R"({"s":"BTCUSDT","x":{"c":"5)", fields));
+    fields.clear();
+    EXPECT_FALSE(parser.parse(R"({"s":"BTCUS)", fields));
+    fields.clear();
+    EXPECT_FALSE(parser.parse(R"({"skip":[1,2,{"a":)", fields));
+}
+
 // Main test runner
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
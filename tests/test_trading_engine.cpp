@@ -0,0 +1,515 @@
+#include <gtest/gtest.h>
+#include "fill_simulator.hpp"
+#include "opportunity_queue.hpp"
+#include "order_template.hpp"
+#include "spread_calculator.hpp"
+#include "trade_journal.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ats;
+using namespace ats::trading_engine;
+
+namespace {
+
+MarketDepth make_book(const std::string& exchange, double mid, std::chrono::system_clock::time_point timestamp) {
+    MarketDepth book;
+    book.symbol = "BTC/USDT";
+    book.exchange = exchange;
+    book.timestamp = timestamp;
+    for (int level = 0; level < 10; ++level) {
+        book.bids.emplace_back(mid - 0.5 - level, 0.2 + 0.1 * level);
+        book.asks.emplace_back(mid + 0.5 + level, 0.2 + 0.1 * level);
+    }
+    return book;
+}
+
+ArbitrageOpportunity make_opportunity(double quantity, std::chrono::system_clock::time_point detected_at) {
+    ArbitrageOpportunity opportunity;
+    opportunity.symbol = "BTC/USDT";
+    opportunity.buy_exchange = "binance";
+    opportunity.sell_exchange = "upbit";
+    opportunity.buy_price = 50000.5;
+    opportunity.sell_price = 50019.5;
+    opportunity.available_quantity = quantity;
+    opportunity.detected_at = detected_at;
+    return opportunity;
+}
+
+// Each sell exchange is its own route, so these never replace one another
+ArbitrageOpportunity make_queued(const std::string& sell_exchange, double expected_profit,
+                                 std::chrono::system_clock::time_point detected_at) {
+    ArbitrageOpportunity opportunity = make_opportunity(1.0, detected_at);
+    opportunity.sell_exchange = sell_exchange;
+    opportunity.expected_profit = expected_profit;
+    return opportunity;
+}
+
+std::vector<std::string> drain(OpportunityQueue& queue, std::chrono::system_clock::time_point now) {
+    std::vector<std::string> routes;
+    ArbitrageOpportunity out;
+    while (queue.pop(out, now)) {
+        routes.push_back(out.sell_exchange);
+    }
+    return routes;
+}
+
+bool same_fill(const SimulatedFill& a, const SimulatedFill& b) {
+    return a.result == b.result &&
+           a.executed_quantity == b.executed_quantity &&
+           a.unwound_quantity == b.unwound_quantity &&
+           a.total_fees == b.total_fees &&
+           a.profit == b.profit &&
+           a.latency == b.latency &&
+           a.buy.filled_quantity == b.buy.filled_quantity &&
+           a.sell.filled_quantity == b.sell.filled_quantity &&
+           a.buy.notional == b.buy.notional &&
+           a.sell.notional == b.sell.notional;
+}
+
+// Runs a fixed script of orders, with and without cached books
+std::vector<SimulatedFill> run_script(FillSimulator& simulator, std::chrono::system_clock::time_point start) {
+    MarketDepth buy_book = make_book("binance", 50000.0, start);
+    MarketDepth sell_book = make_book("upbit", 50020.0, start);
+
+    std::vector<SimulatedFill> fills;
+    for (int i = 0; i < 200; ++i) {
+        auto now = start + std::chrono::milliseconds(i * 7);
+        ArbitrageOpportunity opportunity = make_opportunity(0.1 + 0.05 * (i % 20), start);
+        bool with_books = i % 5 != 0;
+        fills.push_back(simulator.simulate(opportunity,
+                                           with_books ? &buy_book : nullptr,
+                                           with_books ? &sell_book : nullptr,
+                                           now));
+    }
+    return fills;
+}
+
+int64_t now_millis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+using OpportunityKey = std::pair<std::string, std::string>; // buy, sell
+
+std::map<OpportunityKey, double> by_route(const std::vector<ArbitrageOpportunity>& opportunities) {
+    std::map<OpportunityKey, double> routes;
+    for (const auto& opportunity : opportunities) {
+        routes[{opportunity.buy_exchange, opportunity.sell_exchange}] = opportunity.expected_profit;
+    }
+    return routes;
+}
+
+TradeExecution make_execution(int n) {
+    TradeExecution execution;
+    execution.trade_id = "trade-" + std::to_string(n);
+    execution.symbol = "BTC/USDT";
+    execution.buy_exchange = "binance";
+    execution.sell_exchange = "upbit";
+    execution.quantity = n;
+    execution.executed_quantity = n;
+    execution.actual_profit = n * 0.5;
+    execution.result = ExecutionResult::SUCCESS;
+    execution.timestamp = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000 + n));
+    return execution;
+}
+
+} // namespace
+
+// Fill Simulator Tests
+TEST(FillSimulatorTest, SameSeedGivesSameFills) {
+    auto start = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    FillSimulatorConfig config;
+    config.seed = 42;
+
+    FillSimulator first(config);
+    FillSimulator second(config);
+    auto expected = run_script(first, start);
+    auto actual = run_script(second, start);
+
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_TRUE(same_fill(expected[i], actual[i])) << "fill " << i << " differs";
+    }
+    EXPECT_EQ(first.get_partial_fills(), second.get_partial_fills());
+    EXPECT_EQ(first.get_unfilled_orders(), second.get_unfilled_orders());
+
+    // reset() replays the sequence from scratch, consumed liquidity included
+    first.reset(42);
+    auto replayed = run_script(first, start);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_TRUE(same_fill(expected[i], replayed[i])) << "fill " << i << " differs after reset";
+    }
+
+    // Another seed draws other latencies
+    FillSimulator other(FillSimulatorConfig{});
+    other.reset(7);
+    auto different = run_script(other, start);
+    bool any_difference = false;
+    for (size_t i = 0; i < expected.size() && !any_difference; ++i) {
+        any_difference = !same_fill(expected[i], different[i]);
+    }
+    EXPECT_TRUE(any_difference);
+}
+
+TEST(FillSimulatorTest, CountsPartialUnfilledAndMissingDepth) {
+    auto now = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    FillSimulatorConfig config;
+    config.competing_flow = 0.0;
+    config.volatility_bps = 0.0;
+    FillSimulator simulator(config);
+
+    MarketDepth buy_book = make_book("binance", 50000.0, now);
+    MarketDepth sell_book = make_book("upbit", 50020.0, now);
+
+    // Each side holds 6.5 in total, so a larger order fills partially
+    auto partial = simulator.simulate(make_opportunity(10.0, now), &buy_book, &sell_book, now);
+    EXPECT_EQ(partial.result, ExecutionResult::PARTIAL_SUCCESS);
+
+    // An ask far above the book's reach leaves nothing to buy
+    MarketDepth empty_asks = buy_book;
+    for (auto& level : empty_asks.asks) {
+        level.first *= 2.0;
+    }
+    auto unfilled = simulator.simulate(make_opportunity(0.1, now), &empty_asks, &sell_book, now);
+    EXPECT_EQ(unfilled.result, ExecutionResult::FAILURE);
+
+    // The first order emptied the cached bids; a newer snapshot restores them
+    MarketDepth fresh_bids = make_book("upbit", 50020.0, now + std::chrono::milliseconds(1));
+    auto without_depth = simulator.simulate(make_opportunity(0.1, now), nullptr, &fresh_bids, now);
+    EXPECT_EQ(without_depth.result, ExecutionResult::SUCCESS);
+
+    EXPECT_EQ(simulator.get_fills_simulated(), 3u);
+    EXPECT_EQ(simulator.get_partial_fills(), 1u);
+    EXPECT_EQ(simulator.get_unfilled_orders(), 1u);
+    EXPECT_EQ(simulator.get_fills_without_depth(), 1u);
+}
+
+TEST(FillSimulatorTest, MissingDepthFillsTheQuotedQuantity) {
+    auto now = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    FillSimulatorConfig config;
+    config.volatility_bps = 0.0;  // competing_flow stays at its default
+    FillSimulator simulator(config);
+
+    // The synthetic level is the order itself, so takers ahead would only
+    // shave off our own quantity
+    for (int i = 0; i < 50; ++i) {
+        auto fill = simulator.simulate(make_opportunity(0.5, now), nullptr, nullptr, now);
+        EXPECT_EQ(fill.result, ExecutionResult::SUCCESS) << "fill " << i;
+        EXPECT_DOUBLE_EQ(fill.executed_quantity, 0.5);
+    }
+    EXPECT_EQ(simulator.get_partial_fills(), 0u);
+    EXPECT_EQ(simulator.get_fills_without_depth(), 50u);
+}
+
+// Opportunity Queue Tests
+TEST(OpportunityQueueTest, StalePushesDoNotCountAsSuperseded) {
+    auto now = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    OpportunityQueue queue(16, std::chrono::milliseconds(0));
+
+    EXPECT_EQ(queue.push(make_opportunity(1.0, now), now), OpportunityQueue::PushResult::QUEUED);
+    EXPECT_EQ(queue.push(make_opportunity(2.0, now - std::chrono::milliseconds(5)), now),
+              OpportunityQueue::PushResult::STALE);
+    EXPECT_EQ(queue.superseded_count(), 0u);
+
+    EXPECT_EQ(queue.push(make_opportunity(3.0, now + std::chrono::milliseconds(5)), now),
+              OpportunityQueue::PushResult::REPLACED);
+    EXPECT_EQ(queue.superseded_count(), 1u);
+    EXPECT_EQ(queue.size(), 1u);
+}
+
+TEST(OpportunityQueueTest, PopsMostProfitableFirst) {
+    auto now = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    OpportunityQueue queue(16, std::chrono::milliseconds(0));
+
+    for (const auto& [route, profit] : std::vector<std::pair<std::string, double>>{
+             {"two", 2.0}, {"five-old", 5.0}, {"one", 1.0}, {"five-new", 5.0}}) {
+        ASSERT_EQ(queue.push(make_queued(route, profit, now), now), OpportunityQueue::PushResult::QUEUED);
+    }
+
+    // Equal profits leave in arrival order
+    EXPECT_EQ(drain(queue, now), (std::vector<std::string>{"five-old", "five-new", "two", "one"}));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(OpportunityQueueTest, PopDiscardsExpiredEntries) {
+    auto now = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    OpportunityQueue queue(16, std::chrono::milliseconds(100));
+
+    // The queue TTL caps the default five second validity window
+    queue.push(make_queued("stale", 10.0, now - std::chrono::milliseconds(50)), now);
+    queue.push(make_queued("fresh", 1.0, now + std::chrono::milliseconds(100)), now);
+
+    ArbitrageOpportunity out;
+    ASSERT_TRUE(queue.pop(out, now + std::chrono::milliseconds(120)));
+    EXPECT_EQ(out.sell_exchange, "fresh");
+    EXPECT_EQ(queue.expired_count(), 1u);
+    EXPECT_FALSE(queue.pop(out, now + std::chrono::milliseconds(120)));
+}
+
+TEST(OpportunityQueueTest, FullQueuePurgesExpiredBeforeRejecting) {
+    auto now = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    OpportunityQueue queue(2, std::chrono::milliseconds(100));
+
+    queue.push(make_queued("a", 10.0, now), now);
+    queue.push(make_queued("b", 9.0, now), now);
+
+    // Both queued entries outprofit it, but both are dead by now
+    auto later = now + std::chrono::milliseconds(200);
+    EXPECT_EQ(queue.push(make_queued("c", 1.0, later), later), OpportunityQueue::PushResult::QUEUED);
+    EXPECT_EQ(queue.expired_count(), 2u);
+    EXPECT_EQ(queue.rejected_count(), 0u);
+    EXPECT_EQ(queue.evicted_count(), 0u);
+    EXPECT_EQ(drain(queue, later), (std::vector<std::string>{"c"}));
+}
+
+TEST(OpportunityQueueTest, FullQueueEvictsLeastProfitable) {
+    auto now = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    OpportunityQueue queue(2, std::chrono::milliseconds(0));
+
+    queue.push(make_queued("best", 3.0, now), now);
+    queue.push(make_queued("worst", 1.0, now), now);
+
+    // Only a strictly better entry displaces the least profitable one
+    EXPECT_EQ(queue.push(make_queued("tie", 1.0, now), now), OpportunityQueue::PushResult::FULL);
+    EXPECT_EQ(queue.rejected_count(), 1u);
+    EXPECT_EQ(queue.push(make_queued("better", 2.0, now), now), OpportunityQueue::PushResult::QUEUED);
+    EXPECT_EQ(queue.evicted_count(), 1u);
+    EXPECT_EQ(queue.size(), 2u);
+
+    EXPECT_EQ(drain(queue, now), (std::vector<std::string>{"best", "better"}));
+}
+
+// Order Template Tests
+TEST(HmacSha256SignerTest, MatchesRfc4231Vectors) {
+    struct Vector {
+        std::string key;
+        std::string data;
+        std::string digest;
+    };
+    std::string key_25;
+    for (char byte = 0x01; byte <= 0x19; ++byte) {
+        key_25 += byte;
+    }
+    // Test cases 1-4, 6 and 7; the last two use a 131-byte key, longer
+    // than the SHA-256 block, which must be hashed first
+    const std::vector<Vector> vectors = {
+        {std::string(20, '\x0b'), "Hi There",
+         "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7"},
+        {"Jefe", "what do ya want for nothing?",
+         "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"},
+        {std::string(20, '\xaa'), std::string(50, '\xdd'),
+         "773ea91e36800e46854db8ebd09181a72959098b3ef8c122d9635514ced565fe"},
+        {key_25, std::string(50, '\xcd'),
+         "82558a389a443c0ea4cc819899f2083a85f0faa3e578f8077a2e3ff46729665b"},
+        {std::string(131, '\xaa'), "Test Using Larger Than Block-Size Key - Hash Key First",
+         "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54"},
+        {std::string(131, '\xaa'),
+         "This is a test using a larger than block-size key and a larger than block-size data. "
+         "The key needs to be hashed before being used by the HMAC algorithm.",
+         "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2"},
+    };
+
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        HmacSha256Signer signer(vectors[i].key);
+        EXPECT_EQ(signer.hex_signature(vectors[i].data), vectors[i].digest) << "vector " << i;
+        // The precomputed key states must survive repeated signing
+        EXPECT_EQ(signer.hex_signature(vectors[i].data), vectors[i].digest) << "vector " << i;
+
+        std::string appended = "signature=";
+        signer.append_hex_signature(appended, vectors[i].data.data(), vectors[i].data.size());
+        EXPECT_EQ(appended, "signature=" + vectors[i].digest) << "vector " << i;
+    }
+}
+
+TEST(RoundingTableTest, DownTruncatesAndNearestRounds) {
+    RoundingTable step(0.001);
+    EXPECT_DOUBLE_EQ(step.round(1.2346, RoundingTable::Mode::DOWN), 1.234);
+    EXPECT_DOUBLE_EQ(step.round(1.2346, RoundingTable::Mode::NEAREST), 1.235);
+    EXPECT_DOUBLE_EQ(step.round(1.2344, RoundingTable::Mode::NEAREST), 1.234);
+
+    // Exact multiples must not floor one step short
+    RoundingTable tenths(0.1);
+    EXPECT_DOUBLE_EQ(tenths.round(0.3, RoundingTable::Mode::DOWN), 0.3);
+    EXPECT_DOUBLE_EQ(tenths.round(0.7, RoundingTable::Mode::DOWN), 0.7);
+    EXPECT_DOUBLE_EQ(tenths.round(-0.5, RoundingTable::Mode::NEAREST), 0.0);
+}
+
+TEST(RoundingTableTest, FormatsOnTheTickAndStepGrid) {
+    auto text = [](const RoundingTable& table, double value, RoundingTable::Mode mode) {
+        std::string out = "x=";
+        table.append(out, value, mode);
+        return out;
+    };
+
+    RoundingTable step(0.001);
+    EXPECT_EQ(text(step, 1.2346, RoundingTable::Mode::DOWN), "x=1.234");
+    EXPECT_EQ(text(step, 1.2346, RoundingTable::Mode::NEAREST), "x=1.235");
+    EXPECT_EQ(text(step, 2.0, RoundingTable::Mode::DOWN), "x=2.000");
+
+    // Leading zeros of the fraction are kept
+    RoundingTable fine(0.00001);
+    EXPECT_EQ(text(fine, 0.000123456, RoundingTable::Mode::DOWN), "x=0.00012");
+
+    RoundingTable tenths(0.1);
+    EXPECT_EQ(text(tenths, 0.3, RoundingTable::Mode::DOWN), "x=0.3");
+
+    // Whole-number ticks print without a decimal point
+    RoundingTable thousands(1000.0);
+    EXPECT_EQ(text(thousands, 50123456.7, RoundingTable::Mode::NEAREST), "x=50123000");
+    EXPECT_EQ(text(thousands, 50123956.7, RoundingTable::Mode::DOWN), "x=50123000");
+
+    // Price-dependent bands pick the tick of the band the value falls in
+    RoundingTable krw({{0.0, 0.1}, {100.0, 1.0}, {1000000.0, 500.0}, {2000000.0, 1000.0}});
+    EXPECT_EQ(text(krw, 2345678.0, RoundingTable::Mode::DOWN), "x=2345000");
+    EXPECT_EQ(text(krw, 1234567.0, RoundingTable::Mode::NEAREST), "x=1234500");
+    EXPECT_EQ(text(krw, 950.6, RoundingTable::Mode::NEAREST), "x=951");
+    EXPECT_EQ(text(krw, 12.34, RoundingTable::Mode::NEAREST), "x=12.3");
+}
+
+TEST(RoundingTableTest, LargeQuantitiesOnAFineStepKeepEveryStep) {
+    // Hundreds of units on a 1e-8 step are ~5e10 steps, where the product
+    // carries an error far larger than any fixed tolerance
+    RoundingTable step(1e-8);
+    std::string out;
+    step.append(out, 534.63659931, RoundingTable::Mode::DOWN);
+    EXPECT_EQ(out, "534.63659931");
+    out.clear();
+    step.append(out, 534.636599309, RoundingTable::Mode::DOWN);
+    EXPECT_EQ(out, "534.63659930");
+
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t units = 10000000000ULL + rng() % 90000000000ULL;
+        char expected[32];
+        std::snprintf(expected, sizeof(expected), "%llu.%08llu",
+                      static_cast<unsigned long long>(units / 100000000),
+                      static_cast<unsigned long long>(units % 100000000));
+        out.clear();
+        step.append(out, std::strtod(expected, nullptr), RoundingTable::Mode::DOWN);
+        ASSERT_EQ(out, expected);
+    }
+}
+
+// Spread Calculator Tests
+TEST(SpreadCalculatorTest, FullScanAndIncrementalPathsAgree) {
+    SpreadCalculator calculator;
+
+    // A taker fee above the raw spread and a symbol-specific discount: the
+    // full scan must not pre-judge pairs with a fee model of its own
+    ExchangeFeeStructure cheap;
+    cheap.taker_fee = 0.0005;
+    ExchangeFeeStructure expensive;
+    expensive.taker_fee = 0.007;
+    ExchangeFeeStructure discounted;
+    discounted.taker_fee = 0.002;
+    discounted.symbol_specific_fees["ETH/USDT"] = 0.0;
+    calculator.update_fee_structures({{"spread-a", cheap}, {"spread-b", expensive}, {"spread-c", discounted},
+                                      {"spread-d", cheap}});
+
+    const int64_t now = now_millis();
+    std::vector<types::Ticker> tickers = {
+        types::Ticker("ETH/USDT", "spread-a", 2999.0, 3000.0, 3000.0, 500.0, now),
+        types::Ticker("ETH/USDT", "spread-b", 3018.0, 3019.0, 3018.0, 500.0, now),
+        types::Ticker("ETH/USDT", "spread-c", 3006.0, 3007.0, 3006.0, 500.0, now),
+        types::Ticker("ETH/USDT", "spread-d", 3001.0, 3002.0, 3001.0, 500.0, now),
+    };
+    for (const auto& ticker : tickers) {
+        calculator.update_ticker(ticker);
+    }
+
+    for (double min_profit : {0.0, 1.0}) {
+        auto full = by_route(calculator.detect_arbitrage_opportunities(min_profit));
+
+        std::map<OpportunityKey, double> incremental;
+        for (const auto& ticker : tickers) {
+            auto routes = by_route(calculator.detect_arbitrage_opportunities(ticker, min_profit));
+            incremental.insert(routes.begin(), routes.end());
+        }
+
+        EXPECT_EQ(full.size(), incremental.size()) << "min_profit " << min_profit;
+        for (const auto& [route, profit] : full) {
+            auto it = incremental.find(route);
+            ASSERT_NE(it, incremental.end()) << route.first << " -> " << route.second;
+            EXPECT_DOUBLE_EQ(it->second, profit);
+        }
+    }
+
+    // Buying on a and selling on c only pays at c's symbol rate; c's base
+    // taker fee alone would have priced it out
+    auto profitable = by_route(calculator.detect_arbitrage_opportunities(0.0));
+    EXPECT_EQ(profitable.count({"spread-a", "spread-c"}), 1u);
+    // b's fee exceeds its raw spread, so neither path reports it
+    EXPECT_EQ(profitable.count({"spread-a", "spread-b"}), 0u);
+}
+
+TEST(SpreadCalculatorTest, TickerUpdatesSampleRawSpreads) {
+    SpreadCalculator calculator;
+    const int64_t now = now_millis();
+    calculator.update_ticker(types::Ticker("SOL/USDT", "sample-a", 99.0, 100.0, 99.5, 500.0, now));
+    calculator.update_ticker(types::Ticker("SOL/USDT", "sample-b", 101.0, 102.0, 101.5, 500.0, now));
+
+    // The second update samples both directions against the first exchange
+    auto history = calculator.get_historical_spreads("SOL/USDT", std::chrono::hours(1));
+    ASSERT_EQ(history.size(), 2u);
+    auto routes = std::map<OpportunityKey, double>{};
+    for (const auto& analysis : history) {
+        routes[{analysis.buy_exchange, analysis.sell_exchange}] = analysis.spread_percentage;
+    }
+    EXPECT_DOUBLE_EQ(routes.at({"sample-a", "sample-b"}), 1.0);
+    EXPECT_DOUBLE_EQ(routes.at({"sample-b", "sample-a"}), (99.0 - 102.0) / 102.0 * 100.0);
+    EXPECT_DOUBLE_EQ(calculator.get_average_spread("SOL/USDT", "sample-a", "sample-b", std::chrono::hours(1)), 1.0);
+}
+
+// Trade Journal Tests
+TEST(TradeJournalTest, FailedFlushLeavesColumnsAligned) {
+    const auto directory = std::filesystem::temp_directory_path() / "ats_test_trade_journal";
+    std::filesystem::remove_all(directory);
+    {
+        TradeJournal journal;
+        ASSERT_TRUE(journal.open(directory.string()));
+        journal.append(make_execution(1));
+        ASSERT_TRUE(journal.flush());
+        ASSERT_EQ(journal.partition_count(), 1u);
+
+        // A directory in place of a column file fails the flush after the
+        // columns before it were already appended
+        auto partition = std::filesystem::directory_iterator(directory / "partitions")->path();
+        std::filesystem::rename(partition / "quantity.bin", partition / "quantity.bin.saved");
+        std::filesystem::create_directory(partition / "quantity.bin");
+        journal.append(make_execution(2));
+        journal.append(make_execution(3));
+        EXPECT_FALSE(journal.flush());
+
+        std::filesystem::remove(partition / "quantity.bin");
+        std::filesystem::rename(partition / "quantity.bin.saved", partition / "quantity.bin");
+        EXPECT_TRUE(journal.flush());
+        journal.append(make_execution(4));
+        EXPECT_TRUE(journal.flush());
+    }
+
+    TradeJournal reopened;
+    ASSERT_TRUE(reopened.open(directory.string()));
+    auto trades = reopened.query_trades(TradeJournal::TimePoint{}, TradeJournal::TimePoint::max());
+    ASSERT_EQ(trades.size(), 4u);
+    for (size_t i = 0; i < trades.size(); ++i) {
+        auto expected = make_execution(static_cast<int>(i) + 1);
+        EXPECT_EQ(trades[i].trade_id, expected.trade_id);
+        EXPECT_EQ(trades[i].timestamp, expected.timestamp);
+        EXPECT_DOUBLE_EQ(trades[i].quantity, expected.quantity);
+        EXPECT_DOUBLE_EQ(trades[i].actual_profit, expected.actual_profit);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ats {
+namespace trading_engine {
+
+// One side of an order book with cumulative quantity and notional prefix
+// sums, so the cost of taking any quantity is a binary search instead of a
+// level-by-level walk. Levels are ordered best price first.
+class DepthLadder {
+public:
+    enum class Side { BID, ASK };
+
+    DepthLadder() = default;
+    DepthLadder(const std::vector<std::pair<double, double>>& levels, Side side); // price, quantity
+
+    bool empty() const { return prices_.empty(); }
+    size_t levels() const { return prices_.size(); }
+    double total_quantity() const { return cumulative_quantity_.empty() ? 0.0 : cumulative_quantity_.back(); }
+    double best_price() const { return prices_.empty() ? 0.0 : prices_.front(); }
+
+    // Index of the level that fills the quantity just after `quantity`
+    // has been taken; levels() if the book is exhausted
+    size_t level_at(double quantity) const;
+
+    // Price of the marginal unit after `quantity` has been taken
+    double marginal_price(double quantity) const;
+
+    // Notional of taking `quantity`, clamped to the available depth
+    double notional(double quantity) const;
+
+    // Price of the last level touched when taking `quantity`
+    double limit_price(double quantity) const;
+
+    // Cumulative quantity at the end of each level
+    const std::vector<double>& boundaries() const { return cumulative_quantity_; }
+
+private:
+    Side side_ = Side::ASK;
+    std::vector<double> prices_;
+    std::vector<double> cumulative_quantity_;
+    std::vector<double> cumulative_notional_;
+};
+
+// Size of a two-leg taker trade that maximizes net profit
+struct ExecutableSize {
+    double quantity = 0.0;
+    double buy_vwap = 0.0;
+    double sell_vwap = 0.0;
+    double buy_limit_price = 0.0;   // worst ask level swept
+    double sell_limit_price = 0.0;  // worst bid level swept
+    double buy_notional = 0.0;
+    double sell_notional = 0.0;
+    double net_profit = 0.0;        // after costs
+};
+
+// Finds the quantity maximizing
+//   sell_notional(q) * sell_factor - buy_notional(q) * buy_factor
+// for q <= max_quantity, where the factors fold in fees and proportional
+// slippage (buy_factor = 1 + costs, sell_factor = 1 - costs). The marginal
+// profit is non-increasing in q and only changes at level boundaries, so the
+// optimum is found by binary search over the ask boundaries and then over
+// the bid boundaries inside the chosen ask level, O(log^2 levels) overall.
+ExecutableSize solve_executable_size(const DepthLadder& asks, const DepthLadder& bids,
+                                     double buy_factor, double sell_factor, double max_quantity);
+
+} // namespace trading_engine
+} // namespace ats
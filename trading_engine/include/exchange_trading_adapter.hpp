@@ -1,6 +1,7 @@
 #pragma once
 
 #include "order_router.hpp"
+#include "order_template.hpp"
 #include "exchange/exchange_interface.hpp"
 #include "types/common_types.hpp"
 #include <memory>
@@ -107,6 +108,10 @@ public:
     std::map<std::string, std::string> create_signed_headers(const std::string& method, 
                                                            const std::string& endpoint,
                                                            const std::string& body = "");
+    const std::string& api_key() const;
+    
+    // HMAC-SHA256 keyed with the API secret, reused across requests
+    const HmacSha256Signer& signer() const;
     
     // Rate limiting
     void set_rate_limit(int requests_per_second);
@@ -166,9 +171,14 @@ public:
     std::string get_last_error() const override;
     void clear_error() override;
     bool is_healthy() const override;
+    
+    // Order templates: exchange tick/step filters and warm-up for hot symbols
+    void set_symbol_filters(const std::string& symbol, double tick_size, double step_size);
+    void prepare_order_templates(const std::string& symbol);
 
 private:
     std::unique_ptr<ExchangeRestClient> rest_client_;
+    std::unique_ptr<OrderTemplateCache> order_templates_;
     std::string exchange_id_;
     std::string last_error_;
     std::atomic<bool> connected_{false};
@@ -185,6 +195,8 @@ private:
     std::string order_side_to_string(types::OrderSide side);
     std::string order_type_to_string(types::OrderType type);
     std::string symbol_to_binance_format(const std::string& symbol);
+    OrderTemplate build_order_template(const std::string& symbol, types::OrderSide side,
+                                       types::OrderType type, const SymbolRounding& rounding);
     double round_to_tick_size(double price, const std::string& symbol);
     double round_to_step_size(double quantity, const std::string& symbol);
 };
@@ -230,9 +242,14 @@ public:
     std::string get_last_error() const override;
     void clear_error() override;
     bool is_healthy() const override;
+    
+    // Order templates: exchange tick/step filters and warm-up for hot symbols
+    void set_symbol_filters(const std::string& symbol, double tick_size, double step_size);
+    void prepare_order_templates(const std::string& symbol);
 
 private:
     std::unique_ptr<ExchangeRestClient> rest_client_;
+    std::unique_ptr<OrderTemplateCache> order_templates_;
     std::string exchange_id_;
     std::string last_error_;
     std::atomic<bool> connected_{false};
@@ -249,6 +266,8 @@ private:
     std::string order_side_to_string(types::OrderSide side);
     std::string order_type_to_string(types::OrderType type);
     std::string symbol_to_upbit_format(const std::string& symbol);
+    OrderTemplate build_order_template(const std::string& symbol, types::OrderSide side,
+                                       types::OrderType type, const SymbolRounding& rounding);
     std::string create_jwt_token(const std::string& payload);
 };
 
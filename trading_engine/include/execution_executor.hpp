@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace ats {
+namespace trading_engine {
+
+// Persistent threads for order execution. Every exchange session gets its own
+// pre-spawned thread, so the two legs of an arbitrage run side by side without
+// paying for thread creation on each trade. Coordinator threads run the
+// orchestration that waits on the legs. Threads can optionally be pinned to
+// consecutive cores.
+class ExecutionExecutor {
+public:
+    struct Options {
+        size_t coordinator_threads = 2;
+        bool pin_threads = false;
+        int first_core = 0;
+    };
+
+    explicit ExecutionExecutor(const Options& options);
+    ~ExecutionExecutor();
+
+    ExecutionExecutor(const ExecutionExecutor&) = delete;
+    ExecutionExecutor& operator=(const ExecutionExecutor&) = delete;
+
+    // Spawns the session thread for an exchange; no-op if it already exists
+    void add_session(const std::string& exchange_id);
+    // Drains and joins the session thread
+    void remove_session(const std::string& exchange_id);
+    bool has_session(const std::string& exchange_id) const;
+
+    // Runs f on the exchange's session thread. Without a session f runs on
+    // the calling thread, so a coordinator never waits on work queued behind
+    // itself.
+    template<typename F>
+    auto submit_to_session(const std::string& exchange_id, F&& f) -> std::future<std::invoke_result_t<F>>;
+
+    // Runs f on a coordinator thread
+    template<typename F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<F>>;
+
+    // Drains the coordinators, then the sessions, so orchestration already
+    // under way can still place its remaining legs
+    void stop();
+
+private:
+    struct Lane {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<std::function<void()>> tasks;
+        bool stopping = false;
+    };
+
+    template<typename F>
+    static auto package(F&& f, std::function<void()>& task) -> std::future<std::invoke_result_t<F>>;
+
+    void start_lane(Lane& lane);
+    void run_lane(Lane& lane);
+    void stop_lane(Lane& lane);
+    bool enqueue_to_session(const std::string& exchange_id, std::function<void()>& task);
+    void enqueue_to_coordinator(std::function<void()> task);
+
+    Options options_;
+    std::atomic<bool> running_{true};          // coordinators accept work
+    bool sessions_running_ = true;              // guarded by sessions_mutex_
+    std::atomic<int> next_core_;
+
+    std::vector<std::unique_ptr<Lane>> coordinators_;
+    std::atomic<size_t> next_coordinator_{0};
+
+    std::unordered_map<std::string, std::unique_ptr<Lane>> sessions_;
+    mutable std::shared_mutex sessions_mutex_;
+};
+
+template<typename F>
+auto ExecutionExecutor::package(F&& f, std::function<void()>& task) -> std::future<std::invoke_result_t<F>> {
+    using return_type = std::invoke_result_t<F>;
+    // std::function needs a copyable target, so the packaged task is shared
+    auto packaged = std::make_shared<std::packaged_task<return_type()>>(std::forward<F>(f));
+    task = [packaged]() { (*packaged)(); };
+    return packaged->get_future();
+}
+
+template<typename F>
+auto ExecutionExecutor::submit_to_session(const std::string& exchange_id, F&& f) -> std::future<std::invoke_result_t<F>> {
+    std::function<void()> task;
+    auto future = package(std::forward<F>(f), task);
+    if (!enqueue_to_session(exchange_id, task)) {
+        task();
+    }
+    return future;
+}
+
+template<typename F>
+auto ExecutionExecutor::submit(F&& f) -> std::future<std::invoke_result_t<F>> {
+    std::function<void()> task;
+    auto future = package(std::forward<F>(f), task);
+    enqueue_to_coordinator(std::move(task));
+    return future;
+}
+
+} // namespace trading_engine
+} // namespace ats
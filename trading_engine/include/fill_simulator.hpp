@@ -0,0 +1,161 @@
+#pragma once
+
+#include "trading_engine_service.hpp"
+#include "spread_calculator.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ats {
+namespace trading_engine {
+
+// One-way order entry latency of an exchange: base plus a uniformly drawn
+// jitter in [0, jitter]
+struct SimulatedLatency {
+    std::chrono::milliseconds base{50};
+    std::chrono::milliseconds jitter{20};
+};
+
+struct FillSimulatorConfig {
+    uint64_t seed = 1;
+    SimulatedLatency default_latency;
+    std::unordered_map<std::string, SimulatedLatency> exchange_latency;
+
+    double default_taker_fee = 0.001;
+    std::unordered_map<std::string, double> taker_fees;
+
+    // Limit prices sit this far beyond the quoted prices
+    double slippage_tolerance = 0.001;
+
+    // Queue position: while our order is in flight, competing takers reach
+    // the book first. On average they take this share of the touch quantity
+    // per 100 ms of latency; each order draws its own share in [0, 2x].
+    double competing_flow = 0.5;
+
+    // Standard deviation of the book's price drift over one second of
+    // latency, in basis points; scales with the square root of the latency
+    double volatility_bps = 2.0;
+
+    // Liquidity our own paper fills took from a cached book is considered
+    // replenished after this long, or as soon as a newer snapshot arrives
+    std::chrono::milliseconds replenish_after{1000};
+};
+
+struct SimulatedLeg {
+    double requested_quantity = 0.0;
+    double filled_quantity = 0.0;
+    double notional = 0.0;
+    double fees = 0.0;
+    double limit_price = 0.0;
+    size_t levels_swept = 0;
+    std::chrono::milliseconds latency{0};
+
+    double average_price() const { return filled_quantity > 0 ? notional / filled_quantity : 0.0; }
+};
+
+struct SimulatedFill {
+    ExecutionResult result = ExecutionResult::FAILURE;
+    SimulatedLeg buy;
+    SimulatedLeg sell;
+    double executed_quantity = 0.0;  // quantity filled on both legs
+    double unwound_quantity = 0.0;   // leg imbalance closed out at market
+    double unwind_cost = 0.0;        // loss from closing the imbalance, fees included
+    double total_fees = 0.0;
+    double profit = 0.0;             // net cash after unwinding; position is flat
+    std::chrono::milliseconds latency{0};
+    std::string error_message;
+};
+
+// Matching engine for paper trading. Each leg of an arbitrage is sent as an
+// immediate-or-cancel limit order to the cached depth of its exchange, as of
+// the moment the order would arrive:
+//   - the exchange's latency is drawn from its model;
+//   - the book drifts by a random walk scaled to that latency;
+//   - competing takers ahead of us consume part of the touch;
+//   - quantity our earlier paper fills took from the same snapshot is gone.
+// The order then sweeps levels up to its limit price, so fills can be
+// partial. When the legs fill unevenly, the imbalance is closed out against
+// the opposite side of the same book, and its cost is charged to the trade.
+//
+// All randomness comes from one seeded generator, so a given seed and
+// sequence of calls always produce the same fills. With several workers the
+// call order, and thus the outcome, depends on scheduling. Thread safe.
+class FillSimulator {
+public:
+    explicit FillSimulator(FillSimulatorConfig config = {});
+
+    FillSimulator(const FillSimulator&) = delete;
+    FillSimulator& operator=(const FillSimulator&) = delete;
+
+    // A missing book is modeled as one level at the opportunity's quoted
+    // price holding its available quantity, with no competing takers ahead
+    SimulatedFill simulate(const ArbitrageOpportunity& opportunity,
+                           const MarketDepth* buy_book,
+                           const MarketDepth* sell_book,
+                           std::chrono::system_clock::time_point now);
+
+    // Restarts the random sequence and forgets consumed liquidity
+    void reset(uint64_t seed);
+
+    size_t get_fills_simulated() const;
+    size_t get_partial_fills() const;
+    size_t get_unfilled_orders() const;
+    size_t get_fills_without_depth() const;
+
+private:
+    // Liquidity our own fills took from one side of a cached book
+    struct Consumption {
+        std::chrono::system_clock::time_point snapshot{};
+        std::chrono::system_clock::time_point last_fill{};
+        double quantity = 0.0;
+    };
+
+    using Levels = std::vector<std::pair<double, double>>; // price, quantity
+
+    uint64_t next_random();
+    double uniform();   // [0, 1)
+    double gaussian();  // standard normal
+
+    std::chrono::milliseconds draw_latency(const std::string& exchange);
+    double taker_fee(const std::string& exchange) const;
+
+    // Sweeps levels for a taker order; returns the filled quantity
+    double sweep(const Levels& levels, bool buy, double quantity, double limit_price,
+                 double skip_quantity, double price_factor, double& notional, size_t& levels_swept) const;
+
+    // Sends one leg as a limit order. price_factor receives the drift
+    // applied to the book, which the unwind reuses.
+    void fill_leg(const MarketDepth* book, const std::string& exchange, const std::string& symbol,
+                  bool buy, double quoted_price, double quantity,
+                  std::chrono::system_clock::time_point fallback_snapshot,
+                  std::chrono::system_clock::time_point now, SimulatedLeg& leg, double& price_factor);
+
+    // Closes out quantity with a market order; returns its notional. Depth
+    // the book cannot absorb is priced at fallback_price.
+    double unwind(const MarketDepth* book, const std::string& exchange, const std::string& symbol,
+                  bool buy, double quantity, double fallback_price, double price_factor,
+                  std::chrono::system_clock::time_point now);
+
+    Consumption& consumption_of(const std::string& exchange, const std::string& symbol, bool buy);
+
+    FillSimulatorConfig config_;
+
+    mutable std::mutex mutex_;
+    uint64_t random_state_;
+    std::unordered_map<std::string, Consumption> consumption_; // exchange:symbol:side
+    std::string key_buffer_;  // reused for consumption lookups
+    Levels synthetic_levels_; // stands in for a missing book
+
+    size_t fills_simulated_ = 0;
+    size_t partial_fills_ = 0;
+    size_t unfilled_orders_ = 0;
+    size_t fills_without_depth_ = 0;
+};
+
+} // namespace trading_engine
+} // namespace ats
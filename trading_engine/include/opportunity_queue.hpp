@@ -0,0 +1,105 @@
+#pragma once
+
+#include "trading_engine_service.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace ats {
+namespace trading_engine {
+
+// Pending arbitrage opportunities, best expected profit first.
+//
+// Every entry has a deadline: its detection time plus the shorter of its own
+// validity window and the queue's TTL. Expired entries are never handed out.
+// pop() discards them as it reaches them, and a full queue purges them before
+// it turns anything away. A queue holds at most one entry per route (symbol,
+// buy exchange, sell exchange). A fresher detection of a queued route
+// replaces the queued one, since the older prices no longer hold. A full
+// queue evicts its least profitable entry when the incoming one is better.
+//
+// Not synchronized; the owner guards it with its own mutex.
+class OpportunityQueue {
+public:
+    using Clock = std::chrono::system_clock;
+
+    enum class PushResult {
+        QUEUED,     // added as a new route
+        REPLACED,   // superseded the queued entry for the same route
+        STALE,      // older than the queued entry for the same route; dropped
+        EXPIRED,    // past its deadline on arrival; dropped
+        FULL        // queue full of more profitable entries; dropped
+    };
+
+    // A ttl of zero leaves each opportunity's own validity window in charge
+    OpportunityQueue(size_t capacity, std::chrono::milliseconds ttl);
+
+    OpportunityQueue(const OpportunityQueue&) = delete;
+    OpportunityQueue& operator=(const OpportunityQueue&) = delete;
+
+    void set_limits(size_t capacity, std::chrono::milliseconds ttl);
+
+    // Expected profit must be finite. O(log n); a full queue additionally pays
+    // one O(n) purge of expired entries.
+    PushResult push(const ArbitrageOpportunity& opportunity, Clock::time_point now);
+
+    // Moves the most profitable live opportunity into out; false if none is left
+    bool pop(ArbitrageOpportunity& out, Clock::time_point now);
+
+    // Drops every expired entry; returns how many were dropped
+    size_t purge_expired(Clock::time_point now);
+
+    void clear();
+
+    bool empty() const { return ranked_.empty(); }
+    size_t size() const { return ranked_.size(); }
+
+    // Totals since construction
+    size_t expired_count() const { return expired_; }
+    size_t superseded_count() const { return superseded_; }
+    size_t evicted_count() const { return evicted_; }
+    size_t rejected_count() const { return rejected_; }
+
+private:
+    struct Entry {
+        ArbitrageOpportunity opportunity;
+        Clock::time_point deadline;
+        uint64_t sequence = 0;  // arrival order; breaks profit ties oldest first
+        const std::string* key = nullptr;
+    };
+
+    struct MoreProfitable {
+        bool operator()(const Entry* a, const Entry* b) const {
+            if (a->opportunity.expected_profit != b->opportunity.expected_profit) {
+                return a->opportunity.expected_profit > b->opportunity.expected_profit;
+            }
+            return a->sequence < b->sequence;
+        }
+    };
+
+    using Ranking = std::set<Entry*, MoreProfitable>;
+
+    Clock::time_point deadline_of(const ArbitrageOpportunity& opportunity) const;
+    void erase(Ranking::iterator position);
+
+    size_t capacity_;
+    std::chrono::milliseconds ttl_;
+
+    // Entries are owned by routes_, whose nodes never move, and ranked by
+    // pointer in ranked_
+    std::unordered_map<std::string, Entry> routes_;
+    Ranking ranked_;
+    std::string key_buffer_;  // reused for lookups
+    uint64_t next_sequence_ = 0;
+
+    size_t expired_ = 0;
+    size_t superseded_ = 0;
+    size_t evicted_ = 0;
+    size_t rejected_ = 0;
+};
+
+} // namespace trading_engine
+} // namespace ats
@@ -38,6 +38,7 @@ struct OrderExecutionDetails {
     std::string error_message;
     std::chrono::system_clock::time_point submitted_at;
     std::chrono::system_clock::time_point last_updated;
+    std::chrono::steady_clock::time_point send_time; // taken just before the order is sent
     std::chrono::milliseconds execution_latency;
     
     OrderExecutionDetails()
@@ -60,6 +61,7 @@ struct SimultaneousExecutionResult {
     double actual_profit;
     double total_fees;
     std::chrono::milliseconds total_execution_time;
+    std::chrono::microseconds leg_send_skew; // gap between the two legs' send times; zero unless both were sent
     std::string error_message;
     bool requires_rollback;
     
@@ -68,6 +70,7 @@ struct SimultaneousExecutionResult {
         , total_filled_quantity(0), average_execution_price_buy(0)
         , average_execution_price_sell(0), actual_profit(0)
         , total_fees(0), total_execution_time(std::chrono::milliseconds(0))
+        , leg_send_skew(std::chrono::microseconds(0))
         , requires_rollback(false) {}
 };
 
@@ -125,6 +128,11 @@ struct OrderRouterConfig {
     bool enable_pre_trade_validation;
     bool enable_post_trade_validation;
     
+    // Execution threads: one per exchange session plus coordinators
+    size_t execution_coordinator_threads;
+    bool pin_execution_threads;
+    int execution_first_core;
+    
     OrderRouterConfig()
         : order_timeout(std::chrono::milliseconds(30000))
         , execution_timeout(std::chrono::milliseconds(60000))
@@ -134,7 +142,10 @@ struct OrderRouterConfig {
         , enable_aggressive_fills(false)
         , max_slippage_tolerance(0.01)
         , enable_pre_trade_validation(true)
-        , enable_post_trade_validation(true) {}
+        , enable_post_trade_validation(true)
+        , execution_coordinator_threads(2)
+        , pin_execution_threads(false)
+        , execution_first_core(0) {}
 };
 
 // Main order router class
@@ -193,6 +204,7 @@ public:
         std::atomic<double> success_rate{0.0};
         std::atomic<double> average_slippage{0.0};
         std::atomic<double> total_fees_paid{0.0};
+        std::atomic<double> average_leg_skew_us{0.0}; // mean over all two-leg executions
     };
     
     PerformanceMetrics get_performance_metrics() const;
@@ -246,6 +258,7 @@ private:
     
     // Performance tracking
     void record_order_metrics(const OrderExecutionDetails& details);
+    void record_leg_skew(std::chrono::microseconds skew);
     void update_performance_statistics();
     
     // Error handling
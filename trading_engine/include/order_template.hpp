@@ -0,0 +1,159 @@
+#pragma once
+
+#include "types/common_types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ats {
+namespace trading_engine {
+
+// Appends lowercase hex of the given bytes
+void append_hex(std::string& out, const unsigned char* data, size_t size);
+
+// HMAC-SHA256 with the key schedule computed once. The inner and outer
+// digest states after absorbing the padded key are kept, so signing a
+// message only copies those states and hashes the message itself.
+// Safe to share between threads.
+class HmacSha256Signer {
+public:
+    static constexpr size_t DIGEST_SIZE = 32;
+
+    explicit HmacSha256Signer(const std::string& key);
+    ~HmacSha256Signer();
+
+    HmacSha256Signer(const HmacSha256Signer&) = delete;
+    HmacSha256Signer& operator=(const HmacSha256Signer&) = delete;
+
+    void sign(const char* data, size_t size, unsigned char* digest) const;
+    void append_hex_signature(std::string& out, const char* data, size_t size) const;
+    std::string hex_signature(const std::string& message) const;
+
+private:
+    struct Implementation;
+    std::unique_ptr<Implementation> impl_;
+};
+
+// Price band of a rounding table: values at or above min_price use increment
+struct PriceBand {
+    double min_price;
+    double increment;
+};
+
+// Snaps values onto an exchange's tick or step grid and prints them as fixed
+// point text. Increments are converted to integer units up front, so
+// formatting needs no locale lookup or temporary strings. A single increment
+// covers Binance-style filters; several bands cover price-dependent tick
+// tables like Upbit's KRW market. Printed values must stay below 9e18 in
+// units of the smallest decimal place.
+class RoundingTable {
+public:
+    enum class Mode { NEAREST, DOWN };
+
+    explicit RoundingTable(double increment = 1e-8);
+    explicit RoundingTable(std::vector<PriceBand> bands);
+
+    double round(double value, Mode mode) const;
+    void append(std::string& out, double value, Mode mode) const;
+
+private:
+    struct Band {
+        double min_price;
+        double increment;
+        double inverse;
+        int64_t scaled_increment; // increment * scale
+        int64_t scale;            // 10^decimals
+        int decimals;
+    };
+
+    const Band& band_for(double value) const;
+    static int64_t units(const Band& band, double value, Mode mode);
+
+    std::vector<Band> bands_; // highest min_price first
+};
+
+struct SymbolRounding {
+    RoundingTable price;
+    RoundingTable quantity;
+};
+
+// A request field the template patches per order, with its key rendered for
+// both query string and JSON bodies
+struct TemplateField {
+    std::string query_key; // "&quantity="
+    std::string json_key;  // ",\"quantity\":\""
+
+    bool enabled() const { return !query_key.empty(); }
+    static TemplateField named(const std::string& name);
+};
+
+// Pre-serialized order request for one (symbol, side, type). Everything
+// except quantity, price and timestamp is fixed when the template is built.
+struct OrderTemplate {
+    std::string static_query; // fixed fields, already encoded
+    std::string static_json;  // same fields as an unterminated JSON object; empty if unused
+    TemplateField quantity;
+    TemplateField price;
+    TemplateField timestamp;
+    RoundingTable price_rounding;
+    RoundingTable quantity_rounding;
+
+    // Overwrites out, reusing its capacity. Quantities round down to the step
+    // so an order never exceeds what was sized; prices round to the nearest tick.
+    void render_query(std::string& out, double quantity_value, double price_value, int64_t timestamp_value) const;
+    void render_json(std::string& out, double quantity_value, double price_value) const;
+};
+
+// Order templates per (symbol, side, type) for one exchange, built on first
+// use by the exchange-specific builder. Hot symbols can be prepared ahead of
+// trading so the first order does not pay for the build either.
+class OrderTemplateCache {
+public:
+    using Builder = std::function<OrderTemplate(const std::string& symbol, types::OrderSide side,
+                                                types::OrderType type, const SymbolRounding& rounding)>;
+
+    OrderTemplateCache(Builder builder, SymbolRounding default_rounding);
+
+    std::shared_ptr<const OrderTemplate> get(const std::string& symbol, types::OrderSide side, types::OrderType type);
+
+    // Builds market and limit templates for both sides
+    void prepare(const std::string& symbol);
+
+    // Replaces the symbol's tick and step tables and drops its templates
+    void set_rounding(const std::string& symbol, SymbolRounding rounding);
+    SymbolRounding rounding(const std::string& symbol) const;
+
+    size_t size() const;
+
+private:
+    struct Key {
+        std::string symbol;
+        types::OrderSide side;
+        types::OrderType type;
+
+        bool operator==(const Key& other) const {
+            return side == other.side && type == other.type && symbol == other.symbol;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<std::string>()(key.symbol) ^
+                   (static_cast<size_t>(key.side) << 4 | static_cast<size_t>(key.type));
+        }
+    };
+
+    Builder builder_;
+    SymbolRounding default_rounding_;
+    std::unordered_map<Key, std::shared_ptr<const OrderTemplate>, KeyHash> templates_;
+    std::unordered_map<std::string, SymbolRounding> rounding_;
+    mutable std::shared_mutex mutex_;
+};
+
+} // namespace trading_engine
+} // namespace ats
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types/common_types.hpp"
+#include "types/ticker_wire.hpp"
 #include "trading_engine_service.hpp"
 #include <memory>
 #include <string>
@@ -18,10 +19,11 @@ struct RedisMessage {
     std::string channel;
     std::string message;
     std::chrono::system_clock::time_point timestamp;
+    std::chrono::steady_clock::time_point enqueued_at; // set when handed to a parse worker
     
     RedisMessage() : timestamp(std::chrono::system_clock::now()) {}
-    RedisMessage(const std::string& ch, const std::string& msg)
-        : channel(ch), message(msg), timestamp(std::chrono::system_clock::now()) {}
+    RedisMessage(std::string ch, std::string msg)
+        : channel(std::move(ch)), message(std::move(msg)), timestamp(std::chrono::system_clock::now()) {}
 };
 
 // Price update event from Redis
@@ -34,6 +36,21 @@ struct PriceUpdateEvent {
     PriceUpdateEvent() : received_at(std::chrono::system_clock::now()) {}
 };
 
+// What the reader thread does when a partition queue is full
+enum class QueueOverflowPolicy {
+    BLOCK,        // wait for the worker to make room (backpressure onto Redis)
+    DROP_OLDEST   // discard the oldest queued message; stale ticks are superseded anyway.
+                  // Messages carrying dictionary frames are never discarded
+};
+
+// How messages are assigned to parse workers. Messages with the same key
+// always land on the same worker, so their order is preserved.
+enum class PartitionKey {
+    CHANNEL,
+    SYMBOL   // "symbol" field of a JSON payload; binary frames and payloads
+             // without one fall back to the channel, whose decoder is stateful
+};
+
 // Redis subscriber configuration
 struct RedisSubscriberConfig {
     std::string host;
@@ -49,8 +66,10 @@ struct RedisSubscriberConfig {
     std::chrono::seconds reconnect_delay;
     
     // Performance settings
-    size_t message_buffer_size;
-    int worker_thread_count;
+    size_t message_buffer_size;      // capacity of each partition queue
+    int worker_thread_count;         // parse workers, one partition each
+    QueueOverflowPolicy overflow_policy;
+    PartitionKey partition_key;
     bool enable_message_batching;
     std::chrono::milliseconds batch_timeout;
     
@@ -67,6 +86,8 @@ struct RedisSubscriberConfig {
         , reconnect_delay(std::chrono::seconds(5))
         , message_buffer_size(10000)
         , worker_thread_count(2)
+        , overflow_policy(QueueOverflowPolicy::BLOCK)
+        , partition_key(PartitionKey::SYMBOL)
         , enable_message_batching(false)
         , batch_timeout(std::chrono::milliseconds(100))
         , enable_health_check(true)
@@ -79,14 +100,28 @@ struct SubscriberStatistics {
     std::atomic<size_t> total_messages_received{0};
     std::atomic<size_t> total_messages_processed{0};
     std::atomic<size_t> total_price_updates{0};
+    std::atomic<size_t> total_order_book_updates{0};
     std::atomic<size_t> total_parsing_errors{0};
     std::atomic<size_t> total_connection_errors{0};
     std::atomic<size_t> total_reconnections{0};
     
     std::atomic<double> messages_per_second{0.0};
-    std::atomic<std::chrono::milliseconds> average_processing_latency{std::chrono::milliseconds(0)};
+    std::atomic<std::chrono::microseconds> average_processing_latency{std::chrono::microseconds(0)};
     std::atomic<std::chrono::milliseconds> last_message_time{std::chrono::milliseconds(0)};
     
+    // Pipeline stages, averaged with an exponential moving average
+    std::atomic<std::chrono::microseconds> average_queue_latency{std::chrono::microseconds(0)};    // reader -> worker
+    std::atomic<std::chrono::microseconds> average_parse_latency{std::chrono::microseconds(0)};    // JSON -> event
+    std::atomic<std::chrono::microseconds> average_dispatch_latency{std::chrono::microseconds(0)}; // callbacks
+    std::atomic<size_t> total_messages_dropped{0};     // discarded here by DROP_OLDEST
+    std::atomic<size_t> total_backpressure_waits{0};
+    std::atomic<size_t> max_queue_depth{0};
+    
+    // Binary ticker frames
+    std::atomic<size_t> total_binary_messages{0};
+    std::atomic<size_t> total_sequence_gaps{0};       // messages lost between publisher and subscriber
+    std::atomic<size_t> total_undecodable_messages{0}; // tickers seen before their dictionary
+    
     std::chrono::system_clock::time_point start_time;
     std::atomic<bool> is_connected{false};
     std::atomic<std::chrono::milliseconds> uptime{std::chrono::milliseconds(0)};
@@ -118,14 +153,21 @@ public:
     std::vector<std::string> get_subscribed_channels() const;
     std::vector<std::string> get_subscribed_patterns() const;
     
+    // BINARY once any binary frame has arrived on the channel, JSON before.
+    // It never reverts: JSON messages stay accepted on a binary channel.
+    types::WireFormat get_channel_wire_format(const std::string& channel) const;
+    
     // Message handling callbacks
     using MessageCallback = std::function<void(const RedisMessage&)>;
     using PriceUpdateCallback = std::function<void(const PriceUpdateEvent&)>;
+    using OrderBookCallback = std::function<void(const types::OrderBook&)>;
     using ConnectionCallback = std::function<void(bool connected, const std::string& reason)>;
     using ErrorCallback = std::function<void(const std::string& error)>;
     
     void set_message_callback(MessageCallback callback);
     void set_price_update_callback(PriceUpdateCallback callback);
+    // Order book snapshots arrive on channels containing "order_book"
+    void set_order_book_callback(OrderBookCallback callback);
     void set_connection_callback(ConnectionCallback callback);
     void set_error_callback(ErrorCallback callback);
     
@@ -162,14 +204,19 @@ private:
     void handle_reconnection();
     
     // Message processing
-    void message_processing_loop();
-    void process_raw_message(const RedisMessage& message);
-    void process_price_update_message(const RedisMessage& message);
+    void enqueue_message(RedisMessage message);
+    size_t partition_for(const RedisMessage& message) const;
+    void message_processing_loop(size_t partition);
+    void process_raw_message(const RedisMessage& message, size_t partition);
+    void process_price_update_message(const RedisMessage& message, size_t partition);
+    void process_order_book_message(const RedisMessage& message);
     
     // Message parsing
     PriceUpdateEvent parse_price_message(const RedisMessage& message);
+    bool decode_binary_price_message(const RedisMessage& message, size_t partition, PriceUpdateEvent& event);
     types::Ticker parse_ticker_json(const std::string& json_str);
     bool is_price_update_message(const RedisMessage& message);
+    bool is_order_book_message(const RedisMessage& message);
     
     // Error handling
     void handle_parsing_error(const RedisMessage& message, const std::string& error);
@@ -188,6 +235,14 @@ private:
     void check_message_flow_health();
 };
 
+// Outcome of one InfluxDB write. A rejected payload would fail the same way
+// on every retry.
+enum class InfluxWriteResult {
+    WRITTEN,
+    RETRYABLE,  // transport error, 5xx, 408 or 429
+    REJECTED    // any other 4xx
+};
+
 // Trade logger for storing execution records
 class TradeLogger {
 public:
@@ -228,9 +283,21 @@ public:
     bool compact_old_data(std::chrono::hours max_age);
     size_t get_pending_log_count() const;
     
-    // Configuration
+    // Configuration. A batch is sent once it holds batch_size lines or
+    // batch_bytes bytes, or has been open for flush_interval. Sealed batches
+    // wait in a backlog of at most max_backlog_bytes; beyond that they are
+    // appended to the spill file and replayed once InfluxDB accepts writes.
+    // Batches InfluxDB rejects are not retried; they are moved to a
+    // ".rejected" file next to the spill file, or dropped without one.
     void set_batch_size(size_t batch_size);
-    void set_flush_interval(std::chrono::seconds interval);
+    void set_batch_bytes(size_t batch_bytes);
+    void set_flush_interval(std::chrono::milliseconds interval);
+    void set_max_backlog_bytes(size_t max_backlog_bytes);
+    void set_spill_path(const std::string& path);
+    // The local trade journal drops partitions older than this, in memory
+    // and on disk, about once a minute. Zero keeps them all.
+    void set_journal_retention(std::chrono::hours retention);
+    void enable_compression(bool enable);
     void enable_file_logging(bool enable);
     void enable_database_logging(bool enable);
     
@@ -238,16 +305,23 @@ public:
     bool is_healthy() const;
     std::string get_status() const;
     size_t get_total_logs_written() const;
+    size_t get_backlog_bytes() const;
+    size_t get_spilled_batches() const;
+    size_t get_dropped_logs() const;
+    size_t get_rejected_logs() const;
     
 private:
     struct Implementation;
     std::unique_ptr<Implementation> impl_;
     
-    // InfluxDB integration
-    bool write_to_influxdb(const std::string& measurement, const std::string& line_protocol);
-    std::string trade_execution_to_line_protocol(const TradeExecution& execution);
-    std::string order_execution_to_line_protocol(const OrderExecutionDetails& order);
-    std::string arbitrage_opportunity_to_line_protocol(const ArbitrageOpportunity& opportunity);
+    // InfluxDB integration. The *_to_line_protocol helpers append one line
+    // without the trailing newline. They leave out empty tags and non-finite
+    // fields, and append nothing, returning false, when no field is left.
+    InfluxWriteResult write_to_influxdb(const std::string& measurement, const std::string& line_protocol);
+    bool trade_execution_to_line_protocol(const TradeExecution& execution, std::string& out);
+    bool order_execution_to_line_protocol(const OrderExecutionDetails& order, std::string& out);
+    bool arbitrage_opportunity_to_line_protocol(const ArbitrageOpportunity& opportunity, std::string& out);
+    bool enqueue_lines(const std::string& lines, size_t count);
     
     // File logging
     bool write_to_file(const std::string& log_entry);
@@ -256,6 +330,7 @@ private:
     
     // Batch processing
     void process_pending_logs();
+    bool replay_spilled_logs();
     void flush_file_buffers();
     
     // Data formatting
@@ -295,7 +370,7 @@ public:
     // Statistics
     size_t get_opportunities_detected() const;
     size_t get_price_updates_processed() const;
-    double get_average_processing_latency_ms() const;
+    double get_average_processing_latency_us() const;
     
 private:
     struct Implementation;
@@ -325,16 +400,20 @@ namespace redis_utils {
     // Channel name builders
     std::string build_price_channel(const std::string& exchange, const std::string& symbol);
     std::string build_ticker_channel(const std::string& exchange);
+    std::string build_order_book_channel();
     std::string build_trade_channel(const std::string& exchange, const std::string& symbol);
     std::string build_arbitrage_channel();
     
     // Message formatting
     std::string format_ticker_message(const types::Ticker& ticker);
+    // {"symbol", "exchange", "bids": [[price, quantity], ...], "asks": [...], "timestamp": ms}
+    std::string format_order_book_message(const types::OrderBook& book);
     std::string format_trade_execution_message(const TradeExecution& execution);
     std::string format_opportunity_message(const ArbitrageOpportunity& opportunity);
     
     // Message parsing
     types::Ticker parse_ticker_message(const std::string& message);
+    types::OrderBook parse_order_book_message(const std::string& message);
     TradeExecution parse_trade_execution_message(const std::string& message);
     ArbitrageOpportunity parse_opportunity_message(const std::string& message);
     
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ats {
+namespace trading_engine {
+
+// Count, mean and sum of squared deviations (Welford). Partitions can be
+// merged and removed again, which lets a window drop an expired bucket in
+// O(1) instead of rescanning its samples.
+struct RollingStats {
+    size_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void add(double value);
+    void merge(const RollingStats& other);
+    void remove(const RollingStats& other);
+
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+    double stddev() const;
+};
+
+// Fixed-capacity time series summarized per time bucket. Buckets live in a
+// ring and expire as time moves past the window, so memory is bounded by
+// bucket_count regardless of the update rate. Whole-window statistics are
+// kept as running totals; an exponentially weighted mean and variance track
+// the most recent behaviour per sample.
+class RollingSeries {
+public:
+    using Clock = std::chrono::system_clock;
+
+    RollingSeries(std::chrono::seconds bucket_width, size_t bucket_count, double ewma_alpha);
+
+    void add(double value, Clock::time_point now);
+
+    // Statistics over the whole window. O(1) unless buckets expired since
+    // the last add, which costs one step per expired bucket.
+    RollingStats window(Clock::time_point now) const;
+
+    // Statistics over the most recent lookback, clamped to the window;
+    // O(buckets covered)
+    RollingStats window(Clock::time_point now, std::chrono::seconds lookback) const;
+
+    double ewma_mean() const { return ewma_mean_; }
+    double ewma_stddev() const;
+    size_t samples() const { return samples_; }
+
+    Clock::time_point last_update() const { return last_update_; }
+    std::chrono::seconds span() const { return bucket_width_ * static_cast<int64_t>(buckets_.size()); }
+
+private:
+    struct Bucket {
+        int64_t epoch = -1; // bucket index since the Unix epoch; -1 if unused
+        RollingStats stats;
+    };
+
+    int64_t epoch_of(Clock::time_point time) const;
+    void advance(int64_t epoch);
+
+    std::chrono::seconds bucket_width_;
+    std::vector<Bucket> buckets_;
+    RollingStats totals_;
+    int64_t newest_epoch_ = -1;
+
+    double ewma_alpha_;
+    double ewma_mean_ = 0.0;
+    double ewma_variance_ = 0.0;
+    size_t samples_ = 0;
+    Clock::time_point last_update_{};
+};
+
+} // namespace trading_engine
+} // namespace ats
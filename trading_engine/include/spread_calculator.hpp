@@ -3,6 +3,7 @@
 #include "types/common_types.hpp"
 #include "trading_engine_service.hpp"
 #include <memory>
+#include <map>
 #include <unordered_map>
 #include <vector>
 #include <chrono>
@@ -11,6 +12,8 @@
 namespace ats {
 namespace trading_engine {
 
+struct ExecutableSize;
+
 // Market depth data for spread calculation
 struct MarketDepth {
     std::string symbol;
@@ -22,6 +25,37 @@ struct MarketDepth {
     MarketDepth() : timestamp(std::chrono::system_clock::now()) {}
 };
 
+// Interned market depth kept in the calculator's caches; names are resolved
+// only when a depth is handed back to callers
+struct CompactMarketDepth {
+    types::SymbolCode symbol = types::INVALID_CODE;
+    types::ExchangeCode exchange = types::INVALID_CODE;
+    std::vector<std::pair<double, double>> bids;  // price, quantity
+    std::vector<std::pair<double, double>> asks;  // price, quantity
+    std::chrono::system_clock::time_point timestamp{};
+};
+
+// Either code is INVALID_CODE when its registry is full
+inline CompactMarketDepth to_compact(const MarketDepth& depth) {
+    CompactMarketDepth compact;
+    compact.symbol = types::intern_symbol(depth.symbol);
+    compact.exchange = types::intern_exchange(depth.exchange);
+    compact.bids = depth.bids;
+    compact.asks = depth.asks;
+    compact.timestamp = depth.timestamp;
+    return compact;
+}
+
+inline MarketDepth to_market_depth(const CompactMarketDepth& compact) {
+    MarketDepth depth;
+    depth.symbol = types::symbol_name(compact.symbol);
+    depth.exchange = types::exchange_name(compact.exchange);
+    depth.bids = compact.bids;
+    depth.asks = compact.asks;
+    depth.timestamp = compact.timestamp;
+    return depth;
+}
+
 // Spread analysis result
 struct SpreadAnalysis {
     std::string symbol;
@@ -106,10 +140,12 @@ public:
     
     // Market data updates
     void update_market_depth(const MarketDepth& depth);
+    // Copies the cached book into depth, reusing its storage; false if none is cached
+    bool get_market_depth(const std::string& exchange, const std::string& symbol, MarketDepth& depth) const;
     void update_ticker(const types::Ticker& ticker);
     void update_trade_volume(const std::string& exchange, const std::string& symbol, double volume);
     
-    // Spread analysis
+    // Spread analysis. Read-only: spread histories are sampled by update_ticker.
     SpreadAnalysis analyze_spread(const std::string& symbol,
                                  const std::string& buy_exchange,
                                  const std::string& sell_exchange,
@@ -121,6 +157,12 @@ public:
     std::vector<ArbitrageOpportunity> detect_arbitrage_opportunities(
         double min_profit_threshold = 100.0) const;
     
+    // Incremental detection: only re-evaluates pairs involving the updated
+    // (exchange, symbol), walking the per-symbol best bid/ask index
+    std::vector<ArbitrageOpportunity> detect_arbitrage_opportunities(
+        const types::Ticker& updated_ticker,
+        double min_profit_threshold = 100.0) const;
+    
     // Fee calculations
     double calculate_trading_fee(const std::string& exchange, const std::string& symbol,
                                double quantity, double price, bool is_maker = false) const;
@@ -158,7 +200,8 @@ public:
     double calculate_confidence_score(const ArbitrageOpportunity& opportunity) const;
     double calculate_execution_probability(const ArbitrageOpportunity& opportunity) const;
     
-    // Historical analysis
+    // Historical analysis. Samples are taken from the top of book on every
+    // ticker update and carry the raw spread only.
     std::vector<SpreadAnalysis> get_historical_spreads(const std::string& symbol,
                                                       std::chrono::hours lookback) const;
     
@@ -191,7 +234,7 @@ private:
     double calculate_effective_spread(const std::string& symbol, const std::string& buy_exchange,
                                     const std::string& sell_exchange, double quantity) const;
     
-    double calculate_order_book_impact(const MarketDepth& depth, double quantity, 
+    double calculate_order_book_impact(const CompactMarketDepth& depth, double quantity, 
                                      types::OrderSide side) const;
     
     double calculate_time_decay_factor(std::chrono::system_clock::time_point timestamp) const;
@@ -203,7 +246,7 @@ private:
     // Slippage modeling
     double calculate_linear_slippage(const SlippageModel& model, double quantity) const;
     double calculate_nonlinear_slippage(const SlippageModel& model, double quantity,
-                                      const MarketDepth& depth) const;
+                                      const CompactMarketDepth& depth) const;
     
     void update_slippage_model(const std::string& exchange, const std::string& symbol,
                              double observed_slippage, double quantity);
@@ -217,6 +260,27 @@ private:
     // Opportunity validation
     bool validate_opportunity(const ArbitrageOpportunity& opportunity) const;
     void enrich_opportunity(ArbitrageOpportunity& opportunity) const;
+    bool build_opportunity(const SpreadAnalysis& analysis, double min_profit_threshold,
+                           ArbitrageOpportunity& opportunity) const;
+    // Profit-maximizing size from the cached order books; false if either
+    // book is missing
+    bool solve_depth_size(const SpreadAnalysis& analysis, ExecutableSize& size,
+                          double& buy_fee_rate, double& sell_fee_rate) const;
+    
+    // Top-of-book index maintenance (called with the write lock held)
+    void update_top_of_book_index(const types::Ticker& ticker);
+    
+    // Samples the raw spread of every route through the updated exchange from
+    // the top-of-book matrix and appends them all to the bounded histories
+    // under one history lock; called without locks held
+    void record_spreads_for_update(const types::Ticker& ticker);
+    
+    // Risk adjustment inputs
+    double calculate_confidence_score_internal(const types::Ticker& buy_ticker,
+                                               const types::Ticker& sell_ticker,
+                                               double quantity) const;
+    double calculate_volatility_adjustment(const std::string& symbol) const;
+    double calculate_liquidity_adjustment(const ArbitrageOpportunity& opportunity) const;
     
     // Statistical calculations
     double calculate_rolling_average(const std::vector<double>& values, size_t window_size) const;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "types/common_types.hpp"
+#include "types/symbol_registry.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ats {
+namespace trading_engine {
+
+// Dense structure-of-arrays view of every exchange's best bid and ask, one
+// row per interned symbol and one column per interned exchange. A symbol's
+// quotes from all venues sit in a few contiguous cache lines, so the
+// cross-exchange scan is a single vectorized pass instead of a walk through
+// nested hash maps. Not thread-safe; the owner provides synchronization.
+class TopOfBookMatrix {
+public:
+    static constexpr size_t MAX_SLOTS = types::MAX_EXCHANGES;
+    using SpreadMatrix = std::array<double, MAX_SLOTS * MAX_SLOTS>;
+
+    // Empty slots hold bid 0 and ask +inf, so they price every pair
+    // involving them at -100% without a branch in the kernel
+    struct alignas(64) Row {
+        double bid[MAX_SLOTS];
+        double ask[MAX_SLOTS];
+        int64_t timestamp[MAX_SLOTS]; // Unix milliseconds
+        uint32_t present = 0;         // bit per exchange slot
+
+        Row();
+        bool has(types::ExchangeCode exchange) const { return (present >> exchange) & 1u; }
+    };
+
+    void update(types::ExchangeCode exchange, types::SymbolCode symbol,
+                double bid, double ask, int64_t timestamp);
+
+    // nullptr if no quote has been seen for the symbol
+    const Row* row(types::SymbolCode symbol) const;
+
+    // Fills out[buy * MAX_SLOTS + sell] with the raw return of buying at
+    // buy's ask and selling at sell's bid:
+    //   bid_sell / ask_buy - 1
+    // This is SpreadAnalysis::spread_percentage / 100; fees are left to the
+    // full analysis, which knows symbol and tier rates. Only the first
+    // width() rows and columns are written. Returns false if the symbol has
+    // no quotes.
+    bool spreads(types::SymbolCode symbol, SpreadMatrix& out) const;
+
+    // Exchange slots covered by the kernel, rounded up to the vector width
+    size_t width() const { return width_; }
+
+    template <typename F>
+    void for_each_symbol(F&& f) const {
+        for (size_t code = 0; code < rows_.size(); ++code) {
+            if (rows_[code].present != 0) {
+                f(static_cast<types::SymbolCode>(code), rows_[code]);
+            }
+        }
+    }
+
+    void clear();
+
+    // Name of the kernel selected at compile time ("avx2", "sse2" or "scalar")
+    static const char* kernel_name();
+
+private:
+    std::vector<Row> rows_; // by symbol code
+    size_t width_ = 0;
+};
+
+} // namespace trading_engine
+} // namespace ats
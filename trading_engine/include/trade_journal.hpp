@@ -0,0 +1,67 @@
+#pragma once
+
+#include "trading_engine_service.hpp"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ats {
+namespace trading_engine {
+
+// Embedded, append-only store of trade executions for local analytics.
+//
+// Rows are grouped into time partitions (one hour by default). Inside a
+// partition each field is a separate column array, so an aggregate only
+// touches the columns it reads, in tight loops the compiler vectorizes.
+// Every partition keeps a sparse index with the time range of each block of
+// rows. A query skips partitions and blocks outside its window, and it
+// tests timestamps only in blocks that straddle the window's edges.
+//
+// On disk each partition is a directory holding one append-only file per
+// column, plus dictionaries for symbol and exchange names. Appends go to
+// memory. flush() writes the new rows, and open() reloads the journal,
+// trimming rows left incomplete by a crash. Safe to share between threads.
+class TradeJournal {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    explicit TradeJournal(std::chrono::hours partition_span = std::chrono::hours(1));
+    ~TradeJournal();
+
+    TradeJournal(const TradeJournal&) = delete;
+    TradeJournal& operator=(const TradeJournal&) = delete;
+
+    // Loads existing partitions and persists new rows under directory.
+    // Without a directory the journal is memory only.
+    bool open(const std::string& directory);
+
+    void append(const TradeExecution& execution);
+    bool flush();
+
+    // Executions with timestamps in [from, to], oldest partition first
+    std::vector<TradeExecution> query_trades(TimePoint from, TimePoint to) const;
+    std::vector<TradeExecution> query_trades_by_symbol(const std::string& symbol, TimePoint from, TimePoint to) const;
+
+    double total_profit(TimePoint from, TimePoint to) const;
+    // Share of executions with a SUCCESS or PARTIAL_SUCCESS result
+    double success_rate(TimePoint from, TimePoint to) const;
+    std::unordered_map<std::string, double> profit_by_symbol(TimePoint from, TimePoint to) const;
+    // Executed notional per exchange, buy and sell legs both counted
+    std::unordered_map<std::string, double> volume_by_exchange(TimePoint from, TimePoint to) const;
+
+    // Drops partitions that end before cutoff, in memory and on disk
+    size_t drop_partitions_before(TimePoint cutoff);
+
+    size_t size() const;
+    size_t partition_count() const;
+
+private:
+    struct Implementation;
+    std::unique_ptr<Implementation> impl_;
+};
+
+} // namespace trading_engine
+} // namespace ats
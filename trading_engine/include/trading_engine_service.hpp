@@ -3,6 +3,7 @@
 #include "types/common_types.hpp"
 #include "config/config_manager.hpp"
 #include "utils/prometheus_exporter.hpp"
+#include <nlohmann/json.hpp>
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -22,6 +23,8 @@ class SpreadCalculator;
 class RiskManager;
 class TradeLogger;
 class RedisSubscriber;
+class OpportunityQueue;
+class FillSimulator;
 
 // Trade execution result
 enum class ExecutionResult {
@@ -113,7 +116,9 @@ struct TradingEngineConfig {
     int worker_thread_count;
     size_t max_queue_size;
     bool enable_paper_trading;
+    bool paper_trading_realtime;  // Workers wait out simulated latency instead of running flat out
     bool enable_rollback_on_failure;
+    bool incremental_detection;  // Re-evaluate only pairs touched by each ticker
     
     TradingEngineConfig()
         : enabled(false), min_spread_threshold(0.005)
@@ -124,17 +129,27 @@ struct TradingEngineConfig {
         , max_portfolio_exposure(0.8), max_single_trade_size(0.1)
         , emergency_stop_loss(0.05), slippage_tolerance(0.001)
         , worker_thread_count(4), max_queue_size(1000)
-        , enable_paper_trading(false), enable_rollback_on_failure(true) {}
+        , enable_paper_trading(false), paper_trading_realtime(false)
+        , enable_rollback_on_failure(true)
+        , incremental_detection(true) {}
 };
 
 // Trading engine statistics
 struct TradingStatistics {
     std::atomic<size_t> total_opportunities_detected{0};
     std::atomic<size_t> total_opportunities_executed{0};
+    std::atomic<size_t> total_opportunities_expired{0};     // deadline passed while queued
+    std::atomic<size_t> total_opportunities_superseded{0};  // replaced by a fresher detection of the same route
     std::atomic<size_t> total_successful_trades{0};
     std::atomic<size_t> total_failed_trades{0};
     std::atomic<size_t> total_rollbacks{0};
     
+    // Paper trading fill simulator
+    std::atomic<size_t> simulated_fills{0};
+    std::atomic<size_t> simulated_partial_fills{0};
+    std::atomic<size_t> simulated_unfilled_orders{0};
+    std::atomic<size_t> simulated_fills_without_depth{0}; // a leg had no cached book
+    
     std::atomic<double> total_profit_loss{0.0};
     std::atomic<double> total_fees_paid{0.0};
     std::atomic<double> total_volume_traded{0.0};
@@ -223,17 +238,19 @@ private:
     std::unique_ptr<RedisSubscriber> redis_subscriber_;
     std::unique_ptr<OrderRouter> order_router_;
     std::unique_ptr<SpreadCalculator> spread_calculator_;
+    std::unique_ptr<FillSimulator> fill_simulator_; // paper trading fills
     std::unique_ptr<TradeLogger> trade_logger_;
     std::shared_ptr<RiskManager> risk_manager_;
-    std::unique_ptr<monitoring::PrometheusExporter> prometheus_exporter_;
+    std::unique_ptr<utils::PrometheusExporter> prometheus_exporter_;
+    int metrics_port_ = 8082;
     
     // Threading and queuing
     std::vector<std::thread> worker_threads_;
     std::thread price_monitoring_thread_;
     std::thread statistics_thread_;
     
-    // Opportunity queue
-    std::queue<ArbitrageOpportunity> opportunity_queue_;
+    // Opportunity queue, most profitable live opportunity first
+    std::unique_ptr<OpportunityQueue> opportunity_queue_;
     std::mutex queue_mutex_;
     std::condition_variable queue_condition_;
     
@@ -253,6 +270,7 @@ private:
     
     // Event handlers
     void on_price_update(const types::Ticker& ticker);
+    void on_order_book_update(const types::OrderBook& book);
     void on_arbitrage_opportunity_detected(const ArbitrageOpportunity& opportunity);
     void on_trade_execution_completed(const TradeExecution& execution);
     void on_error_occurred(const std::string& error);
@@ -274,6 +292,7 @@ private:
     
     // Utility methods
     void update_statistics();
+    void sync_queue_statistics(); // caller holds queue_mutex_
     void collect_system_metrics();
     double get_cpu_usage();
     double get_memory_usage();
@@ -285,6 +304,7 @@ private:
     bool initialize_redis_subscriber(const config::ConfigManager& config);
     bool initialize_order_router(const config::ConfigManager& config);
     bool initialize_spread_calculator(const config::ConfigManager& config);
+    bool initialize_fill_simulator(const config::ConfigManager& config);
     
     void start_worker_threads();
     void stop_worker_threads();
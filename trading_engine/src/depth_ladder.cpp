@@ -0,0 +1,108 @@
+#include "depth_ladder.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace ats {
+namespace trading_engine {
+
+DepthLadder::DepthLadder(const std::vector<std::pair<double, double>>& levels, Side side) : side_(side) {
+    std::vector<std::pair<double, double>> sorted(levels);
+    auto better = [side](const std::pair<double, double>& a, const std::pair<double, double>& b) {
+        return side == Side::BID ? a.first > b.first : a.first < b.first;
+    };
+    if (!std::is_sorted(sorted.begin(), sorted.end(), better)) {
+        std::sort(sorted.begin(), sorted.end(), better);
+    }
+
+    prices_.reserve(sorted.size());
+    cumulative_quantity_.reserve(sorted.size());
+    cumulative_notional_.reserve(sorted.size());
+
+    double quantity = 0.0;
+    double notional = 0.0;
+    for (const auto& [price, level_quantity] : sorted) {
+        if (price <= 0 || level_quantity <= 0) continue;
+        quantity += level_quantity;
+        notional += price * level_quantity;
+        prices_.push_back(price);
+        cumulative_quantity_.push_back(quantity);
+        cumulative_notional_.push_back(notional);
+    }
+}
+
+size_t DepthLadder::level_at(double quantity) const {
+    return std::upper_bound(cumulative_quantity_.begin(), cumulative_quantity_.end(), quantity) -
+           cumulative_quantity_.begin();
+}
+
+double DepthLadder::marginal_price(double quantity) const {
+    size_t level = level_at(quantity);
+    if (level < prices_.size()) {
+        return prices_[level];
+    }
+    // Exhausted: nothing more can be sold, and buying more costs infinitely much
+    return side_ == Side::BID ? 0.0 : std::numeric_limits<double>::infinity();
+}
+
+double DepthLadder::notional(double quantity) const {
+    if (prices_.empty() || quantity <= 0) return 0.0;
+    quantity = std::min(quantity, total_quantity());
+
+    size_t level = level_at(quantity);
+    if (level >= prices_.size()) {
+        return cumulative_notional_.back();
+    }
+    double before_quantity = level > 0 ? cumulative_quantity_[level - 1] : 0.0;
+    double before_notional = level > 0 ? cumulative_notional_[level - 1] : 0.0;
+    return before_notional + (quantity - before_quantity) * prices_[level];
+}
+
+double DepthLadder::limit_price(double quantity) const {
+    if (prices_.empty() || quantity <= 0) return best_price();
+    size_t level = std::lower_bound(cumulative_quantity_.begin(), cumulative_quantity_.end(), quantity) -
+                   cumulative_quantity_.begin();
+    return prices_[std::min(level, prices_.size() - 1)];
+}
+
+ExecutableSize solve_executable_size(const DepthLadder& asks, const DepthLadder& bids,
+                                     double buy_factor, double sell_factor, double max_quantity) {
+    ExecutableSize result;
+
+    const double cap = std::min({max_quantity, asks.total_quantity(), bids.total_quantity()});
+    auto marginal_profit = [&](double quantity) {
+        return bids.marginal_price(quantity) * sell_factor - asks.marginal_price(quantity) * buy_factor;
+    };
+    if (cap <= 0 || marginal_profit(0.0) <= 0) {
+        return result;
+    }
+
+    // Last ask boundary below the cap where the next unit is still profitable
+    const auto& ask_bounds = asks.boundaries();
+    auto ask_end = std::lower_bound(ask_bounds.begin(), ask_bounds.end(), cap);
+    auto ask_split = std::partition_point(ask_bounds.begin(), ask_end,
+                                          [&](double q) { return marginal_profit(q) > 0; });
+    const double start = ask_split == ask_bounds.begin() ? 0.0 : *(ask_split - 1);
+    const double stop = ask_split == ask_end ? cap : *ask_split;
+
+    // The ask price is fixed on (start, stop], so only bid boundaries can
+    // turn the marginal profit negative there
+    const auto& bid_bounds = bids.boundaries();
+    auto bid_begin = std::upper_bound(bid_bounds.begin(), bid_bounds.end(), start);
+    auto bid_end = std::lower_bound(bid_begin, bid_bounds.end(), stop);
+    auto bid_split = std::partition_point(bid_begin, bid_end,
+                                          [&](double q) { return marginal_profit(q) > 0; });
+    const double quantity = bid_split == bid_end ? stop : *bid_split;
+
+    result.quantity = quantity;
+    result.buy_notional = asks.notional(quantity);
+    result.sell_notional = bids.notional(quantity);
+    result.buy_vwap = result.buy_notional / quantity;
+    result.sell_vwap = result.sell_notional / quantity;
+    result.buy_limit_price = asks.limit_price(quantity);
+    result.sell_limit_price = bids.limit_price(quantity);
+    result.net_profit = result.sell_notional * sell_factor - result.buy_notional * buy_factor;
+    return result;
+}
+
+} // namespace trading_engine
+} // namespace ats
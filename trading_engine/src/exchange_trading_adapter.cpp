@@ -5,10 +5,8 @@
 #include "utils/json_parser.hpp"
 #include <nlohmann/json.hpp>
 #include <curl/curl.h>
-#include <openssl/hmac.h>
-#include <openssl/sha.h>
-#include <iomanip>
-#include <sstream>
+#include <openssl/evp.h>
+#include <random>
 #include <thread>
 #include <chrono>
 
@@ -327,6 +325,7 @@ struct ExchangeRestClient::Implementation {
     std::string base_url;
     std::string api_key;
     std::string secret;
+    std::unique_ptr<HmacSha256Signer> signer;
     
     // Rate limiting
     int requests_per_second = 10;
@@ -353,6 +352,7 @@ ExchangeRestClient::ExchangeRestClient(const std::string& base_url, const std::s
     impl_->base_url = base_url;
     impl_->api_key = api_key;
     impl_->secret = secret;
+    impl_->signer = std::make_unique<HmacSha256Signer>(secret);
 }
 
 ExchangeRestClient::~ExchangeRestClient() = default;
@@ -470,17 +470,16 @@ void ExchangeRestClient::wait_for_rate_limit() {
     impl_->last_request_time = std::chrono::steady_clock::now();
 }
 
+const std::string& ExchangeRestClient::api_key() const {
+    return impl_->api_key;
+}
+
+const HmacSha256Signer& ExchangeRestClient::signer() const {
+    return *impl_->signer;
+}
+
 std::string ExchangeRestClient::create_signature(const std::string& message) {
-    unsigned char* digest = HMAC(EVP_sha256(), impl_->secret.c_str(), impl_->secret.length(),
-                                reinterpret_cast<const unsigned char*>(message.c_str()), message.length(),
-                                nullptr, nullptr);
-    
-    std::ostringstream oss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; ++i) {
-        oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
-    }
-    
-    return oss.str();
+    return impl_->signer->hex_signature(message);
 }
 
 std::string ExchangeRestClient::create_timestamp() {
@@ -497,6 +496,13 @@ BinanceTradingInterface::BinanceTradingInterface(const std::string& api_key, con
     std::string base_url = testnet ? "https://testnet.binance.vision" : "https://api.binance.com";
     rest_client_ = std::make_unique<ExchangeRestClient>(base_url, api_key, secret);
     rest_client_->set_rate_limit(10); // 10 requests per second
+    
+    // Binance allows at most 8 decimals; set_symbol_filters narrows this per symbol
+    order_templates_ = std::make_unique<OrderTemplateCache>(
+        [this](const std::string& symbol, types::OrderSide side, types::OrderType type, const SymbolRounding& rounding) {
+            return build_order_template(symbol, side, type, rounding);
+        },
+        SymbolRounding{RoundingTable(1e-8), RoundingTable(1e-8)});
     connected_ = true;
     
     utils::Logger::info("Initialized Binance trading interface (testnet: {})", testnet);
@@ -515,32 +521,21 @@ std::string BinanceTradingInterface::place_order(const types::Order& order) {
 }
 
 std::string BinanceTradingInterface::place_binance_order(const types::Order& order) {
-    std::map<std::string, std::string> params;
-    params["symbol"] = symbol_to_binance_format(order.symbol);
-    params["side"] = order_side_to_string(order.side);
-    params["type"] = order_type_to_string(order.type);
-    params["quantity"] = std::to_string(order.quantity);
-    
-    if (order.type == types::OrderType::LIMIT) {
-        params["price"] = std::to_string(order.price);
-        params["timeInForce"] = "GTC";
-    }
+    // Everything but quantity, price and timestamp is pre-serialized in the template
+    auto order_template = order_templates_->get(order.symbol, order.side, order.type);
     
-    params["timestamp"] = rest_client_->create_timestamp();
+    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
     
-    // Create query string for signature
-    std::string query_string;
-    bool first = true;
-    for (const auto& [key, value] : params) {
-        if (!first) query_string += "&";
-        query_string += key + "=" + value;
-        first = false;
-    }
+    thread_local std::string query_string;
+    order_template->render_query(query_string, order.quantity, order.price, timestamp);
     
-    // Add signature
-    auto signed_headers = rest_client_->create_signed_headers("POST", "/api/v3/order", query_string);
+    // The signature covers the payload and is appended as the last parameter
+    size_t payload_size = query_string.size();
+    query_string += "&signature=";
+    rest_client_->signer().append_hex_signature(query_string, query_string.data(), payload_size);
     
-    std::string response = rest_client_->post("/api/v3/order", query_string, signed_headers);
+    std::string response = rest_client_->post("/api/v3/order", query_string);
     
     if (!response.empty()) {
         try {
@@ -578,6 +573,41 @@ std::string BinanceTradingInterface::symbol_to_binance_format(const std::string&
     return binance_symbol;
 }
 
+OrderTemplate BinanceTradingInterface::build_order_template(const std::string& symbol, types::OrderSide side,
+                                                            types::OrderType type, const SymbolRounding& rounding) {
+    OrderTemplate order_template;
+    order_template.static_query = "symbol=" + symbol_to_binance_format(symbol) +
+                                  "&side=" + order_side_to_string(side) +
+                                  "&type=" + order_type_to_string(type);
+    order_template.quantity = TemplateField::named("quantity");
+    
+    if (type == types::OrderType::LIMIT) {
+        order_template.static_query += "&timeInForce=GTC";
+        order_template.price = TemplateField::named("price");
+    }
+    
+    order_template.timestamp = TemplateField::named("timestamp");
+    order_template.price_rounding = rounding.price;
+    order_template.quantity_rounding = rounding.quantity;
+    return order_template;
+}
+
+double BinanceTradingInterface::round_to_tick_size(double price, const std::string& symbol) {
+    return order_templates_->rounding(symbol).price.round(price, RoundingTable::Mode::NEAREST);
+}
+
+double BinanceTradingInterface::round_to_step_size(double quantity, const std::string& symbol) {
+    return order_templates_->rounding(symbol).quantity.round(quantity, RoundingTable::Mode::DOWN);
+}
+
+void BinanceTradingInterface::set_symbol_filters(const std::string& symbol, double tick_size, double step_size) {
+    order_templates_->set_rounding(symbol, SymbolRounding{RoundingTable(tick_size), RoundingTable(step_size)});
+}
+
+void BinanceTradingInterface::prepare_order_templates(const std::string& symbol) {
+    order_templates_->prepare(symbol);
+}
+
 // Implement other required methods with mock implementations for now
 bool BinanceTradingInterface::cancel_order(const std::string& order_id) {
     // Mock implementation
@@ -697,6 +727,18 @@ UpbitTradingInterface::UpbitTradingInterface(const std::string& access_key, cons
     
     rest_client_ = std::make_unique<ExchangeRestClient>("https://api.upbit.com", access_key, secret_key);
     rest_client_->set_rate_limit(8); // 8 requests per second for Upbit
+    
+    // KRW market tick sizes depend on the price band
+    order_templates_ = std::make_unique<OrderTemplateCache>(
+        [this](const std::string& symbol, types::OrderSide side, types::OrderType type, const SymbolRounding& rounding) {
+            return build_order_template(symbol, side, type, rounding);
+        },
+        SymbolRounding{RoundingTable({{2000000.0, 1000.0}, {1000000.0, 500.0}, {500000.0, 100.0},
+                                      {100000.0, 50.0}, {10000.0, 10.0}, {1000.0, 1.0},
+                                      {100.0, 0.1}, {10.0, 0.01}, {1.0, 0.001},
+                                      {0.1, 0.0001}, {0.01, 0.00001}, {0.001, 0.000001},
+                                      {0.0001, 0.0000001}, {0.0, 0.00000001}}),
+                       RoundingTable(1e-8)});
     connected_ = true;
     
     utils::Logger::info("Initialized Upbit trading interface");
@@ -706,8 +748,50 @@ UpbitTradingInterface::~UpbitTradingInterface() = default;
 
 // Implement Upbit methods (mostly mock implementations for now)
 std::string UpbitTradingInterface::place_order(const types::Order& order) {
-    return "UPBIT_ORDER_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count());
+    try {
+        return place_upbit_order(order);
+    } catch (const std::exception& e) {
+        last_error_ = "Failed to place Upbit order: " + std::string(e.what());
+        utils::Logger::error(last_error_);
+        return "";
+    }
+}
+
+std::string UpbitTradingInterface::place_upbit_order(const types::Order& order) {
+    auto order_template = order_templates_->get(order.symbol, order.side, order.type);
+    
+    // Market buys are sized by the quote amount to spend
+    double price = order.price;
+    if (order.type != types::OrderType::LIMIT && order.side == types::OrderSide::BUY) {
+        if (order.price <= 0.0) {
+            throw std::invalid_argument("Upbit market buy needs a reference price");
+        }
+        price = order.quantity * order.price;
+    }
+    
+    thread_local std::string query_string;
+    thread_local std::string body;
+    order_template->render_query(query_string, order.quantity, price, 0);
+    order_template->render_json(body, order.quantity, price);
+    
+    std::map<std::string, std::string> headers;
+    headers["Authorization"] = "Bearer " + create_jwt_token(query_string);
+    headers["Content-Type"] = "application/json";
+    
+    std::string response = rest_client_->post("/v1/orders", body, headers);
+    
+    if (!response.empty()) {
+        try {
+            nlohmann::json j = nlohmann::json::parse(response);
+            if (j.contains("uuid")) {
+                return j["uuid"].get<std::string>();
+            }
+        } catch (const std::exception& e) {
+            utils::Logger::error("Failed to parse Upbit order response: {}", e.what());
+        }
+    }
+    
+    return "";
 }
 
 bool UpbitTradingInterface::cancel_order(const std::string& order_id) { return true; }
@@ -791,5 +875,125 @@ std::string UpbitTradingInterface::symbol_to_upbit_format(const std::string& sym
     return symbol;
 }
 
+OrderTemplate UpbitTradingInterface::build_order_template(const std::string& symbol, types::OrderSide side,
+                                                          types::OrderType type, const SymbolRounding& rounding) {
+    std::string market = symbol_to_upbit_format(symbol);
+    std::string side_name = order_side_to_string(side);
+    std::string order_type = order_type_to_string(type);
+    
+    // Upbit market buys use the "price" order type, which carries the KRW amount instead of a volume
+    bool quote_sized = type != types::OrderType::LIMIT && side == types::OrderSide::BUY;
+    if (quote_sized) {
+        order_type = "price";
+    }
+    
+    OrderTemplate order_template;
+    order_template.static_query = "market=" + market + "&side=" + side_name + "&ord_type=" + order_type;
+    order_template.static_json = "{\"market\":\"" + market + "\",\"side\":\"" + side_name +
+                                 "\",\"ord_type\":\"" + order_type + "\"";
+    if (!quote_sized) {
+        order_template.quantity = TemplateField::named("volume");
+    }
+    if (type == types::OrderType::LIMIT || quote_sized) {
+        order_template.price = TemplateField::named("price");
+    }
+    
+    order_template.price_rounding = quote_sized ? RoundingTable(1.0) : rounding.price;
+    order_template.quantity_rounding = rounding.quantity;
+    return order_template;
+}
+
+void UpbitTradingInterface::set_symbol_filters(const std::string& symbol, double tick_size, double step_size) {
+    order_templates_->set_rounding(symbol, SymbolRounding{RoundingTable(tick_size), RoundingTable(step_size)});
+}
+
+void UpbitTradingInterface::prepare_order_templates(const std::string& symbol) {
+    order_templates_->prepare(symbol);
+}
+
+static void append_base64url(std::string& out, const unsigned char* data, size_t size) {
+    static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    size_t i = 0;
+    for (; i + 2 < size; i += 3) {
+        uint32_t chunk = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+        out += alphabet[(chunk >> 18) & 0x3f];
+        out += alphabet[(chunk >> 12) & 0x3f];
+        out += alphabet[(chunk >> 6) & 0x3f];
+        out += alphabet[chunk & 0x3f];
+    }
+    // JWT uses the unpadded form
+    if (i + 1 == size) {
+        uint32_t chunk = data[i] << 16;
+        out += alphabet[(chunk >> 18) & 0x3f];
+        out += alphabet[(chunk >> 12) & 0x3f];
+    } else if (i + 2 == size) {
+        uint32_t chunk = (data[i] << 16) | (data[i + 1] << 8);
+        out += alphabet[(chunk >> 18) & 0x3f];
+        out += alphabet[(chunk >> 12) & 0x3f];
+        out += alphabet[(chunk >> 6) & 0x3f];
+    }
+}
+
+static void append_base64url(std::string& out, const std::string& text) {
+    append_base64url(out, reinterpret_cast<const unsigned char*>(text.data()), text.size());
+}
+
+// Random UUID v4, unique per request as Upbit requires
+static std::string create_nonce() {
+    thread_local std::mt19937_64 generator(std::random_device{}());
+    unsigned char bytes[16];
+    uint64_t high = generator();
+    uint64_t low = generator();
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<unsigned char>(high >> (i * 8));
+        bytes[i + 8] = static_cast<unsigned char>(low >> (i * 8));
+    }
+    bytes[6] = (bytes[6] & 0x0f) | 0x40;
+    bytes[8] = (bytes[8] & 0x3f) | 0x80;
+    
+    std::string nonce;
+    nonce.reserve(36);
+    append_hex(nonce, bytes, 4);
+    nonce += '-';
+    append_hex(nonce, bytes + 4, 2);
+    nonce += '-';
+    append_hex(nonce, bytes + 6, 2);
+    nonce += '-';
+    append_hex(nonce, bytes + 8, 2);
+    nonce += '-';
+    append_hex(nonce, bytes + 10, 6);
+    return nonce;
+}
+
+std::string UpbitTradingInterface::create_jwt_token(const std::string& payload) {
+    // HS256 token whose claims carry the SHA-512 hash of the order parameters in payload
+    static const std::string header = [] {
+        std::string encoded;
+        append_base64url(encoded, std::string("{\"alg\":\"HS256\",\"typ\":\"JWT\"}"));
+        return encoded;
+    }();
+    
+    unsigned char query_hash[64];
+    unsigned int hash_size = 0;
+    if (EVP_Digest(payload.data(), payload.size(), query_hash, &hash_size, EVP_sha512(), nullptr) != 1) {
+        throw std::runtime_error("Failed to hash Upbit order parameters");
+    }
+    
+    std::string claims = "{\"access_key\":\"" + rest_client_->api_key() + "\",\"nonce\":\"" + create_nonce() +
+                         "\",\"query_hash\":\"";
+    append_hex(claims, query_hash, hash_size);
+    claims += "\",\"query_hash_alg\":\"SHA512\"}";
+    
+    std::string token = header;
+    token += '.';
+    append_base64url(token, claims);
+    
+    unsigned char signature[HmacSha256Signer::DIGEST_SIZE];
+    rest_client_->signer().sign(token.data(), token.size(), signature);
+    token += '.';
+    append_base64url(token, signature, sizeof(signature));
+    return token;
+}
+
 } // namespace trading_engine
 } // namespace ats
\ No newline at end of file
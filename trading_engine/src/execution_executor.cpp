@@ -0,0 +1,168 @@
+#include "execution_executor.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ats {
+namespace trading_engine {
+
+namespace {
+
+bool pin_thread_to_core(std::thread& thread, int core) {
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+    (void)thread;
+    (void)core;
+    return false;
+#endif
+}
+
+} // namespace
+
+ExecutionExecutor::ExecutionExecutor(const Options& options)
+    : options_(options), next_core_(options.first_core) {
+    size_t count = std::max<size_t>(options_.coordinator_threads, 1);
+    for (size_t i = 0; i < count; ++i) {
+        coordinators_.push_back(std::make_unique<Lane>());
+        start_lane(*coordinators_.back());
+    }
+}
+
+ExecutionExecutor::~ExecutionExecutor() {
+    stop();
+}
+
+void ExecutionExecutor::start_lane(Lane& lane) {
+    lane.thread = std::thread([this, &lane]() { run_lane(lane); });
+
+    if (options_.pin_threads) {
+        int core = next_core_++;
+        if (!pin_thread_to_core(lane.thread, core)) {
+            utils::Logger::warn("Failed to pin execution thread to core {}", core);
+        }
+    }
+}
+
+void ExecutionExecutor::run_lane(Lane& lane) {
+    std::unique_lock<std::mutex> lock(lane.mutex);
+    while (true) {
+        lane.cv.wait(lock, [&lane]() { return !lane.tasks.empty() || lane.stopping; });
+        if (lane.tasks.empty()) {
+            return; // stopping and drained
+        }
+
+        auto task = std::move(lane.tasks.front());
+        lane.tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+void ExecutionExecutor::stop_lane(Lane& lane) {
+    {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.stopping = true;
+    }
+    lane.cv.notify_one();
+    if (lane.thread.joinable()) {
+        lane.thread.join();
+    }
+}
+
+void ExecutionExecutor::add_session(const std::string& exchange_id) {
+    std::unique_lock<std::shared_mutex> lock(sessions_mutex_);
+    if (!running_ || sessions_.count(exchange_id)) {
+        return;
+    }
+
+    auto lane = std::make_unique<Lane>();
+    start_lane(*lane);
+    sessions_.emplace(exchange_id, std::move(lane));
+}
+
+void ExecutionExecutor::remove_session(const std::string& exchange_id) {
+    std::unique_ptr<Lane> lane;
+    {
+        std::unique_lock<std::shared_mutex> lock(sessions_mutex_);
+        auto it = sessions_.find(exchange_id);
+        if (it == sessions_.end()) {
+            return;
+        }
+        lane = std::move(it->second);
+        sessions_.erase(it);
+    }
+    stop_lane(*lane);
+}
+
+bool ExecutionExecutor::has_session(const std::string& exchange_id) const {
+    std::shared_lock<std::shared_mutex> lock(sessions_mutex_);
+    return sessions_.count(exchange_id) > 0;
+}
+
+bool ExecutionExecutor::enqueue_to_session(const std::string& exchange_id, std::function<void()>& task) {
+    // Held while queueing so remove_session cannot retire the lane underneath
+    std::shared_lock<std::shared_mutex> sessions_lock(sessions_mutex_);
+    if (!sessions_running_) {
+        throw std::runtime_error("Cannot submit task to stopped ExecutionExecutor");
+    }
+
+    auto it = sessions_.find(exchange_id);
+    if (it == sessions_.end()) {
+        return false;
+    }
+
+    Lane& lane = *it->second;
+    {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.tasks.push_back(std::move(task));
+    }
+    lane.cv.notify_one();
+    return true;
+}
+
+void ExecutionExecutor::enqueue_to_coordinator(std::function<void()> task) {
+    if (!running_) {
+        throw std::runtime_error("Cannot submit task to stopped ExecutionExecutor");
+    }
+
+    Lane& lane = *coordinators_[next_coordinator_++ % coordinators_.size()];
+    {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.tasks.push_back(std::move(task));
+    }
+    lane.cv.notify_one();
+}
+
+void ExecutionExecutor::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    // Coordinators drain first: one that already sent a buy leg must still
+    // be able to hand the sell leg to its session
+    for (auto& lane : coordinators_) {
+        stop_lane(*lane);
+    }
+
+    std::unordered_map<std::string, std::unique_ptr<Lane>> sessions;
+    {
+        std::unique_lock<std::shared_mutex> lock(sessions_mutex_);
+        sessions_running_ = false;
+        sessions.swap(sessions_);
+    }
+    for (auto& [exchange_id, lane] : sessions) {
+        stop_lane(*lane);
+    }
+}
+
+} // namespace trading_engine
+} // namespace ats
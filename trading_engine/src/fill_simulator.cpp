@@ -0,0 +1,281 @@
+#include "fill_simulator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ats {
+namespace trading_engine {
+
+namespace {
+
+// Quantities below this share of the order are treated as rounding noise
+constexpr double QUANTITY_EPSILON = 1e-9;
+
+constexpr double PI = 3.14159265358979323846;
+
+const std::vector<std::pair<double, double>>* book_side(const MarketDepth* book, bool buy) {
+    if (!book) return nullptr;
+    const auto& levels = buy ? book->asks : book->bids;
+    return levels.empty() ? nullptr : &levels;
+}
+
+} // namespace
+
+FillSimulator::FillSimulator(FillSimulatorConfig config)
+    : config_(std::move(config)), random_state_(config_.seed) {}
+
+void FillSimulator::reset(uint64_t seed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_.seed = seed;
+    random_state_ = seed;
+    consumption_.clear();
+}
+
+// SplitMix64: small, fast and identical on every platform, unlike the
+// standard library distributions
+uint64_t FillSimulator::next_random() {
+    uint64_t z = (random_state_ += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+double FillSimulator::uniform() {
+    return static_cast<double>(next_random() >> 11) * 0x1.0p-53;
+}
+
+double FillSimulator::gaussian() {
+    // Box-Muller; 1 - uniform() keeps the logarithm's argument in (0, 1]
+    double radius = std::sqrt(-2.0 * std::log(1.0 - uniform()));
+    return radius * std::cos(2.0 * PI * uniform());
+}
+
+std::chrono::milliseconds FillSimulator::draw_latency(const std::string& exchange) {
+    auto it = config_.exchange_latency.find(exchange);
+    const SimulatedLatency& model = it != config_.exchange_latency.end() ? it->second : config_.default_latency;
+    auto jitter = model.jitter.count() > 0
+        ? static_cast<std::chrono::milliseconds::rep>(uniform() * static_cast<double>(model.jitter.count() + 1))
+        : 0;
+    return model.base + std::chrono::milliseconds(jitter);
+}
+
+double FillSimulator::taker_fee(const std::string& exchange) const {
+    auto it = config_.taker_fees.find(exchange);
+    return it != config_.taker_fees.end() ? it->second : config_.default_taker_fee;
+}
+
+FillSimulator::Consumption& FillSimulator::consumption_of(const std::string& exchange, const std::string& symbol,
+                                                          bool buy) {
+    key_buffer_.assign(exchange);
+    key_buffer_ += ':';
+    key_buffer_ += symbol;
+    key_buffer_ += buy ? ":ask" : ":bid";
+
+    auto it = consumption_.find(key_buffer_);
+    if (it == consumption_.end()) {
+        it = consumption_.emplace(key_buffer_, Consumption{}).first;
+    }
+    return it->second;
+}
+
+double FillSimulator::sweep(const Levels& levels, bool buy, double quantity, double limit_price,
+                            double skip_quantity, double price_factor, double& notional,
+                            size_t& levels_swept) const {
+    double remaining = quantity;
+    double skip = skip_quantity;
+    notional = 0.0;
+    levels_swept = 0;
+
+    for (const auto& [level_price, level_quantity] : levels) {
+        if (remaining <= 0.0) break;
+
+        double price = level_price * price_factor;
+        if (buy ? price > limit_price : price < limit_price) break;
+
+        double available = level_quantity;
+        if (skip > 0.0) {
+            double skipped = std::min(skip, available);
+            available -= skipped;
+            skip -= skipped;
+        }
+        if (available <= 0.0) continue;
+
+        double taken = std::min(available, remaining);
+        notional += taken * price;
+        remaining -= taken;
+        ++levels_swept;
+    }
+
+    return quantity - remaining;
+}
+
+void FillSimulator::fill_leg(const MarketDepth* book, const std::string& exchange, const std::string& symbol,
+                             bool buy, double quoted_price, double quantity,
+                             std::chrono::system_clock::time_point fallback_snapshot,
+                             std::chrono::system_clock::time_point now, SimulatedLeg& leg, double& price_factor) {
+    leg.requested_quantity = quantity;
+    leg.latency = draw_latency(exchange);
+    leg.limit_price = buy ? quoted_price * (1.0 + config_.slippage_tolerance)
+                          : quoted_price * (1.0 - config_.slippage_tolerance);
+
+    const Levels* levels = book_side(book, buy);
+    bool synthetic = levels == nullptr;
+    auto snapshot = synthetic ? fallback_snapshot : book->timestamp;
+    if (synthetic) {
+        synthetic_levels_.assign(1, {quoted_price, quantity});
+        levels = &synthetic_levels_;
+    }
+
+    // The book moves for as long as the snapshot is old when the order lands
+    double horizon_ms = std::max(0.0, std::chrono::duration<double, std::milli>(now - snapshot).count()) +
+                        static_cast<double>(leg.latency.count());
+    double drift = config_.volatility_bps * 1e-4 * std::sqrt(horizon_ms / 1000.0) * gaussian();
+    price_factor = std::max(0.0, 1.0 + drift);
+
+    // Competing takers that reach the touch before our order does. A
+    // synthetic level holds only our own order size, not the real touch,
+    // so taking a share of it would turn nearly every such fill partial.
+    double ahead = 0.0;
+    if (!synthetic) {
+        double touch_share = std::min(1.0, config_.competing_flow * static_cast<double>(leg.latency.count()) /
+                                               100.0 * 2.0 * uniform());
+        ahead = touch_share * levels->front().second;
+    }
+
+    // A synthetic book is rebuilt for every order, so there is nothing to deplete
+    Consumption* consumed = nullptr;
+    if (!synthetic) {
+        consumed = &consumption_of(exchange, symbol, buy);
+        if (consumed->snapshot != snapshot || now - consumed->last_fill > config_.replenish_after) {
+            consumed->snapshot = snapshot;
+            consumed->quantity = 0.0;
+        }
+    }
+
+    leg.filled_quantity = sweep(*levels, buy, quantity, leg.limit_price, (consumed ? consumed->quantity : 0.0) + ahead,
+                                price_factor, leg.notional, leg.levels_swept);
+    leg.fees = leg.notional * taker_fee(exchange);
+
+    if (consumed && leg.filled_quantity > 0.0) {
+        consumed->quantity += leg.filled_quantity;
+        consumed->last_fill = now;
+    }
+}
+
+double FillSimulator::unwind(const MarketDepth* book, const std::string& exchange, const std::string& symbol,
+                             bool buy, double quantity, double fallback_price, double price_factor,
+                             std::chrono::system_clock::time_point now) {
+    const Levels* levels = book_side(book, buy);
+    if (!levels) {
+        return quantity * fallback_price;
+    }
+
+    Consumption& consumed = consumption_of(exchange, symbol, buy);
+    if (consumed.snapshot != book->timestamp || now - consumed.last_fill > config_.replenish_after) {
+        consumed.snapshot = book->timestamp;
+        consumed.quantity = 0.0;
+    }
+
+    double notional = 0.0;
+    size_t levels_swept = 0;
+    double limit = buy ? std::numeric_limits<double>::max() : 0.0;
+    double filled = sweep(*levels, buy, quantity, limit, consumed.quantity, price_factor, notional, levels_swept);
+    consumed.quantity += filled;
+    consumed.last_fill = now;
+
+    return notional + (quantity - filled) * fallback_price;
+}
+
+SimulatedFill FillSimulator::simulate(const ArbitrageOpportunity& opportunity,
+                                      const MarketDepth* buy_book,
+                                      const MarketDepth* sell_book,
+                                      std::chrono::system_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    SimulatedFill fill;
+    double quantity = opportunity.available_quantity;
+    double epsilon = quantity * QUANTITY_EPSILON;
+
+    if (!book_side(buy_book, true) || !book_side(sell_book, false)) {
+        ++fills_without_depth_;
+    }
+
+    double buy_factor = 1.0;
+    double sell_factor = 1.0;
+    fill_leg(buy_book, opportunity.buy_exchange, opportunity.symbol, true, opportunity.buy_price, quantity,
+             opportunity.detected_at, now, fill.buy, buy_factor);
+    fill_leg(sell_book, opportunity.sell_exchange, opportunity.symbol, false, opportunity.sell_price, quantity,
+             opportunity.detected_at, now, fill.sell, sell_factor);
+
+    fill.executed_quantity = std::min(fill.buy.filled_quantity, fill.sell.filled_quantity);
+    fill.total_fees = fill.buy.fees + fill.sell.fees;
+    fill.profit = fill.sell.notional - fill.buy.notional - fill.total_fees;
+    fill.latency = std::max(fill.buy.latency, fill.sell.latency);
+
+    // Close out the leg imbalance on the exchange that overfilled, crossing
+    // back over its spread, so the reported profit leaves no open position
+    double imbalance = fill.buy.filled_quantity - fill.sell.filled_quantity;
+    if (std::fabs(imbalance) > epsilon) {
+        bool long_excess = imbalance > 0.0;
+        const std::string& exchange = long_excess ? opportunity.buy_exchange : opportunity.sell_exchange;
+        const SimulatedLeg& leg = long_excess ? fill.buy : fill.sell;
+        double excess = std::fabs(imbalance);
+
+        // Without the opposite side, assume the spread costs the slippage tolerance
+        double fallback_price = long_excess ? leg.average_price() * (1.0 - config_.slippage_tolerance)
+                                            : leg.average_price() * (1.0 + config_.slippage_tolerance);
+        double notional = unwind(long_excess ? buy_book : sell_book, exchange, opportunity.symbol, !long_excess,
+                                 excess, fallback_price, long_excess ? buy_factor : sell_factor, now);
+        double fee = notional * taker_fee(exchange);
+
+        if (long_excess) {
+            fill.profit += notional - fee;
+            fill.unwind_cost = excess * leg.average_price() - notional + fee;
+        } else {
+            fill.profit -= notional + fee;
+            fill.unwind_cost = notional + fee - excess * leg.average_price();
+        }
+        fill.unwound_quantity = excess;
+        fill.total_fees += fee;
+        fill.latency += draw_latency(exchange);
+    }
+
+    ++fills_simulated_;
+    if (fill.executed_quantity <= epsilon) {
+        fill.result = ExecutionResult::FAILURE;
+        fill.error_message = fill.buy.filled_quantity <= epsilon
+            ? "No ask liquidity within limit price on " + opportunity.buy_exchange
+            : "No bid liquidity within limit price on " + opportunity.sell_exchange;
+        ++unfilled_orders_;
+    } else if (fill.executed_quantity < quantity - epsilon) {
+        fill.result = ExecutionResult::PARTIAL_SUCCESS;
+        ++partial_fills_;
+    } else {
+        fill.result = ExecutionResult::SUCCESS;
+    }
+
+    return fill;
+}
+
+size_t FillSimulator::get_fills_simulated() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fills_simulated_;
+}
+
+size_t FillSimulator::get_partial_fills() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return partial_fills_;
+}
+
+size_t FillSimulator::get_unfilled_orders() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return unfilled_orders_;
+}
+
+size_t FillSimulator::get_fills_without_depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fills_without_depth_;
+}
+
+} // namespace trading_engine
+} // namespace ats
@@ -0,0 +1,124 @@
+#include "opportunity_queue.hpp"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace ats {
+namespace trading_engine {
+
+OpportunityQueue::OpportunityQueue(size_t capacity, std::chrono::milliseconds ttl)
+    : capacity_(capacity), ttl_(ttl) {}
+
+void OpportunityQueue::set_limits(size_t capacity, std::chrono::milliseconds ttl) {
+    capacity_ = capacity;
+    ttl_ = ttl;
+}
+
+OpportunityQueue::Clock::time_point OpportunityQueue::deadline_of(const ArbitrageOpportunity& opportunity) const {
+    auto window = opportunity.validity_window;
+    if (ttl_.count() > 0) {
+        window = std::min(window, ttl_);
+    }
+    return opportunity.detected_at + window;
+}
+
+OpportunityQueue::PushResult OpportunityQueue::push(const ArbitrageOpportunity& opportunity, Clock::time_point now) {
+    auto deadline = deadline_of(opportunity);
+    if (now > deadline) {
+        ++expired_;
+        return PushResult::EXPIRED;
+    }
+
+    key_buffer_.assign(opportunity.symbol);
+    key_buffer_ += '\x1f';
+    key_buffer_ += opportunity.buy_exchange;
+    key_buffer_ += '\x1f';
+    key_buffer_ += opportunity.sell_exchange;
+
+    auto route = routes_.find(key_buffer_);
+    if (route != routes_.end()) {
+        Entry& entry = route->second;
+        if (opportunity.detected_at < entry.opportunity.detected_at) {
+            return PushResult::STALE;
+        }
+        ++superseded_;
+
+        // Re-rank under the new profit; the entry must leave the set before
+        // the fields it is ordered by change
+        ranked_.erase(&entry);
+        entry.opportunity = opportunity;
+        entry.deadline = deadline;
+        entry.sequence = next_sequence_++;
+        ranked_.insert(&entry);
+        return PushResult::REPLACED;
+    }
+
+    if (ranked_.size() >= capacity_) {
+        purge_expired(now);
+    }
+    if (ranked_.size() >= capacity_) {
+        if (ranked_.empty() ||
+            !(opportunity.expected_profit > (*ranked_.rbegin())->opportunity.expected_profit)) {
+            ++rejected_;
+            return PushResult::FULL;
+        }
+        erase(std::prev(ranked_.end()));
+        ++evicted_;
+    }
+
+    auto inserted = routes_.emplace(key_buffer_, Entry{}).first;
+    Entry& entry = inserted->second;
+    entry.opportunity = opportunity;
+    entry.deadline = deadline;
+    entry.sequence = next_sequence_++;
+    entry.key = &inserted->first;
+    ranked_.insert(&entry);
+    return PushResult::QUEUED;
+}
+
+bool OpportunityQueue::pop(ArbitrageOpportunity& out, Clock::time_point now) {
+    while (!ranked_.empty()) {
+        auto best = ranked_.begin();
+        Entry& entry = **best;
+        if (now > entry.deadline) {
+            ++expired_;
+            erase(best);
+            continue;
+        }
+
+        out = std::move(entry.opportunity);
+        erase(best);
+        return true;
+    }
+    return false;
+}
+
+size_t OpportunityQueue::purge_expired(Clock::time_point now) {
+    size_t dropped = 0;
+    for (auto it = ranked_.begin(); it != ranked_.end();) {
+        if (now > (*it)->deadline) {
+            auto expired = it++;
+            erase(expired);
+            ++dropped;
+        } else {
+            ++it;
+        }
+    }
+    expired_ += dropped;
+    return dropped;
+}
+
+void OpportunityQueue::clear() {
+    ranked_.clear();
+    routes_.clear();
+}
+
+void OpportunityQueue::erase(Ranking::iterator position) {
+    const std::string& key = *(*position)->key;
+    ranked_.erase(position);
+    // Erase through an iterator: the key lives inside the node being erased
+    routes_.erase(routes_.find(key));
+}
+
+} // namespace trading_engine
+} // namespace ats
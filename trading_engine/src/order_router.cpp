@@ -1,4 +1,5 @@
 #include "order_router.hpp"
+#include "execution_executor.hpp"
 #include "utils/logger.hpp"
 #include "utils/json_parser.hpp"
 #include <nlohmann/json.hpp>
@@ -26,6 +27,7 @@ struct OrderRouter::Implementation {
     ErrorCallback error_callback;
     
     // Thread management
+    std::unique_ptr<ExecutionExecutor> executor; // persistent execution threads
     std::vector<std::thread> monitor_threads;
     std::queue<std::string> pending_orders;
     std::mutex pending_mutex;
@@ -35,6 +37,11 @@ struct OrderRouter::Implementation {
     std::unordered_map<std::string, OrderExecutionDetails> active_orders;
     std::shared_mutex active_orders_mutex;
     
+    // Running mean behind performance_metrics.average_leg_skew_us
+    std::mutex leg_skew_mutex;
+    double leg_skew_total_us = 0.0;
+    size_t leg_skew_samples = 0;
+    
     mutable std::shared_mutex mutex;
 };
 
@@ -56,6 +63,10 @@ std::string status_to_string(OrderExecutionStatus status) {
 OrderRouter::OrderRouter() : impl_(std::make_unique<Implementation>()) {}
 
 OrderRouter::~OrderRouter() {
+    if (impl_->executor) {
+        impl_->executor->stop();
+    }
+    
     if (impl_->running) {
         // Stop monitoring threads
         impl_->running = false;
@@ -75,6 +86,19 @@ bool OrderRouter::initialize(const OrderRouterConfig& config) {
     impl_->config = config;
     impl_->running = true;
     
+    // Pre-spawn the execution threads so no trade pays for thread creation
+    if (!impl_->executor) {
+        ExecutionExecutor::Options executor_options;
+        executor_options.coordinator_threads = config.execution_coordinator_threads;
+        executor_options.pin_threads = config.pin_execution_threads;
+        executor_options.first_core = config.execution_first_core;
+        impl_->executor = std::make_unique<ExecutionExecutor>(executor_options);
+        
+        for (const auto& [exchange_id, exchange] : impl_->exchanges) {
+            impl_->executor->add_session(exchange_id);
+        }
+    }
+    
     // Start order monitoring thread
     impl_->monitor_threads.emplace_back([this]() {
         while (impl_->running) {
@@ -117,10 +141,19 @@ void OrderRouter::add_exchange(const std::string& exchange_id,
     impl_->exchanges[exchange_id] = std::move(exchange);
     update_balance_cache(exchange_id);
     
+    if (impl_->executor) {
+        impl_->executor->add_session(exchange_id);
+    }
+    
     utils::Logger::info("Added exchange: {}", exchange_id);
 }
 
 void OrderRouter::remove_exchange(const std::string& exchange_id) {
+    // Drain the session first so no in-flight order outlives its exchange
+    if (impl_->executor) {
+        impl_->executor->remove_session(exchange_id);
+    }
+    
     std::unique_lock<std::shared_mutex> lock(impl_->mutex);
     
     impl_->exchanges.erase(exchange_id);
@@ -130,7 +163,12 @@ void OrderRouter::remove_exchange(const std::string& exchange_id) {
 }
 
 std::future<OrderExecutionDetails> OrderRouter::place_order_async(const types::Order& order) {
-    return std::async(std::launch::async, [this, order]() {
+    if (!impl_->executor) {
+        return std::async(std::launch::async, [this, order]() {
+            return place_order_sync(order);
+        });
+    }
+    return impl_->executor->submit_to_session(order.exchange, [this, order]() {
         return place_order_sync(order);
     });
 }
@@ -159,6 +197,7 @@ OrderExecutionDetails OrderRouter::place_order_sync(const types::Order& order) {
     
     try {
         details.submitted_at = std::chrono::system_clock::now();
+        details.send_time = std::chrono::steady_clock::now();
         details.exchange_order_id = exchange->place_order(order);
         details.status = OrderExecutionStatus::SUBMITTED;
         
@@ -196,7 +235,12 @@ OrderExecutionDetails OrderRouter::place_order_sync(const types::Order& order) {
 
 std::future<SimultaneousExecutionResult> OrderRouter::execute_arbitrage_orders_async(
     const ArbitrageOpportunity& opportunity) {
-    return std::async(std::launch::async, [this, opportunity]() {
+    if (!impl_->executor) {
+        return std::async(std::launch::async, [this, opportunity]() {
+            return execute_arbitrage_orders_sync(opportunity);
+        });
+    }
+    return impl_->executor->submit([this, opportunity]() {
         return execute_arbitrage_orders_sync(opportunity);
     });
 }
@@ -233,16 +277,19 @@ SimultaneousExecutionResult OrderRouter::execute_arbitrage_orders_sync(
     sell_order.quantity = opportunity.available_quantity;
     sell_order.price = opportunity.sell_price;
     
-    // Execute orders simultaneously
-    auto buy_future = place_order_async(buy_order);
-    auto sell_future = place_order_async(sell_order);
-    
-    // Wait for both orders with timeout
-    auto timeout = impl_->config.execution_timeout;
+    // Wait for both orders against one shared deadline
+    auto deadline = std::chrono::steady_clock::now() + impl_->config.execution_timeout;
+    std::future<OrderExecutionDetails> buy_future;
+    std::future<OrderExecutionDetails> sell_future;
     
     try {
-        auto buy_result = buy_future.wait_for(timeout);
-        auto sell_result = sell_future.wait_for(timeout);
+        // Both legs are built up front, then handed to their exchange sessions
+        // back to back so they go out in parallel
+        buy_future = place_order_async(buy_order);
+        sell_future = place_order_async(sell_order);
+        
+        auto buy_result = buy_future.wait_until(deadline);
+        auto sell_result = sell_future.wait_until(deadline);
         
         if (buy_result == std::future_status::timeout || 
             sell_result == std::future_status::timeout) {
@@ -256,6 +303,16 @@ SimultaneousExecutionResult OrderRouter::execute_arbitrage_orders_sync(
             result.order_executions.push_back(buy_details);
             result.order_executions.push_back(sell_details);
             
+            // A leg rejected before submission never set its send time
+            std::chrono::steady_clock::time_point not_sent{};
+            if (buy_details.send_time != not_sent && sell_details.send_time != not_sent) {
+                auto skew = buy_details.send_time > sell_details.send_time
+                    ? buy_details.send_time - sell_details.send_time
+                    : sell_details.send_time - buy_details.send_time;
+                result.leg_send_skew = std::chrono::duration_cast<std::chrono::microseconds>(skew);
+                record_leg_skew(result.leg_send_skew);
+            }
+            
             // Analyze execution results
             bool buy_success = (buy_details.status == OrderExecutionStatus::FILLED ||
                               buy_details.status == OrderExecutionStatus::PARTIALLY_FILLED);
@@ -294,6 +351,19 @@ SimultaneousExecutionResult OrderRouter::execute_arbitrage_orders_sync(
         result.error_message = "Exception during execution: " + std::string(e.what());
         result.requires_rollback = true;
         impl_->performance_metrics.failed_orders++;
+        
+        // A leg that already went out must reach the rollback, so collect
+        // whatever was submitted before the failure
+        for (auto* leg : {&buy_future, &sell_future}) {
+            if (!leg->valid() || leg->wait_until(deadline) != std::future_status::ready) {
+                continue;
+            }
+            try {
+                result.order_executions.push_back(leg->get());
+            } catch (const std::exception&) {
+                // The leg itself failed; nothing to unwind
+            }
+        }
     }
     
     result.total_execution_time = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -616,6 +686,14 @@ void OrderRouter::record_order_metrics(const OrderExecutionDetails& details) {
     update_performance_statistics();
 }
 
+void OrderRouter::record_leg_skew(std::chrono::microseconds skew) {
+    std::lock_guard<std::mutex> lock(impl_->leg_skew_mutex);
+    impl_->leg_skew_total_us += static_cast<double>(skew.count());
+    ++impl_->leg_skew_samples;
+    impl_->performance_metrics.average_leg_skew_us =
+        impl_->leg_skew_total_us / static_cast<double>(impl_->leg_skew_samples);
+}
+
 void OrderRouter::update_performance_statistics() {
     size_t total = impl_->performance_metrics.total_orders_placed.load();
     size_t successful = impl_->performance_metrics.successful_orders.load();
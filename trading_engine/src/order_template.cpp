@@ -0,0 +1,307 @@
+#include "order_template.hpp"
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace ats {
+namespace trading_engine {
+
+namespace {
+
+constexpr size_t SHA256_BLOCK_SIZE = 64;
+constexpr int MAX_DECIMALS = 12;
+
+struct MdContextDeleter {
+    void operator()(EVP_MD_CTX* ctx) const { EVP_MD_CTX_free(ctx); }
+};
+
+using MdContext = std::unique_ptr<EVP_MD_CTX, MdContextDeleter>;
+
+// Scratch context per thread; copying a prepared state into it allocates nothing
+EVP_MD_CTX* scratch_context() {
+    thread_local MdContext ctx(EVP_MD_CTX_new());
+    return ctx.get();
+}
+
+MdContext keyed_context(const unsigned char* key_block, unsigned char pad) {
+    unsigned char padded[SHA256_BLOCK_SIZE];
+    for (size_t i = 0; i < SHA256_BLOCK_SIZE; ++i) {
+        padded[i] = key_block[i] ^ pad;
+    }
+
+    MdContext ctx(EVP_MD_CTX_new());
+    bool ok = ctx && EVP_DigestInit_ex(ctx.get(), EVP_sha256(), nullptr) == 1 &&
+              EVP_DigestUpdate(ctx.get(), padded, SHA256_BLOCK_SIZE) == 1;
+    OPENSSL_cleanse(padded, sizeof(padded));
+    if (!ok) {
+        throw std::runtime_error("Failed to initialize HMAC-SHA256 key state");
+    }
+    return ctx;
+}
+
+void append_uint(std::string& out, uint64_t value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+} // namespace
+
+void append_hex(std::string& out, const unsigned char* data, size_t size) {
+    static constexpr char digits[] = "0123456789abcdef";
+    size_t offset = out.size();
+    out.resize(offset + size * 2);
+    for (size_t i = 0; i < size; ++i) {
+        out[offset + i * 2] = digits[data[i] >> 4];
+        out[offset + i * 2 + 1] = digits[data[i] & 0x0f];
+    }
+}
+
+// HmacSha256Signer implementation
+struct HmacSha256Signer::Implementation {
+    MdContext inner;
+    MdContext outer;
+};
+
+HmacSha256Signer::HmacSha256Signer(const std::string& key)
+    : impl_(std::make_unique<Implementation>()) {
+    unsigned char key_block[SHA256_BLOCK_SIZE] = {0};
+    if (key.size() > SHA256_BLOCK_SIZE) {
+        unsigned int length = 0;
+        if (EVP_Digest(key.data(), key.size(), key_block, &length, EVP_sha256(), nullptr) != 1) {
+            throw std::runtime_error("Failed to hash HMAC key");
+        }
+    } else {
+        std::copy(key.begin(), key.end(), key_block);
+    }
+
+    impl_->inner = keyed_context(key_block, 0x36);
+    impl_->outer = keyed_context(key_block, 0x5c);
+    OPENSSL_cleanse(key_block, sizeof(key_block));
+}
+
+HmacSha256Signer::~HmacSha256Signer() = default;
+
+void HmacSha256Signer::sign(const char* data, size_t size, unsigned char* digest) const {
+    EVP_MD_CTX* ctx = scratch_context();
+    unsigned char inner_digest[DIGEST_SIZE];
+    unsigned int length = 0;
+
+    bool ok = ctx &&
+              EVP_MD_CTX_copy_ex(ctx, impl_->inner.get()) == 1 &&
+              EVP_DigestUpdate(ctx, data, size) == 1 &&
+              EVP_DigestFinal_ex(ctx, inner_digest, &length) == 1 &&
+              EVP_MD_CTX_copy_ex(ctx, impl_->outer.get()) == 1 &&
+              EVP_DigestUpdate(ctx, inner_digest, DIGEST_SIZE) == 1 &&
+              EVP_DigestFinal_ex(ctx, digest, &length) == 1;
+    if (!ok) {
+        throw std::runtime_error("HMAC-SHA256 signing failed");
+    }
+}
+
+void HmacSha256Signer::append_hex_signature(std::string& out, const char* data, size_t size) const {
+    unsigned char digest[DIGEST_SIZE];
+    sign(data, size, digest);
+    append_hex(out, digest, DIGEST_SIZE);
+}
+
+std::string HmacSha256Signer::hex_signature(const std::string& message) const {
+    std::string signature;
+    signature.reserve(DIGEST_SIZE * 2);
+    append_hex_signature(signature, message.data(), message.size());
+    return signature;
+}
+
+// RoundingTable implementation
+RoundingTable::RoundingTable(double increment)
+    : RoundingTable(std::vector<PriceBand>{{0.0, increment}}) {}
+
+RoundingTable::RoundingTable(std::vector<PriceBand> bands) {
+    if (bands.empty()) {
+        bands.push_back({0.0, 1e-8});
+    }
+    std::sort(bands.begin(), bands.end(), [](const PriceBand& a, const PriceBand& b) {
+        return a.min_price > b.min_price;
+    });
+
+    for (const auto& band : bands) {
+        if (!(band.increment > 0.0)) {
+            throw std::invalid_argument("Rounding increment must be positive");
+        }
+
+        // Fewest decimals that represent the increment exactly
+        int decimals = 0;
+        double scale = 1.0;
+        while (decimals < MAX_DECIMALS) {
+            double scaled = band.increment * scale;
+            if (std::fabs(scaled - std::round(scaled)) <= 1e-9 * std::max(1.0, scaled)) {
+                break;
+            }
+            ++decimals;
+            scale *= 10.0;
+        }
+
+        Band entry;
+        entry.min_price = band.min_price;
+        entry.increment = band.increment;
+        entry.inverse = 1.0 / band.increment;
+        entry.scale = static_cast<int64_t>(scale);
+        entry.scaled_increment = std::max<int64_t>(std::llround(band.increment * scale), 1);
+        entry.decimals = decimals;
+        bands_.push_back(entry);
+    }
+}
+
+const RoundingTable::Band& RoundingTable::band_for(double value) const {
+    for (const auto& band : bands_) {
+        if (value >= band.min_price) {
+            return band;
+        }
+    }
+    return bands_.back();
+}
+
+int64_t RoundingTable::units(const Band& band, double value, Mode mode) {
+    double steps = value * band.inverse;
+    double rounded = std::round(steps);
+    if (mode == Mode::DOWN) {
+        // On-grid values like 0.3 / 0.1 land a few ulps either side of the
+        // whole step count, so they snap to it instead of flooring one step
+        // short. The error grows with the step count, hence the relative
+        // term; it stays far below one step for any printable value.
+        double tolerance = std::max(1e-9, std::fabs(steps) * 1e-12);
+        if (std::fabs(steps - rounded) > tolerance) {
+            rounded = std::floor(steps);
+        }
+    }
+    return rounded > 0.0 ? static_cast<int64_t>(rounded) : 0;
+}
+
+double RoundingTable::round(double value, Mode mode) const {
+    const Band& band = band_for(value);
+    return static_cast<double>(units(band, value, mode) * band.scaled_increment) / band.scale;
+}
+
+void RoundingTable::append(std::string& out, double value, Mode mode) const {
+    const Band& band = band_for(value);
+    uint64_t scaled = static_cast<uint64_t>(units(band, value, mode) * band.scaled_increment);
+
+    append_uint(out, scaled / band.scale);
+    if (band.decimals > 0) {
+        char fraction[MAX_DECIMALS];
+        uint64_t remainder = scaled % band.scale;
+        for (int i = band.decimals - 1; i >= 0; --i) {
+            fraction[i] = static_cast<char>('0' + remainder % 10);
+            remainder /= 10;
+        }
+        out += '.';
+        out.append(fraction, band.decimals);
+    }
+}
+
+// TemplateField implementation
+TemplateField TemplateField::named(const std::string& name) {
+    TemplateField field;
+    field.query_key = "&" + name + "=";
+    field.json_key = ",\"" + name + "\":\"";
+    return field;
+}
+
+// OrderTemplate implementation
+void OrderTemplate::render_query(std::string& out, double quantity_value, double price_value,
+                                 int64_t timestamp_value) const {
+    out.assign(static_query);
+    if (quantity.enabled()) {
+        out += quantity.query_key;
+        quantity_rounding.append(out, quantity_value, RoundingTable::Mode::DOWN);
+    }
+    if (price.enabled()) {
+        out += price.query_key;
+        price_rounding.append(out, price_value, RoundingTable::Mode::NEAREST);
+    }
+    if (timestamp.enabled()) {
+        out += timestamp.query_key;
+        append_uint(out, static_cast<uint64_t>(timestamp_value));
+    }
+}
+
+void OrderTemplate::render_json(std::string& out, double quantity_value, double price_value) const {
+    out.assign(static_json);
+    if (quantity.enabled()) {
+        out += quantity.json_key;
+        quantity_rounding.append(out, quantity_value, RoundingTable::Mode::DOWN);
+        out += '"';
+    }
+    if (price.enabled()) {
+        out += price.json_key;
+        price_rounding.append(out, price_value, RoundingTable::Mode::NEAREST);
+        out += '"';
+    }
+    out += '}';
+}
+
+// OrderTemplateCache implementation
+OrderTemplateCache::OrderTemplateCache(Builder builder, SymbolRounding default_rounding)
+    : builder_(std::move(builder)), default_rounding_(std::move(default_rounding)) {}
+
+std::shared_ptr<const OrderTemplate> OrderTemplateCache::get(const std::string& symbol, types::OrderSide side,
+                                                             types::OrderType type) {
+    Key key{symbol, side, type};
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = templates_.find(key);
+        if (it != templates_.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = templates_.find(key);
+    if (it != templates_.end()) {
+        return it->second;
+    }
+
+    auto rounding_it = rounding_.find(symbol);
+    const SymbolRounding& rounding = rounding_it != rounding_.end() ? rounding_it->second : default_rounding_;
+    auto built = std::make_shared<const OrderTemplate>(builder_(symbol, side, type, rounding));
+    templates_.emplace(std::move(key), built);
+    return built;
+}
+
+void OrderTemplateCache::prepare(const std::string& symbol) {
+    for (auto side : {types::OrderSide::BUY, types::OrderSide::SELL}) {
+        for (auto type : {types::OrderType::MARKET, types::OrderType::LIMIT}) {
+            get(symbol, side, type);
+        }
+    }
+}
+
+void OrderTemplateCache::set_rounding(const std::string& symbol, SymbolRounding rounding) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    rounding_[symbol] = std::move(rounding);
+    for (auto it = templates_.begin(); it != templates_.end();) {
+        if (it->first.symbol == symbol) {
+            it = templates_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+SymbolRounding OrderTemplateCache::rounding(const std::string& symbol) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = rounding_.find(symbol);
+    return it != rounding_.end() ? it->second : default_rounding_;
+}
+
+size_t OrderTemplateCache::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return templates_.size();
+}
+
+} // namespace trading_engine
+} // namespace ats
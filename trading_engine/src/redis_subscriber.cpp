@@ -7,12 +7,54 @@
 #include <chrono>
 #include <sstream>
 #include <queue>
+#include <algorithm>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
+#include <string_view>
 
 namespace ats {
 namespace trading_engine {
 
+namespace {
+
+// Lock-free exponential moving average (alpha = 1/8); parse workers record
+// samples concurrently
+template<typename Duration>
+void record_average(std::atomic<Duration>& average, std::chrono::steady_clock::duration sample) {
+    Duration value = std::chrono::duration_cast<Duration>(sample);
+    Duration current = average.load(std::memory_order_relaxed);
+    Duration updated;
+    do {
+        updated = current.count() == 0 ? value : current + (value - current) / 8;
+    } while (!average.compare_exchange_weak(current, updated, std::memory_order_relaxed));
+}
+
+// Value of the "symbol" field, found by scanning the raw payload so the
+// reader thread never parses JSON
+std::string_view find_symbol(const std::string& payload) {
+    static constexpr std::string_view key = "\"symbol\"";
+    size_t pos = payload.find(key.data(), 0, key.size());
+    if (pos == std::string::npos) {
+        return {};
+    }
+    pos = payload.find(':', pos + key.size());
+    if (pos == std::string::npos) {
+        return {};
+    }
+    size_t open = payload.find_first_not_of(" \t\r\n", pos + 1);
+    if (open == std::string::npos || payload[open] != '"') {
+        return {};
+    }
+    size_t close = payload.find('"', open + 1);
+    if (close == std::string::npos) {
+        return {};
+    }
+    return std::string_view(payload).substr(open + 1, close - open - 1);
+}
+
+} // namespace
+
 struct RedisSubscriber::Implementation {
     RedisSubscriberConfig config;
     redisContext* redis_context = nullptr;
@@ -22,14 +64,29 @@ struct RedisSubscriber::Implementation {
     
     // Threading
     std::thread connection_thread;
-    std::thread message_processing_thread;
     std::thread health_check_thread;
     std::vector<std::thread> worker_threads;
     
-    // Message queue
-    std::queue<RedisMessage> message_queue;
-    std::mutex message_queue_mutex;
-    std::condition_variable message_queue_cv;
+    // One bounded queue per parse worker. The reader thread only routes raw
+    // payloads; parsing and callbacks run on the workers.
+    struct Partition {
+        std::deque<RedisMessage> queue;
+        std::mutex mutex;
+        std::condition_variable not_empty;
+        std::condition_variable not_full;
+        
+        // Binary ticker decoders per channel. Binary payloads carry no symbol
+        // text, so a channel always maps to one partition and only its
+        // worker touches these.
+        std::unordered_map<std::string, types::TickerWireDecoder> decoders;
+        // Ticker frames dropped here per channel, not yet seen by the
+        // decoder as a sequence gap; guarded by mutex
+        std::unordered_map<std::string, uint64_t> dropped_sequences;
+    };
+    std::vector<std::unique_ptr<Partition>> partitions;
+    
+    std::unordered_map<std::string, types::WireFormat> channel_formats;
+    mutable std::shared_mutex channel_formats_mutex;
     
     // Subscriptions
     std::vector<std::string> subscribed_channels;
@@ -39,6 +96,7 @@ struct RedisSubscriber::Implementation {
     // Callbacks
     MessageCallback message_callback;
     PriceUpdateCallback price_update_callback;
+    OrderBookCallback order_book_callback;
     ConnectionCallback connection_callback;
     ErrorCallback error_callback;
     
@@ -107,6 +165,18 @@ bool RedisSubscriber::start() {
     impl_->running = true;
     impl_->reconnect_attempts = 0;
     
+    // Start parse workers, one per partition, before the reader can enqueue
+    size_t worker_count = static_cast<size_t>(std::max(impl_->config.worker_thread_count, 1));
+    impl_->partitions.clear();
+    for (size_t i = 0; i < worker_count; ++i) {
+        impl_->partitions.push_back(std::make_unique<Implementation::Partition>());
+    }
+    for (size_t i = 0; i < worker_count; ++i) {
+        impl_->worker_threads.emplace_back([this, i]() {
+            message_processing_loop(i);
+        });
+    }
+    
     // Start connection thread
     impl_->connection_thread = std::thread([this]() {
         while (impl_->running) {
@@ -157,21 +227,19 @@ bool RedisSubscriber::start() {
                 if (result == REDIS_OK && reply) {
                     if (reply->type == REDIS_REPLY_ARRAY && reply->elements >= 3) {
                         std::string message_type = reply->element[0]->str;
-                        std::string channel = reply->element[1]->str;
-                        std::string message = reply->element[2]->str;
+                        
+                        // pmessage replies carry the matched pattern before the channel
+                        size_t channel_index = (message_type == "pmessage" && reply->elements >= 4) ? 2 : 1;
                         
                         if (message_type == "message" || message_type == "pmessage") {
-                            RedisMessage redis_msg(channel, message);
-                            
-                            // Add to processing queue
-                            {
-                                std::lock_guard<std::mutex> lock(impl_->message_queue_mutex);
-                                impl_->message_queue.push(redis_msg);
-                            }
-                            impl_->message_queue_cv.notify_one();
+                            const redisReply* channel = reply->element[channel_index];
+                            const redisReply* payload = reply->element[channel_index + 1];
                             
                             impl_->statistics.total_messages_received++;
                             impl_->last_message_time = std::chrono::system_clock::now();
+                            
+                            enqueue_message(RedisMessage(std::string(channel->str, channel->len),
+                                                         std::string(payload->str, payload->len)));
                         }
                     }
                     freeReplyObject(reply);
@@ -183,11 +251,6 @@ bool RedisSubscriber::start() {
         }
     });
     
-    // Start message processing thread
-    impl_->message_processing_thread = std::thread([this]() {
-        message_processing_loop();
-    });
-    
     // Start health check thread
     if (impl_->config.enable_health_check) {
         impl_->health_check_thread = std::thread([this]() {
@@ -207,16 +270,24 @@ void RedisSubscriber::stop() {
     utils::Logger::info("Stopping RedisSubscriber...");
     
     impl_->running = false;
-    impl_->message_queue_cv.notify_all();
+    for (auto& partition : impl_->partitions) {
+        // Taking the lock orders the flag change before any waiter re-checks it
+        std::lock_guard<std::mutex> lock(partition->mutex);
+        partition->not_empty.notify_all();
+        partition->not_full.notify_all();
+    }
     
     // Join threads
     if (impl_->connection_thread.joinable()) {
         impl_->connection_thread.join();
     }
     
-    if (impl_->message_processing_thread.joinable()) {
-        impl_->message_processing_thread.join();
+    for (auto& worker : impl_->worker_threads) {
+        if (worker.joinable()) {
+            worker.join();
+        }
     }
+    impl_->worker_threads.clear();
     
     if (impl_->health_check_thread.joinable()) {
         impl_->health_check_thread.join();
@@ -287,6 +358,10 @@ void RedisSubscriber::set_price_update_callback(PriceUpdateCallback callback) {
     impl_->price_update_callback = callback;
 }
 
+void RedisSubscriber::set_order_book_callback(OrderBookCallback callback) {
+    impl_->order_book_callback = callback;
+}
+
 void RedisSubscriber::set_connection_callback(ConnectionCallback callback) {
     impl_->connection_callback = callback;
 }
@@ -420,34 +495,107 @@ void RedisSubscriber::handle_connection_lost() {
     disconnect_from_redis();
 }
 
-void RedisSubscriber::message_processing_loop() {
-    utils::Logger::debug("Redis message processing loop started");
+size_t RedisSubscriber::partition_for(const RedisMessage& message) const {
+    size_t count = impl_->partitions.size();
+    if (count == 1) {
+        return 0;
+    }
     
-    while (impl_->running) {
-        std::unique_lock<std::mutex> lock(impl_->message_queue_mutex);
-        
-        impl_->message_queue_cv.wait(lock, [this]() {
-            return !impl_->message_queue.empty() || !impl_->running;
-        });
-        
-        if (!impl_->running) break;
+    std::string_view key = message.channel;
+    // Binary frames share their channel's decoder, so they stay on one worker
+    if (impl_->config.partition_key == PartitionKey::SYMBOL && !types::is_binary_frame(message.message)) {
+        std::string_view symbol = find_symbol(message.message);
+        if (!symbol.empty()) {
+            key = symbol;
+        }
+    }
+    return std::hash<std::string_view>()(key) % count;
+}
+
+void RedisSubscriber::enqueue_message(RedisMessage message) {
+    auto& partition = *impl_->partitions[partition_for(message)];
+    size_t capacity = std::max<size_t>(impl_->config.message_buffer_size, 1);
+    size_t depth = 0;
+    
+    {
+        std::unique_lock<std::mutex> lock(partition.mutex);
+        if (partition.queue.size() >= capacity) {
+            // Dictionary frames are announced once per interval, so losing
+            // one leaves later tickers undecodable; those messages are kept
+            // and the oldest plain message goes instead
+            auto victim = partition.queue.end();
+            types::WireFrameCounts frames;
+            if (impl_->config.overflow_policy == QueueOverflowPolicy::DROP_OLDEST) {
+                for (auto it = partition.queue.begin(); it != partition.queue.end(); ++it) {
+                    frames = types::is_binary_frame(it->message) ? types::count_frames(it->message)
+                                                                 : types::WireFrameCounts{};
+                    if (frames.dictionaries == 0) {
+                        victim = it;
+                        break;
+                    }
+                }
+            }
+            if (victim != partition.queue.end()) {
+                if (frames.tickers > 0) {
+                    partition.dropped_sequences[victim->channel] += frames.tickers;
+                }
+                partition.queue.erase(victim);
+                impl_->statistics.total_messages_dropped++;
+            } else {
+                impl_->statistics.total_backpressure_waits++;
+                partition.not_full.wait(lock, [&]() {
+                    return partition.queue.size() < capacity || !impl_->running;
+                });
+                if (!impl_->running) {
+                    return;
+                }
+            }
+        }
         
-        while (!impl_->message_queue.empty()) {
-            RedisMessage message = impl_->message_queue.front();
-            impl_->message_queue.pop();
-            lock.unlock();
+        message.enqueued_at = std::chrono::steady_clock::now();
+        partition.queue.push_back(std::move(message));
+        depth = partition.queue.size();
+    }
+    partition.not_empty.notify_one();
+    
+    // Only the reader thread enqueues, so a plain compare suffices
+    if (depth > impl_->statistics.max_queue_depth.load(std::memory_order_relaxed)) {
+        impl_->statistics.max_queue_depth.store(depth, std::memory_order_relaxed);
+    }
+}
+
+void RedisSubscriber::message_processing_loop(size_t partition_index) {
+    utils::Logger::debug("Redis message processing loop {} started", partition_index);
+    
+    auto& partition = *impl_->partitions[partition_index];
+    std::deque<RedisMessage> batch;
+    
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(partition.mutex);
+            partition.not_empty.wait(lock, [&]() {
+                return !partition.queue.empty() || !impl_->running;
+            });
             
-            process_raw_message(message);
+            if (!impl_->running) break;
             
-            lock.lock();
+            // Take everything queued so far; the reader refills while we process
+            batch.swap(partition.queue);
+        }
+        partition.not_full.notify_one();
+        
+        for (const auto& message : batch) {
+            process_raw_message(message, partition_index);
         }
+        batch.clear();
     }
     
-    utils::Logger::debug("Redis message processing loop stopped");
+    utils::Logger::debug("Redis message processing loop {} stopped", partition_index);
 }
 
-void RedisSubscriber::process_raw_message(const RedisMessage& message) {
-    auto start_time = std::chrono::high_resolution_clock::now();
+void RedisSubscriber::process_raw_message(const RedisMessage& message, size_t partition) {
+    auto start_time = std::chrono::steady_clock::now();
+    record_average(impl_->statistics.average_queue_latency, start_time - message.enqueued_at);
     
     try {
         // Call general message callback
@@ -455,15 +603,17 @@ void RedisSubscriber::process_raw_message(const RedisMessage& message) {
             impl_->message_callback(message);
         }
         
-        // Process price update messages
-        if (is_price_update_message(message)) {
-            process_price_update_message(message);
+        // Process order book and price update messages
+        if (is_order_book_message(message)) {
+            process_order_book_message(message);
+        } else if (is_price_update_message(message)) {
+            process_price_update_message(message, partition);
         }
         
         impl_->statistics.total_messages_processed++;
         
         // Record processing time
-        auto end_time = std::chrono::high_resolution_clock::now();
+        auto end_time = std::chrono::steady_clock::now();
         auto processing_time = std::chrono::duration_cast<std::chrono::microseconds>(
             end_time - start_time);
         record_message_processed(processing_time);
@@ -473,13 +623,24 @@ void RedisSubscriber::process_raw_message(const RedisMessage& message) {
     }
 }
 
-void RedisSubscriber::process_price_update_message(const RedisMessage& message) {
+void RedisSubscriber::process_price_update_message(const RedisMessage& message, size_t partition) {
     try {
-        PriceUpdateEvent event = parse_price_message(message);
+        auto parse_start = std::chrono::steady_clock::now();
+        PriceUpdateEvent event;
+        if (types::is_binary_frame(message.message)) {
+            if (!decode_binary_price_message(message, partition, event)) {
+                return; // dictionary only, or a ticker not decodable yet
+            }
+        } else {
+            event = parse_price_message(message);
+        }
+        auto parsed_at = std::chrono::steady_clock::now();
+        record_average(impl_->statistics.average_parse_latency, parsed_at - parse_start);
         
         if (impl_->price_update_callback) {
             impl_->price_update_callback(event);
         }
+        record_average(impl_->statistics.average_dispatch_latency, std::chrono::steady_clock::now() - parsed_at);
         
         impl_->statistics.total_price_updates++;
         
@@ -488,6 +649,19 @@ void RedisSubscriber::process_price_update_message(const RedisMessage& message)
     }
 }
 
+void RedisSubscriber::process_order_book_message(const RedisMessage& message) {
+    try {
+        types::OrderBook book = redis_utils::parse_order_book_message(message.message);
+        if (impl_->order_book_callback) {
+            impl_->order_book_callback(book);
+        }
+        impl_->statistics.total_order_book_updates++;
+        
+    } catch (const std::exception& e) {
+        handle_parsing_error(message, "Order book parsing error: " + std::string(e.what()));
+    }
+}
+
 PriceUpdateEvent RedisSubscriber::parse_price_message(const RedisMessage& message) {
     PriceUpdateEvent event;
     event.source_channel = message.channel;
@@ -530,6 +704,71 @@ PriceUpdateEvent RedisSubscriber::parse_price_message(const RedisMessage& messag
     return event;
 }
 
+bool RedisSubscriber::decode_binary_price_message(const RedisMessage& message, size_t partition,
+                                                  PriceUpdateEvent& event) {
+    auto& partition_state = *impl_->partitions[partition];
+    auto decoder_it = partition_state.decoders.find(message.channel);
+    if (decoder_it == partition_state.decoders.end()) {
+        decoder_it = partition_state.decoders.emplace(message.channel, types::TickerWireDecoder()).first;
+        
+        std::unique_lock<std::shared_mutex> lock(impl_->channel_formats_mutex);
+        impl_->channel_formats[message.channel] = types::WireFormat::BINARY;
+        utils::Logger::info("Channel {} switched to binary ticker frames", message.channel);
+    }
+    
+    auto& decoder = decoder_it->second;
+    uint64_t gaps_before = decoder.sequence_gaps();
+    types::CompactTicker compact;
+    auto status = decoder.decode(message.message, compact);
+    
+    impl_->statistics.total_binary_messages++;
+    uint64_t gaps = decoder.sequence_gaps() - gaps_before;
+    if (gaps > 0) {
+        // Messages this subscriber dropped itself are already counted in
+        // total_messages_dropped; only the rest were lost upstream
+        std::lock_guard<std::mutex> lock(partition_state.mutex);
+        auto dropped_it = partition_state.dropped_sequences.find(message.channel);
+        if (dropped_it != partition_state.dropped_sequences.end()) {
+            uint64_t local = std::min(gaps, dropped_it->second);
+            gaps -= local;
+            dropped_it->second -= local;
+        }
+    }
+    impl_->statistics.total_sequence_gaps += gaps;
+    
+    switch (status) {
+        case types::TickerWireDecoder::Status::TICKER:
+            break;
+        case types::TickerWireDecoder::Status::DICTIONARY:
+            return false;
+        case types::TickerWireDecoder::Status::UNKNOWN_CODE:
+            impl_->statistics.total_undecodable_messages++;
+            return false;
+        case types::TickerWireDecoder::Status::MALFORMED:
+            throw std::runtime_error("Malformed binary ticker frame");
+    }
+    
+    event.source_channel = message.channel;
+    event.received_at = message.timestamp;
+    event.event_type = "price_update";
+    event.ticker.symbol = types::symbol_name(compact.symbol);
+    event.ticker.exchange = types::exchange_name(compact.exchange);
+    event.ticker.bid = compact.bid;
+    event.ticker.ask = compact.ask;
+    event.ticker.price = compact.last;
+    event.ticker.last = compact.last;
+    event.ticker.volume = compact.volume;
+    event.ticker.volume_24h = compact.volume;
+    event.ticker.timestamp = compact.timestamp;
+    return true;
+}
+
+types::WireFormat RedisSubscriber::get_channel_wire_format(const std::string& channel) const {
+    std::shared_lock<std::shared_mutex> lock(impl_->channel_formats_mutex);
+    auto it = impl_->channel_formats.find(channel);
+    return it != impl_->channel_formats.end() ? it->second : types::WireFormat::JSON;
+}
+
 bool RedisSubscriber::is_price_update_message(const RedisMessage& message) {
     // Check if the channel name indicates a price update
     return message.channel.find("price") != std::string::npos ||
@@ -537,6 +776,10 @@ bool RedisSubscriber::is_price_update_message(const RedisMessage& message) {
            message.channel.find("market") != std::string::npos;
 }
 
+bool RedisSubscriber::is_order_book_message(const RedisMessage& message) {
+    return message.channel.find("order_book") != std::string::npos;
+}
+
 void RedisSubscriber::handle_parsing_error(const RedisMessage& message, const std::string& error) {
     utils::Logger::error("Message parsing error in channel {}: {}", message.channel, error);
     
@@ -548,12 +791,7 @@ void RedisSubscriber::handle_parsing_error(const RedisMessage& message, const st
 }
 
 void RedisSubscriber::record_message_processed(std::chrono::microseconds processing_time) {
-    std::lock_guard<std::mutex> lock(impl_->stats_mutex);
-    
-    auto current_latency = impl_->statistics.average_processing_latency.load();
-    auto new_latency = std::chrono::duration_cast<std::chrono::milliseconds>(
-        (current_latency + processing_time) / 2);
-    impl_->statistics.average_processing_latency = new_latency;
+    record_average(impl_->statistics.average_processing_latency, processing_time);
 }
 
 void RedisSubscriber::health_check_loop() {
@@ -592,238 +830,6 @@ void RedisSubscriber::check_message_flow_health() {
     }
 }
 
-// TradeLogger implementation
-struct TradeLogger::Implementation {
-    std::string influxdb_url;
-    std::string database;
-    std::string log_directory;
-    
-    std::atomic<bool> influxdb_enabled{false};
-    std::atomic<bool> file_logging_enabled{false};
-    std::atomic<bool> healthy{false};
-    
-    std::queue<std::string> pending_logs;
-    std::mutex pending_logs_mutex;
-    std::thread flush_thread;
-    std::atomic<bool> running{false};
-    
-    std::chrono::seconds flush_interval{30};
-    size_t batch_size{100};
-    std::atomic<size_t> total_logs_written{0};
-    
-    std::ofstream current_log_file;
-    std::mutex file_mutex;
-};
-
-TradeLogger::TradeLogger() : impl_(std::make_unique<Implementation>()) {}
-
-TradeLogger::~TradeLogger() {
-    if (impl_->running) {
-        flush_pending_logs();
-    }
-    
-    if (impl_->current_log_file.is_open()) {
-        impl_->current_log_file.close();
-    }
-}
-
-bool TradeLogger::initialize(const std::string& influxdb_url, const std::string& database) {
-    impl_->influxdb_url = influxdb_url;
-    impl_->database = database;
-    impl_->influxdb_enabled = true;
-    impl_->running = true;
-    impl_->healthy = true;
-    
-    // Start flush thread
-    impl_->flush_thread = std::thread([this]() {
-        while (impl_->running) {
-            std::this_thread::sleep_for(impl_->flush_interval);
-            if (impl_->running) {
-                process_pending_logs();
-            }
-        }
-    });
-    
-    utils::Logger::info("TradeLogger initialized with InfluxDB at {}", influxdb_url);
-    return true;
-}
-
-bool TradeLogger::initialize_file_logging(const std::string& log_directory) {
-    impl_->log_directory = log_directory;
-    impl_->file_logging_enabled = true;
-    
-    // Create directory if it doesn't exist
-    std::filesystem::create_directories(log_directory);
-    
-    utils::Logger::info("TradeLogger file logging enabled at {}", log_directory);
-    return true;
-}
-
-bool TradeLogger::log_trade_execution(const TradeExecution& execution) {
-    std::string log_entry;
-    
-    if (impl_->influxdb_enabled) {
-        log_entry = trade_execution_to_line_protocol(execution);
-        
-        std::lock_guard<std::mutex> lock(impl_->pending_logs_mutex);
-        impl_->pending_logs.push(log_entry);
-    }
-    
-    if (impl_->file_logging_enabled) {
-        std::string csv_entry = trade_execution_to_csv(execution);
-        write_to_file(csv_entry);
-    }
-    
-    return true;
-}
-
-bool TradeLogger::log_arbitrage_opportunity(const ArbitrageOpportunity& opportunity) {
-    if (impl_->influxdb_enabled) {
-        std::string log_entry = arbitrage_opportunity_to_line_protocol(opportunity);
-        
-        std::lock_guard<std::mutex> lock(impl_->pending_logs_mutex);
-        impl_->pending_logs.push(log_entry);
-    }
-    
-    return true;
-}
-
-bool TradeLogger::flush_pending_logs() {
-    process_pending_logs();
-    flush_file_buffers();
-    return true;
-}
-
-size_t TradeLogger::get_pending_log_count() const {
-    std::lock_guard<std::mutex> lock(impl_->pending_logs_mutex);
-    return impl_->pending_logs.size();
-}
-
-bool TradeLogger::is_healthy() const {
-    return impl_->healthy;
-}
-
-std::string TradeLogger::trade_execution_to_line_protocol(const TradeExecution& execution) {
-    std::ostringstream oss;
-    oss << "trade_execution,symbol=" << execution.symbol 
-        << ",buy_exchange=" << execution.buy_exchange
-        << ",sell_exchange=" << execution.sell_exchange
-        << ",result=" << static_cast<int>(execution.result)
-        << " quantity=" << execution.quantity
-        << ",executed_quantity=" << execution.executed_quantity
-        << ",buy_price=" << execution.buy_price
-        << ",sell_price=" << execution.sell_price
-        << ",expected_profit=" << execution.expected_profit
-        << ",actual_profit=" << execution.actual_profit
-        << ",total_fees=" << execution.total_fees
-        << ",execution_latency=" << execution.execution_latency.count()
-        << " " << std::chrono::duration_cast<std::chrono::nanoseconds>(
-               execution.timestamp.time_since_epoch()).count();
-    
-    return oss.str();
-}
-
-std::string TradeLogger::trade_execution_to_csv(const TradeExecution& execution) {
-    std::ostringstream oss;
-    oss << execution.trade_id << ","
-        << execution.symbol << ","
-        << execution.buy_exchange << ","
-        << execution.sell_exchange << ","
-        << execution.quantity << ","
-        << execution.executed_quantity << ","
-        << execution.buy_price << ","
-        << execution.sell_price << ","
-        << execution.expected_profit << ","
-        << execution.actual_profit << ","
-        << execution.total_fees << ","
-        << execution.execution_latency.count() << ","
-        << static_cast<int>(execution.result) << ","
-        << format_timestamp(execution.timestamp) << std::endl;
-    
-    return oss.str();
-}
-
-std::string TradeLogger::arbitrage_opportunity_to_line_protocol(const ArbitrageOpportunity& opportunity) {
-    std::ostringstream oss;
-    oss << "arbitrage_opportunity,symbol=" << opportunity.symbol 
-        << ",buy_exchange=" << opportunity.buy_exchange
-        << ",sell_exchange=" << opportunity.sell_exchange
-        << " buy_price=" << opportunity.buy_price
-        << ",sell_price=" << opportunity.sell_price
-        << ",available_quantity=" << opportunity.available_quantity
-        << ",spread_percentage=" << opportunity.spread_percentage
-        << ",expected_profit=" << opportunity.expected_profit
-        << ",confidence_score=" << opportunity.confidence_score
-        << " " << std::chrono::duration_cast<std::chrono::nanoseconds>(
-               opportunity.detected_at.time_since_epoch()).count();
-    
-    return oss.str();
-}
-
-bool TradeLogger::write_to_file(const std::string& log_entry) {
-    std::lock_guard<std::mutex> lock(impl_->file_mutex);
-    
-    if (!impl_->current_log_file.is_open()) {
-        std::string filename = create_log_filename("trades");
-        impl_->current_log_file.open(filename, std::ios::app);
-        
-        if (!impl_->current_log_file.is_open()) {
-            utils::Logger::error("Failed to open log file: {}", filename);
-            return false;
-        }
-    }
-    
-    impl_->current_log_file << log_entry;
-    impl_->total_logs_written++;
-    
-    return true;
-}
-
-std::string TradeLogger::create_log_filename(const std::string& prefix) {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    
-    std::ostringstream oss;
-    oss << impl_->log_directory << "/" << prefix << "_" 
-        << std::put_time(std::localtime(&time_t), "%Y%m%d_%H%M%S") << ".csv";
-    
-    return oss.str();
-}
-
-void TradeLogger::process_pending_logs() {
-    std::vector<std::string> batch;
-    
-    {
-        std::lock_guard<std::mutex> lock(impl_->pending_logs_mutex);
-        
-        while (!impl_->pending_logs.empty() && batch.size() < impl_->batch_size) {
-            batch.push_back(impl_->pending_logs.front());
-            impl_->pending_logs.pop();
-        }
-    }
-    
-    // Process batch (in real implementation, would send to InfluxDB)
-    for (const auto& log_entry : batch) {
-        // Simulate InfluxDB write
-        utils::Logger::debug("Writing to InfluxDB: {}", log_entry);
-        impl_->total_logs_written++;
-    }
-}
-
-void TradeLogger::flush_file_buffers() {
-    std::lock_guard<std::mutex> lock(impl_->file_mutex);
-    if (impl_->current_log_file.is_open()) {
-        impl_->current_log_file.flush();
-    }
-}
-
-std::string TradeLogger::format_timestamp(std::chrono::system_clock::time_point timestamp) {
-    auto time_t = std::chrono::system_clock::to_time_t(timestamp);
-    std::ostringstream oss;
-    oss << std::put_time(std::gmtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    return oss.str();
-}
-
 // Utility functions implementation
 namespace redis_utils {
 
@@ -835,6 +841,10 @@ std::string build_ticker_channel(const std::string& exchange) {
     return "ticker:" + exchange;
 }
 
+std::string build_order_book_channel() {
+    return "order_book_updates";
+}
+
 std::string build_arbitrage_channel() {
     return "arbitrage:opportunities";
 }
@@ -860,6 +870,49 @@ std::string format_ticker_message(const types::Ticker& ticker) {
     return j.dump();
 }
 
+std::string format_order_book_message(const types::OrderBook& book) {
+    nlohmann::json j;
+    j["symbol"] = book.symbol;
+    j["exchange"] = book.exchange;
+    j["bids"] = nlohmann::json::array();
+    for (const auto& level : book.bids) {
+        j["bids"].push_back({level.price, level.quantity});
+    }
+    j["asks"] = nlohmann::json::array();
+    for (const auto& level : book.asks) {
+        j["asks"].push_back({level.price, level.quantity});
+    }
+    j["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        book.timestamp.time_since_epoch()).count();
+    
+    return j.dump();
+}
+
+types::OrderBook parse_order_book_message(const std::string& message) {
+    nlohmann::json j = nlohmann::json::parse(message);
+    types::OrderBook book(j.value("symbol", ""), j.value("exchange", ""));
+    
+    auto read_levels = [&j](const char* side, std::vector<types::OrderBookEntry>& levels) {
+        if (!j.contains(side)) {
+            return;
+        }
+        const auto& array = j[side];
+        levels.reserve(array.size());
+        for (const auto& level : array) {
+            levels.emplace_back(level.at(0).get<double>(), level.at(1).get<double>());
+        }
+    };
+    read_levels("bids", book.bids);
+    read_levels("asks", book.asks);
+    
+    if (j.contains("timestamp")) {
+        int64_t timestamp_ms = j["timestamp"];
+        book.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(timestamp_ms));
+    }
+    
+    return book;
+}
+
 types::Ticker parse_ticker_message(const std::string& message) {
     types::Ticker ticker;
     
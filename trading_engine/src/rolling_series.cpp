@@ -0,0 +1,143 @@
+#include "rolling_series.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ats {
+namespace trading_engine {
+
+void RollingStats::add(double value) {
+    ++count;
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+}
+
+void RollingStats::merge(const RollingStats& other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    size_t total = count + other.count;
+    double delta = other.mean - mean;
+    mean += delta * other.count / total;
+    m2 += other.m2 + delta * delta * count * other.count / total;
+    count = total;
+}
+
+void RollingStats::remove(const RollingStats& other) {
+    if (other.count == 0) return;
+    if (other.count >= count) {
+        *this = RollingStats();
+        return;
+    }
+    // Inverse of merge: solve for the partition that remains
+    size_t remaining = count - other.count;
+    double remaining_mean = (mean * count - other.mean * other.count) / remaining;
+    double delta = other.mean - remaining_mean;
+    m2 = std::max(0.0, m2 - other.m2 - delta * delta * remaining * other.count / count);
+    mean = remaining_mean;
+    count = remaining;
+}
+
+double RollingStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+RollingSeries::RollingSeries(std::chrono::seconds bucket_width, size_t bucket_count, double ewma_alpha)
+    : bucket_width_(std::max(bucket_width, std::chrono::seconds(1)))
+    , buckets_(std::max<size_t>(bucket_count, 1))
+    , ewma_alpha_(ewma_alpha) {}
+
+int64_t RollingSeries::epoch_of(Clock::time_point time) const {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count() /
+           bucket_width_.count();
+}
+
+void RollingSeries::advance(int64_t epoch) {
+    if (epoch <= newest_epoch_) return;
+
+    const int64_t capacity = static_cast<int64_t>(buckets_.size());
+    if (newest_epoch_ < 0 || epoch - newest_epoch_ >= capacity) {
+        for (auto& bucket : buckets_) {
+            bucket = Bucket();
+        }
+        totals_ = RollingStats();
+    } else {
+        for (int64_t e = newest_epoch_ + 1; e <= epoch; ++e) {
+            Bucket& bucket = buckets_[e % capacity];
+            totals_.remove(bucket.stats);
+            bucket = Bucket();
+        }
+    }
+    newest_epoch_ = epoch;
+}
+
+void RollingSeries::add(double value, Clock::time_point now) {
+    const int64_t epoch = epoch_of(now);
+    advance(epoch);
+
+    // Late samples from an already expired bucket only feed the EWMA
+    Bucket& bucket = buckets_[epoch % static_cast<int64_t>(buckets_.size())];
+    if (epoch > newest_epoch_ - static_cast<int64_t>(buckets_.size())) {
+        if (bucket.epoch != epoch) {
+            totals_.remove(bucket.stats);
+            bucket = Bucket();
+            bucket.epoch = epoch;
+        }
+        bucket.stats.add(value);
+        totals_.add(value);
+    }
+
+    if (samples_ == 0) {
+        ewma_mean_ = value;
+        ewma_variance_ = 0.0;
+    } else {
+        double diff = value - ewma_mean_;
+        double increment = ewma_alpha_ * diff;
+        ewma_mean_ += increment;
+        ewma_variance_ = (1.0 - ewma_alpha_) * (ewma_variance_ + diff * increment);
+    }
+    ++samples_;
+    last_update_ = std::max(last_update_, now);
+}
+
+RollingStats RollingSeries::window(Clock::time_point now) const {
+    const int64_t epoch = epoch_of(now);
+    const int64_t capacity = static_cast<int64_t>(buckets_.size());
+    if (newest_epoch_ < 0 || epoch - newest_epoch_ >= capacity) {
+        return RollingStats();
+    }
+
+    // Subtract buckets that have aged out since the last add
+    RollingStats stats = totals_;
+    for (int64_t e = newest_epoch_ + 1; e <= epoch; ++e) {
+        stats.remove(buckets_[e % capacity].stats);
+    }
+    return stats;
+}
+
+RollingStats RollingSeries::window(Clock::time_point now, std::chrono::seconds lookback) const {
+    const int64_t covered = (lookback.count() + bucket_width_.count() - 1) / bucket_width_.count();
+    const int64_t capacity = static_cast<int64_t>(buckets_.size());
+    if (covered >= capacity) {
+        return window(now);
+    }
+
+    const int64_t epoch = epoch_of(now);
+    RollingStats stats;
+    for (int64_t e = std::max(epoch - covered + 1, newest_epoch_ - capacity + 1); e <= std::min(epoch, newest_epoch_); ++e) {
+        const Bucket& bucket = buckets_[e % capacity];
+        if (bucket.epoch == e) {
+            stats.merge(bucket.stats);
+        }
+    }
+    return stats;
+}
+
+double RollingSeries::ewma_stddev() const {
+    return std::sqrt(ewma_variance_);
+}
+
+} // namespace trading_engine
+} // namespace ats
@@ -1,27 +1,117 @@
 #include "spread_calculator.hpp"
+#include "top_of_book_matrix.hpp"
+#include "depth_ladder.hpp"
+#include "rolling_series.hpp"
 #include "utils/logger.hpp"
-#include "utils/json_parser.hpp"
 #include <nlohmann/json.hpp>
 #include <algorithm>
+#include <array>
 #include <numeric>
 #include <cmath>
 #include <map>
+#include <deque>
 
 namespace ats {
 namespace trading_engine {
 
+namespace {
+
+// Slack, in percentage points, for the matrix prefilter's rounding
+constexpr double SPREAD_PREFILTER_MARGIN = 1e-9;
+
+// Per-symbol ordered view of every exchange's best bid and best ask, so the
+// best counterparty for an updated venue is found without scanning all pairs
+struct TopOfBookIndex {
+    using BidIndex = std::multimap<double, std::string, std::greater<double>>; // bid -> exchange, best first
+    using AskIndex = std::multimap<double, std::string>;                       // ask -> exchange, best first
+    
+    BidIndex bids;
+    AskIndex asks;
+    std::unordered_map<std::string, std::pair<BidIndex::iterator, AskIndex::iterator>> entries; // exchange -> positions
+    
+    void update(const std::string& exchange, double bid, double ask) {
+        auto it = entries.find(exchange);
+        if (it != entries.end()) {
+            bids.erase(it->second.first);
+            asks.erase(it->second.second);
+        }
+        entries[exchange] = {bids.emplace(bid, exchange), asks.emplace(ask, exchange)};
+    }
+};
+
+// Prefix-summed book sides kept alongside each MarketDepth for sizing
+struct DepthLadders {
+    DepthLadder bids;
+    DepthLadder asks;
+};
+
+// Log returns of a symbol's last price, pooled across venues
+struct ReturnHistory {
+    std::unordered_map<std::string, double> last_price; // exchange -> last price
+    RollingSeries returns;
+};
+
+// Depth caches are keyed by interned codes rather than name pairs
+uint32_t depth_key(types::ExchangeCode exchange, types::SymbolCode symbol) {
+    return (static_cast<uint32_t>(exchange) << 16) | symbol;
+}
+
+// False if either name was never interned, so nothing can be cached for it
+bool find_depth_key(const std::string& exchange, const std::string& symbol, uint32_t& key) {
+    types::ExchangeCode exchange_code = types::ExchangeRegistry::instance().find(exchange);
+    types::SymbolCode symbol_code = types::SymbolRegistry::instance().find(symbol);
+    if (exchange_code == types::INVALID_CODE || symbol_code == types::INVALID_CODE) {
+        return false;
+    }
+    key = depth_key(exchange_code, symbol_code);
+    return true;
+}
+
+// Spread series are keyed by the route's interned codes
+uint64_t route_key(types::SymbolCode symbol, types::ExchangeCode buy_exchange, types::ExchangeCode sell_exchange) {
+    return (static_cast<uint64_t>(symbol) << 32) | (static_cast<uint64_t>(buy_exchange) << 16) | sell_exchange;
+}
+
+// False if any name was never interned, so no series can exist for the route
+bool find_route_key(const std::string& symbol, const std::string& buy_exchange,
+                    const std::string& sell_exchange, uint64_t& key) {
+    const auto& exchanges = types::ExchangeRegistry::instance();
+    types::SymbolCode symbol_code = types::SymbolRegistry::instance().find(symbol);
+    types::ExchangeCode buy_code = exchanges.find(buy_exchange);
+    types::ExchangeCode sell_code = exchanges.find(sell_exchange);
+    if (symbol_code == types::INVALID_CODE || buy_code == types::INVALID_CODE || sell_code == types::INVALID_CODE) {
+        return false;
+    }
+    key = route_key(symbol_code, buy_code, sell_code);
+    return true;
+}
+
+// Raw spread of one route at one quote update. The history keeps these
+// rather than full analyses and expands them only when queried.
+struct SpreadSample {
+    std::chrono::system_clock::time_point recorded_at;
+    types::ExchangeCode buy_exchange = types::INVALID_CODE;
+    types::ExchangeCode sell_exchange = types::INVALID_CODE;
+    double raw_spread = 0.0;
+    double spread_percentage = 0.0;
+};
+
+} // namespace
+
 struct SpreadCalculator::Implementation {
-    config::ConfigManager config;
-    
     // Market data storage
     std::unordered_map<std::string, std::unordered_map<std::string, types::Ticker>> ticker_cache; // exchange -> symbol -> ticker
-    std::unordered_map<std::string, std::unordered_map<std::string, MarketDepth>> depth_cache; // exchange -> symbol -> depth
+    std::unordered_map<uint32_t, CompactMarketDepth> depth_cache; // depth_key -> depth
+    std::unordered_map<uint32_t, DepthLadders> depth_ladders; // depth_key -> ladders
     std::unordered_map<std::string, ExchangeFeeStructure> fee_structures; // exchange -> fees
     std::unordered_map<std::string, std::unordered_map<std::string, SlippageModel>> slippage_models; // exchange -> symbol -> model
+    std::unordered_map<std::string, TopOfBookIndex> top_of_book; // symbol -> best bid/ask index
+    TopOfBookMatrix book_matrix; // symbol code -> quotes by exchange slot
     
-    // Historical data for analysis
-    std::unordered_map<std::string, std::vector<SpreadAnalysis>> spread_history; // symbol -> history
-    std::unordered_map<std::string, std::unordered_map<std::string, std::vector<double>>> price_history; // exchange -> symbol -> prices
+    // Historical data for analysis, bounded by the configured window
+    std::unordered_map<types::SymbolCode, std::deque<SpreadSample>> spread_history; // symbol code -> recent samples
+    std::unordered_map<uint64_t, RollingSeries> spread_series; // route_key -> spread percentage
+    std::unordered_map<std::string, ReturnHistory> return_history; // symbol -> returns
     
     // Statistics
     std::atomic<size_t> opportunities_detected{0};
@@ -31,6 +121,15 @@ struct SpreadCalculator::Implementation {
     // Configuration
     double spread_threshold = 0.005; // 0.5%
     double slippage_tolerance = 0.001; // 0.1%
+    double max_order_quantity = 10.0; // cap on depth-sized opportunities
+    std::chrono::seconds history_bucket_width{60};
+    size_t history_buckets = 60; // one hour window at the default width
+    double history_ewma_alpha = 0.05;
+    size_t max_spread_history = 1000; // samples kept per symbol
+    
+    RollingSeries make_series() const {
+        return RollingSeries(history_bucket_width, history_buckets, history_ewma_alpha);
+    }
     bool dynamic_fee_calculation = true;
     bool advanced_slippage_modeling = true;
     
@@ -45,13 +144,27 @@ SpreadCalculator::SpreadCalculator() : impl_(std::make_unique<Implementation>())
 SpreadCalculator::~SpreadCalculator() = default;
 
 bool SpreadCalculator::initialize(const config::ConfigManager& config) {
-    impl_->config = config;
-    
     // Load configuration
     impl_->spread_threshold = config.get_value<double>("spread_calculator.min_spread_threshold", 0.005);
     impl_->slippage_tolerance = config.get_value<double>("spread_calculator.slippage_tolerance", 0.001);
     impl_->dynamic_fee_calculation = config.get_value<bool>("spread_calculator.dynamic_fee_calculation", true);
     impl_->advanced_slippage_modeling = config.get_value<bool>("spread_calculator.advanced_slippage_modeling", true);
+    impl_->max_order_quantity = config.get_value<double>("spread_calculator.max_order_quantity", 10.0);
+    impl_->history_ewma_alpha = config.get_value<double>("spread_calculator.history_ewma_alpha", 0.05);
+    
+    // History sizes are read wide and checked before they become size_t, so
+    // a negative setting is rejected instead of wrapping to a huge window
+    const int64_t bucket_seconds = config.get_value<int64_t>("spread_calculator.history_bucket_seconds", 60);
+    const int64_t history_buckets = config.get_value<int64_t>("spread_calculator.history_buckets", 60);
+    const int64_t max_spread_history = config.get_value<int64_t>("spread_calculator.max_spread_history", 1000);
+    if (bucket_seconds <= 0 || history_buckets <= 0 || max_spread_history <= 0) {
+        utils::Logger::error("Spread history settings must be positive: bucket seconds {}, buckets {}, max history {}",
+                             bucket_seconds, history_buckets, max_spread_history);
+        return false;
+    }
+    impl_->history_bucket_width = std::chrono::seconds(bucket_seconds);
+    impl_->history_buckets = static_cast<size_t>(history_buckets);
+    impl_->max_spread_history = static_cast<size_t>(max_spread_history);
     
     // Initialize default fee structures for common exchanges
     ExchangeFeeStructure binance_fees;
@@ -69,7 +182,8 @@ bool SpreadCalculator::initialize(const config::ConfigManager& config) {
     impl_->fee_structures["binance"] = binance_fees;
     impl_->fee_structures["upbit"] = upbit_fees;
     
-    utils::Logger::info("SpreadCalculator initialized successfully");
+    utils::Logger::info("SpreadCalculator initialized successfully (spread kernel: {})",
+                        TopOfBookMatrix::kernel_name());
     return true;
 }
 
@@ -102,29 +216,68 @@ void SpreadCalculator::update_market_depth(const MarketDepth& depth) {
     std::unique_lock<std::shared_mutex> lock(impl_->mutex);
     
     if (is_valid_market_depth(depth)) {
-        impl_->depth_cache[depth.exchange][depth.symbol] = depth;
+        CompactMarketDepth compact = to_compact(depth);
+        if (compact.exchange == types::INVALID_CODE || compact.symbol == types::INVALID_CODE) {
+            utils::Logger::warn("Registry full, dropping market depth for {}:{}", depth.exchange, depth.symbol);
+            return;
+        }
+        uint32_t key = depth_key(compact.exchange, compact.symbol);
+        
+        auto& ladders = impl_->depth_ladders[key];
+        ladders.bids = DepthLadder(compact.bids, DepthLadder::Side::BID);
+        ladders.asks = DepthLadder(compact.asks, DepthLadder::Side::ASK);
+        impl_->depth_cache[key] = std::move(compact);
         utils::Logger::debug("Updated market depth for {}:{}", depth.exchange, depth.symbol);
     }
 }
 
+bool SpreadCalculator::get_market_depth(const std::string& exchange, const std::string& symbol,
+                                        MarketDepth& depth) const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    
+    uint32_t key = 0;
+    if (!find_depth_key(exchange, symbol, key)) return false;
+    auto it = impl_->depth_cache.find(key);
+    if (it == impl_->depth_cache.end()) return false;
+    
+    const CompactMarketDepth& cached = it->second;
+    depth.symbol = symbol;
+    depth.exchange = exchange;
+    depth.bids.assign(cached.bids.begin(), cached.bids.end());
+    depth.asks.assign(cached.asks.begin(), cached.asks.end());
+    depth.timestamp = cached.timestamp;
+    return true;
+}
+
 void SpreadCalculator::update_ticker(const types::Ticker& ticker) {
-    std::unique_lock<std::shared_mutex> lock(impl_->mutex);
+    if (!is_valid_ticker(ticker)) {
+        return;
+    }
     
-    if (is_valid_ticker(ticker)) {
+    {
+        std::unique_lock<std::shared_mutex> lock(impl_->mutex);
         impl_->ticker_cache[ticker.exchange][ticker.symbol] = ticker;
+        update_top_of_book_index(ticker);
         
-        // Update price history
-        impl_->price_history[ticker.exchange][ticker.symbol].push_back(ticker.last);
-        
-        // Keep only recent price history (last 1000 prices)
-        auto& history = impl_->price_history[ticker.exchange][ticker.symbol];
-        if (history.size() > 1000) {
-            history.erase(history.begin(), history.begin() + 100);
+        // Update return history
+        if (ticker.last > 0) {
+            std::unique_lock<std::shared_mutex> history_lock(impl_->history_mutex);
+            auto& history = impl_->return_history.try_emplace(ticker.symbol, ReturnHistory{{}, impl_->make_series()})
+                                .first->second;
+            double& last_price = history.last_price[ticker.exchange];
+            if (last_price > 0) {
+                history.returns.add(std::log(ticker.last / last_price), std::chrono::system_clock::now());
+            }
+            last_price = ticker.last;
         }
-        
-        utils::Logger::debug("Updated ticker for {}:{} - last: {}", 
-                           ticker.exchange, ticker.symbol, ticker.last);
     }
+    
+    // Sampled once per update, after the write lock is released, so the
+    // spread histories see every quote change and queries stay read-only
+    record_spreads_for_update(ticker);
+    
+    utils::Logger::debug("Updated ticker for {}:{} - last: {}", 
+                       ticker.exchange, ticker.symbol, ticker.last);
 }
 
 SpreadAnalysis SpreadCalculator::analyze_spread(const std::string& symbol,
@@ -198,31 +351,34 @@ std::vector<SpreadAnalysis> SpreadCalculator::find_best_opportunities(const std:
     
     std::vector<SpreadAnalysis> opportunities;
     
-    // Find all exchanges that have this symbol
-    std::vector<std::string> exchanges;
-    for (const auto& [exchange, symbols] : impl_->ticker_cache) {
-        if (symbols.find(symbol) != symbols.end()) {
-            exchanges.push_back(exchange);
-        }
+    const types::SymbolCode symbol_code = types::SymbolRegistry::instance().find(symbol);
+    TopOfBookMatrix::SpreadMatrix spreads;
+    if (symbol_code == types::INVALID_CODE || !impl_->book_matrix.spreads(symbol_code, spreads)) {
+        return opportunities;
     }
     
-    // Compare all exchange pairs
-    for (size_t i = 0; i < exchanges.size(); ++i) {
-        for (size_t j = i + 1; j < exchanges.size(); ++j) {
-            const std::string& exchange1 = exchanges[i];
-            const std::string& exchange2 = exchanges[j];
-            
-            // Analyze both directions
-            double quantity = 1.0; // Default quantity for analysis
-            
-            auto analysis1 = analyze_spread(symbol, exchange1, exchange2, quantity);
-            if (analysis1.spread_percentage >= min_spread_threshold) {
-                opportunities.push_back(analysis1);
-            }
+    // The kernel prices every directed pair's raw spread in one pass. Pairs
+    // clearly under the threshold are skipped; the rest get the full analysis
+    // and the same spread_percentage test as the incremental path, so both
+    // return the same set. The margin only absorbs rounding between the two
+    // formulas.
+    const auto* quotes = impl_->book_matrix.row(symbol_code);
+    const size_t width = impl_->book_matrix.width();
+    const double quantity = 1.0; // Default quantity for analysis
+    
+    for (size_t buy = 0; buy < width; ++buy) {
+        if (!quotes->has(buy)) continue;
+        
+        for (size_t sell = 0; sell < width; ++sell) {
+            if (sell == buy || !quotes->has(sell)) continue;
+            if (spreads[buy * TopOfBookMatrix::MAX_SLOTS + sell] * 100.0 < min_spread_threshold - SPREAD_PREFILTER_MARGIN) continue;
             
-            auto analysis2 = analyze_spread(symbol, exchange2, exchange1, quantity);
-            if (analysis2.spread_percentage >= min_spread_threshold) {
-                opportunities.push_back(analysis2);
+            auto analysis = analyze_spread(symbol,
+                                           types::exchange_name(static_cast<types::ExchangeCode>(buy)),
+                                           types::exchange_name(static_cast<types::ExchangeCode>(sell)),
+                                           quantity);
+            if (analysis.spread_percentage >= min_spread_threshold) {
+                opportunities.push_back(analysis);
             }
         }
     }
@@ -243,62 +399,20 @@ std::vector<ArbitrageOpportunity> SpreadCalculator::detect_arbitrage_opportuniti
     
     std::vector<ArbitrageOpportunity> opportunities;
     
-    // Get all unique symbols across all exchanges
-    std::set<std::string> all_symbols;
-    for (const auto& [exchange, symbols] : impl_->ticker_cache) {
-        for (const auto& [symbol, ticker] : symbols) {
-            all_symbols.insert(symbol);
-        }
-    }
+    // Get all symbols quoted on at least one exchange
+    std::vector<types::SymbolCode> all_symbols;
+    impl_->book_matrix.for_each_symbol([&all_symbols](types::SymbolCode code, const TopOfBookMatrix::Row&) {
+        all_symbols.push_back(code);
+    });
     
     // Analyze each symbol
-    for (const std::string& symbol : all_symbols) {
-        auto spread_opportunities = find_best_opportunities(symbol, impl_->spread_threshold);
+    for (types::SymbolCode code : all_symbols) {
+        auto spread_opportunities = find_best_opportunities(types::symbol_name(code), impl_->spread_threshold);
         
         for (const auto& spread_analysis : spread_opportunities) {
-            if (spread_analysis.profit_margin >= min_profit_threshold) {
-                ArbitrageOpportunity opportunity;
-                opportunity.symbol = spread_analysis.symbol;
-                opportunity.buy_exchange = spread_analysis.buy_exchange;
-                opportunity.sell_exchange = spread_analysis.sell_exchange;
-                
-                // Get current prices
-                const auto& buy_ticker = impl_->ticker_cache.at(spread_analysis.buy_exchange).at(symbol);
-                const auto& sell_ticker = impl_->ticker_cache.at(spread_analysis.sell_exchange).at(symbol);
-                
-                opportunity.buy_price = buy_ticker.ask;
-                opportunity.sell_price = sell_ticker.bid;
-                opportunity.spread_percentage = spread_analysis.spread_percentage;
-                opportunity.expected_profit = spread_analysis.profit_margin;
-                opportunity.confidence_score = spread_analysis.confidence_score;
-                opportunity.detected_at = std::chrono::system_clock::now();
-                
-                // Estimate available quantity based on order book depth
-                opportunity.available_quantity = std::min(buy_ticker.volume, sell_ticker.volume) * 0.01; // 1% of volume
-                opportunity.available_quantity = std::min(opportunity.available_quantity, 10.0); // Max 10 units
-                
-                // Calculate fees and slippage
-                opportunity.total_fees = calculate_total_fees(opportunity.buy_exchange, 
-                                                            opportunity.sell_exchange,
-                                                            opportunity.symbol,
-                                                            opportunity.available_quantity,
-                                                            opportunity.buy_price,
-                                                            opportunity.sell_price);
-                
-                opportunity.estimated_slippage = estimate_slippage(opportunity.buy_exchange, symbol, 
-                                                                 opportunity.available_quantity, types::OrderSide::BUY) +
-                                               estimate_slippage(opportunity.sell_exchange, symbol,
-                                                                 opportunity.available_quantity, types::OrderSide::SELL);
-                
-                // Risk assessment
-                opportunity.max_position_size = opportunity.available_quantity;
-                opportunity.risk_approved = true; // Simplified - would normally check with risk manager
-                
-                enrich_opportunity(opportunity);
-                
-                if (validate_opportunity(opportunity)) {
-                    opportunities.push_back(opportunity);
-                }
+            ArbitrageOpportunity opportunity;
+            if (build_opportunity(spread_analysis, min_profit_threshold, opportunity)) {
+                opportunities.push_back(opportunity);
             }
         }
     }
@@ -309,6 +423,71 @@ std::vector<ArbitrageOpportunity> SpreadCalculator::detect_arbitrage_opportuniti
     return opportunities;
 }
 
+std::vector<ArbitrageOpportunity> SpreadCalculator::detect_arbitrage_opportunities(
+    const types::Ticker& updated_ticker, double min_profit_threshold) const {
+    
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    
+    std::vector<ArbitrageOpportunity> opportunities;
+    
+    auto index_it = impl_->top_of_book.find(updated_ticker.symbol);
+    if (index_it == impl_->top_of_book.end()) {
+        return opportunities;
+    }
+    
+    const auto& index = index_it->second;
+    const auto self_it = index.entries.find(updated_ticker.exchange);
+    if (self_it == index.entries.end()) {
+        return opportunities;
+    }
+    
+    const double own_bid = self_it->second.first->first;
+    const double own_ask = self_it->second.second->first;
+    const double quantity = 1.0; // Default quantity for analysis, as in find_best_opportunities
+    
+    std::vector<SpreadAnalysis> candidates;
+    
+    // Buy on the updated exchange, sell where the bid is highest. The index is
+    // sorted, so the walk stops at the first venue without a positive raw spread.
+    for (const auto& [bid, exchange] : index.bids) {
+        if (bid <= own_ask) break;
+        if (exchange == updated_ticker.exchange) continue;
+        
+        auto analysis = analyze_spread(updated_ticker.symbol, updated_ticker.exchange, exchange, quantity);
+        if (analysis.spread_percentage >= impl_->spread_threshold) {
+            candidates.push_back(analysis);
+        }
+    }
+    
+    // Sell on the updated exchange, buy where the ask is lowest
+    for (const auto& [ask, exchange] : index.asks) {
+        if (ask >= own_bid) break;
+        if (exchange == updated_ticker.exchange) continue;
+        
+        auto analysis = analyze_spread(updated_ticker.symbol, exchange, updated_ticker.exchange, quantity);
+        if (analysis.spread_percentage >= impl_->spread_threshold) {
+            candidates.push_back(analysis);
+        }
+    }
+    
+    std::sort(candidates.begin(), candidates.end(),
+              [](const SpreadAnalysis& a, const SpreadAnalysis& b) {
+                  return a.profit_margin > b.profit_margin;
+              });
+    
+    for (const auto& spread_analysis : candidates) {
+        ArbitrageOpportunity opportunity;
+        if (build_opportunity(spread_analysis, min_profit_threshold, opportunity)) {
+            opportunities.push_back(opportunity);
+        }
+    }
+    
+    // Update statistics
+    const_cast<SpreadCalculator*>(this)->impl_->opportunities_detected += opportunities.size();
+    
+    return opportunities;
+}
+
 double SpreadCalculator::calculate_trading_fee(const std::string& exchange, const std::string& symbol,
                                              double quantity, double price, bool is_maker) const {
     std::shared_lock<std::shared_mutex> lock(impl_->mutex);
@@ -362,11 +541,11 @@ double SpreadCalculator::estimate_slippage(const std::string& exchange, const st
             
             if (impl_->advanced_slippage_modeling) {
                 // Use order book data if available
-                auto depth_it = impl_->depth_cache.find(exchange);
-                if (depth_it != impl_->depth_cache.end()) {
-                    auto symbol_depth_it = depth_it->second.find(symbol);
-                    if (symbol_depth_it != depth_it->second.end()) {
-                        return calculate_nonlinear_slippage(model, quantity, symbol_depth_it->second);
+                uint32_t key = 0;
+                if (find_depth_key(exchange, symbol, key)) {
+                    auto depth_it = impl_->depth_cache.find(key);
+                    if (depth_it != impl_->depth_cache.end()) {
+                        return calculate_nonlinear_slippage(model, quantity, depth_it->second);
                     }
                 }
             }
@@ -431,6 +610,93 @@ double SpreadCalculator::calculate_confidence_score(const ArbitrageOpportunity&
     return score * 0.5; // Reduce confidence if data is missing
 }
 
+double SpreadCalculator::calculate_volatility(const std::string& symbol, std::chrono::hours lookback) const {
+    std::shared_lock<std::shared_mutex> lock(impl_->history_mutex);
+    
+    auto it = impl_->return_history.find(symbol);
+    if (it == impl_->return_history.end()) {
+        return 0.0;
+    }
+    return it->second.returns.window(std::chrono::system_clock::now(), lookback).stddev();
+}
+
+std::vector<SpreadAnalysis> SpreadCalculator::get_historical_spreads(const std::string& symbol,
+                                                                    std::chrono::hours lookback) const {
+    std::shared_lock<std::shared_mutex> lock(impl_->history_mutex);
+    
+    std::vector<SpreadAnalysis> spreads;
+    auto it = impl_->spread_history.find(types::SymbolRegistry::instance().find(symbol));
+    if (it == impl_->spread_history.end()) {
+        return spreads;
+    }
+    
+    const auto cutoff = std::chrono::system_clock::now() - lookback;
+    for (const auto& sample : it->second) {
+        if (sample.recorded_at >= cutoff) {
+            SpreadAnalysis analysis;
+            analysis.symbol = symbol;
+            analysis.buy_exchange = types::exchange_name(sample.buy_exchange);
+            analysis.sell_exchange = types::exchange_name(sample.sell_exchange);
+            analysis.raw_spread = sample.raw_spread;
+            analysis.spread_percentage = sample.spread_percentage;
+            spreads.push_back(std::move(analysis));
+        }
+    }
+    return spreads;
+}
+
+double SpreadCalculator::get_average_spread(const std::string& symbol, const std::string& buy_exchange,
+                                          const std::string& sell_exchange, std::chrono::hours lookback) const {
+    uint64_t key;
+    if (!find_route_key(symbol, buy_exchange, sell_exchange, key)) {
+        return 0.0;
+    }
+    
+    std::shared_lock<std::shared_mutex> lock(impl_->history_mutex);
+    auto it = impl_->spread_series.find(key);
+    if (it == impl_->spread_series.end()) {
+        return 0.0;
+    }
+    return it->second.window(std::chrono::system_clock::now(), lookback).mean;
+}
+
+void SpreadCalculator::clear_historical_data() {
+    std::unique_lock<std::shared_mutex> lock(impl_->history_mutex);
+    impl_->spread_history.clear();
+    impl_->spread_series.clear();
+    impl_->return_history.clear();
+}
+
+void SpreadCalculator::cleanup_old_data(std::chrono::hours max_age) {
+    std::unique_lock<std::shared_mutex> lock(impl_->history_mutex);
+    
+    // Series expire their own buckets; this only drops idle keys
+    const auto cutoff = std::chrono::system_clock::now() - max_age;
+    for (auto it = impl_->spread_history.begin(); it != impl_->spread_history.end();) {
+        auto& history = it->second;
+        while (!history.empty() && history.front().recorded_at < cutoff) {
+            history.pop_front();
+        }
+        it = history.empty() ? impl_->spread_history.erase(it) : std::next(it);
+    }
+    for (auto it = impl_->spread_series.begin(); it != impl_->spread_series.end();) {
+        it = it->second.last_update() < cutoff ? impl_->spread_series.erase(it) : std::next(it);
+    }
+    for (auto it = impl_->return_history.begin(); it != impl_->return_history.end();) {
+        it = it->second.returns.last_update() < cutoff ? impl_->return_history.erase(it) : std::next(it);
+    }
+}
+
+size_t SpreadCalculator::get_data_size() const {
+    std::shared_lock<std::shared_mutex> lock(impl_->history_mutex);
+    
+    size_t size = impl_->spread_series.size() + impl_->return_history.size();
+    for (const auto& [symbol, history] : impl_->spread_history) {
+        size += history.size();
+    }
+    return size;
+}
+
 size_t SpreadCalculator::get_opportunities_detected() const {
     return impl_->opportunities_detected;
 }
@@ -465,7 +731,7 @@ double SpreadCalculator::calculate_linear_slippage(const SlippageModel& model, d
 }
 
 double SpreadCalculator::calculate_nonlinear_slippage(const SlippageModel& model, double quantity,
-                                                    const MarketDepth& depth) const {
+                                                    const CompactMarketDepth& depth) const {
     // Calculate order book impact
     double order_book_impact = calculate_order_book_impact(depth, quantity, types::OrderSide::BUY);
     
@@ -475,7 +741,7 @@ double SpreadCalculator::calculate_nonlinear_slippage(const SlippageModel& model
     return linear_slippage + (order_book_impact * model.liquidity_factor);
 }
 
-double SpreadCalculator::calculate_order_book_impact(const MarketDepth& depth, double quantity, 
+double SpreadCalculator::calculate_order_book_impact(const CompactMarketDepth& depth, double quantity, 
                                                    types::OrderSide side) const {
     const auto& levels = (side == types::OrderSide::BUY) ? depth.asks : depth.bids;
     
@@ -564,15 +830,201 @@ void SpreadCalculator::enrich_opportunity(ArbitrageOpportunity& opportunity) con
     opportunity.max_position_size = opportunity.available_quantity * 0.8; // 80% of available
 }
 
+bool SpreadCalculator::solve_depth_size(const SpreadAnalysis& spread_analysis, ExecutableSize& size,
+                                        double& buy_fee_rate, double& sell_fee_rate) const {
+    auto find_ladders = [this, &spread_analysis](const std::string& exchange) -> const DepthLadders* {
+        uint32_t key = 0;
+        if (!find_depth_key(exchange, spread_analysis.symbol, key)) return nullptr;
+        auto it = impl_->depth_ladders.find(key);
+        return it != impl_->depth_ladders.end() ? &it->second : nullptr;
+    };
+    
+    const DepthLadders* buy_book = find_ladders(spread_analysis.buy_exchange);
+    const DepthLadders* sell_book = find_ladders(spread_analysis.sell_exchange);
+    if (!buy_book || !sell_book || buy_book->asks.empty() || sell_book->bids.empty()) {
+        return false;
+    }
+    
+    auto taker_rate = [this, &spread_analysis](const std::string& exchange) {
+        auto fee_it = impl_->fee_structures.find(exchange);
+        if (fee_it == impl_->fee_structures.end()) return 0.001; // Default 0.1% fee
+        auto symbol_fee_it = fee_it->second.symbol_specific_fees.find(spread_analysis.symbol);
+        return symbol_fee_it != fee_it->second.symbol_specific_fees.end() ? symbol_fee_it->second
+                                                                         : fee_it->second.taker_fee;
+    };
+    
+    // The book walk already prices market impact, so only the model's base
+    // slippage is charged on top
+    auto base_slippage = [this, &spread_analysis](const std::string& exchange) {
+        auto exchange_it = impl_->slippage_models.find(exchange);
+        if (exchange_it != impl_->slippage_models.end()) {
+            auto symbol_it = exchange_it->second.find(spread_analysis.symbol);
+            if (symbol_it != exchange_it->second.end()) return symbol_it->second.base_slippage;
+        }
+        return SlippageModel().base_slippage;
+    };
+    
+    buy_fee_rate = taker_rate(spread_analysis.buy_exchange);
+    sell_fee_rate = taker_rate(spread_analysis.sell_exchange);
+    const double buy_factor = 1.0 + buy_fee_rate + base_slippage(spread_analysis.buy_exchange);
+    const double sell_factor = 1.0 - sell_fee_rate - base_slippage(spread_analysis.sell_exchange);
+    
+    size = solve_executable_size(buy_book->asks, sell_book->bids, buy_factor, sell_factor,
+                                 impl_->max_order_quantity);
+    return true;
+}
+
+bool SpreadCalculator::build_opportunity(const SpreadAnalysis& spread_analysis, double min_profit_threshold,
+                                         ArbitrageOpportunity& opportunity) const {
+    // Size against the order books when both are known; otherwise fall back
+    // to the ticker-based estimate below
+    ExecutableSize depth_size;
+    double buy_fee_rate = 0.0;
+    double sell_fee_rate = 0.0;
+    const bool depth_sized = solve_depth_size(spread_analysis, depth_size, buy_fee_rate, sell_fee_rate);
+    
+    const double expected_profit = depth_sized ? depth_size.net_profit : spread_analysis.profit_margin;
+    if (expected_profit < min_profit_threshold) {
+        return false;
+    }
+    
+    const std::string& symbol = spread_analysis.symbol;
+    opportunity.symbol = symbol;
+    opportunity.buy_exchange = spread_analysis.buy_exchange;
+    opportunity.sell_exchange = spread_analysis.sell_exchange;
+    
+    // Get current prices
+    const auto& buy_ticker = impl_->ticker_cache.at(spread_analysis.buy_exchange).at(symbol);
+    const auto& sell_ticker = impl_->ticker_cache.at(spread_analysis.sell_exchange).at(symbol);
+    
+    opportunity.buy_price = buy_ticker.ask;
+    opportunity.sell_price = sell_ticker.bid;
+    opportunity.spread_percentage = spread_analysis.spread_percentage;
+    opportunity.expected_profit = spread_analysis.profit_margin;
+    opportunity.confidence_score = spread_analysis.confidence_score;
+    opportunity.detected_at = std::chrono::system_clock::now();
+    
+    if (depth_sized) {
+        // Limit prices are the worst levels swept, so both legs fill in full
+        opportunity.buy_price = depth_size.buy_limit_price;
+        opportunity.sell_price = depth_size.sell_limit_price;
+        opportunity.available_quantity = depth_size.quantity;
+        opportunity.expected_profit = depth_size.net_profit;
+        opportunity.total_fees = depth_size.buy_notional * buy_fee_rate + depth_size.sell_notional * sell_fee_rate;
+        opportunity.estimated_slippage = (depth_size.buy_vwap / buy_ticker.ask - 1.0) +
+                                         (1.0 - depth_size.sell_vwap / sell_ticker.bid);
+        opportunity.max_position_size = opportunity.available_quantity;
+        opportunity.risk_approved = true; // Simplified - would normally check with risk manager
+        
+        enrich_opportunity(opportunity);
+        
+        return validate_opportunity(opportunity);
+    }
+    
+    // Estimate available quantity from ticker volume
+    opportunity.available_quantity = std::min(buy_ticker.volume, sell_ticker.volume) * 0.01; // 1% of volume
+    opportunity.available_quantity = std::min(opportunity.available_quantity, 10.0); // Max 10 units
+    
+    // Calculate fees and slippage
+    opportunity.total_fees = calculate_total_fees(opportunity.buy_exchange, 
+                                                opportunity.sell_exchange,
+                                                opportunity.symbol,
+                                                opportunity.available_quantity,
+                                                opportunity.buy_price,
+                                                opportunity.sell_price);
+    
+    opportunity.estimated_slippage = estimate_slippage(opportunity.buy_exchange, symbol, 
+                                                     opportunity.available_quantity, types::OrderSide::BUY) +
+                                   estimate_slippage(opportunity.sell_exchange, symbol,
+                                                     opportunity.available_quantity, types::OrderSide::SELL);
+    
+    // Risk assessment
+    opportunity.max_position_size = opportunity.available_quantity;
+    opportunity.risk_approved = true; // Simplified - would normally check with risk manager
+    
+    enrich_opportunity(opportunity);
+    
+    return validate_opportunity(opportunity);
+}
+
+void SpreadCalculator::record_spreads_for_update(const types::Ticker& ticker) {
+    // Samples are priced straight from the top-of-book matrix: the histories
+    // only keep raw spreads, so the fee, slippage and confidence work of a
+    // full analysis would be thrown away on every quote
+    const types::SymbolCode symbol = types::SymbolRegistry::instance().find(ticker.symbol);
+    const types::ExchangeCode updated = types::ExchangeRegistry::instance().find(ticker.exchange);
+    if (symbol == types::INVALID_CODE || updated >= TopOfBookMatrix::MAX_SLOTS) {
+        return;
+    }
+    
+    std::array<SpreadSample, 2 * TopOfBookMatrix::MAX_SLOTS> samples;
+    size_t count = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+        const TopOfBookMatrix::Row* row = impl_->book_matrix.row(symbol);
+        if (!row || !row->has(updated)) {
+            return;
+        }
+        
+        auto sample = [&](types::ExchangeCode buy, types::ExchangeCode sell) {
+            const double buy_ask = row->ask[buy];
+            if (buy_ask <= 0) {
+                return;
+            }
+            SpreadSample& next = samples[count++];
+            next.buy_exchange = buy;
+            next.sell_exchange = sell;
+            next.raw_spread = row->bid[sell] - buy_ask;
+            next.spread_percentage = (next.raw_spread / buy_ask) * 100.0;
+        };
+        
+        // Both directions of every route through the updated exchange
+        for (types::ExchangeCode other = 0; other < TopOfBookMatrix::MAX_SLOTS; ++other) {
+            if (other != updated && row->has(other)) {
+                sample(updated, other);
+                sample(other, updated);
+            }
+        }
+    }
+    if (count == 0) {
+        return;
+    }
+    
+    // One history lock for the whole update rather than one per route
+    const auto now = std::chrono::system_clock::now();
+    std::unique_lock<std::shared_mutex> lock(impl_->history_mutex);
+    auto& history = impl_->spread_history[symbol];
+    for (size_t i = 0; i < count; ++i) {
+        SpreadSample& sample = samples[i];
+        sample.recorded_at = now;
+        impl_->spread_series
+            .try_emplace(route_key(symbol, sample.buy_exchange, sample.sell_exchange), impl_->make_series())
+            .first->second.add(sample.spread_percentage, now);
+        history.push_back(sample);
+    }
+    while (history.size() > impl_->max_spread_history) {
+        history.pop_front();
+    }
+}
+
+void SpreadCalculator::update_top_of_book_index(const types::Ticker& ticker) {
+    impl_->top_of_book[ticker.symbol].update(ticker.exchange, ticker.bid, ticker.ask);
+    // The matrix ignores names the full registries left without a code
+    impl_->book_matrix.update(types::intern_exchange(ticker.exchange), types::intern_symbol(ticker.symbol),
+                              ticker.bid, ticker.ask, ticker.timestamp);
+}
+
 double SpreadCalculator::calculate_confidence_score_internal(const types::Ticker& buy_ticker, 
                                                            const types::Ticker& sell_ticker,
                                                            double quantity) const {
     double score = 1.0;
     
     // Data freshness factor
-    auto now = std::chrono::system_clock::now();
-    auto buy_age = std::chrono::duration_cast<std::chrono::seconds>(now - buy_ticker.timestamp);
-    auto sell_age = std::chrono::duration_cast<std::chrono::seconds>(now - sell_ticker.timestamp);
+    // Ticker timestamps are Unix milliseconds
+    const int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    auto buy_age = std::chrono::milliseconds(now_ms - buy_ticker.timestamp);
+    auto sell_age = std::chrono::milliseconds(now_ms - sell_ticker.timestamp);
     
     if (buy_age > std::chrono::seconds(30) || sell_age > std::chrono::seconds(30)) {
         score *= 0.8; // Reduce confidence for stale data
@@ -584,17 +1036,37 @@ double SpreadCalculator::calculate_confidence_score_internal(const types::Ticker
         score *= 0.7; // Reduce confidence if quantity is large relative to volume
     }
     
-    // Spread stability (simplified)
-    if (buy_ticker.high - buy_ticker.low > buy_ticker.last * 0.05) {
-        score *= 0.9; // Reduce confidence in highly volatile markets
+    // Spread stability: a spread far outside its recent range is more likely
+    // a stale or erroneous quote than a real opportunity
+    {
+        uint64_t key;
+        std::shared_lock<std::shared_mutex> history_lock(impl_->history_mutex);
+        auto series_it = find_route_key(buy_ticker.symbol, buy_ticker.exchange, sell_ticker.exchange, key)
+                             ? impl_->spread_series.find(key)
+                             : impl_->spread_series.end();
+        if (series_it != impl_->spread_series.end() && series_it->second.samples() > 1) {
+            const auto& series = series_it->second;
+            double spread_percentage = (sell_ticker.bid - buy_ticker.ask) / buy_ticker.ask * 100.0;
+            double deviation = std::abs(spread_percentage - series.ewma_mean());
+            if (deviation > 3.0 * series.ewma_stddev()) {
+                score *= 0.9;
+            }
+        }
     }
     
     return std::max(0.1, std::min(1.0, score));
 }
 
 double SpreadCalculator::calculate_volatility_adjustment(const std::string& symbol) const {
-    // Simplified volatility calculation
-    return 0.95; // 5% volatility discount
+    std::shared_lock<std::shared_mutex> lock(impl_->history_mutex);
+    
+    auto it = impl_->return_history.find(symbol);
+    if (it == impl_->return_history.end() || it->second.returns.samples() < 2) {
+        return 0.95; // 5% volatility discount without history
+    }
+    
+    // Discount 10% for every 1% of recent per-update return volatility
+    return std::max(0.5, 1.0 - 10.0 * it->second.returns.ewma_stddev());
 }
 
 double SpreadCalculator::calculate_liquidity_adjustment(const ArbitrageOpportunity& opportunity) const {
@@ -0,0 +1,119 @@
+#include "top_of_book_matrix.hpp"
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace ats {
+namespace trading_engine {
+
+namespace {
+
+#if defined(__AVX2__)
+constexpr size_t VECTOR_WIDTH = 4;
+#elif defined(__SSE2__) || defined(_M_X64)
+constexpr size_t VECTOR_WIDTH = 2;
+#else
+constexpr size_t VECTOR_WIDTH = 1;
+#endif
+
+// out[i * stride + j] = bid[j] * inv_ask[i] - 1 for i, j < width.
+// width is a multiple of VECTOR_WIDTH.
+void spread_kernel(const double* bid_in, const double* inv_ask, size_t width,
+                   size_t stride, double* out) {
+    for (size_t i = 0; i < width; ++i) {
+        double* row = out + i * stride;
+#if defined(__AVX2__)
+        const __m256d inv = _mm256_set1_pd(inv_ask[i]);
+        const __m256d one = _mm256_set1_pd(1.0);
+        for (size_t j = 0; j < width; j += 4) {
+            __m256d bid = _mm256_load_pd(bid_in + j);
+            _mm256_storeu_pd(row + j, _mm256_sub_pd(_mm256_mul_pd(bid, inv), one));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        const __m128d inv = _mm_set1_pd(inv_ask[i]);
+        const __m128d one = _mm_set1_pd(1.0);
+        for (size_t j = 0; j < width; j += 2) {
+            __m128d bid = _mm_load_pd(bid_in + j);
+            _mm_storeu_pd(row + j, _mm_sub_pd(_mm_mul_pd(bid, inv), one));
+        }
+#else
+        const double inv = inv_ask[i];
+        for (size_t j = 0; j < width; ++j) {
+            row[j] = bid_in[j] * inv - 1.0;
+        }
+#endif
+    }
+}
+
+} // namespace
+
+TopOfBookMatrix::Row::Row() : timestamp{} {
+    std::fill(std::begin(bid), std::end(bid), 0.0);
+    std::fill(std::begin(ask), std::end(ask), std::numeric_limits<double>::infinity());
+}
+
+void TopOfBookMatrix::update(types::ExchangeCode exchange, types::SymbolCode symbol,
+                             double bid, double ask, int64_t timestamp) {
+    if (exchange >= MAX_SLOTS || symbol == types::INVALID_CODE) {
+        return;
+    }
+    if (symbol >= rows_.size()) {
+        rows_.resize(symbol + 1);
+    }
+
+    Row& row = rows_[symbol];
+    row.bid[exchange] = bid;
+    row.ask[exchange] = ask;
+    row.timestamp[exchange] = timestamp;
+    row.present |= 1u << exchange;
+
+    size_t needed = (exchange / VECTOR_WIDTH + 1) * VECTOR_WIDTH;
+    width_ = std::max(width_, std::min(needed, MAX_SLOTS));
+}
+
+const TopOfBookMatrix::Row* TopOfBookMatrix::row(types::SymbolCode symbol) const {
+    if (symbol >= rows_.size() || rows_[symbol].present == 0) {
+        return nullptr;
+    }
+    return &rows_[symbol];
+}
+
+bool TopOfBookMatrix::spreads(types::SymbolCode symbol, SpreadMatrix& out) const {
+    const Row* quotes = row(symbol);
+    if (!quotes) {
+        return false;
+    }
+
+    // Take the reciprocal of each ask once, so the pairwise pass is a single
+    // multiply-subtract. Bids are already contiguous and aligned in the row.
+    alignas(64) double inv_ask[MAX_SLOTS];
+    for (size_t k = 0; k < width_; ++k) {
+        inv_ask[k] = 1.0 / quotes->ask[k];
+    }
+
+    spread_kernel(quotes->bid, inv_ask, width_, MAX_SLOTS, out.data());
+    return true;
+}
+
+void TopOfBookMatrix::clear() {
+    rows_.clear();
+    width_ = 0;
+}
+
+const char* TopOfBookMatrix::kernel_name() {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__) || defined(_M_X64)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace trading_engine
+} // namespace ats
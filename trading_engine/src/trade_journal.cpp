@@ -0,0 +1,649 @@
+#include "trade_journal.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace ats {
+namespace trading_engine {
+
+namespace {
+
+constexpr size_t BLOCK_ROWS = 1024;
+constexpr size_t MAX_NAMES = 65535;
+
+int64_t to_nanoseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// Time range of one block of rows; the sparse index of a partition
+struct Block {
+    int64_t min_ts;
+    int64_t max_ts;
+};
+
+// Names with journal-local ids, stable across restarts
+struct NameDictionary {
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint16_t> ids;
+    size_t persisted = 0;
+
+    uint16_t intern(const std::string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        if (names.size() >= MAX_NAMES) {
+            throw std::length_error("Trade journal dictionary is full");
+        }
+        uint16_t id = static_cast<uint16_t>(names.size());
+        names.push_back(name);
+        ids.emplace(name, id);
+        return id;
+    }
+
+    int find(const std::string& name) const {
+        auto it = ids.find(name);
+        return it != ids.end() ? it->second : -1;
+    }
+
+    const std::string& name(uint16_t id) const {
+        static const std::string unknown;
+        return id < names.size() ? names[id] : unknown;
+    }
+};
+
+struct Partition {
+    std::vector<int64_t> timestamp; // ns since epoch
+    std::vector<uint16_t> symbol;
+    std::vector<uint16_t> buy_exchange;
+    std::vector<uint16_t> sell_exchange;
+    std::vector<uint8_t> result;
+    std::vector<double> quantity;
+    std::vector<double> executed_quantity;
+    std::vector<double> buy_price;
+    std::vector<double> sell_price;
+    std::vector<double> expected_profit;
+    std::vector<double> actual_profit;
+    std::vector<double> total_fees;
+    std::vector<int64_t> latency_ms;
+    std::vector<uint32_t> trade_id_end; // end offset of each row's id in trade_ids
+    std::vector<char> trade_ids;
+
+    std::vector<Block> blocks;
+    int64_t min_ts = INT64_MAX;
+    int64_t max_ts = INT64_MIN;
+    size_t persisted_rows = 0;
+
+    size_t rows() const { return timestamp.size(); }
+
+    // Copy of rows [from, rows()), trade ids included; not indexed
+    Partition tail(size_t from) const {
+        Partition copy;
+        copy.timestamp.assign(timestamp.begin() + from, timestamp.end());
+        copy.symbol.assign(symbol.begin() + from, symbol.end());
+        copy.buy_exchange.assign(buy_exchange.begin() + from, buy_exchange.end());
+        copy.sell_exchange.assign(sell_exchange.begin() + from, sell_exchange.end());
+        copy.result.assign(result.begin() + from, result.end());
+        copy.quantity.assign(quantity.begin() + from, quantity.end());
+        copy.executed_quantity.assign(executed_quantity.begin() + from, executed_quantity.end());
+        copy.buy_price.assign(buy_price.begin() + from, buy_price.end());
+        copy.sell_price.assign(sell_price.begin() + from, sell_price.end());
+        copy.expected_profit.assign(expected_profit.begin() + from, expected_profit.end());
+        copy.actual_profit.assign(actual_profit.begin() + from, actual_profit.end());
+        copy.total_fees.assign(total_fees.begin() + from, total_fees.end());
+        copy.latency_ms.assign(latency_ms.begin() + from, latency_ms.end());
+        copy.trade_id_end.assign(trade_id_end.begin() + from, trade_id_end.end());
+        size_t id_begin = from > 0 ? trade_id_end[from - 1] : 0;
+        copy.trade_ids.assign(trade_ids.begin() + id_begin, trade_ids.end());
+        return copy;
+    }
+
+    template <typename F>
+    void for_each_column(F&& f) {
+        f("timestamp", timestamp);
+        f("symbol", symbol);
+        f("buy_exchange", buy_exchange);
+        f("sell_exchange", sell_exchange);
+        f("result", result);
+        f("quantity", quantity);
+        f("executed_quantity", executed_quantity);
+        f("buy_price", buy_price);
+        f("sell_price", sell_price);
+        f("expected_profit", expected_profit);
+        f("actual_profit", actual_profit);
+        f("total_fees", total_fees);
+        f("latency_ms", latency_ms);
+        f("trade_id_end", trade_id_end);
+    }
+
+    void index_row(size_t row) {
+        int64_t ts = timestamp[row];
+        if (row % BLOCK_ROWS == 0) {
+            blocks.push_back({ts, ts});
+        } else {
+            blocks.back().min_ts = std::min(blocks.back().min_ts, ts);
+            blocks.back().max_ts = std::max(blocks.back().max_ts, ts);
+        }
+        min_ts = std::min(min_ts, ts);
+        max_ts = std::max(max_ts, ts);
+    }
+};
+
+template <typename T>
+bool append_column(const std::filesystem::path& path, const T* data, size_t count) {
+    if (count == 0) {
+        return true;
+    }
+    std::FILE* file = std::fopen(path.c_str(), "ab");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(data, sizeof(T), count, file) == count;
+    return std::fclose(file) == 0 && ok;
+}
+
+template <typename T>
+void load_column(const std::filesystem::path& path, std::vector<T>& column) {
+    std::error_code ec;
+    auto bytes = std::filesystem::file_size(path, ec);
+    column.clear();
+    if (ec || bytes < sizeof(T)) {
+        return;
+    }
+    column.resize(bytes / sizeof(T));
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        column.clear();
+        return;
+    }
+    column.resize(std::fread(column.data(), sizeof(T), column.size(), file));
+    std::fclose(file);
+}
+
+// Sums with independent accumulators so the adds pipeline and vectorize
+// without reassociating a single running total
+double sum_range(const double* values, size_t begin, size_t end) {
+    double lanes[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        lanes[0] += values[i];
+        lanes[1] += values[i + 1];
+        lanes[2] += values[i + 2];
+        lanes[3] += values[i + 3];
+    }
+    for (; i < end; ++i) {
+        lanes[0] += values[i];
+    }
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+double masked_sum(const double* values, const int64_t* ts, size_t begin, size_t end, int64_t from, int64_t to) {
+    double lanes[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            bool inside = ts[i + lane] >= from && ts[i + lane] <= to;
+            lanes[lane] += inside ? values[i + lane] : 0.0;
+        }
+    }
+    for (; i < end; ++i) {
+        lanes[0] += ts[i] >= from && ts[i] <= to ? values[i] : 0.0;
+    }
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+} // namespace
+
+struct TradeJournal::Implementation {
+    int64_t span_ns;
+    std::filesystem::path directory; // empty: memory only
+    std::map<int64_t, Partition> partitions;
+    NameDictionary symbols;
+    NameDictionary exchanges;
+    size_t rows = 0;
+    mutable std::shared_mutex mutex;
+    std::mutex flush_mutex; // taken before mutex
+
+    explicit Implementation(int64_t span) : span_ns(span) {}
+
+    int64_t partition_start(int64_t ts) const {
+        int64_t start = ts / span_ns * span_ns;
+        return start > ts ? start - span_ns : start;
+    }
+
+    std::filesystem::path partition_path(int64_t start) const {
+        return directory / "partitions" / std::to_string(start / 1000000000);
+    }
+
+    // Calls visit(partition, begin, end, whole) for each block that may hold
+    // rows in [from, to]; whole is true when every row of the block does
+    template <typename F>
+    void scan(int64_t from, int64_t to, F&& visit) const {
+        for (auto it = partitions.lower_bound(partition_start(from)); it != partitions.end() && it->first <= to; ++it) {
+            const Partition& partition = it->second;
+            if (partition.rows() == 0 || partition.max_ts < from || partition.min_ts > to) {
+                continue;
+            }
+            for (size_t b = 0; b < partition.blocks.size(); ++b) {
+                const Block& block = partition.blocks[b];
+                if (block.max_ts < from || block.min_ts > to) {
+                    continue;
+                }
+                size_t begin = b * BLOCK_ROWS;
+                size_t end = std::min(begin + BLOCK_ROWS, partition.rows());
+                visit(partition, begin, end, block.min_ts >= from && block.max_ts <= to);
+            }
+        }
+    }
+
+    // Rows of [from, to] whose symbol column matches symbol_id, or all rows
+    // when symbol_id is negative
+    std::vector<TradeExecution> collect(int64_t from, int64_t to, int symbol_id) const {
+        std::vector<TradeExecution> trades;
+        scan(from, to, [&](const Partition& partition, size_t begin, size_t end, bool whole) {
+            for (size_t i = begin; i < end; ++i) {
+                if (!whole && (partition.timestamp[i] < from || partition.timestamp[i] > to)) {
+                    continue;
+                }
+                if (symbol_id >= 0 && partition.symbol[i] != symbol_id) {
+                    continue;
+                }
+                trades.push_back(row(partition, i));
+            }
+        });
+        return trades;
+    }
+
+    TradeExecution row(const Partition& partition, size_t i) const {
+        TradeExecution execution;
+        size_t id_begin = i > 0 ? partition.trade_id_end[i - 1] : 0;
+        execution.trade_id.assign(partition.trade_ids.data() + id_begin, partition.trade_id_end[i] - id_begin);
+        execution.symbol = symbols.name(partition.symbol[i]);
+        execution.buy_exchange = exchanges.name(partition.buy_exchange[i]);
+        execution.sell_exchange = exchanges.name(partition.sell_exchange[i]);
+        execution.result = static_cast<ExecutionResult>(partition.result[i]);
+        execution.quantity = partition.quantity[i];
+        execution.executed_quantity = partition.executed_quantity[i];
+        execution.buy_price = partition.buy_price[i];
+        execution.sell_price = partition.sell_price[i];
+        execution.expected_profit = partition.expected_profit[i];
+        execution.actual_profit = partition.actual_profit[i];
+        execution.total_fees = partition.total_fees[i];
+        execution.execution_latency = std::chrono::milliseconds(partition.latency_ms[i]);
+        execution.timestamp = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(partition.timestamp[i])));
+        return execution;
+    }
+
+    bool load_dictionary(const std::filesystem::path& path, NameDictionary& dictionary) {
+        std::ifstream file(path);
+        std::string name;
+        while (std::getline(file, name)) {
+            dictionary.intern(name);
+        }
+        dictionary.persisted = dictionary.names.size();
+        return true;
+    }
+
+    static bool persist_names(const std::filesystem::path& path, const std::vector<std::string>& names) {
+        if (names.empty()) {
+            return true;
+        }
+        std::ofstream file(path, std::ios::app);
+        for (const auto& name : names) {
+            file << name << '\n';
+        }
+        file.flush();
+        return static_cast<bool>(file);
+    }
+
+    // Loads one partition directory, trimming every column to the rows all
+    // columns hold so a torn append leaves no partial row behind
+    void load_partition(const std::filesystem::path& path, int64_t start) {
+        Partition partition;
+        partition.for_each_column([&](const char* name, auto& column) {
+            load_column(path / (std::string(name) + ".bin"), column);
+        });
+        std::vector<char> ids;
+        load_column(path / "trade_id.bin", ids);
+
+        size_t count = SIZE_MAX;
+        partition.for_each_column([&](const char*, auto& column) {
+            count = std::min(count, column.size());
+        });
+        while (count > 0 && partition.trade_id_end[count - 1] > ids.size()) {
+            --count;
+        }
+
+        partition.for_each_column([&](const char* name, auto& column) {
+            using Value = typename std::decay_t<decltype(column)>::value_type;
+            column.resize(count);
+            std::error_code ec;
+            std::filesystem::resize_file(path / (std::string(name) + ".bin"), count * sizeof(Value), ec);
+        });
+        ids.resize(count > 0 ? partition.trade_id_end[count - 1] : 0);
+        std::error_code ec;
+        std::filesystem::resize_file(path / "trade_id.bin", ids.size(), ec);
+        partition.trade_ids = std::move(ids);
+
+        for (size_t i = 0; i < count; ++i) {
+            partition.index_row(i);
+        }
+        partition.persisted_rows = count;
+        rows += count;
+        partitions[start] = std::move(partition);
+    }
+};
+
+TradeJournal::TradeJournal(std::chrono::hours partition_span)
+    : impl_(std::make_unique<Implementation>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::max(partition_span, std::chrono::hours(1))).count())) {}
+
+TradeJournal::~TradeJournal() {
+    flush();
+}
+
+bool TradeJournal::open(const std::string& directory) {
+    std::lock_guard<std::mutex> flush_lock(impl_->flush_mutex);
+    std::unique_lock<std::shared_mutex> lock(impl_->mutex);
+
+    try {
+        impl_->directory = directory;
+        std::filesystem::create_directories(impl_->directory / "partitions");
+        impl_->load_dictionary(impl_->directory / "symbols.dict", impl_->symbols);
+        impl_->load_dictionary(impl_->directory / "exchanges.dict", impl_->exchanges);
+
+        for (const auto& entry : std::filesystem::directory_iterator(impl_->directory / "partitions")) {
+            if (!entry.is_directory()) {
+                continue;
+            }
+            // Partition directories are named by their start in epoch seconds
+            const std::string name = entry.path().filename().string();
+            int64_t seconds = 0;
+            auto parsed = std::from_chars(name.data(), name.data() + name.size(), seconds);
+            if (parsed.ec != std::errc() || parsed.ptr != name.data() + name.size()) {
+                utils::Logger::warn("Skipping unexpected entry {} in trade journal", entry.path().string());
+                continue;
+            }
+            impl_->load_partition(entry.path(), seconds * 1000000000);
+        }
+
+        utils::Logger::info("Trade journal opened at {} with {} rows in {} partitions",
+                            directory, impl_->rows, impl_->partitions.size());
+        return true;
+    } catch (const std::exception& e) {
+        utils::Logger::error("Failed to open trade journal at {}: {}", directory, e.what());
+        impl_->directory.clear();
+        return false;
+    }
+}
+
+void TradeJournal::append(const TradeExecution& execution) {
+    int64_t ts = to_nanoseconds(execution.timestamp);
+    std::unique_lock<std::shared_mutex> lock(impl_->mutex);
+
+    uint16_t symbol = impl_->symbols.intern(execution.symbol);
+    uint16_t buy_exchange = impl_->exchanges.intern(execution.buy_exchange);
+    uint16_t sell_exchange = impl_->exchanges.intern(execution.sell_exchange);
+    Partition& partition = impl_->partitions[impl_->partition_start(ts)];
+
+    partition.timestamp.push_back(ts);
+    partition.symbol.push_back(symbol);
+    partition.buy_exchange.push_back(buy_exchange);
+    partition.sell_exchange.push_back(sell_exchange);
+    partition.result.push_back(static_cast<uint8_t>(execution.result));
+    partition.quantity.push_back(execution.quantity);
+    partition.executed_quantity.push_back(execution.executed_quantity);
+    partition.buy_price.push_back(execution.buy_price);
+    partition.sell_price.push_back(execution.sell_price);
+    partition.expected_profit.push_back(execution.expected_profit);
+    partition.actual_profit.push_back(execution.actual_profit);
+    partition.total_fees.push_back(execution.total_fees);
+    partition.latency_ms.push_back(execution.execution_latency.count());
+    partition.trade_ids.insert(partition.trade_ids.end(), execution.trade_id.begin(), execution.trade_id.end());
+    partition.trade_id_end.push_back(static_cast<uint32_t>(partition.trade_ids.size()));
+    partition.index_row(partition.rows() - 1);
+    impl_->rows++;
+}
+
+bool TradeJournal::flush() {
+    std::lock_guard<std::mutex> flush_lock(impl_->flush_mutex);
+    if (impl_->directory.empty()) {
+        return true;
+    }
+
+    // Rows not yet on disk are copied out, so appends only wait for the copy
+    // and no lock is held during I/O; queries are never blocked
+    struct Pending {
+        int64_t start;
+        size_t rows; // persisted_rows once written
+        Partition tail;
+    };
+    std::vector<std::string> new_symbols;
+    std::vector<std::string> new_exchanges;
+    std::vector<Pending> pending;
+    {
+        std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+        new_symbols.assign(impl_->symbols.names.begin() + impl_->symbols.persisted, impl_->symbols.names.end());
+        new_exchanges.assign(impl_->exchanges.names.begin() + impl_->exchanges.persisted,
+                             impl_->exchanges.names.end());
+        for (const auto& [start, partition] : impl_->partitions) {
+            if (partition.persisted_rows < partition.rows()) {
+                pending.push_back({start, partition.rows(), partition.tail(partition.persisted_rows)});
+            }
+        }
+    }
+
+    // Names first, so persisted rows never reference an unknown id
+    bool symbols_ok = Implementation::persist_names(impl_->directory / "symbols.dict", new_symbols);
+    bool exchanges_ok = symbols_ok && Implementation::persist_names(impl_->directory / "exchanges.dict", new_exchanges);
+    bool ok = exchanges_ok;
+    size_t written = 0;
+    for (; ok && written < pending.size(); ++written) {
+        auto path = impl_->partition_path(pending[written].start);
+        Partition& tail = pending[written].tail;
+        std::error_code ec;
+        std::filesystem::create_directories(path, ec);
+
+        // Sizes before this flush; a failed append cuts every column back to
+        // them, so the retry does not write the same rows twice
+        std::vector<std::pair<std::filesystem::path, uintmax_t>> sizes;
+        auto append = [&](const std::filesystem::path& file, const auto* data, size_t count) {
+            auto bytes = std::filesystem::file_size(file, ec);
+            sizes.emplace_back(file, ec ? 0 : bytes);
+            return append_column(file, data, count);
+        };
+
+        ok = append(path / "trade_id.bin", tail.trade_ids.data(), tail.trade_ids.size());
+        // Offsets are written last; load trims rows to what every column holds
+        tail.for_each_column([&](const char* name, auto& column) {
+            ok = ok && append(path / (std::string(name) + ".bin"), column.data(), column.size());
+        });
+        if (!ok) {
+            for (const auto& [file, bytes] : sizes) {
+                std::filesystem::resize_file(file, bytes, ec);
+            }
+            break;
+        }
+    }
+
+    // Record progress; flush_mutex kept drop_partitions_before from removing
+    // any of these partitions in the meantime
+    {
+        std::unique_lock<std::shared_mutex> lock(impl_->mutex);
+        if (symbols_ok) {
+            impl_->symbols.persisted += new_symbols.size();
+        }
+        if (exchanges_ok) {
+            impl_->exchanges.persisted += new_exchanges.size();
+        }
+        for (size_t i = 0; i < written; ++i) {
+            auto it = impl_->partitions.find(pending[i].start);
+            if (it != impl_->partitions.end()) {
+                it->second.persisted_rows = pending[i].rows;
+            }
+        }
+    }
+
+    if (!ok) {
+        utils::Logger::error("Failed to persist trade journal to {}", impl_->directory.string());
+    }
+    return ok;
+}
+
+std::vector<TradeExecution> TradeJournal::query_trades(TimePoint from, TimePoint to) const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    return impl_->collect(to_nanoseconds(from), to_nanoseconds(to), -1);
+}
+
+std::vector<TradeExecution> TradeJournal::query_trades_by_symbol(const std::string& symbol, TimePoint from,
+                                                                 TimePoint to) const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    int symbol_id = impl_->symbols.find(symbol);
+    if (symbol_id < 0) {
+        return {};
+    }
+    return impl_->collect(to_nanoseconds(from), to_nanoseconds(to), symbol_id);
+}
+
+double TradeJournal::total_profit(TimePoint from, TimePoint to) const {
+    const int64_t from_ns = to_nanoseconds(from);
+    const int64_t to_ns = to_nanoseconds(to);
+    double total = 0.0;
+
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    impl_->scan(from_ns, to_ns, [&](const Partition& partition, size_t begin, size_t end, bool whole) {
+        const double* profit = partition.actual_profit.data();
+        total += whole ? sum_range(profit, begin, end)
+                       : masked_sum(profit, partition.timestamp.data(), begin, end, from_ns, to_ns);
+    });
+    return total;
+}
+
+double TradeJournal::success_rate(TimePoint from, TimePoint to) const {
+    const int64_t from_ns = to_nanoseconds(from);
+    const int64_t to_ns = to_nanoseconds(to);
+    const uint8_t last_success = static_cast<uint8_t>(ExecutionResult::PARTIAL_SUCCESS);
+    static_assert(static_cast<int>(ExecutionResult::SUCCESS) == 0 &&
+                  static_cast<int>(ExecutionResult::PARTIAL_SUCCESS) == 1,
+                  "success_rate counts results up to PARTIAL_SUCCESS");
+    size_t total = 0;
+    size_t successful = 0;
+
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    impl_->scan(from_ns, to_ns, [&](const Partition& partition, size_t begin, size_t end, bool whole) {
+        const uint8_t* result = partition.result.data();
+        const int64_t* ts = partition.timestamp.data();
+        if (whole) {
+            total += end - begin;
+            for (size_t i = begin; i < end; ++i) {
+                successful += result[i] <= last_success;
+            }
+        } else {
+            for (size_t i = begin; i < end; ++i) {
+                size_t inside = ts[i] >= from_ns && ts[i] <= to_ns;
+                total += inside;
+                successful += inside & (result[i] <= last_success);
+            }
+        }
+    });
+    return total > 0 ? static_cast<double>(successful) / total : 0.0;
+}
+
+std::unordered_map<std::string, double> TradeJournal::profit_by_symbol(TimePoint from, TimePoint to) const {
+    const int64_t from_ns = to_nanoseconds(from);
+    const int64_t to_ns = to_nanoseconds(to);
+
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    // Dense per-id accumulators; names are resolved once at the end
+    std::vector<double> profit(impl_->symbols.names.size(), 0.0);
+    std::vector<uint8_t> seen(impl_->symbols.names.size(), 0);
+    impl_->scan(from_ns, to_ns, [&](const Partition& partition, size_t begin, size_t end, bool whole) {
+        for (size_t i = begin; i < end; ++i) {
+            if (!whole && (partition.timestamp[i] < from_ns || partition.timestamp[i] > to_ns)) {
+                continue;
+            }
+            profit[partition.symbol[i]] += partition.actual_profit[i];
+            seen[partition.symbol[i]] = 1;
+        }
+    });
+
+    std::unordered_map<std::string, double> by_symbol;
+    for (size_t id = 0; id < profit.size(); ++id) {
+        if (seen[id]) {
+            by_symbol[impl_->symbols.names[id]] = profit[id];
+        }
+    }
+    return by_symbol;
+}
+
+std::unordered_map<std::string, double> TradeJournal::volume_by_exchange(TimePoint from, TimePoint to) const {
+    const int64_t from_ns = to_nanoseconds(from);
+    const int64_t to_ns = to_nanoseconds(to);
+
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    std::vector<double> volume(impl_->exchanges.names.size(), 0.0);
+    std::vector<uint8_t> seen(impl_->exchanges.names.size(), 0);
+    impl_->scan(from_ns, to_ns, [&](const Partition& partition, size_t begin, size_t end, bool whole) {
+        for (size_t i = begin; i < end; ++i) {
+            if (!whole && (partition.timestamp[i] < from_ns || partition.timestamp[i] > to_ns)) {
+                continue;
+            }
+            double executed = partition.executed_quantity[i];
+            volume[partition.buy_exchange[i]] += executed * partition.buy_price[i];
+            volume[partition.sell_exchange[i]] += executed * partition.sell_price[i];
+            seen[partition.buy_exchange[i]] = 1;
+            seen[partition.sell_exchange[i]] = 1;
+        }
+    });
+
+    std::unordered_map<std::string, double> by_exchange;
+    for (size_t id = 0; id < volume.size(); ++id) {
+        if (seen[id]) {
+            by_exchange[impl_->exchanges.names[id]] = volume[id];
+        }
+    }
+    return by_exchange;
+}
+
+size_t TradeJournal::drop_partitions_before(TimePoint cutoff) {
+    const int64_t cutoff_ns = to_nanoseconds(cutoff);
+    std::lock_guard<std::mutex> flush_lock(impl_->flush_mutex);
+    std::unique_lock<std::shared_mutex> lock(impl_->mutex);
+
+    size_t dropped = 0;
+    for (auto it = impl_->partitions.begin(); it != impl_->partitions.end() && it->first + impl_->span_ns <= cutoff_ns;) {
+        if (!impl_->directory.empty()) {
+            std::error_code ec;
+            std::filesystem::remove_all(impl_->partition_path(it->first), ec);
+        }
+        impl_->rows -= it->second.rows();
+        it = impl_->partitions.erase(it);
+        ++dropped;
+    }
+    return dropped;
+}
+
+size_t TradeJournal::size() const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    return impl_->rows;
+}
+
+size_t TradeJournal::partition_count() const {
+    std::shared_lock<std::shared_mutex> lock(impl_->mutex);
+    return impl_->partitions.size();
+}
+
+} // namespace trading_engine
+} // namespace ats
@@ -1,16 +1,194 @@
 #include "redis_subscriber.hpp"
+#include "trade_journal.hpp"
 #include "utils/logger.hpp"
 #include <curl/curl.h>
+#include <zlib.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <deque>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
 #include <filesystem>
 #include <thread>
-#include <queue>
 
 namespace ats {
 namespace trading_engine {
 
+namespace {
+
+// Line protocol records sent to InfluxDB in one request, newline separated
+struct LineBatch {
+    std::string lines;
+    size_t count = 0;
+    std::chrono::steady_clock::time_point opened_at;
+};
+
+// Spill file record: {uint32 line count, uint32 size} followed by the lines
+constexpr size_t SPILL_RECORD_HEADER = 8;
+
+// How often the writer thread applies the journal retention
+constexpr std::chrono::minutes JOURNAL_COMPACTION_PERIOD{1};
+
+void append_double(std::string& out, double value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void append_integer(std::string& out, int64_t value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Tag values escape spaces, commas and equals signs
+void append_escaped(std::string& out, const std::string& value) {
+    for (char c : value) {
+        if (c == ' ' || c == ',' || c == '=') {
+            out += '\\';
+        }
+        out += c;
+    }
+}
+
+// InfluxDB rejects a tag with an empty value, so such tags are left out
+void append_tag(std::string& out, const char* key, const std::string& value) {
+    if (value.empty()) return;
+    out += ',';
+    out += key;
+    out += '=';
+    append_escaped(out, value);
+}
+
+void append_tag(std::string& out, const char* key, int64_t value) {
+    out += ',';
+    out += key;
+    out += '=';
+    append_integer(out, value);
+}
+
+// Fields follow the tags after a space and are comma separated. InfluxDB
+// cannot store NaN or infinity, so those fields are left out.
+void append_field(std::string& out, bool& first_field, const char* key, double value) {
+    if (!std::isfinite(value)) return;
+    out += first_field ? ' ' : ',';
+    first_field = false;
+    out += key;
+    out += '=';
+    append_double(out, value);
+}
+
+// Ends the line begun at start with its timestamp. A line without fields is
+// invalid and is removed again; returns whether the line was kept.
+bool finish_line(std::string& out, size_t start, bool no_fields, int64_t timestamp) {
+    if (no_fields) {
+        out.resize(start);
+        return false;
+    }
+    out += ' ';
+    append_integer(out, timestamp);
+    return true;
+}
+
+// Owns the writer thread's HTTP handle and gzip stream so every request
+// reuses the same connection and buffers
+class InfluxWriter {
+public:
+    InfluxWriter(const std::string& url, bool compress) : url_(url), compress_(compress) {
+        curl_ = curl_easy_init();
+        headers_ = curl_slist_append(headers_, "Content-Type: text/plain; charset=utf-8");
+        if (compress_) {
+            headers_ = curl_slist_append(headers_, "Content-Encoding: gzip");
+            // windowBits 15 + 16 selects the gzip wrapper
+            zstream_ready_ = deflateInit2(&zstream_, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8,
+                                          Z_DEFAULT_STRATEGY) == Z_OK;
+        }
+        if (curl_) {
+            curl_easy_setopt(curl_, CURLOPT_URL, url_.c_str());
+            curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers_);
+            curl_easy_setopt(curl_, CURLOPT_TIMEOUT, 10L);
+            curl_easy_setopt(curl_, CURLOPT_CONNECTTIMEOUT, 3L);
+            curl_easy_setopt(curl_, CURLOPT_NOSIGNAL, 1L);
+        }
+    }
+
+    ~InfluxWriter() {
+        if (zstream_ready_) {
+            deflateEnd(&zstream_);
+        }
+        curl_slist_free_all(headers_);
+        if (curl_) {
+            curl_easy_cleanup(curl_);
+        }
+    }
+
+    InfluxWriter(const InfluxWriter&) = delete;
+    InfluxWriter& operator=(const InfluxWriter&) = delete;
+
+    InfluxWriteResult write(const std::string& body) {
+        if (!curl_) {
+            utils::Logger::error("Failed to initialize CURL for InfluxDB");
+            return InfluxWriteResult::RETRYABLE;
+        }
+
+        const std::string* payload = &body;
+        if (compress_) {
+            if (!zstream_ready_ || !gzip(body)) {
+                utils::Logger::error("Failed to gzip InfluxDB batch");
+                return InfluxWriteResult::RETRYABLE;
+            }
+            payload = &compressed_;
+        }
+        curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, payload->data());
+        curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, static_cast<long>(payload->size()));
+
+        CURLcode res = curl_easy_perform(curl_);
+        if (res != CURLE_OK) {
+            utils::Logger::error("InfluxDB write failed: {}", curl_easy_strerror(res));
+            return InfluxWriteResult::RETRYABLE;
+        }
+        long response_code = 0;
+        curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &response_code);
+        if (response_code >= 400) {
+            // Server errors, timeouts and rate limits pass; any other 4xx
+            // (bad line protocol, auth, payload too large) refuses the payload
+            bool retryable = response_code >= 500 || response_code == 408 || response_code == 429;
+            utils::Logger::error("InfluxDB write failed: HTTP {}", response_code);
+            return retryable ? InfluxWriteResult::RETRYABLE : InfluxWriteResult::REJECTED;
+        }
+        return InfluxWriteResult::WRITTEN;
+    }
+
+private:
+    bool gzip(const std::string& body) {
+        deflateReset(&zstream_);
+        compressed_.resize(deflateBound(&zstream_, body.size()));
+        zstream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data()));
+        zstream_.avail_in = static_cast<uInt>(body.size());
+        zstream_.next_out = reinterpret_cast<Bytef*>(&compressed_[0]);
+        zstream_.avail_out = static_cast<uInt>(compressed_.size());
+        // deflateBound leaves room for the whole stream, so one call finishes it
+        if (deflate(&zstream_, Z_FINISH) != Z_STREAM_END) {
+            return false;
+        }
+        compressed_.resize(zstream_.total_out);
+        return true;
+    }
+
+    std::string url_;
+    bool compress_;
+    CURL* curl_ = nullptr;
+    struct curl_slist* headers_ = nullptr;
+    z_stream zstream_{};
+    bool zstream_ready_ = false;
+    std::string compressed_;
+};
+
+} // namespace
+
 // TradeLogger Implementation
 struct TradeLogger::Implementation {
     std::string influxdb_url;
@@ -18,39 +196,171 @@ struct TradeLogger::Implementation {
     std::string log_directory;
     
     // Configuration
-    size_t batch_size = 100;
-    std::chrono::seconds flush_interval{10};
+    size_t batch_size = 5000;
+    size_t batch_bytes = 256 * 1024;
+    std::chrono::milliseconds flush_interval{1000};
+    std::chrono::hours journal_retention{168}; // zero keeps every partition
+    size_t max_backlog_bytes = 64 * 1024 * 1024;
+    bool compression_enabled = true;
     bool file_logging_enabled = true;
     bool database_logging_enabled = true;
     
-    // Buffering
-    std::queue<std::string> pending_logs;
+    // Group commit: producers append to the open batch; full or stale
+    // batches are sealed into the backlog, which the writer thread drains
+    std::unique_ptr<LineBatch> open_batch = std::make_unique<LineBatch>();
+    std::deque<std::unique_ptr<LineBatch>> backlog;
+    std::vector<std::unique_ptr<LineBatch>> free_batches;
+    size_t backlog_bytes = 0;
+    size_t backlog_lines = 0;
+    bool writing = false;
     std::mutex pending_mutex;
     std::condition_variable pending_cv;
+    std::condition_variable drained_cv;
+    
+    // Spill file for batches that do not fit in the backlog
+    std::string spill_path;
+    std::FILE* spill_file = nullptr;
+    std::mutex spill_mutex;
+    std::atomic<bool> spill_present{false};
+    uint64_t replay_offset = 0; // writer thread only
+    std::string replay_buffer;  // writer thread only
     
     // Background processing
     std::thread background_thread;
     std::atomic<bool> running{false};
+    std::unique_ptr<InfluxWriter> writer;
+    
+    // Local columnar copy of trade executions that answers history and
+    // analytics queries; persisted by the writer thread
+    TradeJournal journal;
+    std::chrono::steady_clock::time_point journal_flushed_at;
+    std::chrono::steady_clock::time_point journal_compacted_at;
     
     // Statistics
     std::atomic<size_t> total_logs_written{0};
+    std::atomic<size_t> spilled_batches{0};
+    std::atomic<size_t> dropped_logs{0};
+    std::atomic<size_t> rejected_logs{0};
+    std::atomic<uint64_t> write_failures{0};
     std::atomic<bool> healthy{true};
     
     // File handles
     std::unordered_map<std::string, std::unique_ptr<std::ofstream>> log_files;
     mutable std::shared_mutex mutex;
+    
+    std::string replay_path() const { return spill_path + ".replay"; }
+    std::string rejected_path() const { return spill_path + ".rejected"; }
+    
+    std::unique_ptr<LineBatch> take_free_batch() {
+        if (free_batches.empty()) {
+            auto batch = std::make_unique<LineBatch>();
+            batch->lines.reserve(batch_bytes + batch_bytes / 4);
+            return batch;
+        }
+        auto batch = std::move(free_batches.back());
+        free_batches.pop_back();
+        return batch;
+    }
+    
+    // Called with pending_mutex held. Returns the batch when the backlog has
+    // no room for it; the caller spills it after releasing the lock.
+    std::unique_ptr<LineBatch> seal_open_batch() {
+        auto batch = std::move(open_batch);
+        open_batch = take_free_batch();
+        if (backlog_bytes + batch->lines.size() > max_backlog_bytes) {
+            return batch;
+        }
+        backlog_bytes += batch->lines.size();
+        backlog_lines += batch->count;
+        backlog.push_back(std::move(batch));
+        pending_cv.notify_one();
+        return nullptr;
+    }
+    
+    void recycle(std::unique_ptr<LineBatch> batch) {
+        batch->lines.clear();
+        batch->count = 0;
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        free_batches.push_back(std::move(batch));
+    }
+    
+    // Appends the batch to the spill file. Writes go to the page cache, so a
+    // producer that has to spill is not held up by InfluxDB.
+    void spill(std::unique_ptr<LineBatch> batch) {
+        bool spilled = false;
+        {
+            std::lock_guard<std::mutex> lock(spill_mutex);
+            if (!spill_path.empty()) {
+                if (!spill_file) {
+                    spill_file = std::fopen(spill_path.c_str(), "ab");
+                }
+                if (spill_file) {
+                    uint32_t header[2] = {static_cast<uint32_t>(batch->count),
+                                          static_cast<uint32_t>(batch->lines.size())};
+                    spilled = std::fwrite(header, sizeof(header), 1, spill_file) == 1 &&
+                              std::fwrite(batch->lines.data(), 1, batch->lines.size(), spill_file) ==
+                                  batch->lines.size() &&
+                              std::fflush(spill_file) == 0;
+                }
+            }
+            if (spilled) {
+                spill_present = true;
+            }
+        }
+        
+        if (spilled) {
+            spilled_batches++;
+        } else {
+            dropped_logs += batch->count;
+            utils::Logger::error("Dropped {} trade log lines: InfluxDB backlog full and spill file unavailable",
+                                 batch->count);
+        }
+        recycle(std::move(batch));
+    }
+    
+    // Sets aside lines InfluxDB rejected, for inspection; retrying them would
+    // stall every batch behind them. On a 400 InfluxDB has still stored the
+    // batch's valid points, so the file holds the whole batch as sent.
+    void reject(const std::string& lines, size_t count) {
+        rejected_logs += count;
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(spill_mutex);
+            if (!spill_path.empty()) {
+                std::FILE* file = std::fopen(rejected_path().c_str(), "ab");
+                if (file) {
+                    bool kept = std::fwrite(lines.data(), 1, lines.size(), file) == lines.size();
+                    if (std::fclose(file) == 0 && kept) {
+                        path = rejected_path();
+                    }
+                }
+            }
+        }
+        
+        if (path.empty()) {
+            utils::Logger::error("InfluxDB rejected {} trade log lines; dropped", count);
+        } else {
+            utils::Logger::error("InfluxDB rejected {} trade log lines; moved to {}", count, path);
+        }
+    }
 };
 
 TradeLogger::TradeLogger() : impl_(std::make_unique<Implementation>()) {}
 
 TradeLogger::~TradeLogger() {
     if (impl_->running) {
-        impl_->running = false;
+        {
+            std::lock_guard<std::mutex> lock(impl_->pending_mutex);
+            impl_->running = false;
+        }
         impl_->pending_cv.notify_all();
         if (impl_->background_thread.joinable()) {
             impl_->background_thread.join();
         }
     }
+    if (impl_->spill_file) {
+        std::fclose(impl_->spill_file);
+    }
 }
 
 bool TradeLogger::initialize(const std::string& influxdb_url, const std::string& database) {
@@ -58,6 +368,8 @@ bool TradeLogger::initialize(const std::string& influxdb_url, const std::string&
     
     impl_->influxdb_url = influxdb_url;
     impl_->database_name = database;
+    impl_->writer = std::make_unique<InfluxWriter>(influxdb_url + "/write?db=" + database,
+                                                   impl_->compression_enabled);
     impl_->running = true;
     
     // Start background processing thread
@@ -79,23 +391,38 @@ bool TradeLogger::initialize_file_logging(const std::string& log_directory) {
         std::filesystem::create_directories(log_directory);
     }
     
+    {
+        std::lock_guard<std::mutex> spill_lock(impl_->spill_mutex);
+        if (impl_->spill_path.empty()) {
+            impl_->spill_path = log_directory + "/influxdb_spill.lp";
+        }
+        // Batches spilled before a restart are replayed too
+        std::error_code ec;
+        impl_->spill_present = std::filesystem::exists(impl_->spill_path, ec) ||
+                               std::filesystem::exists(impl_->replay_path(), ec);
+    }
+    
+    impl_->journal.open(log_directory + "/journal");
+    
     utils::Logger::info("File logging initialized in directory: {}", log_directory);
     return true;
 }
 
 bool TradeLogger::log_trade_execution(const TradeExecution& execution) {
-    if (!impl_->database_logging_enabled && !impl_->file_logging_enabled) {
-        return true; // Nothing to do
-    }
-    
     try {
-        std::string log_entry;
+        impl_->journal.append(execution);
+        
+        if (!impl_->database_logging_enabled && !impl_->file_logging_enabled) {
+            return true; // Nothing else to do
+        }
         
         if (impl_->database_logging_enabled) {
-            log_entry = trade_execution_to_line_protocol(execution);
-            
-            std::lock_guard<std::mutex> lock(impl_->pending_mutex);
-            impl_->pending_logs.push(log_entry);
+            thread_local std::string line;
+            line.clear();
+            if (trade_execution_to_line_protocol(execution, line)) {
+                line += '\n';
+                enqueue_lines(line, 1);
+            }
         }
         
         if (impl_->file_logging_enabled) {
@@ -103,7 +430,6 @@ bool TradeLogger::log_trade_execution(const TradeExecution& execution) {
             write_to_file(csv_entry);
         }
         
-        impl_->pending_cv.notify_one();
         return true;
         
     } catch (const std::exception& e) {
@@ -114,13 +440,13 @@ bool TradeLogger::log_trade_execution(const TradeExecution& execution) {
 
 bool TradeLogger::log_arbitrage_opportunity(const ArbitrageOpportunity& opportunity) {
     try {
-        std::string line_protocol = arbitrage_opportunity_to_line_protocol(opportunity);
-        
-        std::lock_guard<std::mutex> lock(impl_->pending_mutex);
-        impl_->pending_logs.push(line_protocol);
-        impl_->pending_cv.notify_one();
-        
-        return true;
+        thread_local std::string line;
+        line.clear();
+        if (!arbitrage_opportunity_to_line_protocol(opportunity, line)) {
+            return true;
+        }
+        line += '\n';
+        return enqueue_lines(line, 1);
     } catch (const std::exception& e) {
         utils::Logger::error("Failed to log arbitrage opportunity: {}", e.what());
         return false;
@@ -129,13 +455,13 @@ bool TradeLogger::log_arbitrage_opportunity(const ArbitrageOpportunity& opportun
 
 bool TradeLogger::log_order_execution(const OrderExecutionDetails& order_details) {
     try {
-        std::string line_protocol = order_execution_to_line_protocol(order_details);
-        
-        std::lock_guard<std::mutex> lock(impl_->pending_mutex);
-        impl_->pending_logs.push(line_protocol);
-        impl_->pending_cv.notify_one();
-        
-        return true;
+        thread_local std::string line;
+        line.clear();
+        if (!order_execution_to_line_protocol(order_details, line)) {
+            return true;
+        }
+        line += '\n';
+        return enqueue_lines(line, 1);
     } catch (const std::exception& e) {
         utils::Logger::error("Failed to log order execution: {}", e.what());
         return false;
@@ -146,12 +472,16 @@ bool TradeLogger::log_trade_executions_batch(const std::vector<TradeExecution>&
     if (executions.empty()) return true;
     
     try {
-        std::vector<std::string> batch_logs;
-        batch_logs.reserve(executions.size());
+        thread_local std::string lines;
+        lines.clear();
+        size_t count = 0;
         
         for (const auto& execution : executions) {
-            if (impl_->database_logging_enabled) {
-                batch_logs.push_back(trade_execution_to_line_protocol(execution));
+            impl_->journal.append(execution);
+            
+            if (impl_->database_logging_enabled && trade_execution_to_line_protocol(execution, lines)) {
+                lines += '\n';
+                ++count;
             }
             
             if (impl_->file_logging_enabled) {
@@ -159,12 +489,8 @@ bool TradeLogger::log_trade_executions_batch(const std::vector<TradeExecution>&
             }
         }
         
-        if (!batch_logs.empty()) {
-            std::lock_guard<std::mutex> lock(impl_->pending_mutex);
-            for (const auto& log : batch_logs) {
-                impl_->pending_logs.push(log);
-            }
-            impl_->pending_cv.notify_one();
+        if (count > 0) {
+            enqueue_lines(lines, count);
         }
         
         return true;
@@ -174,26 +500,46 @@ bool TradeLogger::log_trade_executions_batch(const std::vector<TradeExecution>&
     }
 }
 
+bool TradeLogger::log_order_executions_batch(const std::vector<OrderExecutionDetails>& orders) {
+    if (orders.empty()) return true;
+    
+    try {
+        thread_local std::string lines;
+        lines.clear();
+        size_t count = 0;
+        for (const auto& order : orders) {
+            if (order_execution_to_line_protocol(order, lines)) {
+                lines += '\n';
+                ++count;
+            }
+        }
+        return count == 0 || enqueue_lines(lines, count);
+    } catch (const std::exception& e) {
+        utils::Logger::error("Failed to log order executions batch: {}", e.what());
+        return false;
+    }
+}
+
 bool TradeLogger::log_performance_metrics(const TradingStatistics& stats) {
     try {
-        std::ostringstream oss;
         auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count();
         
-        oss << "trading_performance"
-            << " total_opportunities=" << stats.total_opportunities_detected.load()
-            << ",total_executed=" << stats.total_opportunities_executed.load()
-            << ",successful_trades=" << stats.total_successful_trades.load()
-            << ",failed_trades=" << stats.total_failed_trades.load()
-            << ",total_profit=" << stats.total_profit_loss.load()
-            << ",total_fees=" << stats.total_fees_paid.load()
-            << ",success_rate=" << stats.success_rate.load()
-            << ",avg_execution_time=" << stats.average_execution_time.load().count()
-            << " " << timestamp;
-        
-        std::lock_guard<std::mutex> lock(impl_->pending_mutex);
-        impl_->pending_logs.push(oss.str());
-        impl_->pending_cv.notify_one();
+        thread_local std::string line;
+        line.clear();
+        bool first_field = true;
+        line += "trading_performance";
+        append_field(line, first_field, "total_opportunities", static_cast<double>(stats.total_opportunities_detected.load()));
+        append_field(line, first_field, "total_executed", static_cast<double>(stats.total_opportunities_executed.load()));
+        append_field(line, first_field, "successful_trades", static_cast<double>(stats.total_successful_trades.load()));
+        append_field(line, first_field, "failed_trades", static_cast<double>(stats.total_failed_trades.load()));
+        append_field(line, first_field, "total_profit", stats.total_profit_loss.load());
+        append_field(line, first_field, "total_fees", stats.total_fees_paid.load());
+        append_field(line, first_field, "success_rate", stats.success_rate.load());
+        append_field(line, first_field, "avg_execution_time", static_cast<double>(stats.average_execution_time.load().count()));
+        finish_line(line, 0, first_field, timestamp);
+        line += '\n';
+        enqueue_lines(line, 1);
         
         return true;
     } catch (const std::exception& e) {
@@ -202,62 +548,128 @@ bool TradeLogger::log_performance_metrics(const TradingStatistics& stats) {
     }
 }
 
+// History and analytics are answered from the local journal, so they cost
+// no round trip to InfluxDB and keep working while it is unavailable
 std::vector<TradeExecution> TradeLogger::query_trade_history(std::chrono::hours lookback) {
-    // In a real implementation, this would query InfluxDB
-    // For now, return empty vector as this is a complex query operation
-    utils::Logger::warn("Trade history queries not implemented yet");
-    return {};
+    auto now = std::chrono::system_clock::now();
+    return impl_->journal.query_trades(now - lookback, now);
+}
+
+std::vector<TradeExecution> TradeLogger::query_trades_by_symbol(const std::string& symbol, std::chrono::hours lookback) {
+    auto now = std::chrono::system_clock::now();
+    return impl_->journal.query_trades_by_symbol(symbol, now - lookback, now);
 }
 
 double TradeLogger::calculate_total_profit(std::chrono::hours period) {
-    // This would query InfluxDB for profit calculations
-    utils::Logger::warn("Profit calculations from database not implemented yet");
-    return 0.0;
+    auto now = std::chrono::system_clock::now();
+    return impl_->journal.total_profit(now - period, now);
 }
 
 double TradeLogger::calculate_success_rate(std::chrono::hours period) {
-    // This would query InfluxDB for success rate calculations  
-    utils::Logger::warn("Success rate calculations from database not implemented yet");
-    return 0.0;
+    auto now = std::chrono::system_clock::now();
+    return impl_->journal.success_rate(now - period, now);
 }
 
-bool TradeLogger::flush_pending_logs() {
-    std::lock_guard<std::mutex> lock(impl_->pending_mutex);
-    
-    if (impl_->pending_logs.empty()) {
-        return true;
+std::unordered_map<std::string, double> TradeLogger::get_profit_by_symbol(std::chrono::hours period) {
+    auto now = std::chrono::system_clock::now();
+    return impl_->journal.profit_by_symbol(now - period, now);
+}
+
+std::unordered_map<std::string, double> TradeLogger::get_volume_by_exchange(std::chrono::hours period) {
+    auto now = std::chrono::system_clock::now();
+    return impl_->journal.volume_by_exchange(now - period, now);
+}
+
+bool TradeLogger::compact_old_data(std::chrono::hours max_age) {
+    size_t dropped = impl_->journal.drop_partitions_before(std::chrono::system_clock::now() - max_age);
+    if (dropped > 0) {
+        utils::Logger::info("Dropped {} trade journal partitions older than {}h", dropped, max_age.count());
     }
+    return true;
+}
+
+bool TradeLogger::flush_pending_logs() {
+    std::unique_lock<std::mutex> lock(impl_->pending_mutex);
     
-    // Process all pending logs
-    std::vector<std::string> batch;
-    while (!impl_->pending_logs.empty()) {
-        batch.push_back(impl_->pending_logs.front());
-        impl_->pending_logs.pop();
+    if (impl_->open_batch->count > 0) {
+        auto overflow = impl_->seal_open_batch();
+        if (overflow) {
+            lock.unlock();
+            impl_->spill(std::move(overflow));
+            lock.lock();
+        }
     }
     
-    // Write batch to InfluxDB
-    for (const auto& log : batch) {
-        if (!write_to_influxdb("trade_data", log)) {
-            utils::Logger::error("Failed to write log to InfluxDB");
-            return false;
-        }
+    // Wait for the writer to drain the backlog, or give up on its next failure
+    bool drained = impl_->backlog.empty() && !impl_->writing;
+    if (impl_->running) {
+        uint64_t failures = impl_->write_failures.load();
+        impl_->drained_cv.wait(lock, [this, failures]() {
+            return (impl_->backlog.empty() && !impl_->writing) ||
+                   impl_->write_failures.load() != failures || !impl_->running;
+        });
+        drained = impl_->backlog.empty() && !impl_->writing;
     }
+    lock.unlock();
     
+    impl_->journal.flush();
     flush_file_buffers();
-    return true;
+    return drained;
 }
 
 size_t TradeLogger::get_pending_log_count() const {
     std::lock_guard<std::mutex> lock(impl_->pending_mutex);
-    return impl_->pending_logs.size();
+    return impl_->open_batch->count + impl_->backlog_lines;
 }
 
 void TradeLogger::set_batch_size(size_t batch_size) {
-    impl_->batch_size = batch_size;
+    std::lock_guard<std::mutex> lock(impl_->pending_mutex);
+    impl_->batch_size = std::max<size_t>(batch_size, 1);
 }
 
-void TradeLogger::set_flush_interval(std::chrono::seconds interval) {
-    impl_->flush_interval = interval;
+void TradeLogger::set_batch_bytes(size_t batch_bytes) {
+    std::lock_guard<std::mutex> lock(impl_->pending_mutex);
+    impl_->batch_bytes = std::max<size_t>(batch_bytes, 1024);
+}
+
+void TradeLogger::set_flush_interval(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(impl_->pending_mutex);
+    impl_->flush_interval = std::max(interval, std::chrono::milliseconds(10));
+}
+
+void TradeLogger::set_max_backlog_bytes(size_t max_backlog_bytes) {
+    std::lock_guard<std::mutex> lock(impl_->pending_mutex);
+    impl_->max_backlog_bytes = max_backlog_bytes;
+}
+
+void TradeLogger::set_journal_retention(std::chrono::hours retention) {
+    std::lock_guard<std::mutex> lock(impl_->pending_mutex);
+    impl_->journal_retention = std::max(retention, std::chrono::hours(0));
+}
+
+void TradeLogger::set_spill_path(const std::string& path) {
+    std::lock_guard<std::mutex> lock(impl_->spill_mutex);
+    if (impl_->spill_file) {
+        std::fclose(impl_->spill_file);
+        impl_->spill_file = nullptr;
+    }
+    impl_->spill_path = path;
+    std::error_code ec;
+    impl_->spill_present = !path.empty() && (std::filesystem::exists(path, ec) ||
+                                             std::filesystem::exists(impl_->replay_path(), ec));
+}
+
+// Takes effect for writers created by initialize()
+void TradeLogger::enable_compression(bool enable) {
+    impl_->compression_enabled = enable;
+}
+
+void TradeLogger::enable_file_logging(bool enable) {
+    impl_->file_logging_enabled = enable;
+}
+
+void TradeLogger::enable_database_logging(bool enable) {
+    impl_->database_logging_enabled = enable;
 }
 
 bool TradeLogger::is_healthy() const {
@@ -270,6 +682,10 @@ std::string TradeLogger::get_status() const {
     oss << "  Database logging: " << (impl_->database_logging_enabled ? "enabled" : "disabled") << "\n";
     oss << "  File logging: " << (impl_->file_logging_enabled ? "enabled" : "disabled") << "\n";
     oss << "  Pending logs: " << get_pending_log_count() << "\n";
+    oss << "  Backlog bytes: " << get_backlog_bytes() << "\n";
+    oss << "  Spilled batches: " << impl_->spilled_batches.load() << "\n";
+    oss << "  Dropped logs: " << impl_->dropped_logs.load() << "\n";
+    oss << "  Rejected logs: " << impl_->rejected_logs.load() << "\n";
     oss << "  Total logs written: " << impl_->total_logs_written.load() << "\n";
     oss << "  Healthy: " << (impl_->healthy.load() ? "yes" : "no");
     return oss.str();
@@ -279,112 +695,117 @@ size_t TradeLogger::get_total_logs_written() const {
     return impl_->total_logs_written.load();
 }
 
+size_t TradeLogger::get_backlog_bytes() const {
+    std::lock_guard<std::mutex> lock(impl_->pending_mutex);
+    return impl_->backlog_bytes + impl_->open_batch->lines.size();
+}
+
+size_t TradeLogger::get_spilled_batches() const {
+    return impl_->spilled_batches.load();
+}
+
+size_t TradeLogger::get_dropped_logs() const {
+    return impl_->dropped_logs.load();
+}
+
+size_t TradeLogger::get_rejected_logs() const {
+    return impl_->rejected_logs.load();
+}
+
 // Private method implementations
-bool TradeLogger::write_to_influxdb(const std::string& measurement, const std::string& line_protocol) {
-    if (impl_->influxdb_url.empty()) {
-        return false;
-    }
-    
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        utils::Logger::error("Failed to initialize CURL for InfluxDB");
-        return false;
+InfluxWriteResult TradeLogger::write_to_influxdb(const std::string& measurement, const std::string& line_protocol) {
+    if (impl_->influxdb_url.empty() || !impl_->writer) {
+        return InfluxWriteResult::RETRYABLE;
     }
-    
-    // Construct InfluxDB write URL
-    std::string url = impl_->influxdb_url + "/write?db=" + impl_->database_name;
-    
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, line_protocol.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, line_protocol.length());
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-    
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: text/plain");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    
-    CURLcode res = curl_easy_perform(curl);
-    long response_code;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
-    
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-    
-    if (res != CURLE_OK || response_code >= 400) {
-        utils::Logger::error("InfluxDB write failed: {} (HTTP {})", curl_easy_strerror(res), response_code);
-        return false;
-    }
-    
-    impl_->total_logs_written++;
-    return true;
+    return impl_->writer->write(line_protocol);
 }
 
-std::string TradeLogger::trade_execution_to_line_protocol(const TradeExecution& execution) {
-    std::ostringstream oss;
+bool TradeLogger::trade_execution_to_line_protocol(const TradeExecution& execution, std::string& out) {
     auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
         execution.timestamp.time_since_epoch()).count();
+    size_t start = out.size();
+    bool first_field = true;
     
-    oss << "trade_execution"
-        << ",trade_id=" << escape_string_for_influx(execution.trade_id)
-        << ",symbol=" << escape_string_for_influx(execution.symbol)
-        << ",buy_exchange=" << escape_string_for_influx(execution.buy_exchange)
-        << ",sell_exchange=" << escape_string_for_influx(execution.sell_exchange)
-        << ",result=" << static_cast<int>(execution.result)
-        << " buy_price=" << execution.buy_price
-        << ",sell_price=" << execution.sell_price
-        << ",quantity=" << execution.quantity
-        << ",executed_quantity=" << execution.executed_quantity
-        << ",expected_profit=" << execution.expected_profit
-        << ",actual_profit=" << execution.actual_profit
-        << ",total_fees=" << execution.total_fees
-        << ",execution_latency=" << execution.execution_latency.count()
-        << " " << timestamp;
-    
-    return oss.str();
+    out += "trade_execution";
+    append_tag(out, "trade_id", execution.trade_id);
+    append_tag(out, "symbol", execution.symbol);
+    append_tag(out, "buy_exchange", execution.buy_exchange);
+    append_tag(out, "sell_exchange", execution.sell_exchange);
+    append_tag(out, "result", static_cast<int>(execution.result));
+    append_field(out, first_field, "buy_price", execution.buy_price);
+    append_field(out, first_field, "sell_price", execution.sell_price);
+    append_field(out, first_field, "quantity", execution.quantity);
+    append_field(out, first_field, "executed_quantity", execution.executed_quantity);
+    append_field(out, first_field, "expected_profit", execution.expected_profit);
+    append_field(out, first_field, "actual_profit", execution.actual_profit);
+    append_field(out, first_field, "total_fees", execution.total_fees);
+    append_field(out, first_field, "execution_latency", static_cast<double>(execution.execution_latency.count()));
+    return finish_line(out, start, first_field, timestamp);
 }
 
-std::string TradeLogger::order_execution_to_line_protocol(const OrderExecutionDetails& order) {
-    std::ostringstream oss;
+bool TradeLogger::order_execution_to_line_protocol(const OrderExecutionDetails& order, std::string& out) {
     auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
         order.submitted_at.time_since_epoch()).count();
+    size_t start = out.size();
+    bool first_field = true;
     
-    oss << "order_execution"
-        << ",order_id=" << escape_string_for_influx(order.order_id)
-        << ",exchange_order_id=" << escape_string_for_influx(order.exchange_order_id)
-        << ",exchange=" << escape_string_for_influx(order.original_order.exchange)
-        << ",symbol=" << escape_string_for_influx(order.original_order.symbol)
-        << ",side=" << static_cast<int>(order.original_order.side)
-        << ",status=" << static_cast<int>(order.status)
-        << " filled_quantity=" << order.filled_quantity
-        << ",remaining_quantity=" << order.remaining_quantity
-        << ",average_fill_price=" << order.average_fill_price
-        << ",total_fees=" << order.total_fees
-        << ",execution_latency=" << order.execution_latency.count()
-        << " " << timestamp;
-    
-    return oss.str();
+    out += "order_execution";
+    append_tag(out, "order_id", order.order_id);
+    append_tag(out, "exchange_order_id", order.exchange_order_id);
+    append_tag(out, "exchange", order.original_order.exchange);
+    append_tag(out, "symbol", order.original_order.symbol);
+    append_tag(out, "side", static_cast<int>(order.original_order.side));
+    append_tag(out, "status", static_cast<int>(order.status));
+    append_field(out, first_field, "filled_quantity", order.filled_quantity);
+    append_field(out, first_field, "remaining_quantity", order.remaining_quantity);
+    append_field(out, first_field, "average_fill_price", order.average_fill_price);
+    append_field(out, first_field, "total_fees", order.total_fees);
+    append_field(out, first_field, "execution_latency", static_cast<double>(order.execution_latency.count()));
+    return finish_line(out, start, first_field, timestamp);
 }
 
-std::string TradeLogger::arbitrage_opportunity_to_line_protocol(const ArbitrageOpportunity& opportunity) {
-    std::ostringstream oss;
+bool TradeLogger::arbitrage_opportunity_to_line_protocol(const ArbitrageOpportunity& opportunity, std::string& out) {
     auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
         opportunity.detected_at.time_since_epoch()).count();
+    size_t start = out.size();
+    bool first_field = true;
     
-    oss << "arbitrage_opportunity"
-        << ",symbol=" << escape_string_for_influx(opportunity.symbol)
-        << ",buy_exchange=" << escape_string_for_influx(opportunity.buy_exchange)
-        << ",sell_exchange=" << escape_string_for_influx(opportunity.sell_exchange)
-        << " buy_price=" << opportunity.buy_price
-        << ",sell_price=" << opportunity.sell_price
-        << ",available_quantity=" << opportunity.available_quantity
-        << ",spread_percentage=" << opportunity.spread_percentage
-        << ",expected_profit=" << opportunity.expected_profit
-        << ",confidence_score=" << opportunity.confidence_score
-        << ",estimated_slippage=" << opportunity.estimated_slippage
-        << ",total_fees=" << opportunity.total_fees
-        << " " << timestamp;
-    
-    return oss.str();
+    out += "arbitrage_opportunity";
+    append_tag(out, "symbol", opportunity.symbol);
+    append_tag(out, "buy_exchange", opportunity.buy_exchange);
+    append_tag(out, "sell_exchange", opportunity.sell_exchange);
+    append_field(out, first_field, "buy_price", opportunity.buy_price);
+    append_field(out, first_field, "sell_price", opportunity.sell_price);
+    append_field(out, first_field, "available_quantity", opportunity.available_quantity);
+    append_field(out, first_field, "spread_percentage", opportunity.spread_percentage);
+    append_field(out, first_field, "expected_profit", opportunity.expected_profit);
+    append_field(out, first_field, "confidence_score", opportunity.confidence_score);
+    append_field(out, first_field, "estimated_slippage", opportunity.estimated_slippage);
+    append_field(out, first_field, "total_fees", opportunity.total_fees);
+    return finish_line(out, start, first_field, timestamp);
+}
+
+// Appends newline-terminated lines to the open batch. Callers only copy into
+// a reused buffer under the lock; a full backlog costs them a page-cache
+// append to the spill file, never a wait on InfluxDB.
+bool TradeLogger::enqueue_lines(const std::string& lines, size_t count) {
+    std::unique_ptr<LineBatch> overflow;
+    {
+        std::lock_guard<std::mutex> lock(impl_->pending_mutex);
+        LineBatch& batch = *impl_->open_batch;
+        if (batch.count == 0) {
+            batch.opened_at = std::chrono::steady_clock::now();
+        }
+        batch.lines += lines;
+        batch.count += count;
+        if (batch.count >= impl_->batch_size || batch.lines.size() >= impl_->batch_bytes) {
+            overflow = impl_->seal_open_batch();
+        }
+    }
+    if (overflow) {
+        impl_->spill(std::move(overflow));
+    }
+    return true;
 }
 
 bool TradeLogger::write_to_file(const std::string& log_entry) {
@@ -448,39 +869,205 @@ std::string TradeLogger::create_log_filename(const std::string& prefix) {
 }
 
 void TradeLogger::process_pending_logs() {
-    while (impl_->running) {
-        std::unique_lock<std::mutex> lock(impl_->pending_mutex);
-        
-        // Wait for logs or shutdown
+    const auto max_retry_delay = std::chrono::milliseconds(30000);
+    auto retry_delay = std::chrono::milliseconds(100);
+    std::unique_lock<std::mutex> lock(impl_->pending_mutex);
+    
+    while (true) {
         impl_->pending_cv.wait_for(lock, impl_->flush_interval, [this]() {
-            return !impl_->pending_logs.empty() || !impl_->running;
+            return !impl_->backlog.empty() || !impl_->running;
         });
         
-        if (!impl_->running) break;
+        auto now = std::chrono::steady_clock::now();
+        if (now - impl_->journal_flushed_at >= impl_->flush_interval || !impl_->running) {
+            impl_->journal_flushed_at = now;
+            auto retention = impl_->journal_retention;
+            bool compact = retention.count() > 0 && now - impl_->journal_compacted_at >= JOURNAL_COMPACTION_PERIOD;
+            if (compact) {
+                impl_->journal_compacted_at = now;
+            }
+            lock.unlock();
+            impl_->journal.flush();
+            if (compact) {
+                compact_old_data(retention);
+            }
+            lock.lock();
+        }
         
-        // Process logs in batches
-        std::vector<std::string> batch;
-        size_t batch_count = 0;
+        // Time trigger: a batch that has been open a full interval is sent as is
+        LineBatch& open = *impl_->open_batch;
+        if (open.count > 0 &&
+            (!impl_->running || std::chrono::steady_clock::now() - open.opened_at >= impl_->flush_interval)) {
+            auto overflow = impl_->seal_open_batch();
+            if (overflow) {
+                lock.unlock();
+                impl_->spill(std::move(overflow));
+                lock.lock();
+            }
+        }
         
-        while (!impl_->pending_logs.empty() && batch_count < impl_->batch_size) {
-            batch.push_back(impl_->pending_logs.front());
-            impl_->pending_logs.pop();
-            batch_count++;
+        if (impl_->backlog.empty()) {
+            if (!impl_->running) break;
+            if (impl_->spill_present) {
+                lock.unlock();
+                bool replayed = replay_spilled_logs();
+                lock.lock();
+                if (!replayed) {
+                    impl_->pending_cv.wait_for(lock, retry_delay, [this]() { return !impl_->running; });
+                    retry_delay = std::min(retry_delay * 2, max_retry_delay);
+                }
+            }
+            continue;
         }
         
+        // The batch stays counted in the backlog until InfluxDB accepts it
+        std::unique_ptr<LineBatch> batch = std::move(impl_->backlog.front());
+        impl_->backlog.pop_front();
+        impl_->writing = true;
         lock.unlock();
         
-        // Write batch to InfluxDB
-        if (!batch.empty()) {
-            for (const auto& log : batch) {
-                if (!write_to_influxdb("trade_data", log)) {
-                    impl_->healthy = false;
-                    utils::Logger::error("Failed to write batch to InfluxDB");
-                    break;
-                }
+        InfluxWriteResult result = write_to_influxdb("trade_data", batch->lines);
+        
+        lock.lock();
+        impl_->writing = false;
+        if (result == InfluxWriteResult::REJECTED) {
+            // InfluxDB is up but refuses this batch; retrying would stall the backlog
+            impl_->backlog_bytes -= batch->lines.size();
+            impl_->backlog_lines -= batch->count;
+            retry_delay = std::chrono::milliseconds(100);
+            impl_->drained_cv.notify_all();
+            lock.unlock();
+            impl_->reject(batch->lines, batch->count);
+            impl_->recycle(std::move(batch));
+            lock.lock();
+            continue;
+        }
+        if (result == InfluxWriteResult::WRITTEN) {
+            impl_->backlog_bytes -= batch->lines.size();
+            impl_->backlog_lines -= batch->count;
+            impl_->total_logs_written += batch->count;
+            impl_->healthy = true;
+            retry_delay = std::chrono::milliseconds(100);
+            batch->lines.clear();
+            batch->count = 0;
+            impl_->free_batches.push_back(std::move(batch));
+            impl_->drained_cv.notify_all();
+            continue;
+        }
+        
+        impl_->healthy = false;
+        impl_->write_failures++;
+        impl_->drained_cv.notify_all();
+        
+        if (!impl_->running) {
+            // Shutting down with InfluxDB unavailable: keep everything on disk
+            impl_->backlog.push_front(std::move(batch));
+            while (!impl_->backlog.empty()) {
+                auto pending = std::move(impl_->backlog.front());
+                impl_->backlog.pop_front();
+                impl_->backlog_bytes -= pending->lines.size();
+                impl_->backlog_lines -= pending->count;
+                lock.unlock();
+                impl_->spill(std::move(pending));
+                lock.lock();
+            }
+            continue;
+        }
+        
+        impl_->backlog.push_front(std::move(batch));
+        impl_->pending_cv.wait_for(lock, retry_delay, [this]() { return !impl_->running; });
+        retry_delay = std::min(retry_delay * 2, max_retry_delay);
+    }
+}
+
+// Sends spilled batches back to InfluxDB, oldest first. The spill file is
+// renamed before replay so producers can keep spilling into a fresh one.
+// Returns false when a write fails; the position is kept for the next try.
+// Points are keyed by series and timestamp, so a batch replayed twice after
+// a crash overwrites itself rather than duplicating.
+bool TradeLogger::replay_spilled_logs() {
+    const std::string replay_path = impl_->replay_path();
+    std::error_code ec;
+    {
+        std::lock_guard<std::mutex> lock(impl_->spill_mutex);
+        impl_->spill_present = false;
+        if (!std::filesystem::exists(replay_path, ec)) {
+            if (impl_->spill_file) {
+                std::fclose(impl_->spill_file);
+                impl_->spill_file = nullptr;
+            }
+            if (!std::filesystem::exists(impl_->spill_path, ec)) {
+                return true;
             }
+            std::filesystem::rename(impl_->spill_path, replay_path, ec);
+            if (ec) {
+                utils::Logger::error("Failed to rotate InfluxDB spill file: {}", ec.message());
+                impl_->spill_present = true;
+                return false;
+            }
+            impl_->replay_offset = 0;
         }
     }
+    
+    std::FILE* file = std::fopen(replay_path.c_str(), "rb");
+    if (!file) {
+        impl_->spill_present = true;
+        return false;
+    }
+    std::fseek(file, static_cast<long>(impl_->replay_offset), SEEK_SET);
+    
+    bool failed = false;
+    bool interrupted = false;
+    size_t replayed = 0;
+    while (impl_->running) {
+        uint32_t header[2];
+        if (std::fread(header, sizeof(header), 1, file) != 1) {
+            break;
+        }
+        impl_->replay_buffer.resize(header[1]);
+        if (std::fread(&impl_->replay_buffer[0], 1, header[1], file) != header[1]) {
+            break; // torn record from a crash mid-append
+        }
+        InfluxWriteResult result = write_to_influxdb("trade_data", impl_->replay_buffer);
+        if (result == InfluxWriteResult::RETRYABLE) {
+            impl_->healthy = false;
+            failed = true;
+            break;
+        }
+        impl_->replay_offset += SPILL_RECORD_HEADER + header[1];
+        if (result == InfluxWriteResult::REJECTED) {
+            impl_->reject(impl_->replay_buffer, header[0]);
+        } else {
+            impl_->healthy = true;
+            impl_->total_logs_written += header[0];
+            replayed += header[0];
+        }
+        
+        // Live batches go first; resume the replay once they are written
+        std::lock_guard<std::mutex> lock(impl_->pending_mutex);
+        if (!impl_->backlog.empty()) {
+            interrupted = true;
+            break;
+        }
+    }
+    bool reached_end = !failed && !interrupted && impl_->running;
+    std::fclose(file);
+    
+    if (replayed > 0) {
+        utils::Logger::info("Replayed {} spilled trade log lines to InfluxDB", replayed);
+    }
+    
+    std::lock_guard<std::mutex> lock(impl_->spill_mutex);
+    if (reached_end) {
+        std::filesystem::remove(replay_path, ec);
+        impl_->replay_offset = 0;
+        if (std::filesystem::exists(impl_->spill_path, ec)) {
+            impl_->spill_present = true;
+        }
+    } else {
+        impl_->spill_present = true;
+    }
+    return !failed;
 }
 
 void TradeLogger::flush_file_buffers() {
@@ -501,27 +1088,9 @@ std::string TradeLogger::format_timestamp(std::chrono::system_clock::time_point
 }
 
 std::string TradeLogger::escape_string_for_influx(const std::string& str) {
-    std::string escaped = str;
-    
-    // Escape spaces, commas, and equals signs
-    size_t pos = 0;
-    while ((pos = escaped.find(' ', pos)) != std::string::npos) {
-        escaped.replace(pos, 1, "\\ ");
-        pos += 2;
-    }
-    
-    pos = 0;
-    while ((pos = escaped.find(',', pos)) != std::string::npos) {
-        escaped.replace(pos, 1, "\\,");
-        pos += 2;
-    }
-    
-    pos = 0;
-    while ((pos = escaped.find('=', pos)) != std::string::npos) {
-        escaped.replace(pos, 1, "\\=");
-        pos += 2;
-    }
-    
+    std::string escaped;
+    escaped.reserve(str.size());
+    append_escaped(escaped, str);
     return escaped;
 }
 
@@ -2,8 +2,11 @@
 #include "order_router.hpp"
 #include "spread_calculator.hpp"
 #include "redis_subscriber.hpp"
+#include "opportunity_queue.hpp"
+#include "fill_simulator.hpp"
 #include "utils/logger.hpp"
 #include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <iomanip>
 #include <fstream>
@@ -24,7 +27,8 @@
 namespace ats {
 namespace trading_engine {
 
-TradingEngineService::TradingEngineService() {
+TradingEngineService::TradingEngineService()
+    : opportunity_queue_(std::make_unique<OpportunityQueue>(config_.max_queue_size, config_.opportunity_timeout)) {
     statistics_.session_start_time = std::chrono::system_clock::now();
 }
 
@@ -49,8 +53,19 @@ bool TradingEngineService::initialize(const config::ConfigManager& config) {
         config_.max_concurrent_trades = config.get_value<int>("trading_engine.max_concurrent_trades", 5);
         config_.worker_thread_count = config.get_value<int>("trading_engine.worker_thread_count", 4);
         config_.max_queue_size = config.get_value<size_t>("trading_engine.max_queue_size", 1000);
+        config_.opportunity_timeout = std::chrono::milliseconds(
+            config.get_value<int>("trading_engine.opportunity_timeout", 5000));
         config_.enable_paper_trading = config.get_value<bool>("trading_engine.enable_paper_trading", false);
+        config_.paper_trading_realtime = config.get_value<bool>("trading_engine.paper_realtime", false);
+        config_.exchange_fees = config.get_value<std::unordered_map<std::string, double>>(
+            "trading_engine.exchange_fees", {});
         config_.enable_rollback_on_failure = config.get_value<bool>("trading_engine.enable_rollback_on_failure", true);
+        config_.incremental_detection = config.get_value<bool>("trading_engine.incremental_detection", true);
+        
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            opportunity_queue_->set_limits(config_.max_queue_size, config_.opportunity_timeout);
+        }
         
         // Initialize core components
         if (!initialize_redis_subscriber(config)) {
@@ -68,14 +83,32 @@ bool TradingEngineService::initialize(const config::ConfigManager& config) {
             return false;
         }
         
+        if (!initialize_fill_simulator(config)) {
+            utils::Logger::error("Failed to initialize fill simulator");
+            return false;
+        }
+        
         // Initialize Prometheus exporter
-        int metrics_port = config.get_value<int>("trading_engine.metrics_port", 8082);
-        prometheus_exporter_ = std::make_unique<monitoring::PrometheusExporter>("trading-engine", metrics_port);
+        metrics_port_ = config.get_value<int>("trading_engine.metrics_port", 8082);
+        prometheus_exporter_ = std::make_unique<utils::PrometheusExporter>();
         
         // Initialize trade logger
         trade_logger_ = std::make_unique<TradeLogger>();
         std::string influxdb_url = config.get_value<std::string>("influxdb.url", "http://localhost:8086");
         std::string database = config.get_value<std::string>("influxdb.database", "ats_trades");
+        trade_logger_->set_batch_size(config.get_value<int>("trading_engine.influx_batch_lines", 5000));
+        trade_logger_->set_batch_bytes(config.get_value<int>("trading_engine.influx_batch_kb", 256) * 1024);
+        trade_logger_->set_flush_interval(std::chrono::milliseconds(
+            config.get_value<int>("trading_engine.influx_flush_interval_ms", 1000)));
+        trade_logger_->set_max_backlog_bytes(
+            static_cast<size_t>(config.get_value<int>("trading_engine.influx_max_backlog_mb", 64)) * 1024 * 1024);
+        trade_logger_->enable_compression(config.get_value<bool>("trading_engine.influx_gzip", true));
+        trade_logger_->set_journal_retention(
+            std::chrono::hours(config.get_value<int>("trading_engine.journal_retention_hours", 168)));
+        std::string spill_path = config.get_value<std::string>("trading_engine.influx_spill_path", "");
+        if (!spill_path.empty()) {
+            trade_logger_->set_spill_path(spill_path);
+        }
         
         if (!trade_logger_->initialize(influxdb_url, database)) {
             utils::Logger::error("Failed to initialize trade logger");
@@ -118,8 +151,16 @@ bool TradingEngineService::start() {
         emergency_stopped_ = false;
         
         // Start Prometheus metrics exporter
-        prometheus_exporter_->start();
-        prometheus_exporter_->set_health_status(true);
+        prometheus_exporter_->start("0.0.0.0", metrics_port_);
+        prometheus_exporter_->set_gauge("trading_engine_healthy", 1.0);
+        
+        // Set up callbacks before the subscriber's workers can invoke them
+        redis_subscriber_->set_price_update_callback([this](const PriceUpdateEvent& event) {
+            on_price_update(event.ticker);
+        });
+        redis_subscriber_->set_order_book_callback([this](const types::OrderBook& book) {
+            on_order_book_update(book);
+        });
         
         // Start core components
         if (!redis_subscriber_->start()) {
@@ -128,11 +169,6 @@ bool TradingEngineService::start() {
             return false;
         }
         
-        // Set up callbacks
-        redis_subscriber_->set_price_update_callback([this](const PriceUpdateEvent& event) {
-            on_price_update(event.ticker);
-        });
-        
         order_router_->set_execution_completed_callback([this](const SimultaneousExecutionResult& result) {
             TradeExecution execution;
             execution.trade_id = result.trade_id;
@@ -171,7 +207,7 @@ void TradingEngineService::stop() {
     
     // Stop Prometheus exporter
     if (prometheus_exporter_) {
-        prometheus_exporter_->set_health_status(false);
+        prometheus_exporter_->set_gauge("trading_engine_healthy", 0.0);
         prometheus_exporter_->stop();
     }
     
@@ -210,6 +246,11 @@ void TradingEngineService::update_config(const TradingEngineConfig& config) {
         order_router_->update_config(router_config);
     }
     
+    {
+        std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+        opportunity_queue_->set_limits(config.max_queue_size, config.opportunity_timeout);
+    }
+    
     utils::Logger::info("TradingEngineService configuration updated");
 }
 
@@ -246,12 +287,23 @@ bool TradingEngineService::execute_arbitrage(const ArbitrageOpportunity& opportu
     // Add to opportunity queue
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
-        if (opportunity_queue_.size() >= config_.max_queue_size) {
-            utils::Logger::warn("Opportunity queue is full");
-            return false;
-        }
+        auto result = opportunity_queue_->push(opportunity, std::chrono::system_clock::now());
+        sync_queue_statistics();
         
-        opportunity_queue_.push(opportunity);
+        switch (result) {
+            case OpportunityQueue::PushResult::QUEUED:
+            case OpportunityQueue::PushResult::REPLACED:
+                break;
+            case OpportunityQueue::PushResult::STALE:
+                utils::Logger::debug("Dropped stale opportunity for {}: a fresher one is queued", opportunity.symbol);
+                return false;
+            case OpportunityQueue::PushResult::EXPIRED:
+                utils::Logger::debug("Dropped opportunity for {}: expired before queuing", opportunity.symbol);
+                return false;
+            case OpportunityQueue::PushResult::FULL:
+                utils::Logger::warn("Opportunity queue is full");
+                return false;
+        }
     }
     
     queue_condition_.notify_one();
@@ -425,6 +477,14 @@ TradingStatistics TradingEngineService::get_statistics() const {
         now - statistics_.session_start_time);
     const_cast<TradingStatistics&>(statistics_).uptime = uptime;
     
+    if (fill_simulator_) {
+        auto& stats = const_cast<TradingStatistics&>(statistics_);
+        stats.simulated_fills = fill_simulator_->get_fills_simulated();
+        stats.simulated_partial_fills = fill_simulator_->get_partial_fills();
+        stats.simulated_unfilled_orders = fill_simulator_->get_unfilled_orders();
+        stats.simulated_fills_without_depth = fill_simulator_->get_fills_without_depth();
+    }
+    
     return statistics_;
 }
 
@@ -527,11 +587,19 @@ std::string TradingEngineService::get_status_report() const {
     oss << "Active Trades: " << get_active_trade_count() << "\n";
     oss << "Total Opportunities: " << stats.total_opportunities_detected.load() << "\n";
     oss << "Executed Trades: " << stats.total_opportunities_executed.load() << "\n";
+    oss << "Expired Opportunities: " << stats.total_opportunities_expired.load() << "\n";
+    oss << "Superseded Opportunities: " << stats.total_opportunities_superseded.load() << "\n";
     oss << "Success Rate: " << std::fixed << std::setprecision(2) 
         << (stats.success_rate.load() * 100) << "%\n";
     oss << "Total P&L: " << std::fixed << std::setprecision(2) 
         << stats.total_profit_loss.load() << " USD\n";
     oss << "Average Execution Time: " << stats.average_execution_time.load().count() << " ms\n";
+    if (config_.enable_paper_trading) {
+        oss << "Simulated Fills: " << stats.simulated_fills.load()
+            << " (partial " << stats.simulated_partial_fills.load()
+            << ", unfilled " << stats.simulated_unfilled_orders.load()
+            << ", without depth " << stats.simulated_fills_without_depth.load() << ")\n";
+    }
     oss << "Uptime: " << stats.uptime.load().count() / 1000 << " seconds\n";
     
     auto health_issues = get_health_issues();
@@ -555,9 +623,11 @@ void TradingEngineService::on_price_update(const types::Ticker& ticker) {
     if (spread_calculator_) {
         spread_calculator_->update_ticker(ticker);
         
-        // Detect arbitrage opportunities
-        auto opportunities = spread_calculator_->detect_arbitrage_opportunities(
-            config_.min_spread_threshold);
+        // Detect arbitrage opportunities, either for the updated pairs only or
+        // across the whole universe
+        auto opportunities = config_.incremental_detection
+            ? spread_calculator_->detect_arbitrage_opportunities(ticker, config_.min_spread_threshold)
+            : spread_calculator_->detect_arbitrage_opportunities(config_.min_spread_threshold);
         
         for (const auto& opportunity : opportunities) {
             on_arbitrage_opportunity_detected(opportunity);
@@ -565,6 +635,28 @@ void TradingEngineService::on_price_update(const types::Ticker& ticker) {
     }
 }
 
+void TradingEngineService::on_order_book_update(const types::OrderBook& book) {
+    if (!spread_calculator_) {
+        return;
+    }
+    
+    // Cached books size opportunities and back the paper fill simulator;
+    // the buffer is reused across updates
+    thread_local MarketDepth depth;
+    depth.symbol = book.symbol;
+    depth.exchange = book.exchange;
+    depth.timestamp = book.timestamp;
+    depth.bids.clear();
+    depth.asks.clear();
+    for (const auto& level : book.bids) {
+        depth.bids.emplace_back(level.price, level.quantity);
+    }
+    for (const auto& level : book.asks) {
+        depth.asks.emplace_back(level.price, level.quantity);
+    }
+    spread_calculator_->update_market_depth(depth);
+}
+
 void TradingEngineService::on_arbitrage_opportunity_detected(const ArbitrageOpportunity& opportunity) {
     if (!running_ || emergency_stopped_) {
         return;
@@ -577,7 +669,8 @@ void TradingEngineService::on_arbitrage_opportunity_detected(const ArbitrageOppo
     
     // Update Prometheus metrics
     if (prometheus_exporter_) {
-        prometheus_exporter_->increment_arbitrage_opportunities(opportunity.symbol);
+        prometheus_exporter_->increment_counter("trading_engine_arbitrage_opportunities_total",
+                                                {{"symbol", opportunity.symbol}});
     }
     
     // Execute if profitable and within limits
@@ -597,18 +690,21 @@ void TradingEngineService::on_trade_execution_completed(const TradeExecution& ex
         
         // Update Prometheus metrics for successful trade
         if (prometheus_exporter_) {
-            prometheus_exporter_->increment_successful_trades();
-            prometheus_exporter_->record_profit_per_trade(execution.actual_profit);
-            prometheus_exporter_->record_order_latency(execution.buy_exchange, execution.execution_latency.count());
-            prometheus_exporter_->record_order_latency(execution.sell_exchange, execution.execution_latency.count());
-            prometheus_exporter_->set_total_pnl(statistics_.total_profit_loss.load());
+            double latency_ms = static_cast<double>(execution.execution_latency.count());
+            prometheus_exporter_->increment_counter("trading_engine_successful_trades_total");
+            prometheus_exporter_->observe_histogram("trading_engine_profit_per_trade", execution.actual_profit);
+            prometheus_exporter_->observe_histogram("trading_engine_order_latency_ms", latency_ms,
+                                                    {{"exchange", execution.buy_exchange}});
+            prometheus_exporter_->observe_histogram("trading_engine_order_latency_ms", latency_ms,
+                                                    {{"exchange", execution.sell_exchange}});
+            prometheus_exporter_->set_gauge("trading_engine_total_pnl", statistics_.total_profit_loss.load());
         }
     } else {
         statistics_.total_failed_trades++;
         
         // Update Prometheus metrics for failed trade
         if (prometheus_exporter_) {
-            prometheus_exporter_->increment_failed_trades();
+            prometheus_exporter_->increment_counter("trading_engine_failed_trades_total");
         }
         
         if (config_.enable_rollback_on_failure) {
@@ -677,14 +773,17 @@ void TradingEngineService::worker_thread_main() {
         std::unique_lock<std::mutex> lock(queue_mutex_);
         
         queue_condition_.wait(lock, [this]() {
-            return !opportunity_queue_.empty() || !running_;
+            return !opportunity_queue_->empty() || !running_;
         });
         
         if (!running_) break;
         
-        if (!opportunity_queue_.empty()) {
-            auto opportunity = opportunity_queue_.front();
-            opportunity_queue_.pop();
+        // Expired entries are discarded on the way to the best live one
+        ArbitrageOpportunity opportunity;
+        bool found = opportunity_queue_->pop(opportunity, std::chrono::system_clock::now());
+        sync_queue_statistics();
+        
+        if (found) {
             lock.unlock();
             
             // Execute the trade
@@ -696,8 +795,10 @@ void TradingEngineService::worker_thread_main() {
                 active_trades_[execution.trade_id] = execution;
             }
             
-            // If it's not already completed, the order router will handle monitoring
-            if (execution.result != ExecutionResult::SUCCESS && 
+            // If it's not already completed, the order router will handle monitoring.
+            // Paper trades never involve the router and are always final.
+            if (!config_.enable_paper_trading &&
+                execution.result != ExecutionResult::SUCCESS && 
                 execution.result != ExecutionResult::FAILURE) {
                 // The order router will call our completion callback when done
             } else {
@@ -760,7 +861,8 @@ bool TradingEngineService::validate_opportunity(const ArbitrageOpportunity& oppo
     if (opportunity.buy_exchange == opportunity.sell_exchange) return false;
     if (opportunity.available_quantity <= 0) return false;
     if (opportunity.buy_price >= opportunity.sell_price) return false;
-    if (opportunity.expected_profit <= 0) return false;
+    // NaN would also break the opportunity queue's profit ordering
+    if (!std::isfinite(opportunity.expected_profit) || opportunity.expected_profit <= 0) return false;
     
     return true;
 }
@@ -778,14 +880,37 @@ TradeExecution TradingEngineService::execute_trade_internal(const ArbitrageOppor
     execution.timestamp = std::chrono::system_clock::now();
     
     if (config_.enable_paper_trading) {
-        // Simulate successful execution
-        execution.result = ExecutionResult::SUCCESS;
-        execution.executed_quantity = opportunity.available_quantity;
-        execution.actual_profit = opportunity.expected_profit * 0.95; // Simulate some slippage
-        execution.total_fees = opportunity.total_fees;
-        execution.execution_latency = std::chrono::milliseconds(rand() % 100 + 50);
+        if (!fill_simulator_) {
+            execution.result = ExecutionResult::FAILURE;
+            execution.error_message = "Fill simulator not available";
+            return execution;
+        }
+        
+        // Fill against the cached books; buffers are reused across trades
+        thread_local MarketDepth buy_book;
+        thread_local MarketDepth sell_book;
+        bool has_buy_book = spread_calculator_ &&
+            spread_calculator_->get_market_depth(opportunity.buy_exchange, opportunity.symbol, buy_book);
+        bool has_sell_book = spread_calculator_ &&
+            spread_calculator_->get_market_depth(opportunity.sell_exchange, opportunity.symbol, sell_book);
+        
+        auto fill = fill_simulator_->simulate(opportunity,
+                                              has_buy_book ? &buy_book : nullptr,
+                                              has_sell_book ? &sell_book : nullptr,
+                                              execution.timestamp);
+        if (config_.paper_trading_realtime) {
+            std::this_thread::sleep_for(fill.latency);
+        }
+        
+        execution.result = fill.result;
+        execution.executed_quantity = fill.executed_quantity;
+        execution.actual_profit = fill.profit;
+        execution.total_fees = fill.total_fees;
+        execution.execution_latency = fill.latency;
+        execution.error_message = fill.error_message;
         
-        utils::Logger::info("Paper trade executed: {}", execution.trade_id);
+        utils::Logger::debug("Paper trade {}: filled {}/{} profit {}", execution.trade_id,
+                             fill.executed_quantity, opportunity.available_quantity, fill.profit);
         return execution;
     }
     
@@ -841,9 +966,20 @@ bool TradingEngineService::initialize_redis_subscriber(const config::ConfigManag
     redis_config.port = config.get_value<int>("redis.port", 6379);
     redis_config.password = config.get_value<std::string>("redis.password", "");
     
-    // Subscribe to price channels
+    // Parse pipeline: one worker and one bounded queue per partition
+    redis_config.worker_thread_count = config.get_value<int>("trading_engine.redis_worker_threads", 2);
+    redis_config.message_buffer_size = config.get_value<size_t>("trading_engine.redis_queue_capacity", 10000);
+    redis_config.overflow_policy =
+        config.get_value<std::string>("trading_engine.redis_overflow_policy", "block") == "drop_oldest"
+            ? QueueOverflowPolicy::DROP_OLDEST : QueueOverflowPolicy::BLOCK;
+    redis_config.partition_key =
+        config.get_value<std::string>("trading_engine.redis_partition_by", "symbol") == "channel"
+            ? PartitionKey::CHANNEL : PartitionKey::SYMBOL;
+    
+    // Subscribe to price and order book channels; the books back paper fills
     redis_config.channels = {
         "price_updates",
+        redis_utils::build_order_book_channel(),
         "arbitrage_opportunities"
     };
     
@@ -858,6 +994,10 @@ bool TradingEngineService::initialize_order_router(const config::ConfigManager&
     router_config.execution_timeout = config_.execution_timeout;
     router_config.max_slippage_tolerance = config_.slippage_tolerance;
     router_config.enable_rollback_on_failure = config_.enable_rollback_on_failure;
+    router_config.execution_coordinator_threads =
+        config.get_value<size_t>("trading_engine.execution_coordinator_threads", 2);
+    router_config.pin_execution_threads = config.get_value<bool>("trading_engine.pin_execution_threads", false);
+    router_config.execution_first_core = config.get_value<int>("trading_engine.execution_first_core", 0);
     
     return order_router_->initialize(router_config);
 }
@@ -867,6 +1007,30 @@ bool TradingEngineService::initialize_spread_calculator(const config::ConfigMana
     return spread_calculator_->initialize(config);
 }
 
+bool TradingEngineService::initialize_fill_simulator(const config::ConfigManager& config) {
+    FillSimulatorConfig simulator_config;
+    simulator_config.seed = config.get_value<uint64_t>("trading_engine.paper_seed", 1);
+    simulator_config.default_latency.base = std::chrono::milliseconds(
+        config.get_value<int>("trading_engine.paper_latency_ms", 50));
+    simulator_config.default_latency.jitter = std::chrono::milliseconds(
+        config.get_value<int>("trading_engine.paper_latency_jitter_ms", 20));
+    
+    auto exchange_latency = config.get_value<std::unordered_map<std::string, int>>(
+        "trading_engine.paper_exchange_latency_ms", {});
+    for (const auto& [exchange, latency_ms] : exchange_latency) {
+        simulator_config.exchange_latency[exchange] = {std::chrono::milliseconds(latency_ms),
+                                                       simulator_config.default_latency.jitter};
+    }
+    
+    simulator_config.taker_fees = config_.exchange_fees;
+    simulator_config.slippage_tolerance = config_.slippage_tolerance;
+    simulator_config.competing_flow = config.get_value<double>("trading_engine.paper_competing_flow", 0.5);
+    simulator_config.volatility_bps = config.get_value<double>("trading_engine.paper_volatility_bps", 2.0);
+    
+    fill_simulator_ = std::make_unique<FillSimulator>(std::move(simulator_config));
+    return true;
+}
+
 void TradingEngineService::start_worker_threads() {
     // Start worker threads
     for (int i = 0; i < config_.worker_thread_count; ++i) {
@@ -921,22 +1085,27 @@ void TradingEngineService::update_statistics() {
     }
 }
 
+void TradingEngineService::sync_queue_statistics() {
+    statistics_.total_opportunities_expired = opportunity_queue_->expired_count();
+    statistics_.total_opportunities_superseded = opportunity_queue_->superseded_count();
+}
+
 void TradingEngineService::collect_system_metrics() {
     if (!prometheus_exporter_) return;
     
     // Collect CPU usage
     double cpu_usage = get_cpu_usage();
-    prometheus_exporter_->set_cpu_usage(cpu_usage);
+    prometheus_exporter_->set_gauge("trading_engine_cpu_usage_percent", cpu_usage);
     
     // Collect memory usage
     double memory_mb = get_memory_usage();
-    prometheus_exporter_->set_memory_usage(memory_mb);
+    prometheus_exporter_->set_gauge("trading_engine_memory_usage_mb", memory_mb);
     
     // Update service uptime
     auto uptime = std::chrono::duration_cast<std::chrono::seconds>(
         std::chrono::steady_clock::now() - statistics_.session_start_time.load()
     ).count();
-    prometheus_exporter_->set_service_uptime(static_cast<double>(uptime));
+    prometheus_exporter_->set_gauge("trading_engine_uptime_seconds", static_cast<double>(uptime));
 }
 
 double TradingEngineService::get_cpu_usage() {
@@ -1108,8 +1277,14 @@ nlohmann::json trading_statistics_to_json(const TradingStatistics& stats) {
     nlohmann::json j;
     j["total_opportunities_detected"] = stats.total_opportunities_detected.load();
     j["total_opportunities_executed"] = stats.total_opportunities_executed.load();
+    j["total_opportunities_expired"] = stats.total_opportunities_expired.load();
+    j["total_opportunities_superseded"] = stats.total_opportunities_superseded.load();
     j["total_successful_trades"] = stats.total_successful_trades.load();
     j["total_failed_trades"] = stats.total_failed_trades.load();
+    j["simulated_fills"] = stats.simulated_fills.load();
+    j["simulated_partial_fills"] = stats.simulated_partial_fills.load();
+    j["simulated_unfilled_orders"] = stats.simulated_unfilled_orders.load();
+    j["simulated_fills_without_depth"] = stats.simulated_fills_without_depth.load();
     j["total_profit_loss"] = stats.total_profit_loss.load();
     j["total_fees_paid"] = stats.total_fees_paid.load();
     j["success_rate"] = stats.success_rate.load();